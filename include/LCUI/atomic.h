@@ -0,0 +1,169 @@
+﻿/*
+ * atomic.h -- atomic operations
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LCUI_ATOMIC_H
+#define LCUI_ATOMIC_H
+
+/*
+ * 所有读-修改-写操作都是顺序一致的，LCUIAtomic_Load() 具有 acquire 语义，
+ * LCUIAtomic_Store() 具有 release 语义
+ */
+
+#include <LCUI/types.h>
+
+#ifdef _MSC_VER
+
+#include <windows.h>
+
+typedef volatile LONG LCUI_AtomicInt;
+typedef void *volatile LCUI_AtomicPtr;
+
+INLINE int LCUIAtomic_Load(LCUI_AtomicInt *a)
+{
+	return (int)InterlockedCompareExchange(a, 0, 0);
+}
+
+INLINE void LCUIAtomic_Store(LCUI_AtomicInt *a, int value)
+{
+	InterlockedExchange(a, value);
+}
+
+/** 加上 value，返回相加后的值 */
+INLINE int LCUIAtomic_Add(LCUI_AtomicInt *a, int value)
+{
+	return (int)InterlockedExchangeAdd(a, value) + value;
+}
+
+/** 设置新的值，返回旧的值 */
+INLINE int LCUIAtomic_Exchange(LCUI_AtomicInt *a, int value)
+{
+	return (int)InterlockedExchange(a, value);
+}
+
+/** 若当前值等于 expected 则设置为 value，并返回 TRUE */
+INLINE LCUI_BOOL LCUIAtomic_CompareExchange(LCUI_AtomicInt *a, int expected,
+					    int value)
+{
+	return InterlockedCompareExchange(a, value, expected) == expected;
+}
+
+INLINE void *LCUIAtomic_LoadPtr(LCUI_AtomicPtr *a)
+{
+	return InterlockedCompareExchangePointer(a, NULL, NULL);
+}
+
+INLINE void LCUIAtomic_StorePtr(LCUI_AtomicPtr *a, void *value)
+{
+	InterlockedExchangePointer(a, value);
+}
+
+INLINE LCUI_BOOL LCUIAtomic_CompareExchangePtr(LCUI_AtomicPtr *a,
+					       void *expected, void *value)
+{
+	return InterlockedCompareExchangePointer(a, value, expected) ==
+	       expected;
+}
+
+/** 完整的内存屏障 */
+#define LCUIAtomic_Fence() MemoryBarrier()
+
+/** 在自旋等待中提示 CPU 降低功耗并让出流水线 */
+#define LCUIAtomic_Pause() YieldProcessor()
+
+#else
+
+typedef volatile int LCUI_AtomicInt;
+typedef void *volatile LCUI_AtomicPtr;
+
+INLINE int LCUIAtomic_Load(LCUI_AtomicInt *a)
+{
+	return __atomic_load_n(a, __ATOMIC_ACQUIRE);
+}
+
+INLINE void LCUIAtomic_Store(LCUI_AtomicInt *a, int value)
+{
+	__atomic_store_n(a, value, __ATOMIC_RELEASE);
+}
+
+/** 加上 value，返回相加后的值 */
+INLINE int LCUIAtomic_Add(LCUI_AtomicInt *a, int value)
+{
+	return __atomic_add_fetch(a, value, __ATOMIC_SEQ_CST);
+}
+
+/** 设置新的值，返回旧的值 */
+INLINE int LCUIAtomic_Exchange(LCUI_AtomicInt *a, int value)
+{
+	return __atomic_exchange_n(a, value, __ATOMIC_SEQ_CST);
+}
+
+/** 若当前值等于 expected 则设置为 value，并返回 TRUE */
+INLINE LCUI_BOOL LCUIAtomic_CompareExchange(LCUI_AtomicInt *a, int expected,
+					    int value)
+{
+	return __atomic_compare_exchange_n(a, &expected, value, 0,
+					   __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+INLINE void *LCUIAtomic_LoadPtr(LCUI_AtomicPtr *a)
+{
+	return __atomic_load_n(a, __ATOMIC_ACQUIRE);
+}
+
+INLINE void LCUIAtomic_StorePtr(LCUI_AtomicPtr *a, void *value)
+{
+	__atomic_store_n(a, value, __ATOMIC_RELEASE);
+}
+
+INLINE LCUI_BOOL LCUIAtomic_CompareExchangePtr(LCUI_AtomicPtr *a,
+					       void *expected, void *value)
+{
+	return __atomic_compare_exchange_n(a, &expected, value, 0,
+					   __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/** 完整的内存屏障 */
+#define LCUIAtomic_Fence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+/** 在自旋等待中提示 CPU 降低功耗并让出流水线 */
+#if defined(__i386__) || defined(__x86_64__)
+#define LCUIAtomic_Pause() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define LCUIAtomic_Pause() __asm__ __volatile__("yield")
+#else
+#define LCUIAtomic_Pause() LCUIAtomic_Fence()
+#endif
+
+#endif
+
+#define LCUIAtomic_Increment(A) LCUIAtomic_Add(A, 1)
+#define LCUIAtomic_Decrement(A) LCUIAtomic_Add(A, -1)
+
+#endif
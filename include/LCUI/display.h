@@ -34,6 +34,7 @@
 #include <LCUI/gui/metrics.h>
 #include <LCUI/gui/widget.h>
 #include <LCUI/surface.h>
+#include <LCUI/thread.h>
 
 LCUI_BEGIN_HEADER
 
@@ -75,6 +76,15 @@ typedef struct LCUI_DisplayEventRec_ {
 	LCUI_Surface surface;
 } LCUI_DisplayEventRec, *LCUI_DisplayEvent;
 
+/** surface 的渲染和呈现耗时 */
+typedef struct LCUI_SurfaceTimingRec_ {
+	int64_t render_time;		/**< 最近一帧的渲染耗时（纳秒） */
+	int64_t present_time;		/**< 最近一帧的呈现耗时（纳秒） */
+	int64_t total_render_time;	/**< 渲染的总耗时（纳秒） */
+	int64_t total_present_time;	/**< 呈现的总耗时（纳秒） */
+	size_t frames;			/**< 有内容需要渲染的帧数 */
+} LCUI_SurfaceTimingRec, *LCUI_SurfaceTiming;
+
 /** surface 的操作方法集 */
 typedef struct LCUI_DisplayDriverRec_ {
 	char name[256];
@@ -92,6 +102,7 @@ typedef struct LCUI_DisplayDriverRec_ {
 	LCUI_BOOL (*isReady)(LCUI_Surface);
 	LCUI_PaintContext (*beginPaint)(LCUI_Surface, LCUI_Rect *);
 	void (*endPaint)(LCUI_Surface, LCUI_PaintContext);
+	int (*copyRect)(LCUI_Surface, LCUI_Rect *, int, int);
 	void (*setCaptionW)(LCUI_Surface, const wchar_t *);
 	void (*setRenderMode)(LCUI_Surface, int);
 	void *(*getHandle)(LCUI_Surface);
@@ -118,6 +129,23 @@ LCUI_API void LCUIDisplay_Present(void);
 
 LCUI_API void LCUIDisplay_EnablePaintFlashing(LCUI_BOOL enable);
 
+/** 获取渲染线程的数量，包括主线程 */
+LCUI_API int LCUIDisplay_GetRenderThreads(void);
+
+/**
+ * 获取渲染线程的忙碌和空闲时间等统计信息
+ * @param[in] index 线程序号，0 表示调用 LCUIDisplay_Render() 的线程
+ */
+LCUI_API int LCUIDisplay_GetRenderThreadStats(int index,
+					      LCUI_ThreadPoolStats stats);
+
+/** 重置渲染线程的统计信息 */
+LCUI_API void LCUIDisplay_ResetRenderThreadStats(void);
+
+/** 获取 surface 的渲染和呈现耗时 */
+LCUI_API int LCUIDisplay_GetSurfaceTiming(LCUI_Surface surface,
+					  LCUI_SurfaceTiming timing);
+
 /** 设置显示区域的尺寸，仅在窗口化、全屏模式下有效 */
 LCUI_API void LCUIDisplay_SetSize(int width, int height);
 
@@ -35,6 +35,7 @@ LCUI_BEGIN_HEADER
 
 #include <LCUI/draw/line.h>
 #include <LCUI/draw/border.h>
+#include <LCUI/draw/border_image.h>
 #include <LCUI/draw/boxshadow.h>
 #include <LCUI/draw/background.h>
 
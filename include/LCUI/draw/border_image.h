@@ -0,0 +1,85 @@
+﻿/*
+ * border_image.h -- Border image (nine-patch) drawing
+ *
+ * Copyright (c) 2019, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LCUI_DRAW_BORDER_IMAGE_H
+#define LCUI_DRAW_BORDER_IMAGE_H
+
+LCUI_BEGIN_HEADER
+
+/** 边框图像被切成的图块数量：四个角、四条边和中间块 */
+#define BORDER_IMAGE_TILES 9
+
+/**
+ * 边框图像的图块缓存
+ * 缓存按目标尺寸缩放或平铺后的图块，在源图像、切片参数和目标尺寸都不变时，绘制
+ * 边框图像只需要复制与绘制区域相交的图块
+ */
+typedef struct LCUI_BorderImageTilesRec_ {
+	LCUI_BorderImage image;   /**< 生成图块时使用的参数 */
+	unsigned long source_id;  /**< 生成图块时源图像的存储的标识号 */
+	LCUI_Rect source_rect;    /**< 源图像在其存储中的区域 */
+	int width, height;        /**< 目标区域的尺寸 */
+	LCUI_Rect rects[BORDER_IMAGE_TILES]; /**< 各图块在目标区域中的位置 */
+	LCUI_Graph graphs[BORDER_IMAGE_TILES]; /**< 缩放或平铺后的图块 */
+} LCUI_BorderImageTilesRec, *LCUI_BorderImageTiles;
+
+LCUI_API void BorderImageTiles_Init(LCUI_BorderImageTiles tiles);
+
+LCUI_API void BorderImageTiles_Free(LCUI_BorderImageTiles tiles);
+
+/** 判断图块是否是用相同的参数和目标尺寸生成的 */
+LCUI_API LCUI_BOOL BorderImageTiles_IsValid(const LCUI_BorderImageTiles tiles,
+					    const LCUI_BorderImage *image,
+					    int width, int height);
+
+/** 复制图块，图块的像素数据是共享的，只在写入时才会复制 */
+LCUI_API void BorderImageTiles_Copy(LCUI_BorderImageTiles dst,
+				    const LCUI_BorderImageTiles src);
+
+/**
+ * 按目标尺寸更新图块
+ * @returns 缓存仍然有效时返回 0，重新生成了图块时返回 1，参数无效时返回 -1
+ */
+LCUI_API int BorderImageTiles_Update(LCUI_BorderImageTiles tiles,
+				     const LCUI_BorderImage *image, int width,
+				     int height);
+
+/** 绘制图块，只复制与绘制区域相交的部分 */
+LCUI_API int BorderImageTiles_Paint(const LCUI_BorderImageTiles tiles,
+				    const LCUI_Rect *box,
+				    LCUI_PaintContext paint);
+
+/** 绘制边框图像，不使用缓存 */
+LCUI_API int BorderImage_Paint(const LCUI_BorderImage *image,
+			       const LCUI_Rect *box, LCUI_PaintContext paint);
+
+LCUI_END_HEADER
+
+#endif
@@ -79,6 +79,21 @@ typedef struct LCUI_FontRec_ {
 	LCUI_FontEngine *engine;	/**< 所属的字体引擎 */
 } LCUI_FontRec, *LCUI_Font;
 
+/**
+ * 字体栈，即按字族列表解析出的字体 ID 列表
+ * 由字族列表、风格和字重都相同的部件共享，不应修改其中的数据
+ */
+typedef struct LCUI_FontStackRec_ {
+	char *family;			/**< 字族名称，多个名字用逗号隔开 */
+	LCUI_FontStyle style;		/**< 风格 */
+	LCUI_FontWeight weight;		/**< 粗细程度 */
+	int *font_ids;			/**< 字体 ID 列表，以 0 结尾，没有可用的字体时为 NULL */
+	size_t length;			/**< 字体 ID 的数量 */
+	unsigned hash;
+	long refs;
+	LCUI_BOOL cached;
+} LCUI_FontStackRec, *LCUI_FontStack;
+
 struct LCUI_FontEngine {
 	char name[64];
 	int(*open)(const char*, LCUI_Font**);
@@ -188,6 +203,21 @@ LCUI_API size_t LCUIFont_GetIdByNames(int **font_ids,
 				      LCUI_FontWeight weight,
 				      const char *names);
 
+/**
+ * 获取字体栈，并增加它的引用计数
+ * 相同参数的字体栈只解析一次，之后都从缓存中获取同一个字体栈。添加字体后缓存
+ * 会被清空，再次获取时会重新解析，已获取的字体栈不受影响。
+ * @param[in] family 字族名称，多个名字用逗号隔开
+ * @param[in] style 风格
+ * @param[in] weight 字重，若为值 0，则默认为 FONT_WEIGHT_NORMAL
+ */
+LCUI_API LCUI_FontStack LCUIFont_GetStack(const char *family,
+					  LCUI_FontStyle style,
+					  LCUI_FontWeight weight);
+
+/** 释放对字体栈的引用 */
+LCUI_API void LCUIFont_ReleaseStack(LCUI_FontStack stack);
+
 /** 获取指定字体ID的字体信息 */
 LCUI_API LCUI_Font LCUIFont_GetById(int id);
 
@@ -211,6 +241,8 @@ LCUI_API LCUI_FontBitmap* LCUIFont_AddBitmap(wchar_t ch, int font_id,
 
 /**
  * 从缓存中获取字体位图
+ * 如果缓存中没有，则渲染后添加至缓存中。缓存区有互斥锁保护，因此可以在工作线程
+ * 中调用它来预先渲染字形。
  * @param[in] ch 字符码
  * @param[in] font_id 使用的字体ID
  * @param[in] size 字体大小（单位为像素）
@@ -55,12 +55,20 @@ typedef struct TextRowRec_ {
 	int length;            /**< 该行文本长度 */
 	LCUI_TextChar *string; /**< 该行文本的数据 */
 	LCUI_EOLChar eol;      /**< 行尾结束类型 */
+
+	/**
+	 * 字形位图缓存
+	 * 它是该行所有文字的字体位图合并后的覆盖率数据，left 和 top 是它相对于
+	 * 文本行左上角的位置，在文本行有变化时会被清除，在绘制时重新生成。
+	 */
+	LCUI_FontBitmap bitmap;
 } LCUI_TextRowRec, *LCUI_TextRow;
 
 /* 文本行列表 */
 typedef struct LCUI_TextRowListRec_ {
 	int length;         /**< 当前总行数 */
 	LCUI_TextRow *rows; /**< 每一行文本的数据 */
+	size_t cache_size;  /**< 各行字形位图缓存占用的内存大小 */
 } LCUI_TextRowListRec, *LCUI_TextRowList;
 
 /**
@@ -102,6 +110,7 @@ typedef struct LCUI_TextLayerRec_ {
 	LCUI_BOOL enable_mulitiline;   /**< 是否启用多行文本模式 */
 	LCUI_BOOL enable_autowrap;     /**< 是否启用自动换行模式 */
 	LCUI_BOOL enable_style_tag;    /**< 是否使用文本样式标签 */
+	LCUI_BOOL enable_row_cache;    /**< 是否缓存各行的字形位图 */
 	LinkedList dirty_rects;               /**< 脏矩形记录 */
 	LinkedList text_styles;               /**< 样式缓存 */
 	LCUI_TextStyleRec text_default_style; /**< 文本全局样式 */
@@ -164,6 +173,14 @@ LCUI_API void TextLayer_ClearText(LCUI_TextLayer layer);
 LCUI_API int TextLayer_InsertTextW(LCUI_TextLayer layer, const wchar_t *wstr,
 				   LinkedList *tag_stack);
 
+/**
+ * 批量插入文本内容（宽字符版）
+ * 结果与 TextLayer_InsertTextW() 相同，但不处理样式标签，适用于插入大量文本
+ * @param[in] len 文本长度
+ */
+LCUI_API int TextLayer_InsertTextBulkW(LCUI_TextLayer layer,
+				       const wchar_t *wstr, size_t len);
+
 /** 插入文本内容 */
 LCUI_API int TextLayer_InsertTextA(LCUI_TextLayer layer, const char *str);
 
@@ -174,6 +191,14 @@ LCUI_API int TextLayer_InsertText(LCUI_TextLayer layer, const char *utf8_str);
 LCUI_API int TextLayer_AppendTextW(LCUI_TextLayer layer, const wchar_t *wstr,
 				   LinkedList *tag_stack);
 
+/**
+ * 批量追加文本内容（宽字符版）
+ * 结果与 TextLayer_AppendTextW() 相同，但不处理样式标签，适用于追加大量文本
+ * @param[in] len 文本长度
+ */
+LCUI_API int TextLayer_AppendTextBulkW(LCUI_TextLayer layer,
+				       const wchar_t *wstr, size_t len);
+
 /** 追加文本内容 */
 LCUI_API int TextLayer_AppendTextA(LCUI_TextLayer layer,
 				   const char *ascii_text);
@@ -227,6 +252,14 @@ LCUI_API void TextLayer_SetWordBreak(LCUI_TextLayer layer,
 /** 设置是否使用样式标签 */
 LCUI_API void TextLayer_EnableStyleTag(LCUI_TextLayer layer, LCUI_BOOL enabled);
 
+/**
+ * 设置是否缓存各行的字形位图
+ * 启用后，没有设置前景色和背景色样式的可见文本行会在 TextLayer_Update() 中将
+ * 各个文字的字体位图合并成一张位图，绘制时只需绘制这张位图，而不用逐个混合文
+ * 字。绘制不会修改缓存，没有缓存的文本行仍然逐个混合文字。
+ */
+LCUI_API void TextLayer_EnableRowCache(LCUI_TextLayer layer, LCUI_BOOL enabled);
+
 /** 重新载入各个文字的字体位图 */
 LCUI_API void TextLayer_ReloadCharBitmap(LCUI_TextLayer layer);
 
@@ -93,6 +93,15 @@ LCUI_BEGIN_HEADER
 
 #define Graph_GetQuote(g) ((g)->quote.is_valid ? (g)->quote.source : (g))
 
+/** 图像像素数据的内存统计 */
+typedef struct LCUI_GraphMemoryStatsRec_ {
+	size_t buffers;		/**< 像素数据存储的数量 */
+	size_t shared_buffers;	/**< 被多个图像共享的存储的数量 */
+	size_t unique_bytes;	/**< 只被一个图像使用的字节数 */
+	size_t shared_bytes;	/**< 被多个图像共享的字节数，每份只计一次 */
+	size_t saved_bytes;	/**< 共享存储比深拷贝节省的字节数 */
+} LCUI_GraphMemoryStatsRec, *LCUI_GraphMemoryStats;
+
 #define Graph_SetPixel(G, X, Y, C)                                        \
 	if ((G)->color_type == LCUI_COLOR_TYPE_ARGB) {                    \
 		(G)->argb[(G)->width * (Y) + (X)] = (C);                  \
@@ -200,8 +209,45 @@ LCUI_API int Graph_SetColorType(LCUI_Graph *graph, int color_type);
 
 LCUI_API int Graph_Create(LCUI_Graph *graph, unsigned width, unsigned height);
 
+/**
+ * 用外部的像素数据创建图像，例如映射到内存中的文件
+ * 像素数据按 graph->color_type 逐行紧密排列，且需要可写入
+ * @param[in] release 图像不再使用像素数据时调用的函数，参数为 arg
+ */
+LCUI_API int Graph_CreateFromMemory(LCUI_Graph *graph, unsigned width,
+				    unsigned height, void *bytes,
+				    void (*release)(void *), void *arg);
+
+/**
+ * 复制图像
+ * 如果复制的是整个图像，则与源图像共享像素数据，直到其中一方写入像素时才会
+ * 复制一份独占的像素数据
+ */
 LCUI_API void Graph_Copy(LCUI_Graph *des, const LCUI_Graph *src);
 
+/**
+ * 让图像独占像素数据
+ * Graph_FillRect()、Graph_Mix() 等函数在写入前会自动调用它，而通过
+ * Graph_SetPixel() 或 bytes 成员直接写入像素的代码需要先调用它
+ * @param[in][out] graph 图像，若为引用，则处理其引用源
+ * @returns 正常返回 0，内存不足时返回 -ENOMEM
+ */
+LCUI_API int Graph_Detach(LCUI_Graph *graph);
+
+/** 判断图像的像素数据是否被多个图像共享 */
+LCUI_API LCUI_BOOL Graph_IsShared(const LCUI_Graph *graph);
+
+/**
+ * 获取图像像素数据存储的标识号
+ * 每份存储的标识号都不同，不会因存储被释放后地址被复用而重复，可用于判断缓存
+ * 是否由同一份像素数据生成。写入共享的存储前会复制出新的存储，标识号也随之改变
+ * @returns 图像没有存储时返回 0
+ */
+LCUI_API unsigned long Graph_GetBufferId(const LCUI_Graph *graph);
+
+/** 获取图像像素数据的内存统计 */
+LCUI_API void Graph_GetMemoryStats(LCUI_GraphMemoryStats stats);
+
 LCUI_API void Graph_Free(LCUI_Graph *graph);
 
 /**
@@ -277,6 +323,17 @@ LCUI_API int Graph_Mix(LCUI_Graph *back, const LCUI_Graph *fore, int left,
 LCUI_API int Graph_Replace(LCUI_Graph *back, const LCUI_Graph *fore, int left,
 			   int top);
 
+/**
+ * 将图层中的一块区域复制到同一图层的另一位置
+ * 源区域和目标区域允许重叠，超出图层范围的部分会被裁剪掉
+ * @param[in][out] graph 图层
+ * @param[in] rect 源区域
+ * @param[in] x 目标位置的 X 坐标
+ * @param[in] y 目标位置的 Y 坐标
+ */
+LCUI_API int Graph_CopyRect(LCUI_Graph *graph, const LCUI_Rect *rect, int x,
+			    int y);
+
 LCUI_END_HEADER
 
 #include <LCUI/draw.h>
@@ -53,8 +53,7 @@ enum LCUI_CSSFontStyleKey {
 typedef struct LCUI_CSSFontStyleRec_ {
 	int font_size;
 	int line_height;
-	int *font_ids;
-	char *font_family;
+	LCUI_FontStack font_stack;	/**< 字体栈，由字体样式相同的部件共享 */
 	wchar_t *content;
 	LCUI_Color color;
 	LCUI_FontStyle font_style;
@@ -98,6 +98,14 @@ enum LCUI_StyleKeyName {
 	key_border_top_right_radius,
 	key_border_bottom_left_radius,
 	key_border_bottom_right_radius,
+	key_border_image_source,
+	key_border_image_slice_top,
+	key_border_image_slice_right,
+	key_border_image_slice_bottom,
+	key_border_image_slice_left,
+	key_border_image_slice_fill,
+	key_border_image_repeat_x,
+	key_border_image_repeat_y,
 	// border end
 
 	// background start
@@ -148,7 +156,7 @@ enum LCUI_StyleKeyName {
 #define key_padding_start	key_padding_top
 #define key_padding_end		key_padding_left
 #define key_border_start	key_border_top_width
-#define key_border_end		key_border_bottom_right_radius
+#define key_border_end		key_border_image_repeat_y
 #define key_background_start	key_background_color
 #define key_background_end	key_background_origin
 #define key_box_shadow_start	key_box_shadow_x
@@ -189,6 +197,12 @@ typedef struct LCUI_SelectorRec_ {
 	LCUI_SelectorNode *nodes;	/**< 选择器结点列表 */
 } LCUI_SelectorRec, *LCUI_Selector;
 
+/** 样式规则，由选择器列表和它们共用的样式表组成 */
+typedef struct LCUI_StyleRuleRec_ {
+	LinkedList selectors;		/**< 选择器列表 */
+	LCUI_StyleSheet sheet;		/**< 样式表 */
+} LCUI_StyleRuleRec, *LCUI_StyleRule;
+
 /* clang-format on */
 
 #define CheckStyleType(S, K, T) \
@@ -262,6 +276,20 @@ LCUI_API LCUI_BOOL SelectorNode_Match(LCUI_SelectorNode sn1,
 LCUI_API int LCUI_PutStyleSheet(LCUI_Selector selector, LCUI_StyleSheet in_ss,
 				const char *space);
 
+LCUI_API LCUI_StyleRule StyleRule(void);
+
+LCUI_API void StyleRule_Delete(LCUI_StyleRule rule);
+
+/**
+ * 将样式规则列表一次性添加至样式库中
+ * 选择器的批次号会被重新分配，使这些规则的层叠顺序和在此刻逐条添加的一样，
+ * 因此规则可以在其它线程上预先解析好，然后在主线程上合并。
+ * @param[in] rules 样式规则列表
+ * @param[in] space 样式记录所属的空间
+ * @returns 添加的样式表数量
+ */
+LCUI_API size_t LCUI_PutStyleRules(LinkedList *rules, const char *space);
+
 /**
  * 从指定组中查找样式表
  * @param[in] group 组号
@@ -272,6 +300,24 @@ LCUI_API int LCUI_PutStyleSheet(LCUI_Selector selector, LCUI_StyleSheet in_ss,
 LCUI_API int LCUI_FindStyleSheetFromGroup(int group, const char *name,
 					  LCUI_Selector s, LinkedList *list);
 
+/**
+ * 从指定组中查找样式表，并收集这些样式表作用的选择器结点名称
+ * @param[in] group 组号
+ * @param[in] name 选择器结点名称
+ * @param[in] s 选择器
+ * @param[out] subjects 样式表的选择器中最后一个结点的名称列表
+ * @returns 找到的样式表数量
+ */
+LCUI_API int LCUI_FindStyleSubjectsFromGroup(int group, const char *name,
+					     LCUI_Selector s,
+					     LinkedList *subjects);
+
+/**
+ * 获取状态（伪类）在样式表的选择器中所处的位置
+ * @returns 位置掩码，第 n 位为 1 表示有选择器的倒数第 n + 1 个结点含有该状态
+ */
+LCUI_API unsigned LCUI_GetStatusPositions(const char *status);
+
 LCUI_API LCUI_CachedStyleSheet LCUI_GetCachedStyleSheet(LCUI_Selector s);
 
 LCUI_API void LCUI_GetStyleSheet(LCUI_Selector s, LCUI_StyleSheet out_ss);
@@ -136,9 +136,12 @@ struct LCUI_CSSParserRuleContextRec_ {
 struct LCUI_CSSParserContextRec_ {
 	int pos;            /**< 缓存中的字符串的下标位置 */
 	const char *cur;    /**< 用于遍历字符串的指针 */
+	const char *end;    /**< 字符串的结束位置，为 NULL 时以空字符结尾 */
 	char *space;        /**< 样式记录所属的空间 */
 	char *buffer;       /**< 缓存中的字符串 */
 	size_t buffer_size; /**< 缓存区大小 */
+	LinkedList *rules;  /**< 若不为 NULL，解析出的样式规则将存入该列表，而不是导入至样式库中 */
+	LinkedList *font_faces; /**< 若不为 NULL，@font-face 中的字体文件路径将存入该列表，而不是立即载入 */
 
 	LCUI_CSSParserTarget target; /**< 当前解析目标 */
 	LCUI_CSSParsers parsers;     /**< 可供使用的解析器列表 */
@@ -162,9 +165,26 @@ LCUI_API void CSSStyleParser_SetCSSProperty(LCUI_CSSParserStyleContext ctx,
 
 LCUI_API LCUI_CSSPropertyParser LCUI_GetCSSPropertyParser(const char *name);
 
+/** CSS 文件异步载入完成后的回调函数，参数依次为文件路径、结果（0 为成功）和附加参数 */
+typedef void (*LCUI_CSSLoadedCallback)(const char *, int, void *);
+
 /** 从文件中载入CSS样式数据，并导入至样式库中 */
 LCUI_API int LCUI_LoadCSSFile(const char *filepath);
 
+/**
+ * 解析CSS文件，并将得到的样式规则存入列表中，不导入至样式库
+ * 该函数不依赖主线程，可在工作线程中调用
+ */
+LCUI_API int LCUI_ParseCSSFile(const char *filepath, LinkedList *rules);
+
+/**
+ * 异步载入CSS文件
+ * 文件会在工作线程中解析为独立的样式规则列表，然后在主线程中一次性导入至样式库，
+ * 导入完成后会调用 callback 通知结果
+ */
+LCUI_API int LCUI_LoadCSSFileAsync(const char *filepath,
+				   LCUI_CSSLoadedCallback callback, void *arg);
+
 /** 从字符串中载入CSS样式数据，并导入至样式库中 */
 LCUI_API size_t LCUI_LoadCSSString(const char *str, const char *space);
 
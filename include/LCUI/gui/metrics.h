@@ -61,6 +61,13 @@ LCUI_API int LCUIMetrics_ComputeActual(float value, LCUI_StyleType type);
 /** 获取当前的全局缩放比例 */
 LCUI_API float LCUIMetrics_GetScale(void);
 
+/**
+ * 获取缩放比例的代数
+ * 每次改变缩放比例时都会加一，与缩放比例相关的缓存可以记录它，在代数不同时
+ * 重建，而不必在改变缩放比例时逐个清除。
+ */
+LCUI_API unsigned LCUIMetrics_GetScaleGeneration(void);
+
 /** 设置密度 */
 LCUI_API void LCUIMetrics_SetDensity(float density);
 
@@ -76,7 +83,10 @@ LCUI_API void LCUIMetrics_SetScaledDensityLevel(LCUI_DensityLevel level);
 /** 设置 DPI */
 LCUI_API void LCUIMetrics_SetDpi(float dpi);
 
-/** 设置全局缩放比例 */
+/**
+ * 设置全局缩放比例
+ * 如果缩放比例有变化，则触发一次 LCUI_SCALE_CHANGE 事件
+ */
 LCUI_API void LCUIMetrics_SetScale(float scale);
 
 LCUI_API void LCUI_InitMetrics(void);
@@ -31,13 +31,37 @@
 #ifndef LCUI_TEXTCARET_H
 #define LCUI_TEXTCARET_H
 
+/**
+ * 插入符闪烁时的回调函数
+ * @param[in] w 绑定闪烁时钟的部件
+ * @param[in] visible 插入符当前是否应该可见
+ */
+typedef void (*LCUI_TextCaretBlinkFunc)(LCUI_Widget, LCUI_BOOL);
+
 LCUI_API void TextCaret_Refresh(LCUI_Widget widget);
 
 LCUI_API void TextCaret_SetVisible(LCUI_Widget widget, LCUI_BOOL visible);
 
-/** 设置闪烁的时间间隔 */
+/** 设置闪烁的时间间隔，所有插入符共用同一个闪烁时钟 */
 LCUI_API void TextCaret_SetBlinkTime(LCUI_Widget widget, unsigned int n_ms);
 
+/**
+ * 让部件跟随共享的闪烁时钟
+ * 所有插入符由同一个定时器驱动，没有部件绑定时定时器会被释放
+ */
+LCUI_API void TextCaret_BindBlink(LCUI_Widget w, LCUI_TextCaretBlinkFunc func);
+
+LCUI_API void TextCaret_UnbindBlink(LCUI_Widget w);
+
+/** 重新开始闪烁周期并立即显示插入符，通常在插入符移动后调用 */
+LCUI_API void TextCaret_ResetBlink(void);
+
+/** 插入符在当前闪烁周期内是否可见 */
+LCUI_API LCUI_BOOL TextCaret_IsBlinkVisible(void);
+
+/** 设置共享的闪烁时钟的时间间隔 */
+LCUI_API void TextCaret_SetBlinkInterval(unsigned int n_ms);
+
 LCUI_API void LCUIWidget_AddTextCaret(void);
 
 #endif
\ No newline at end of file
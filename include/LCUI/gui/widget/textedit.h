@@ -35,6 +35,12 @@ LCUI_BEGIN_HEADER
 
 #define TextEdit_New() Widget_New("textedit")
 
+/**
+ * 批量加载文本的进度回调函数
+ * 参数依次为：文本编辑框、已加载的字符数、总字符数、附加参数
+ */
+typedef void (*LCUI_TextEditProgressFunc)(LCUI_Widget, size_t, size_t, void *);
+
 /** Enable style tag parser  */
 LCUI_API void TextEdit_EnableStyleTag(LCUI_Widget widget, LCUI_BOOL enable);
 
@@ -42,6 +48,15 @@ LCUI_API void TextEdit_EnableMultiline(LCUI_Widget widget, LCUI_BOOL enable);
 
 LCUI_API void TextEdit_MoveCaret(LCUI_Widget widget, int row, int col);
 
+/**
+ * 选中一段文本
+ * 选中区域会绘制在文本上面，结束位置上的字符不会被选中
+ */
+LCUI_API void TextEdit_SetSelection(LCUI_Widget w, int start_row, int start_col,
+				    int end_row, int end_col);
+
+LCUI_API void TextEdit_ClearSelection(LCUI_Widget w);
+
 /** 清空文本内容 */
 LCUI_API void TextEdit_ClearText(LCUI_Widget widget);
 
@@ -68,6 +83,27 @@ LCUI_API int TextEdit_AppendTextW(LCUI_Widget widget, const wchar_t *wstr);
 /** 为文本框插入文本（宽字符版） */
 LCUI_API int TextEdit_InsertTextW(LCUI_Widget widget, const wchar_t *wstr);
 
+/**
+ * 批量插入文本（宽字符版）
+ * 文本行由整段文本直接构建，插入符和排版在全部插入完后才更新，适用于粘贴等
+ * 需要插入大量文本的场景。不处理样式标签。
+ * 指定了进度回调函数时，较多的文本会分成多帧处理，每处理完一段都会调用一次
+ * 进度回调函数；否则在下一次更新时一次处理完。
+ * @param[in] func 进度回调函数，可为 NULL
+ * @param[in] arg 传给回调函数的附加参数
+ */
+LCUI_API int TextEdit_InsertTextBulkW(LCUI_Widget w, const wchar_t *wstr,
+				      LCUI_TextEditProgressFunc func,
+				      void *arg);
+
+/**
+ * 批量加载文本（宽字符版）
+ * 与 TextEdit_InsertTextBulkW() 类似，但会替换原有的文本内容，适用于载入文件
+ * 等场景。在加载完前清空文本会取消加载。
+ */
+LCUI_API int TextEdit_LoadTextW(LCUI_Widget w, const wchar_t *wstr,
+				LCUI_TextEditProgressFunc func, void *arg);
+
 /** 设置占位符，当文本编辑框内容为空时显示占位符 */
 LCUI_API int TextEdit_SetPlaceHolderW(LCUI_Widget w, const wchar_t *wstr);
 
@@ -50,6 +50,14 @@ LCUI_API void TextView_SetMulitiline(LCUI_Widget w, LCUI_BOOL enable);
 
 LCUI_API size_t LCUIWidget_RefreshTextView(void);
 
+/**
+ * 在工作线程上预先渲染已显示的文本视图中的字形
+ * 字形按当前的缩放比例渲染并存入字体位图缓存中，通常在缩放比例改变后调用，
+ * 以减少下一帧排版文本时的渲染量。
+ * @returns 字形的数量
+ */
+LCUI_API size_t LCUIWidget_PrerenderTextView(void);
+
 LCUI_API void LCUIWidget_AddTextView(void);
 
 LCUI_API void LCUIWidget_FreeTextView(void);
@@ -59,6 +59,7 @@ typedef struct LCUI_WidgetStyle {
 	LCUI_StyleValue box_sizing;
 	LCUI_StyleValue vertical_align;
 	LCUI_BorderStyle border;
+	LCUI_BorderImageStyle border_image;
 	LCUI_BoxShadowStyle shadow;
 	LCUI_BackgroundStyle background;
 	LCUI_FlexBoxLayoutStyle flex;
@@ -250,8 +251,16 @@ typedef enum LCUI_InvalidAreaType_ {
 	LCUI_INVALID_AREA_TYPE_CANVAS_BOX
 } LCUI_InvalidAreaType;
 
+/** Parts of the widget that need to be repainted */
+typedef enum LCUI_WidgetRepaintFlag_ {
+	LCUI_WIDGET_REPAINT_BACKGROUND = 1,
+	LCUI_WIDGET_REPAINT_BORDER = 1 << 1,
+	LCUI_WIDGET_REPAINT_SHADOW = 1 << 2
+} LCUI_WidgetRepaintFlag;
+
 typedef struct LCUI_WidgetRec_ {
 	unsigned hash;
+	unsigned local_hash;
 	LCUI_WidgetState state;
 
 	char *id;
@@ -309,7 +318,67 @@ typedef struct LCUI_WidgetRec_ {
 	LCUI_RectF invalid_area;
 	LCUI_InvalidAreaType invalid_area_type;
 	LCUI_BOOL has_child_invalid_area;
+
+	/**
+	 * Node in the invalidation journal
+	 * The widget is recorded at most once before the journal is flushed,
+	 * the ancestors are marked with has_child_invalid_area on flush.
+	 */
+	LinkedListNode invalid_node;
+
+	/** Id of the journal flush in which this widget has been marked */
+	unsigned invalid_flush_id;
 	
+	/**
+	 * Whether the widget has been moved since the last frame
+	 * If nothing else has changed, the painted pixels in the moved_from
+	 * area can be reused instead of repainting the whole subtree.
+	 */
+	LCUI_BOOL moved;
+
+	/** Canvas box before moving, it is valid only if moved is TRUE */
+	LCUI_RectF moved_from;
+
+	/**
+	 * Parts that need to be repainted, see LCUI_WidgetRepaintFlag
+	 * It is used when only the background, border colors or box shadow
+	 * of the widget have been changed, so that the invalid area can be
+	 * limited to the changed parts.
+	 */
+	int repaint_flags;
+
+	/** Canvas box before the box shadow changed */
+	LCUI_RectF shadow_from;
+
+	/**
+	 * Cached content painted by the prototype and the children
+	 * If the widget often changes its background or border, the cached
+	 * content will be reused to avoid repainting the children.
+	 */
+	LCUI_Graph content_cache;
+	LCUI_BOOL enable_content_cache;
+
+	/**
+	 * Scale generation of the cached content, the cache will be repainted
+	 * after the scale is changed, see LCUIMetrics_GetScaleGeneration()
+	 */
+	unsigned content_cache_generation;
+
+	/**
+	 * Node in the list of content caches, the least recently used caches
+	 * are freed when the total size exceeds the budget
+	 */
+	LinkedListNode content_cache_node;
+
+	/** Frame in which the content cache was last used */
+	unsigned content_cache_frame;
+
+	/**
+	 * Scaled tiles of the border image, they will be rebuilt only when the
+	 * size of the widget or the border image is changed.
+	 */
+	struct LCUI_BorderImageTilesRec_ *border_image_cache;
+
 	/** Parent widget */
 	LCUI_Widget parent;
 
@@ -39,6 +39,13 @@ LCUI_API void Widget_GenerateSelfHash(LCUI_Widget w);
 /** Generate hash values for a widget and its children */
 LCUI_API void Widget_GenerateHash(LCUI_Widget w);
 
+/**
+ * Update hash values of a widget and its children after its type, id,
+ * classes, status or rules has changed.
+ * It does nothing if the hash of the widget has not been generated.
+ */
+LCUI_API void Widget_UpdateHash(LCUI_Widget w);
+
 LCUI_API size_t Widget_SetHashList(LCUI_Widget w, unsigned *hash_list,
 				   size_t len);
 
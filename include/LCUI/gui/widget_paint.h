@@ -33,6 +33,54 @@
 
 LCUI_BEGIN_HEADER
 
+/** 移动的区域，其中的像素可以直接从原位置复制到新位置 */
+typedef struct LCUI_MovedAreaRec_ {
+	LCUI_Rect from;
+	LCUI_Rect to;
+} LCUI_MovedAreaRec, *LCUI_MovedArea;
+
+/** 按重绘类型统计的像素数量 */
+typedef struct LCUI_WidgetRepaintStatsRec_ {
+	/** 整体重绘的像素数量 */
+	size_t full_pixels;
+	/** 仅重绘背景的像素数量 */
+	size_t background_pixels;
+	/** 仅重绘边框的像素数量 */
+	size_t border_pixels;
+	/** 仅重绘阴影的像素数量 */
+	size_t shadow_pixels;
+	/** 绘制到内容缓存中的像素数量 */
+	size_t content_rendered_pixels;
+	/** 从内容缓存中复用的像素数量 */
+	size_t content_reused_pixels;
+	/** 当前所有内容缓存占用的字节数 */
+	size_t content_cache_bytes;
+	/** 因超出内存预算或长时间未使用而释放的内容缓存数量 */
+	size_t content_cache_evictions;
+	/**
+	 * 部件自身绘制的像素数量，它与重绘区域的像素数量之比即为过度绘制的倍数
+	 */
+	size_t painted_pixels;
+	/** 因被上层的不透明部件遮挡而跳过绘制的像素数量 */
+	size_t occluded_pixels;
+	/** 因被完全遮挡而跳过绘制的部件数量 */
+	size_t occluded_widgets;
+} LCUI_WidgetRepaintStatsRec, *LCUI_WidgetRepaintStats;
+
+/** 无效区域记录的统计数据 */
+typedef struct LCUI_WidgetInvalidationStatsRec_ {
+	/** Widget_InvalidateArea() 的调用次数 */
+	size_t calls;
+	/** 记录的部件数量 */
+	size_t records;
+	/** 部件已被记录过，直接合并的次数 */
+	size_t merged;
+	/** 刷新记录时标记的父级部件数量 */
+	size_t marked_ancestors;
+	/** 刷新记录的次数 */
+	size_t flushes;
+} LCUI_WidgetInvalidationStatsRec, *LCUI_WidgetInvalidationStats;
+
 /**
  * 标记部件中的无效区域
  * @param[in] w		区域所在的部件
@@ -43,6 +91,27 @@ LCUI_BEGIN_HEADER
 LCUI_API LCUI_BOOL Widget_InvalidateArea(LCUI_Widget widget,
 					 LCUI_RectF *in_rect, int box_type);
 
+/**
+ * 将部件添加到无效区域记录中
+ * 在记录被刷新前，每个部件只会被记录一次，它的父级部件会在刷新记录时统一标记。
+ * 记录由互斥锁保护，可以在工作线程中调用。
+ */
+LCUI_API void Widget_AddToInvalidJournal(LCUI_Widget w);
+
+/** 将部件从无效区域记录中移除，在销毁部件时调用 */
+LCUI_API void Widget_RemoveFromInvalidJournal(LCUI_Widget w);
+
+/**
+ * 刷新无效区域记录
+ * 标记记录中的部件的父级部件含有无效区域，每个父级部件只会被标记一次。
+ * Widget_GetInvalidAreaEx() 在收集无效区域前会调用它。
+ * @return 记录的部件数量
+ */
+LCUI_API size_t LCUIWidget_FlushInvalidJournal(void);
+
+/** 释放部件的内容缓存，在销毁部件时调用 */
+LCUI_API void Widget_DestroyContentCache(LCUI_Widget w);
+
 /**
  * 取出部件中的无效区域
  * @param[in] w		部件
@@ -51,6 +120,18 @@ LCUI_API LCUI_BOOL Widget_InvalidateArea(LCUI_Widget widget,
  */
 LCUI_API size_t Widget_GetInvalidArea(LCUI_Widget w, LinkedList *rects);
 
+/**
+ * 取出部件中的无效区域和移动的区域
+ * 对于仅移动了位置的不透明部件，不会将它的新旧区域标记为无效区域，而是输出一个
+ * 移动区域，调用者应先将该区域内的像素复制到新位置，然后再重绘无效区域。
+ * @param[in] w		部件
+ * @param[out] rects	输出的区域列表
+ * @param[out] areas	输出的移动区域列表，为 NULL 时按无效区域处理
+ * @return 无效区域的数量
+ */
+LCUI_API size_t Widget_GetInvalidAreaEx(LCUI_Widget w, LinkedList *rects,
+					LinkedList *areas);
+
 /**
  * 将部件中的矩形区域转换成指定范围框内有效的矩形区域
  * @param[in]	w		目标部件
@@ -75,6 +156,45 @@ LCUI_API void RectToInvalidArea(const LCUI_Rect *rect, LCUI_Rect *area);
  */
 LCUI_API size_t Widget_Render(LCUI_Widget w, LCUI_PaintContext paint);
 
+/**
+ * 将部件渲染到图像中
+ * 渲染结果与屏幕上呈现的内容无关，可用于生成缩略图、拖拽时的图像等
+ * @param[in] w		部件
+ * @param[in] scale	输出的图像的缩放比例，输出的尺寸为区域尺寸乘以该比例
+ * @param[in] rect	需渲染的区域，相对于部件的边框盒，为 NULL 时渲染整个边框盒
+ * @param[out] out	输出的 ARGB 图像，不在部件范围内的像素是透明的
+ * @return 成功返回 0，失败返回负数
+ */
+LCUI_API int Widget_RenderToGraph(LCUI_Widget w, float scale,
+				  const LCUI_RectF *rect, LCUI_Graph *out);
+
+/**
+ * 在工作线程中将部件渲染到图像中
+ * 调用时会为部件及其子部件创建快照，之后对部件的修改不会影响渲染结果。渲染完成
+ * 后会在主循环中触发部件的 rendered 事件，事件处理函数的附加参数是指向输出图像
+ * 的 LCUI_Graph 指针，图像在事件处理完后会被释放，如需保留请用 Graph_Copy()
+ * 复制。渲染失败时该图像是无效的。
+ * @param[in] w		部件
+ * @param[in] scale	输出的图像的缩放比例
+ * @param[in] rect	需渲染的区域，相对于部件的边框盒，为 NULL 时渲染整个边框盒
+ * @return 成功返回 0，失败返回负数
+ */
+LCUI_API int Widget_RenderToGraphAsync(LCUI_Widget w, float scale,
+				       const LCUI_RectF *rect);
+
+/** 获取重绘的像素统计数据 */
+LCUI_API void LCUIWidget_GetRepaintStats(LCUI_WidgetRepaintStats stats);
+
+/** 重置重绘的像素统计数据 */
+LCUI_API void LCUIWidget_ResetRepaintStats(void);
+
+/** 获取无效区域记录的统计数据 */
+LCUI_API void LCUIWidget_GetInvalidationStats(
+    LCUI_WidgetInvalidationStats stats);
+
+/** 重置无效区域记录的统计数据 */
+LCUI_API void LCUIWidget_ResetInvalidationStats(void);
+
 LCUI_API void LCUIWidget_InitRenderer(void);
 
 LCUI_API void LCUIWidget_FreeRenderer(void);
@@ -44,6 +44,19 @@ LCUI_API void Widget_PrintStyleSheets(LCUI_Widget w);
 LCUI_API void Widget_SetStyleString(LCUI_Widget w, const char *name,
 				    const char *value);
 
+/**
+ * 预先解析样式属性值，将解析结果存入样式列表
+ * 对于需要频繁设置的样式，可以只解析一次，然后用 Widget_SetStyles() 重复设置
+ * @param[in] list 样式列表，已有的同名样式会被覆盖
+ * @param[in] name 样式属性名称，简写属性会被展开为多条样式
+ * @returns 成功返回 0，解析失败返回 -1，找不到属性解析器时返回 -ENOENT
+ */
+LCUI_API int Widget_CompileStyleString(LCUI_StyleList list, const char *name,
+				       const char *value);
+
+/** 将样式列表中的样式全部设置到部件上，只触发一次样式更新 */
+LCUI_API void Widget_SetStyles(LCUI_Widget w, LCUI_StyleList list);
+
 LCUI_API void Widget_ComputePaddingStyle(LCUI_Widget w);
 
 LCUI_API void Widget_ComputeMarginStyle(LCUI_Widget w);
@@ -100,4 +113,16 @@ LCUI_API LCUI_Selector Widget_GetSelector(LCUI_Widget w);
 LCUI_API size_t Widget_GetChildrenStyleChanges(LCUI_Widget w, int type,
 					       const char *name);
 
+/**
+ * 获取部件的类或状态变化后会受到影响的样式表
+ * @param[in] w 部件
+ * @param[in] group 部件在样式表的选择器中的位置，0 表示作用于部件自身
+ * @param[in] type 名称类型，0 为类名，1 为状态名
+ * @param[in] name 类名或状态名
+ * @param[out] subjects 样式表作用的选择器结点名称，为 NULL 时不收集
+ * @returns 受影响的样式表数量
+ */
+LCUI_API size_t Widget_GetStyleChanges(LCUI_Widget w, int group, int type,
+				       const char *name, LinkedList *subjects);
+
 #endif
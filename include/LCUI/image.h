@@ -54,6 +54,12 @@ enum LCUI_ImageReaderType {
 #define LCUI_JPEG_IMAGE		LCUI_JPEG_READER
 #define LCUI_BMP_IMAGE		LCUI_BMP_READER
 
+/** LCUI 原始图像文件中像素数据的压缩方式 */
+enum LCUI_RawImageCompression {
+	LCUI_RAW_IMAGE_UNCOMPRESSED,
+	LCUI_RAW_IMAGE_RLE
+};
+
 #define LCUI_SetImageReaderJump(READER) (READER)->env && setjmp(*((READER)->env))
 
 typedef struct LCUI_ImageHeaderRec_ {
@@ -63,6 +69,13 @@ typedef struct LCUI_ImageHeaderRec_ {
 	unsigned int width, height;
 } LCUI_ImageHeaderRec, *LCUI_ImageHeader;
 
+/** 原始图像文件的来源信息，用于判断文件是否过期 */
+typedef struct LCUI_RawImageSourceRec_ {
+	const char *path;
+	uint64_t size;
+	int64_t mtime;
+} LCUI_RawImageSourceRec, *LCUI_RawImageSource;
+
 /** 图像读取器 */
 typedef struct LCUI_ImageReaderRec_ {
 	void *stream_data;			/**< 自定义的输入流数据 */
@@ -119,9 +132,55 @@ LCUI_API int LCUI_ReadImage(LCUI_ImageReader reader, LCUI_Graph *graph);
 /** 将图像数据写入至png文件 */
 LCUI_API int LCUI_WritePNGFile(const char *file_name, const LCUI_Graph *graph);
 
-/** 载入指定图片文件的图像数据 */
+/**
+ * 载入指定图片文件的图像数据
+ * 如果设置了图像缓存目录，则优先从缓存中载入，缓存不存在时会在解码后写入
+ */
 LCUI_API int LCUI_ReadImageFile(const char *filepath, LCUI_Graph *out);
 
+/** 不使用缓存，直接解码指定图片文件的图像数据 */
+LCUI_API int LCUI_DecodeImageFile(const char *filepath, LCUI_Graph *out);
+
+/**
+ * 将图像写入 LCUI 原始图像文件
+ * 文件中保存的是解码后的像素数据，读取时不需要再解码
+ * @param[in] compression 压缩方式，未压缩的文件可以直接映射到内存中使用
+ * @param[in] source 来源文件的信息，可以为 NULL
+ */
+LCUI_API int LCUI_WriteRawImageFile(const char *filepath,
+				    const LCUI_Graph *graph, int compression,
+				    const LCUI_RawImageSourceRec *source);
+
+/**
+ * 读取 LCUI 原始图像文件
+ * 在支持的平台上，未压缩的像素数据会被映射到内存中直接作为图像的像素数据
+ * @param[in] source 来源文件的信息，若不为 NULL，则在文件记录的来源信息与
+ *  之不一致时返回 -EINVAL
+ */
+LCUI_API int LCUI_ReadRawImageFile(const char *filepath, LCUI_Graph *out,
+				   const LCUI_RawImageSourceRec *source);
+
+/**
+ * 设置已解码图像的缓存目录
+ * 缓存以来源文件的路径、大小和修改时间为键，应在载入图像前设置
+ * @param[in] dirpath 目录路径，不存在时会自动创建，为 NULL 时禁用缓存
+ */
+LCUI_API int LCUI_SetImageCacheDir(const char *dirpath);
+
+/** 获取图片文件在缓存目录中对应的缓存文件路径 */
+LCUI_API int LCUI_GetImageCacheFilePath(const char *filepath, char *buf,
+					size_t max_len);
+
+/** 从缓存中读取图像，缓存不存在或已过期时返回负数 */
+LCUI_API int LCUI_ReadCachedImageFile(const char *filepath, LCUI_Graph *out);
+
+/** 将图像写入缓存 */
+LCUI_API int LCUI_WriteCachedImageFile(const char *filepath,
+				       const LCUI_Graph *graph);
+
+/** 预先解码图片文件并写入缓存，可在安装程序时调用，避免首次启动时解码 */
+LCUI_API int LCUI_CacheImageFile(const char *filepath);
+
 /** 从文件中获取图像尺寸 */
 LCUI_API int LCUI_GetImageSize(const char *filepath, int *width, int *height);
 
@@ -54,6 +54,7 @@ enum LCUI_SysEventType {
 	LCUI_WIDGET,
 	LCUI_QUIT, /**< 在 LCUI 退出前触发的事件 */
 	LCUI_SETTINGS_CHANGE,
+	LCUI_SCALE_CHANGE, /**< 在全局缩放比例改变后触发的事件 */
 	LCUI_USER = 100 /**< 用户事件，可以把这个当成系统事件与用户事件的分界 */
 };
 
@@ -200,10 +201,48 @@ LCUI_API int LCUI_PostAsyncTask(LCUI_Task task);
 		LCUI_PostTask(&_ui_task);                 \
 	} while (0);
 
+/** 帧的处理阶段 */
+typedef enum LCUI_FramePhase {
+	LCUI_FRAME_PHASE_TIMERS,
+	LCUI_FRAME_PHASE_EVENTS,
+	LCUI_FRAME_PHASE_STYLE,
+	LCUI_FRAME_PHASE_LAYOUT,
+	LCUI_FRAME_PHASE_RENDER,
+	LCUI_FRAME_PHASE_PRESENT,
+	LCUI_FRAME_PHASE_TOTAL_NUM
+} LCUI_FramePhase;
+
+/** 耗时的统计数据，单位为纳秒 */
+typedef struct LCUI_FramePhaseStatsRec_ {
+	int64_t p50;
+	int64_t p95;
+	int64_t p99;
+	int64_t max;
+	int64_t mean;
+} LCUI_FramePhaseStatsRec, *LCUI_FramePhaseStats;
+
+/** 帧的统计数据 */
+typedef struct LCUI_FrameStatsRec_ {
+	size_t frames;			/**< 已统计的帧数 */
+	size_t jank_frames;		/**< 耗时超出预算的帧数 */
+	int64_t budget;			/**< 每帧的耗时预算，由帧率上限决定 */
+	LCUI_FramePhaseStatsRec frame;	/**< 整个帧的耗时 */
+	LCUI_FramePhaseStatsRec phases[LCUI_FRAME_PHASE_TOTAL_NUM];
+} LCUI_FrameStatsRec, *LCUI_FrameStats;
+
 LCUI_API void LCUI_RunFrame(void);
 
 LCUI_API void LCUI_RunFrameWithProfile(LCUI_FrameProfile profile);
 
+/**
+ * 获取帧的统计数据
+ * 每一帧的各阶段耗时都会被记录到直方图中，可在任意线程中调用该函数获取统计结果
+ */
+LCUI_API void LCUI_GetFrameStats(LCUI_FrameStats stats);
+
+/** 清空帧的统计数据 */
+LCUI_API void LCUI_ResetFrameStats(void);
+
 /* 新建一个主循环 */
 LCUI_API LCUI_MainLoop LCUIMainLoop_New(void);
 
@@ -36,6 +36,15 @@ LCUI_BEGIN_HEADER
 typedef struct LCUI_SettingsRec_ {
 	int frame_rate_cap;
 	int parallel_rendering_threads;
+
+	/**
+	 * CPU mask of the rendering threads, 0 means no affinity
+	 * The n-th rendering thread is bound to the n-th set bit of the mask.
+	 */
+	unsigned parallel_rendering_cpu_mask;
+
+	/** priority of the rendering threads, see LCUI_ThreadPriority */
+	int parallel_rendering_priority;
 	LCUI_BOOL record_profile;
 	LCUI_BOOL fps_meter;
 	LCUI_BOOL paint_flashing;
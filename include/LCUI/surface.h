@@ -90,6 +90,16 @@ LCUI_API LCUI_PaintContext Surface_BeginPaint(LCUI_Surface surface, LCUI_Rect *r
  */
 LCUI_API void Surface_EndPaint(LCUI_Surface surface, LCUI_PaintContext paint);
 
+/**
+ * 将 Surface 帧缓存中的一块区域复制到另一位置
+ * @param[in] surface	目标 surface
+ * @param[in] rect	源区域
+ * @param[in] x, y	目标位置
+ * @return		复制成功返回 0，若显示驱动不支持该操作则返回负数
+ */
+LCUI_API int Surface_CopyRect(LCUI_Surface surface, LCUI_Rect *rect, int x,
+			      int y);
+
 /** 将帧缓存中的数据呈现至Surface的窗口内 */
 LCUI_API void Surface_Present(LCUI_Surface surface);
 
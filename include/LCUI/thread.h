@@ -43,6 +43,8 @@ typedef pthread_mutex_t LCUI_Mutex;
 typedef pthread_cond_t LCUI_Cond;
 #endif
 
+#include <LCUI/atomic.h>
+
 LCUI_BEGIN_HEADER
 
 /*----------------------------- Mutex <START> -------------------------------*/
@@ -87,8 +89,126 @@ LCUI_API int LCUICond_Broadcast(LCUI_Cond *cond);
 /*------------------------------- Cond <END> --------------------------------*/
 
 
+/*------------------------------ Futex <START> ------------------------------*/
+
+/**
+ * 若 *addr 的值等于 expected，则阻塞当前线程直到被 LCUIFutex_Wake() 唤醒
+ * 可能会被虚假唤醒，调用者需要重新检查条件
+ */
+LCUI_API void LCUIFutex_Wait(LCUI_AtomicInt *addr, int expected);
+
+/** 唤醒在 addr 上等待的一个或全部线程 */
+LCUI_API void LCUIFutex_Wake(LCUI_AtomicInt *addr, LCUI_BOOL wake_all);
+
+/*------------------------------- Futex <END> -------------------------------*/
+
+/*---------------------------- FastMutex <START> ----------------------------*/
+
+/**
+ * 轻量互斥锁
+ * 不需要创建系统对象，未争用时只有一次原子操作，争用时先自旋一段时间，然后
+ * 在 futex 上休眠。与 LCUI_Mutex 不同，它不可重入，适合保护短小的临界区
+ */
+typedef struct LCUI_FastMutexRec_ {
+	LCUI_AtomicInt state;
+} LCUI_FastMutex;
+
+#define LCUI_FAST_MUTEX_INIT { 0 }
+
+LCUI_API void LCUIFastMutex_Init(LCUI_FastMutex *mutex);
+
+/** 尝试加锁，成功时返回 0 */
+LCUI_API int LCUIFastMutex_TryLock(LCUI_FastMutex *mutex);
+
+LCUI_API void LCUIFastMutex_Lock(LCUI_FastMutex *mutex);
+
+LCUI_API void LCUIFastMutex_Unlock(LCUI_FastMutex *mutex);
+
+/*----------------------------- FastMutex <END> -----------------------------*/
+
+/*----------------------------- RWLock <START> ------------------------------*/
+
+/**
+ * 读写锁
+ * 允许多个读者同时持有，适合读多写少的数据。有写者等待时，新的读者会等待，
+ * 以免写者饿死
+ */
+typedef struct LCUI_RWLockRec_ {
+	LCUI_AtomicInt state;		/**< 读者数量，-1 表示被写者持有 */
+	LCUI_AtomicInt writers;		/**< 正在等待的写者数量 */
+	LCUI_AtomicInt waiters;		/**< 正在休眠的线程数量 */
+	LCUI_AtomicInt seq;		/**< 每次释放时递增，用于休眠和唤醒 */
+} LCUI_RWLock;
+
+#define LCUI_RWLOCK_INIT { 0, 0, 0, 0 }
+
+LCUI_API void LCUIRWLock_Init(LCUI_RWLock *lock);
+
+LCUI_API int LCUIRWLock_TryReadLock(LCUI_RWLock *lock);
+
+LCUI_API void LCUIRWLock_ReadLock(LCUI_RWLock *lock);
+
+LCUI_API void LCUIRWLock_ReadUnlock(LCUI_RWLock *lock);
+
+LCUI_API int LCUIRWLock_TryWriteLock(LCUI_RWLock *lock);
+
+LCUI_API void LCUIRWLock_WriteLock(LCUI_RWLock *lock);
+
+LCUI_API void LCUIRWLock_WriteUnlock(LCUI_RWLock *lock);
+
+/*------------------------------ RWLock <END> -------------------------------*/
+
+/*------------------------------ Once <START> -------------------------------*/
+
+typedef LCUI_AtomicInt LCUI_Once;
+
+#define LCUI_ONCE_INIT 0
+
+/**
+ * 只调用一次初始化函数
+ * 多个线程同时调用时，只有一个线程会调用 func，其它线程会等待它返回
+ */
+LCUI_API void LCUIOnce(LCUI_Once *once, void (*func)(void));
+
+/*------------------------------- Once <END> --------------------------------*/
+
+/*----------------------------- SeqLock <START> -----------------------------*/
+
+/**
+ * 顺序锁
+ * 读者不加锁，读取前后检查序号，序号变化时重新读取，写者之间用互斥锁排队。
+ * 适合频繁读取、很少修改的小块数据，例如配置和统计信息。读者只能复制数据，
+ * 不能在读取过程中访问数据中的指针
+ */
+typedef struct LCUI_SeqLockRec_ {
+	LCUI_AtomicInt seq;
+	LCUI_FastMutex mutex;
+} LCUI_SeqLock;
+
+#define LCUI_SEQLOCK_INIT { 0, LCUI_FAST_MUTEX_INIT }
+
+LCUI_API void LCUISeqLock_Init(LCUI_SeqLock *lock);
+
+/** 开始读取，返回当前的序号 */
+LCUI_API int LCUISeqLock_ReadBegin(LCUI_SeqLock *lock);
+
+/** 结束读取，若读取期间数据被修改则返回 TRUE，需要重新读取 */
+LCUI_API LCUI_BOOL LCUISeqLock_ReadRetry(LCUI_SeqLock *lock, int seq);
+
+LCUI_API void LCUISeqLock_WriteBegin(LCUI_SeqLock *lock);
+
+LCUI_API void LCUISeqLock_WriteEnd(LCUI_SeqLock *lock);
+
+/*------------------------------ SeqLock <END> ------------------------------*/
+
 /*----------------------------- Thread <START> ------------------------------*/
 
+typedef enum LCUI_ThreadPriority {
+	LCUI_THREAD_PRIORITY_LOW,
+	LCUI_THREAD_PRIORITY_NORMAL,
+	LCUI_THREAD_PRIORITY_HIGH
+} LCUI_ThreadPriority;
+
 LCUI_API LCUI_Thread LCUIThread_SelfID(void);
 
 /* 创建并运行一个线程 */
@@ -103,8 +223,94 @@ LCUI_API void LCUIThread_Cancel(LCUI_Thread thread);
 /* 记录指针作为返回值，并退出线程 */
 LCUI_API void LCUIThread_Exit(void* retval);
 
+/** 将当前线程绑定到指定的 CPU 上，不支持时返回 -ENOSYS */
+LCUI_API int LCUIThread_SetAffinity(int cpu);
+
+/**
+ * 设置当前线程的优先级，不支持时返回 -ENOSYS
+ * 提高优先级可能需要特权，失败时线程保持原来的优先级
+ */
+LCUI_API int LCUIThread_SetPriority(LCUI_ThreadPriority priority);
+
+/** 让出当前线程的 CPU 时间片 */
+LCUI_API void LCUIThread_Yield(void);
+
 /*------------------------------ Thread <END> -------------------------------*/
 
+/*--------------------------- ThreadPool <START> ----------------------------*/
+
+/**
+ * 常驻的 fork-join 线程池
+ * 线程在创建时启动，之后一直保留，每次调用 LCUIThreadPool_Run() 时唤醒它们，
+ * 调用者也会参与执行，所有任务完成后才返回。适合每帧都需要并行执行一批短小
+ * 任务的场景，例如渲染脏矩形
+ */
+typedef struct LCUI_ThreadPoolRec_ *LCUI_ThreadPool;
+
+typedef struct LCUI_ThreadPoolOptionsRec_ {
+	/** 线程数量，包括调用 LCUIThreadPool_Run() 的线程 */
+	int threads;
+
+	/**
+	 * 允许工作线程使用的 CPU 掩码，第 i 个工作线程绑定到掩码中第 i 个
+	 * 为 1 的位对应的 CPU 上，为 0 时不绑定
+	 */
+	unsigned cpu_mask;
+
+	/** 工作线程的优先级 */
+	LCUI_ThreadPriority priority;
+} LCUI_ThreadPoolOptionsRec, *LCUI_ThreadPoolOptions;
+
+typedef struct LCUI_ThreadPoolStatsRec_ {
+	int64_t busy_time;	/**< 执行任务的时间（纳秒） */
+	int64_t idle_time;	/**< 等待任务的时间（纳秒） */
+	size_t tasks;		/**< 执行过的任务数量 */
+	size_t runs;		/**< 参与过的 LCUIThreadPool_Run() 的次数 */
+} LCUI_ThreadPoolStatsRec, *LCUI_ThreadPoolStats;
+
+/** 任务函数，index 为任务的序号 */
+typedef void (*LCUI_ThreadPoolFunc)(void *arg, int index);
+
+LCUI_API LCUI_ThreadPool LCUIThreadPool_New(const LCUI_ThreadPoolOptionsRec *options);
+
+LCUI_API void LCUIThreadPool_Destroy(LCUI_ThreadPool pool);
+
+/** 获取线程数量，包括调用者 */
+LCUI_API int LCUIThreadPool_GetThreads(LCUI_ThreadPool pool);
+
+/**
+ * 并行执行 count 个任务，返回时所有任务都已完成
+ * 任务按序号动态分配给空闲的线程，不能在任务中嵌套调用
+ */
+LCUI_API void LCUIThreadPool_Run(LCUI_ThreadPool pool, LCUI_ThreadPoolFunc func,
+				 void *arg, int count);
+
+/**
+ * 开始在工作线程中执行 count 个任务，不等待它们完成
+ * 之后必须调用 LCUIThreadPool_Wait()，在此期间调用者可以做其它事情，或者
+ * 通过 LCUIThreadPool_RunNext() 参与执行
+ */
+LCUI_API void LCUIThreadPool_Start(LCUI_ThreadPool pool,
+				   LCUI_ThreadPoolFunc func, void *arg,
+				   int count);
+
+/** 在当前线程中执行下一个未被领取的任务，没有任务时返回 FALSE */
+LCUI_API LCUI_BOOL LCUIThreadPool_RunNext(LCUI_ThreadPool pool);
+
+/** 执行剩余的任务，并等待工作线程完成 */
+LCUI_API void LCUIThreadPool_Wait(LCUI_ThreadPool pool);
+
+/**
+ * 获取线程的统计信息，序号 0 表示调用 LCUIThreadPool_Run() 的线程
+ * 应当在两次 LCUIThreadPool_Run() 之间调用
+ */
+LCUI_API int LCUIThreadPool_GetStats(LCUI_ThreadPool pool, int index,
+				     LCUI_ThreadPoolStats stats);
+
+LCUI_API void LCUIThreadPool_ResetStats(LCUI_ThreadPool pool);
+
+/*---------------------------- ThreadPool <END> -----------------------------*/
+
 LCUI_END_HEADER
 
 #endif
@@ -178,7 +178,9 @@ typedef enum LCUI_StyleValue {
 	SV_WRAP,
 	SV_NOWRAP,
 	SV_ROW,
-	SV_COLUMN
+	SV_COLUMN,
+	SV_REPEAT,
+	SV_ROUND
 } LCUI_StyleValue;
 
 /** 样式变量类型 */
@@ -261,6 +263,9 @@ typedef struct LCUI_Border {
 
 typedef struct LCUI_Graph_ LCUI_Graph;
 
+/** 图像的像素数据存储，可被多个图像共享 */
+typedef struct LCUI_GraphBufferRec_ *LCUI_GraphBuffer;
+
 typedef struct LCUI_GraphQuote_ {
 	int top;
 	int left;
@@ -286,6 +291,7 @@ struct LCUI_Graph_ {
 	float opacity;
 	size_t mem_size;
 	uchar_t *palette;
+	LCUI_GraphBuffer buffer;
 };
 
 typedef struct LCUI_StyleRec_ {
@@ -430,6 +436,30 @@ typedef struct LCUI_Background {
 	} size;
 } LCUI_Background;
 
+/**
+ * 边框图像的样式
+ * 图像按切片线分成九块，四个角绘制在边框的四角，四条边按重复方式绘制在边框的四
+ * 边，中间块仅在设置了 fill 时绘制在内边距区域
+ */
+typedef struct LCUI_BorderImageStyle {
+	LCUI_Graph source;      /**< 源图像 */
+	LCUI_BoundBox slice;    /**< 切片线到图像边缘的距离 */
+	LCUI_BOOL fill;         /**< 是否绘制中间块 */
+	int repeat_x, repeat_y; /**< 重复方式：SV_STRETCH、SV_REPEAT、SV_ROUND */
+} LCUI_BorderImageStyle;
+
+typedef struct LCUI_BorderImage {
+	LCUI_Graph *source; /**< 源图像 */
+	struct {
+		int top, right, bottom, left;
+	} slice; /**< 切片线到图像边缘的距离，单位为图像像素 */
+	struct {
+		int top, right, bottom, left;
+	} width; /**< 图像边框的宽度 */
+	LCUI_BOOL fill;
+	int repeat_x, repeat_y;
+} LCUI_BorderImage;
+
 /** 进行绘制时所需的上下文 */
 typedef struct LCUI_PaintContextRec_ {
 	LCUI_Rect rect;    /**< 需要绘制的区域 */
@@ -447,6 +477,7 @@ typedef struct LCUI_WidgetTasksRec_ {
 	size_t user_task_count;
 	size_t destroy_count;
 	size_t destroy_time;
+	int64_t layout_time; /**< 布局耗时，单位为纳秒 */
 } LCUI_WidgetTasksProfileRec, *LCUI_WidgetTasksProfile;
 
 typedef struct LCUI_FrameProfileRec_ {
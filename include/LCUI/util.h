@@ -39,6 +39,7 @@
 #include <LCUI/util/object.h>
 #include <LCUI/util/rect.h>
 #include <LCUI/util/steptimer.h>
+#include <LCUI/util/histogram.h>
 #include <LCUI/util/string.h>
 #include <LCUI/util/strpool.h>
 #include <LCUI/util/strlist.h>
@@ -48,4 +49,5 @@
 #include <LCUI/util/task.h>
 #include <LCUI/util/uri.h>
 #include <LCUI/util/charset.h>
+#include <LCUI/util/cpu.h>
 #endif
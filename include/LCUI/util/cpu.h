@@ -0,0 +1,53 @@
+﻿/*
+ * cpu.h -- CPU feature detection
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LCUI_UTIL_CPU_H
+#define LCUI_UTIL_CPU_H
+
+LCUI_BEGIN_HEADER
+
+typedef enum LCUI_CPUFeature {
+	LCUI_CPU_SSE2 = 1 << 0,
+	LCUI_CPU_AVX2 = 1 << 1,
+	LCUI_CPU_NEON = 1 << 2
+} LCUI_CPUFeature;
+
+/** 获取当前 CPU 支持并且可用的特性，是 LCUI_CPUFeature 的组合 */
+LCUI_API unsigned LCUI_GetCPUFeatures(void);
+
+/**
+ * 设置可用的 CPU 特性的掩码，用于测试和对比各个实现的性能
+ * 传入 0 则只使用标量代码，传入 ~0u 则恢复使用所有支持的特性
+ */
+LCUI_API void LCUI_SetCPUFeaturesMask(unsigned mask);
+
+LCUI_END_HEADER
+
+#endif
@@ -0,0 +1,74 @@
+﻿/*
+ * histogram.h -- HDR histogram, records the distribution of durations
+ * with a bounded relative error and a fixed memory size.
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LCUI_UTIL_HISTOGRAM_H
+#define LCUI_UTIL_HISTOGRAM_H
+
+LCUI_BEGIN_HEADER
+
+/** 每个 2 的幂区间内的子桶数量的位数，决定了约 3% 的相对误差 */
+#define HISTOGRAM_SUB_BUCKET_BITS 6
+#define HISTOGRAM_SUB_BUCKET_COUNT (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_SUB_BUCKET_HALF (HISTOGRAM_SUB_BUCKET_COUNT / 2)
+
+/** 可记录的最大值的位数，超出的值会被记录到最后一个桶 */
+#define HISTOGRAM_VALUE_BITS 40
+#define HISTOGRAM_BUCKETS                                     \
+	(HISTOGRAM_SUB_BUCKET_COUNT +                         \
+	 (HISTOGRAM_VALUE_BITS - HISTOGRAM_SUB_BUCKET_BITS) * \
+	     HISTOGRAM_SUB_BUCKET_HALF)
+
+typedef struct LCUI_HistogramRec_ {
+	size_t total;		/**< 记录的数值的数量 */
+	int64_t min;		/**< 最小值 */
+	int64_t max;		/**< 最大值 */
+	int64_t sum;		/**< 数值的总和 */
+	unsigned counts[HISTOGRAM_BUCKETS];
+} LCUI_HistogramRec, *LCUI_Histogram;
+
+LCUI_API void Histogram_Init(LCUI_Histogram h);
+
+/** 记录一个数值，负数按 0 处理 */
+LCUI_API void Histogram_Record(LCUI_Histogram h, int64_t value);
+
+/**
+ * 获取百分位数
+ * @param[in] percentile 百分位，取值范围为 [0, 100]
+ * @returns 不小于该百分位上的数值的近似值，它不会超过最大值
+ */
+LCUI_API int64_t Histogram_GetPercentile(LCUI_Histogram h, double percentile);
+
+/** 将 src 中记录的数值合并到 dst 中 */
+LCUI_API void Histogram_Merge(LCUI_Histogram dst, LCUI_Histogram src);
+
+LCUI_END_HEADER
+
+#endif
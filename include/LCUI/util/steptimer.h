@@ -34,6 +34,9 @@
 
 LCUI_BEGIN_HEADER
 
+/** 记录的帧间隔数量 */
+#define STEPTIMER_INTERVALS_LEN 128
+
 #ifdef LCUI_UTIL_STEPTIMER_C
 typedef struct StepTimerRec_* StepTimer;
 #else
@@ -52,7 +55,20 @@ LCUI_API void StepTimer_SetFrameLimit(StepTimer timer, unsigned int max);
 /** 获取当前FPS */
 LCUI_API int StepTimer_GetFrameCount(StepTimer timer);
 
-/** 让当前帧停留一定时间 */
+/**
+ * 获取最近的帧间隔
+ * @param[out] intervals 帧间隔列表，单位为纳秒，按从旧到新的顺序排列
+ * @param[in] max_count 最多获取的数量
+ * @returns 获取到的数量
+ */
+LCUI_API size_t StepTimer_GetFrameIntervals(StepTimer timer,
+					    int64_t *intervals,
+					    size_t max_count);
+
+/**
+ * 让当前帧停留一定时间
+ * 帧的截止时间按帧时长递增，先睡眠到接近截止时间，再用忙等待补齐剩下的时间
+ */
 LCUI_API void StepTimer_Remain(StepTimer timer);
 
 /** 暂停数据帧的更新 */
@@ -39,6 +39,9 @@ LCUI_API int64_t LCUI_GetTime(void);
 
 LCUI_API int64_t LCUI_GetTimeDelta(int64_t start);
 
+/** 获取单调递增的时间，单位为纳秒，只适合用于计算时间间隔 */
+LCUI_API int64_t LCUI_GetTimeNs(void);
+
 LCUI_API void LCUI_Sleep(unsigned int s);
 
 LCUI_API void LCUI_MSleep(unsigned int ms);
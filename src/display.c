@@ -28,11 +28,8 @@
  */
 
 #include "config.h"
-
-#ifdef USE_OPENMP
-#include <omp.h>
-#endif
 #include <time.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -67,9 +64,28 @@ typedef struct SurfaceRecordRec_ {
 	/** dirty rectangles for rendering */
 	LinkedList rects;
 
+	/** moved areas, their pixels should be copied before rendering */
+	LinkedList moved_areas;
+
 	/** flashing rect list */
 	LinkedList flash_rects;
 
+	/** whether the rendered content has been presented in this frame */
+	LCUI_BOOL presented;
+
+	/** whether the dirty rectangles of this frame are being rendered */
+	LCUI_BOOL rendering;
+
+	/** the dirty rectangles being rendered in this frame */
+	LinkedList paint_rects;
+	LCUI_Rect **paint_rect_array;
+	size_t *paint_counts;
+	int dirty;
+
+	/** set to 1 when the dirty rectangles have been painted */
+	LCUI_AtomicInt painted;
+
+	LCUI_SurfaceTimingRec timing;
 	LCUI_Surface surface;
 	LCUI_Widget widget;
 } SurfaceRecordRec, *SurfaceRecord;
@@ -83,6 +99,11 @@ static struct LCUI_DisplayModule {
 	LCUI_DisplayDriver driver;
 	LCUI_SettingsRec settings;
 	int settings_change_handler_id;
+	int scale_change_handler_id;
+
+	/** threads for rendering the dirty rectangles in parallel */
+	LCUI_ThreadPool render_pool;
+	LCUI_ThreadPoolOptionsRec render_pool_options;
 } display;
 
 /* clang-format on */
@@ -102,6 +123,7 @@ static void OnDestroySurfaceRecord(void *data)
 
 	Surface_Close(record->surface);
 	LinkedList_Clear(&record->rects, free);
+	LinkedList_Clear(&record->moved_areas, free);
 	LinkedList_Clear(&record->flash_rects, free);
 	free(record);
 }
@@ -111,6 +133,11 @@ static void OnSettingsChangeEvent(LCUI_SysEvent e, void *arg)
 	Settings_Init(&display.settings);
 }
 
+static void OnScaleChangeEvent(LCUI_SysEvent e, void *arg)
+{
+	LCUIDisplay_InvalidateArea(NULL);
+}
+
 static size_t LCUIDisplay_RenderFlashRect(SurfaceRecord record,
 					  FlashRect flash_rect)
 {
@@ -287,13 +314,10 @@ static size_t LCUIDisplay_RenderSurfaceRect(SurfaceRecord record,
 	if (!paint) {
 		return 0;
 	}
-	DEBUG_MSG("[thread %d/%d] rect: (%d,%d,%d,%d)\n", omp_get_thread_num(),
-		  omp_get_num_threads(), paint->rect.x, paint->rect.y,
-		  paint->rect.width, paint->rect.height);
+	DEBUG_MSG("[thread %lu] rect: (%d,%d,%d,%d)\n",
+		  (unsigned long)LCUIThread_SelfID(), paint->rect.x,
+		  paint->rect.y, paint->rect.width, paint->rect.height);
 	count = Widget_Render(record->widget, paint);
-	if (display.settings.paint_flashing) {
-		LCUIDisplay_AppendFlashRects(record, &paint->rect);
-	}
 	if (display.mode != LCUI_DMODE_SEAMLESS) {
 		LCUICursor_Paint(paint);
 	}
@@ -301,60 +325,263 @@ static size_t LCUIDisplay_RenderSurfaceRect(SurfaceRecord record,
 	return count;
 }
 
-static size_t LCUIDisplay_RenderSurface(SurfaceRecord record)
+/** 按照当前的设置创建渲染线程池，设置未变化时保留原有的线程 */
+static void LCUIDisplay_UpdateRenderPool(void)
+{
+	LCUI_ThreadPoolOptionsRec options;
+
+	options.threads = display.settings.parallel_rendering_threads;
+	options.cpu_mask = display.settings.parallel_rendering_cpu_mask;
+	options.priority = display.settings.parallel_rendering_priority;
+	if (display.render_pool &&
+	    display.render_pool_options.threads == options.threads &&
+	    display.render_pool_options.cpu_mask == options.cpu_mask &&
+	    display.render_pool_options.priority == options.priority) {
+		return;
+	}
+	if (display.render_pool) {
+		LCUIThreadPool_Destroy(display.render_pool);
+	}
+	display.render_pool = LCUIThreadPool_New(&options);
+	display.render_pool_options = options;
+}
+
+int LCUIDisplay_GetRenderThreads(void)
+{
+	if (!display.render_pool) {
+		return 0;
+	}
+	return LCUIThreadPool_GetThreads(display.render_pool);
+}
+
+int LCUIDisplay_GetRenderThreadStats(int index, LCUI_ThreadPoolStats stats)
+{
+	if (!display.render_pool) {
+		return -ENOENT;
+	}
+	return LCUIThreadPool_GetStats(display.render_pool, index, stats);
+}
+
+void LCUIDisplay_ResetRenderThreadStats(void)
+{
+	if (display.render_pool) {
+		LCUIThreadPool_ResetStats(display.render_pool);
+	}
+}
+
+/** 将移动区域内已绘制的像素复制到新位置 */
+static LCUI_BOOL LCUIDisplay_CopyMovedAreas(SurfaceRecord record)
+{
+	LCUI_BOOL copied = FALSE;
+	LCUI_MovedArea area;
+	LCUI_SysEventRec ev;
+	LinkedListNode *node;
+
+	for (LinkedList_Each(node, &record->moved_areas)) {
+		area = node->data;
+		if (!record->surface || !Surface_IsReady(record->surface) ||
+		    Surface_CopyRect(record->surface, &area->from, area->to.x,
+				     area->to.y) != 0) {
+			RectList_Add(&record->rects, &area->from);
+			RectList_Add(&record->rects, &area->to);
+			continue;
+		}
+		ev.type = LCUI_PAINT;
+		ev.paint.rect = area->to;
+		LCUI_TriggerEvent(&ev, NULL);
+		copied = TRUE;
+	}
+	LinkedList_Clear(&record->moved_areas, free);
+	return copied;
+}
+
+/** 准备本帧需要绘制的脏矩形并触发绘制事件，返回脏矩形的数量 */
+static int SurfaceRecord_BeginRender(SurfaceRecord record)
 {
 	int i = 0;
-	int dirty = 0;
-	int layer_width;
-	int layer_height;
-	size_t count = 0;
-	LCUI_Rect **rect_array;
-	LinkedList rects;
 	LinkedListNode *node;
 
-	LinkedList_Init(&rects);
-	GetRenderingLayerSize(&layer_width, &layer_height);
-	SurfaceRecord_DumpRects(record, &rects);
-	if (rects.length < 1) {
+	record->presented = FALSE;
+	record->rendering = FALSE;
+	record->rendered = LCUIDisplay_CopyMovedAreas(record);
+	record->dirty = 0;
+	LinkedList_Init(&record->paint_rects);
+	SurfaceRecord_DumpRects(record, &record->paint_rects);
+	if (record->paint_rects.length < 1) {
 		return 0;
 	}
-	rect_array = (LCUI_Rect **)malloc(sizeof(LCUI_Rect *) * rects.length);
-	for (LinkedList_Each(node, &rects)) {
+	record->rendering = TRUE;
+	LCUIAtomic_Store(&record->painted, 0);
+	record->paint_rect_array =
+	    malloc(sizeof(LCUI_Rect *) * record->paint_rects.length);
+	record->paint_counts = calloc(record->paint_rects.length, sizeof(size_t));
+	for (LinkedList_Each(node, &record->paint_rects)) {
 		LCUI_SysEventRec ev;
+		LCUI_Rect *rect = node->data;
 
-		rect_array[i] = node->data;
+		record->paint_rect_array[i++] = rect;
 		ev.type = LCUI_PAINT;
-		ev.paint.rect = *rect_array[i];
+		ev.paint.rect = *rect;
 		LCUI_TriggerEvent(&ev, NULL);
-		dirty += rect_array[i]->width * rect_array[i]->height;
-		i++;
-	}
-	// Use OPENMP if the render area is larger than two render layers
-	if (dirty >= layer_width * layer_height * 2) {
-#ifdef USE_OPENMP
-#pragma omp parallel for \
-	default(none) \
-	shared(display, rects, rect_array) \
-	firstprivate(record) \
-	reduction(+:count)
-#endif
-		for (i = 0; i < (int)rects.length; ++i) {
-			count += LCUIDisplay_RenderSurfaceRect(record,
-							       rect_array[i]);
-		}
+		record->dirty += rect->width * rect->height;
+	}
+	return i;
+}
+
+static void SurfaceRecord_RenderRect(void *arg, int index)
+{
+	SurfaceRecord record = arg;
+
+	record->paint_counts[index] = LCUIDisplay_RenderSurfaceRect(
+	    record, record->paint_rect_array[index]);
+}
+
+/** 绘制脏矩形，parallel 为 TRUE 时允许将脏矩形分配给渲染线程 */
+static void SurfaceRecord_Render(SurfaceRecord record, LCUI_BOOL parallel)
+{
+	int i;
+	int layer_width;
+	int layer_height;
+	int n = (int)record->paint_rects.length;
+	int64_t start = LCUI_GetTimeNs();
+
+	GetRenderingLayerSize(&layer_width, &layer_height);
+	// Render in parallel if the render area is larger than two render layers
+	if (parallel && display.render_pool &&
+	    record->dirty >= layer_width * layer_height * 2) {
+		LCUIThreadPool_Run(display.render_pool, SurfaceRecord_RenderRect,
+				   record, n);
 	} else {
-		for (i = 0; i < (int)rects.length; ++i) {
-			count += LCUIDisplay_RenderSurfaceRect(record,
-							       rect_array[i]);
+		for (i = 0; i < n; ++i) {
+			SurfaceRecord_RenderRect(record, i);
 		}
 	}
-	free(rect_array);
-	RectList_Clear(&rects);
-	record->rendered = count > 0;
+	record->timing.render_time = LCUI_GetTimeNs() - start;
+}
+
+/** 结束本帧的渲染，返回绘制的部件数量 */
+static size_t SurfaceRecord_EndRender(SurfaceRecord record)
+{
+	int i;
+	size_t count = 0;
+
+	for (i = 0; i < (int)record->paint_rects.length; ++i) {
+		count += record->paint_counts[i];
+		if (display.settings.paint_flashing &&
+		    record->paint_counts[i] > 0) {
+			LCUIDisplay_AppendFlashRects(
+			    record, record->paint_rect_array[i]);
+		}
+	}
+	free(record->paint_counts);
+	free(record->paint_rect_array);
+	record->paint_counts = NULL;
+	record->paint_rect_array = NULL;
+	RectList_Clear(&record->paint_rects);
+	record->rendering = FALSE;
+	record->rendered = record->rendered || count > 0;
+	record->timing.total_render_time += record->timing.render_time;
+	record->timing.frames += 1;
 	count += LCUIDisplay_UpdateFlashRects(record);
 	return count;
 }
 
+static void SurfaceRecord_Present(SurfaceRecord record)
+{
+	int64_t start;
+	LCUI_Surface surface = record->surface;
+
+	if (!surface || !Surface_IsReady(surface) || !record->rendered ||
+	    record->presented) {
+		return;
+	}
+	start = LCUI_GetTimeNs();
+	Surface_Present(surface);
+	record->presented = TRUE;
+	record->timing.present_time = LCUI_GetTimeNs() - start;
+	record->timing.total_present_time += record->timing.present_time;
+}
+
+static void SurfaceRecord_RenderAsync(void *arg, int index)
+{
+	SurfaceRecord record = ((SurfaceRecord *)arg)[index];
+
+	SurfaceRecord_Render(record, FALSE);
+	LCUIAtomic_Store(&record->painted, 1);
+	LCUIFutex_Wake(&record->painted, FALSE);
+}
+
+/**
+ * 在渲染线程中同时渲染多个 surface，并按顺序呈现已经渲染好的 surface
+ * 呈现始终在当前线程中进行，没有可以呈现的 surface 时，当前线程也参与渲染
+ */
+static size_t LCUIDisplay_RenderSurfaces(SurfaceRecord *records, int n)
+{
+	int i;
+	size_t count = 0;
+
+	LCUIThreadPool_Start(display.render_pool, SurfaceRecord_RenderAsync,
+			     records, n);
+	for (i = 0; i < n; ++i) {
+		while (!LCUIAtomic_Load(&records[i]->painted)) {
+			if (!LCUIThreadPool_RunNext(display.render_pool)) {
+				LCUIFutex_Wait(&records[i]->painted, 0);
+			}
+		}
+		count += SurfaceRecord_EndRender(records[i]);
+		SurfaceRecord_Present(records[i]);
+	}
+	LCUIThreadPool_Wait(display.render_pool);
+	return count;
+}
+
+/**
+ * Convert the moved areas into dirty rectangles if their pixels are not
+ * only painted by the widgets, such as the software cursor and the areas
+ * invalidated by LCUIDisplay_InvalidateArea()
+ */
+static void SurfaceRecord_DropMovedAreas(SurfaceRecord record,
+					 LinkedList *extra_rects)
+{
+	LCUI_Rect cursor_rect;
+	LCUI_BOOL has_cursor = FALSE;
+	LCUI_BOOL should_drop;
+	LCUI_MovedArea area;
+	LinkedListNode *node, *prev, *rect_node;
+
+	if (extra_rects && LCUICursor_IsVisible()) {
+		LCUICursor_GetRect(&cursor_rect);
+		has_cursor = TRUE;
+	}
+	for (LinkedList_Each(node, &record->moved_areas)) {
+		area = node->data;
+		should_drop = !extra_rects;
+		if (has_cursor && !should_drop) {
+			should_drop =
+			    LCUIRect_IsCoverRect(&cursor_rect, &area->from) ||
+			    LCUIRect_IsCoverRect(&cursor_rect, &area->to);
+		}
+		if (extra_rects && !should_drop) {
+			for (LinkedList_Each(rect_node, extra_rects)) {
+				if (LCUIRect_IsCoverRect(rect_node->data,
+							 &area->from)) {
+					should_drop = TRUE;
+					break;
+				}
+			}
+		}
+		if (!should_drop) {
+			continue;
+		}
+		prev = node->prev;
+		RectList_Add(&record->rects, &area->from);
+		RectList_Add(&record->rects, &area->to);
+		LinkedList_DeleteNode(&record->moved_areas, node);
+		free(area);
+		node = prev;
+	}
+}
+
 void LCUIDisplay_Update(void)
 {
 	LCUI_Surface surface;
@@ -370,26 +597,60 @@ void LCUIDisplay_Update(void)
 		if (record->widget && surface && Surface_IsReady(surface)) {
 			Surface_Update(surface);
 		}
-		Widget_GetInvalidArea(record->widget, &record->rects);
+		Widget_GetInvalidAreaEx(record->widget, &record->rects,
+					&record->moved_areas);
+		if (display.settings.paint_flashing) {
+			SurfaceRecord_DropMovedAreas(record, NULL);
+		}
 	}
 	if (display.mode == LCUI_DMODE_SEAMLESS || !record) {
 		return;
 	}
+	SurfaceRecord_DropMovedAreas(record, &display.rects);
 	LinkedList_Concat(&record->rects, &display.rects);
 }
 
 size_t LCUIDisplay_Render(void)
 {
+	int i, n = 0;
 	size_t count = 0;
+	SurfaceRecord record;
+	SurfaceRecord *records;
 	LinkedListNode *node;
 
-	if (!display.active) {
+	if (!display.active || display.surfaces.length < 1) {
 		return 0;
 	}
+	LCUIDisplay_UpdateRenderPool();
+	records = malloc(sizeof(SurfaceRecord) * display.surfaces.length);
+	for (LinkedList_Each(node, &display.surfaces)) {
+		record = node->data;
+		if (SurfaceRecord_BeginRender(record) > 0) {
+			records[n++] = record;
+		}
+	}
+	/*
+	 * Render the surfaces at the same time if there are several of them,
+	 * such as the windows in seamless mode. The flash rects are painted
+	 * after the rendering, so the pipeline is not used for paint flashing.
+	 */
+	if (n > 1 && display.render_pool &&
+	    LCUIThreadPool_GetThreads(display.render_pool) > 1 &&
+	    !display.settings.paint_flashing) {
+		count += LCUIDisplay_RenderSurfaces(records, n);
+	} else {
+		for (i = 0; i < n; ++i) {
+			SurfaceRecord_Render(records[i], TRUE);
+		}
+	}
 	for (LinkedList_Each(node, &display.surfaces)) {
-		count += LCUIDisplay_RenderSurface(node->data);
-		count += LCUIDisplay_UpdateFlashRects(node->data);
+		record = node->data;
+		if (record->rendering) {
+			count += SurfaceRecord_EndRender(record);
+		}
+		count += LCUIDisplay_UpdateFlashRects(record);
 	}
+	free(records);
 	return count;
 }
 
@@ -401,15 +662,24 @@ void LCUIDisplay_Present(void)
 		return;
 	}
 	for (LinkedList_Each(sn, &display.surfaces)) {
-		SurfaceRecord record = sn->data;
-		LCUI_Surface surface = record->surface;
-		if (!surface || !Surface_IsReady(surface)) {
-			continue;
-		}
-		if (record->rendered) {
-			Surface_Present(surface);
+		SurfaceRecord_Present(sn->data);
+	}
+}
+
+int LCUIDisplay_GetSurfaceTiming(LCUI_Surface surface,
+				 LCUI_SurfaceTiming timing)
+{
+	SurfaceRecord record;
+	LinkedListNode *node;
+
+	for (LinkedList_Each(node, &display.surfaces)) {
+		record = node->data;
+		if (record->surface == surface) {
+			*timing = record->timing;
+			return 0;
 		}
 	}
+	return -ENOENT;
 }
 
 void LCUIDisplay_InvalidateArea(LCUI_Rect *rect)
@@ -460,8 +730,10 @@ static LCUI_Surface LCUIDisplay_GetBindSurface(LCUI_Widget widget)
 
 LCUI_Surface LCUIDisplay_GetSurfaceOwner(LCUI_Widget w)
 {
+	LCUI_Widget root = LCUIWidget_GetRoot();
+
 	if (LCUIDisplay_GetMode() == LCUI_DMODE_SEAMLESS) {
-		while (w->parent) {
+		while (w->parent && w->parent != root) {
 			w = w->parent;
 		}
 	} else {
@@ -496,6 +768,7 @@ static void LCUIDisplay_BindSurface(LCUI_Widget widget)
 	record->surface = Surface_New();
 	record->widget = widget;
 	record->rendered = FALSE;
+	LinkedList_Init(&record->moved_areas);
 	LinkedList_Init(&record->flash_rects);
 	LCUIMetrics_ComputeRectActual(&rect, &widget->box.canvas);
 	if (Widget_CheckStyleValid(widget, key_top) &&
@@ -803,6 +1076,14 @@ void Surface_EndPaint(LCUI_Surface surface, LCUI_PaintContext paint)
 	}
 }
 
+int Surface_CopyRect(LCUI_Surface surface, LCUI_Rect *rect, int x, int y)
+{
+	if (display.driver && display.driver->copyRect) {
+		return display.driver->copyRect(surface, rect, x, y);
+	}
+	return -1;
+}
+
 void Surface_Present(LCUI_Surface surface)
 {
 	if (display.driver) {
@@ -957,6 +1238,8 @@ int LCUI_InitDisplay(LCUI_DisplayDriver driver)
 	Settings_Init(&display.settings);
 	display.settings_change_handler_id = LCUI_BindEvent(
 	    LCUI_SETTINGS_CHANGE, OnSettingsChangeEvent, NULL, NULL);
+	display.scale_change_handler_id = LCUI_BindEvent(
+	    LCUI_SCALE_CHANGE, OnScaleChangeEvent, NULL, NULL);
 
 	LinkedList_Init(&display.rects);
 	LinkedList_Init(&display.surfaces);
@@ -996,5 +1279,11 @@ int LCUI_FreeDisplay(void)
 	}
 	LCUI_UnbindEvent(display.settings_change_handler_id);
 	display.settings_change_handler_id = -1;
+	LCUI_UnbindEvent(display.scale_change_handler_id);
+	display.scale_change_handler_id = -1;
+	if (display.render_pool) {
+		LCUIThreadPool_Destroy(display.render_pool);
+		display.render_pool = NULL;
+	}
 	return 0;
 }
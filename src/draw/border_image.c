@@ -0,0 +1,420 @@
+﻿/*
+ * border_image.c -- Border image (nine-patch) drawing
+ *
+ * Copyright (c) 2019, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/draw/border_image.h>
+
+/** 图块在单个方向上的排列方式 */
+typedef struct TileAxisRec_ {
+	float start; /**< 第一个单元的位置 */
+	float unit;  /**< 单元的尺寸 */
+	int size;    /**< 单元图像的尺寸 */
+} TileAxisRec, *TileAxis;
+
+static int Graph_CreateTile(LCUI_Graph *graph, int color_type, int width,
+			    int height)
+{
+	Graph_Init(graph);
+	graph->color_type = color_type;
+	return Graph_Create(graph, width, height);
+}
+
+/** 将源图像的切片缩放到指定尺寸 */
+static int Graph_ZoomSlice(const LCUI_Graph *source, const LCUI_Rect *rect,
+			   int width, int height, LCUI_Graph *out)
+{
+	LCUI_Graph slice;
+
+	Graph_Init(out);
+	Graph_QuoteReadOnly(&slice, source, rect);
+	if (!Graph_IsValid(&slice)) {
+		return -1;
+	}
+	if (slice.width == (unsigned)width &&
+	    slice.height == (unsigned)height) {
+		if (Graph_CreateTile(out, slice.color_type, width, height) != 0) {
+			return -2;
+		}
+		Graph_Replace(out, &slice, 0, 0);
+		return 0;
+	}
+	return Graph_ZoomBilinear(&slice, out, FALSE, width, height);
+}
+
+/**
+ * 计算单个方向上的单元排列方式
+ * @param len 图块的尺寸
+ * @param src_len 源图像切片的尺寸
+ * @param scale 切片的缩放比例，stretch 方式不使用它
+ */
+static void TileAxis_Init(TileAxis axis, int mode, int len, int src_len,
+			  float scale)
+{
+	int n;
+	float offset;
+
+	axis->start = 0;
+	axis->unit = (float)len;
+	if (mode == SV_REPEAT || mode == SV_ROUND) {
+		axis->unit = max(1.0f, src_len * scale);
+	}
+	if (mode == SV_ROUND) {
+		n = max(1, (int)(len / axis->unit + 0.5f));
+		axis->unit = 1.0f * len / n;
+	} else if (mode == SV_REPEAT) {
+		/* 居中对齐，两端的单元可能只显示一部分 */
+		offset = (len - axis->unit) / 2.0f;
+		axis->start = offset - (float)ceil(offset / axis->unit) *
+					   axis->unit;
+	}
+	axis->size = (int)ceil(axis->unit);
+}
+
+/** 按单元排列方式将切片平铺到图块中 */
+static int Graph_TileSlice(const LCUI_Graph *source, const LCUI_Rect *rect,
+			   TileAxis x_axis, TileAxis y_axis, int width,
+			   int height, LCUI_Graph *out)
+{
+	int ret;
+	float x, y;
+	LCUI_Graph unit, part;
+	LCUI_Rect area, part_rect, unit_rect;
+
+	if (x_axis->size == width && y_axis->size == height) {
+		return Graph_ZoomSlice(source, rect, width, height, out);
+	}
+	ret = Graph_ZoomSlice(source, rect, x_axis->size, y_axis->size, &unit);
+	if (ret != 0) {
+		Graph_Free(&unit);
+		return ret;
+	}
+	if (Graph_CreateTile(out, unit.color_type, width, height) != 0) {
+		Graph_Free(&unit);
+		return -2;
+	}
+	area.x = 0;
+	area.y = 0;
+	area.width = width;
+	area.height = height;
+	unit_rect.width = unit.width;
+	unit_rect.height = unit.height;
+	for (y = y_axis->start; y < height; y += y_axis->unit) {
+		unit_rect.y = (int)floor(y + 0.5f);
+		for (x = x_axis->start; x < width; x += x_axis->unit) {
+			unit_rect.x = (int)floor(x + 0.5f);
+			if (!LCUIRect_GetOverlayRect(&area, &unit_rect,
+						     &part_rect)) {
+				continue;
+			}
+			part_rect.x -= unit_rect.x;
+			part_rect.y -= unit_rect.y;
+			Graph_QuoteReadOnly(&part, &unit, &part_rect);
+			Graph_Replace(out, &part, unit_rect.x + part_rect.x,
+				      unit_rect.y + part_rect.y);
+		}
+	}
+	Graph_Free(&unit);
+	return 0;
+}
+
+static float GetScale(int len, int src_len)
+{
+	return src_len > 0 && len > 0 ? 1.0f * len / src_len : 0;
+}
+
+/** 计算源图像中的切片线和目标区域中的分割线 */
+static void BorderImage_ComputeLines(const LCUI_BorderImage *image,
+				     int src_width, int src_height, int width,
+				     int height, int sx[4], int sy[4], int dx[4],
+				     int dy[4])
+{
+	float scale = 1.0f;
+	int top, right, bottom, left;
+
+	top = max(0, image->slice.top);
+	left = max(0, image->slice.left);
+	top = min(top, src_height);
+	left = min(left, src_width);
+	bottom = min(max(0, image->slice.bottom), src_height - top);
+	right = min(max(0, image->slice.right), src_width - left);
+	sx[0] = 0;
+	sx[1] = left;
+	sx[2] = src_width - right;
+	sx[3] = src_width;
+	sy[0] = 0;
+	sy[1] = top;
+	sy[2] = src_height - bottom;
+	sy[3] = src_height;
+
+	/* 边框宽度之和超出目标区域时，按比例缩小边框宽度 */
+	top = max(0, image->width.top);
+	right = max(0, image->width.right);
+	bottom = max(0, image->width.bottom);
+	left = max(0, image->width.left);
+	if (left + right > width) {
+		scale = 1.0f * width / (left + right);
+	}
+	if (top + bottom > height) {
+		scale = min(scale, 1.0f * height / (top + bottom));
+	}
+	if (scale < 1.0f) {
+		top = (int)(top * scale);
+		right = (int)(right * scale);
+		bottom = (int)(bottom * scale);
+		left = (int)(left * scale);
+	}
+	dx[0] = 0;
+	dx[1] = left;
+	dx[2] = width - right;
+	dx[3] = width;
+	dy[0] = 0;
+	dy[1] = top;
+	dy[2] = height - bottom;
+	dy[3] = height;
+}
+
+static void BorderImageTiles_Build(LCUI_BorderImageTiles tiles,
+				   const LCUI_BorderImage *image, int width,
+				   int height)
+{
+	int i, j, k, mode_x, mode_y;
+	int sx[4], sy[4], dx[4], dy[4];
+	float scale_x, scale_y;
+	LCUI_Rect src_rect;
+	LCUI_Rect *rect;
+	TileAxisRec x_axis, y_axis;
+
+	BorderImage_ComputeLines(image, image->source->width,
+				 image->source->height, width, height, sx, sy,
+				 dx, dy);
+	for (i = 0; i < 3; ++i) {
+		for (j = 0; j < 3; ++j) {
+			k = i * 3 + j;
+			rect = &tiles->rects[k];
+			rect->x = dx[j];
+			rect->y = dy[i];
+			rect->width = dx[j + 1] - dx[j];
+			rect->height = dy[i + 1] - dy[i];
+			src_rect.x = sx[j];
+			src_rect.y = sy[i];
+			src_rect.width = sx[j + 1] - sx[j];
+			src_rect.height = sy[i + 1] - sy[i];
+			if (k == 4 && !image->fill) {
+				continue;
+			}
+			if (rect->width < 1 || rect->height < 1 ||
+			    src_rect.width < 1 || src_rect.height < 1) {
+				continue;
+			}
+			/* 四个角直接拉伸，四条边只在沿边的方向上重复 */
+			mode_x = j == 1 ? image->repeat_x : SV_STRETCH;
+			mode_y = i == 1 ? image->repeat_y : SV_STRETCH;
+			/* 边的单元按边框宽度与切片宽度的比例缩放，中间块则
+			 * 与上边和左边的缩放比例一致 */
+			scale_x = GetScale(rect->height, src_rect.height);
+			scale_y = GetScale(rect->width, src_rect.width);
+			if (k == 4) {
+				scale_x = GetScale(dy[1], sy[1]);
+				if (scale_x == 0) {
+					scale_x = GetScale(dy[3] - dy[2],
+							   sy[3] - sy[2]);
+				}
+				scale_y = GetScale(dx[1], sx[1]);
+				if (scale_y == 0) {
+					scale_y = GetScale(dx[3] - dx[2],
+							   sx[3] - sx[2]);
+				}
+			}
+			TileAxis_Init(&x_axis, mode_x, rect->width,
+				      src_rect.width,
+				      scale_x > 0 ? scale_x : 1.0f);
+			TileAxis_Init(&y_axis, mode_y, rect->height,
+				      src_rect.height,
+				      scale_y > 0 ? scale_y : 1.0f);
+			Graph_TileSlice(image->source, &src_rect, &x_axis,
+					&y_axis, rect->width, rect->height,
+					&tiles->graphs[k]);
+		}
+	}
+}
+
+void BorderImageTiles_Init(LCUI_BorderImageTiles tiles)
+{
+	int i;
+
+	memset(&tiles->image, 0, sizeof(tiles->image));
+	memset(&tiles->source_rect, 0, sizeof(tiles->source_rect));
+	tiles->source_id = 0;
+	tiles->width = 0;
+	tiles->height = 0;
+	for (i = 0; i < BORDER_IMAGE_TILES; ++i) {
+		Graph_Init(&tiles->graphs[i]);
+	}
+}
+
+void BorderImageTiles_Free(LCUI_BorderImageTiles tiles)
+{
+	int i;
+
+	for (i = 0; i < BORDER_IMAGE_TILES; ++i) {
+		Graph_Free(&tiles->graphs[i]);
+	}
+	BorderImageTiles_Init(tiles);
+}
+
+static LCUI_BOOL BorderImage_IsEquals(const LCUI_BorderImage *a,
+				       const LCUI_BorderImage *b)
+{
+	return a->fill == b->fill &&
+	       a->repeat_x == b->repeat_x && a->repeat_y == b->repeat_y &&
+	       a->slice.top == b->slice.top &&
+	       a->slice.right == b->slice.right &&
+	       a->slice.bottom == b->slice.bottom &&
+	       a->slice.left == b->slice.left &&
+	       a->width.top == b->width.top &&
+	       a->width.right == b->width.right &&
+	       a->width.bottom == b->width.bottom &&
+	       a->width.left == b->width.left;
+}
+
+static void Graph_GetSourceRect(const LCUI_Graph *graph, LCUI_Rect *rect)
+{
+	rect->x = graph->quote.is_valid ? graph->quote.left : 0;
+	rect->y = graph->quote.is_valid ? graph->quote.top : 0;
+	rect->width = graph->width;
+	rect->height = graph->height;
+}
+
+/**
+ * 以存储的标识号而不是地址判断源图像是否相同，因为源图像的存储被释放后，
+ * 新的图像可能会复用同一地址
+ */
+LCUI_BOOL BorderImageTiles_IsValid(const LCUI_BorderImageTiles tiles,
+				   const LCUI_BorderImage *image, int width,
+				   int height)
+{
+	LCUI_Rect rect;
+
+	if (tiles->width != width || tiles->height != height ||
+	    !image->source || !Graph_IsValid(image->source) ||
+	    !tiles->source_id ||
+	    tiles->source_id != Graph_GetBufferId(image->source)) {
+		return FALSE;
+	}
+	Graph_GetSourceRect(image->source, &rect);
+	return LCUIRect_IsEquals(&tiles->source_rect, &rect) &&
+	       BorderImage_IsEquals(&tiles->image, image);
+}
+
+void BorderImageTiles_Copy(LCUI_BorderImageTiles dst,
+			   const LCUI_BorderImageTiles src)
+{
+	int i;
+
+	BorderImageTiles_Free(dst);
+	for (i = 0; i < BORDER_IMAGE_TILES; ++i) {
+		dst->rects[i] = src->rects[i];
+		Graph_Copy(&dst->graphs[i], &src->graphs[i]);
+	}
+	dst->image = src->image;
+	dst->source_id = src->source_id;
+	dst->source_rect = src->source_rect;
+	dst->width = src->width;
+	dst->height = src->height;
+}
+
+int BorderImageTiles_Update(LCUI_BorderImageTiles tiles,
+			    const LCUI_BorderImage *image, int width,
+			    int height)
+{
+	if (!image->source || !Graph_IsValid(image->source) || width < 1 ||
+	    height < 1) {
+		BorderImageTiles_Free(tiles);
+		return -1;
+	}
+	if (BorderImageTiles_IsValid(tiles, image, width, height)) {
+		return 0;
+	}
+	BorderImageTiles_Free(tiles);
+	BorderImageTiles_Build(tiles, image, width, height);
+	tiles->image = *image;
+	tiles->source_id = Graph_GetBufferId(image->source);
+	Graph_GetSourceRect(image->source, &tiles->source_rect);
+	tiles->width = width;
+	tiles->height = height;
+	return 1;
+}
+
+int BorderImageTiles_Paint(const LCUI_BorderImageTiles tiles,
+			   const LCUI_Rect *box, LCUI_PaintContext paint)
+{
+	int i;
+	LCUI_Graph part;
+	LCUI_Rect rect, part_rect;
+
+	for (i = 0; i < BORDER_IMAGE_TILES; ++i) {
+		if (!Graph_IsValid(&tiles->graphs[i])) {
+			continue;
+		}
+		rect = tiles->rects[i];
+		rect.x += box->x;
+		rect.y += box->y;
+		if (!LCUIRect_GetOverlayRect(&rect, &paint->rect, &part_rect)) {
+			continue;
+		}
+		part_rect.x -= rect.x;
+		part_rect.y -= rect.y;
+		Graph_QuoteReadOnly(&part, &tiles->graphs[i], &part_rect);
+		Graph_Mix(&paint->canvas, &part,
+			  rect.x + part_rect.x - paint->rect.x,
+			  rect.y + part_rect.y - paint->rect.y,
+			  paint->with_alpha);
+	}
+	return 0;
+}
+
+int BorderImage_Paint(const LCUI_BorderImage *image, const LCUI_Rect *box,
+		      LCUI_PaintContext paint)
+{
+	int ret;
+	LCUI_BorderImageTilesRec tiles;
+
+	BorderImageTiles_Init(&tiles);
+	ret = BorderImageTiles_Update(&tiles, image, box->width, box->height);
+	if (ret >= 0) {
+		ret = BorderImageTiles_Paint(&tiles, box, paint);
+	}
+	BorderImageTiles_Free(&tiles);
+	return ret;
+}
@@ -38,12 +38,16 @@
 #include <LCUI/util.h>
 #include <LCUI/graph.h>
 #include <LCUI/font.h>
+#include <LCUI/thread.h>
 
 /* clang-format off */
 
 #define FONT_CACHE_SIZE		32
 #define FONT_CACHE_MAX_SIZE	1024
 
+/** 字体栈缓存的最大数量，超出时移除没有被引用的字体栈 */
+#define FONT_STACK_CACHE_MAX_SIZE	256
+
 /**
  * 库中缓存的字体位图是分组存放的，共有三级分组，分别为：
  * 字符->字体信息->字体大小
@@ -76,11 +80,15 @@ static struct LCUI_FontLibraryModule {
 	Dict *font_families;		/**< 字族信息库，以字族名称索引字体信息 */
 	DictType font_families_type;	/**< 字族信息库的字典类型数据 */
 	RBTree bitmap_cache;		/**< 字体位图缓存区 */
+	LCUI_Mutex bitmap_cache_mutex;	/**< 字体位图缓存区的互斥锁，工作线程会预先渲染字形 */
 	LCUI_FontCache *font_cache;	/**< 字体信息缓存区 */
 	LCUI_Font default_font;		/**< 默认字体的信息 */
 	LCUI_Font incore_font;		/**< 内置字体的信息 */
 	LCUI_FontEngine engines[2];	/**< 当前可用字体引擎列表 */
 	LCUI_FontEngine *engine;	/**< 当前选择的字体引擎 */
+	Dict *font_stacks;		/**< 字体栈缓存，以字族列表、风格和字重索引 */
+	DictType font_stacks_type;	/**< 字体栈缓存的字典类型数据 */
+	LCUI_Mutex font_stacks_mutex;	/**< 字体栈缓存的互斥锁 */
 } fontlib;
 
 /* clang-format on */
@@ -255,6 +263,123 @@ static void DestroyTreeNode(void *arg)
 	free(arg);
 }
 
+static unsigned int FontStack_KeyHash(const void *key)
+{
+	const LCUI_FontStackRec *stack = key;
+	return stack->hash;
+}
+
+static int FontStack_KeyCompare(void *privdata, const void *key1,
+				const void *key2)
+{
+	const LCUI_FontStackRec *a = key1;
+	const LCUI_FontStackRec *b = key2;
+
+	return a->hash == b->hash && a->style == b->style &&
+	       a->weight == b->weight && strcmp(a->family, b->family) == 0;
+}
+
+static void FontStack_Destroy(LCUI_FontStack stack)
+{
+	free(stack->family);
+	if (stack->font_ids) {
+		free(stack->font_ids);
+	}
+	free(stack);
+}
+
+/** 将字体栈移出缓存，仍被引用的字体栈会在最后一次释放时销毁 */
+static void FontStack_Uncache(void *privdata, void *data)
+{
+	LCUI_FontStack stack = data;
+
+	stack->cached = FALSE;
+	if (stack->refs == 0) {
+		FontStack_Destroy(stack);
+	}
+}
+
+static void FontStack_InitKey(LCUI_FontStack key, const char *family,
+			      LCUI_FontStyle style, LCUI_FontWeight weight)
+{
+	key->family = (char *)family;
+	key->style = style;
+	key->weight = weight ? weight : FONT_WEIGHT_NORMAL;
+	key->hash = Dict_GenHashFunction((const unsigned char *)family,
+					 (int)strlen(family));
+	key->hash = key->hash * 31 + key->style * 1000 + key->weight;
+}
+
+/** 移除没有被引用的字体栈 */
+static void FontStacks_Shrink(void)
+{
+	DictEntry *entry;
+	DictIterator *iter;
+	LCUI_FontStack stack;
+
+	iter = Dict_GetSafeIterator(fontlib.font_stacks);
+	while ((entry = Dict_Next(iter))) {
+		stack = DictEntry_GetVal(entry);
+		if (stack->refs == 0) {
+			Dict_Delete(fontlib.font_stacks, stack);
+		}
+	}
+	Dict_ReleaseIterator(iter);
+}
+
+LCUI_FontStack LCUIFont_GetStack(const char *family, LCUI_FontStyle style,
+				 LCUI_FontWeight weight)
+{
+	LCUI_FontStackRec key;
+	LCUI_FontStack stack;
+
+	if (!fontlib.active || !family) {
+		return NULL;
+	}
+	FontStack_InitKey(&key, family, style, weight);
+	LCUIMutex_Lock(&fontlib.font_stacks_mutex);
+	stack = Dict_FetchValue(fontlib.font_stacks, &key);
+	if (stack) {
+		stack->refs += 1;
+		LCUIMutex_Unlock(&fontlib.font_stacks_mutex);
+		return stack;
+	}
+	stack = malloc(sizeof(LCUI_FontStackRec));
+	if (!stack) {
+		LCUIMutex_Unlock(&fontlib.font_stacks_mutex);
+		return NULL;
+	}
+	*stack = key;
+	stack->family = strdup2(family);
+	stack->length = LCUIFont_GetIdByNames(&stack->font_ids, stack->style,
+					      stack->weight, family);
+	stack->refs = 1;
+	stack->cached = TRUE;
+	if (Dict_Size(fontlib.font_stacks) >= FONT_STACK_CACHE_MAX_SIZE) {
+		FontStacks_Shrink();
+	}
+	Dict_Add(fontlib.font_stacks, stack, stack);
+	LCUIMutex_Unlock(&fontlib.font_stacks_mutex);
+	return stack;
+}
+
+void LCUIFont_ReleaseStack(LCUI_FontStack stack)
+{
+	LCUI_BOOL active = fontlib.active;
+
+	/* 字体库已经释放时，字体栈都已移出缓存，只剩下这里的引用 */
+	if (active) {
+		LCUIMutex_Lock(&fontlib.font_stacks_mutex);
+	}
+	stack->refs -= 1;
+	if (stack->refs == 0 && !stack->cached) {
+		FontStack_Destroy(stack);
+	}
+	if (active) {
+		LCUIMutex_Unlock(&fontlib.font_stacks_mutex);
+	}
+}
+
 int LCUIFont_Add(LCUI_Font font)
 {
 	LCUI_Font exists_font;
@@ -282,6 +407,10 @@ int LCUIFont_Add(LCUI_Font font)
 	}
 	SetFontWeight(snode, font);
 	SetFontCache(font);
+	/* 新的字体可能会改变字体栈的解析结果，所以清空缓存 */
+	LCUIMutex_Lock(&fontlib.font_stacks_mutex);
+	Dict_Empty(fontlib.font_stacks);
+	LCUIMutex_Unlock(&fontlib.font_stacks_mutex);
 	return font->id;
 }
 
@@ -516,15 +645,12 @@ void LCUIFont_SetDefault(int id)
 	}
 }
 
-LCUI_FontBitmap *LCUIFont_AddBitmap(wchar_t ch, int font_id, int size,
-				    const LCUI_FontBitmap *bmp)
+static LCUI_FontBitmap *FontBitmapCache_Add(wchar_t ch, int font_id, int size,
+					    const LCUI_FontBitmap *bmp)
 {
 	LCUI_FontBitmap *bmp_cache;
 	RBTree *tree_font, *tree_bmp;
 
-	if (!fontlib.active) {
-		return NULL;
-	}
 	/* 获取字符的字体信息集 */
 	tree_font = SelectChar(ch);
 	if (!tree_font) {
@@ -565,17 +691,76 @@ LCUI_FontBitmap *LCUIFont_AddBitmap(wchar_t ch, int font_id, int size,
 	return bmp_cache;
 }
 
-int LCUIFont_GetBitmap(wchar_t ch, int font_id, int size,
-		       const LCUI_FontBitmap **bmp)
+LCUI_FontBitmap *LCUIFont_AddBitmap(wchar_t ch, int font_id, int size,
+				    const LCUI_FontBitmap *bmp)
 {
-	int ret;
-	RBTree *ctx;
-	LCUI_FontBitmap bmp_cache;
+	LCUI_FontBitmap *bmp_cache;
 
-	*bmp = NULL;
 	if (!fontlib.active) {
-		return -2;
+		return NULL;
+	}
+	LCUIMutex_Lock(&fontlib.bitmap_cache_mutex);
+	bmp_cache = FontBitmapCache_Add(ch, font_id, size, bmp);
+	LCUIMutex_Unlock(&fontlib.bitmap_cache_mutex);
+	return bmp_cache;
+}
+
+static const LCUI_FontBitmap *FontBitmapCache_Find(wchar_t ch, int font_id,
+						   int size)
+{
+	RBTree *ctx;
+
+	if (!(ctx = SelectChar(ch))) {
+		return NULL;
 	}
+	if (!(ctx = SelectFont(ctx, font_id))) {
+		return NULL;
+	}
+	return SelectBitmap(ctx, size);
+}
+
+static const LCUI_FontBitmap *FontBitmapCache_Select(wchar_t ch, int font_id,
+						     int size)
+{
+	const LCUI_FontBitmap *bmp;
+
+	LCUIMutex_Lock(&fontlib.bitmap_cache_mutex);
+	bmp = FontBitmapCache_Find(ch, font_id, size);
+	LCUIMutex_Unlock(&fontlib.bitmap_cache_mutex);
+	return bmp;
+}
+
+/**
+ * 将在锁外渲染好的字形位图存入缓存
+ * 若其它线程已先存入同一字形，则保留已有的位图并释放这次渲染的结果
+ */
+static const LCUI_FontBitmap *FontBitmapCache_Put(wchar_t ch, int font_id,
+						  int size,
+						  LCUI_FontBitmap *bmp)
+{
+	const LCUI_FontBitmap *bmp_cache;
+
+	LCUIMutex_Lock(&fontlib.bitmap_cache_mutex);
+	bmp_cache = FontBitmapCache_Find(ch, font_id, size);
+	if (bmp_cache) {
+		LCUIMutex_Unlock(&fontlib.bitmap_cache_mutex);
+		FontBitmap_Free(bmp);
+		return bmp_cache;
+	}
+	bmp_cache = FontBitmapCache_Add(ch, font_id, size, bmp);
+	LCUIMutex_Unlock(&fontlib.bitmap_cache_mutex);
+	if (!bmp_cache) {
+		FontBitmap_Free(bmp);
+	}
+	return bmp_cache;
+}
+
+static int FontBitmapCache_Get(wchar_t ch, int font_id, int size,
+			       const LCUI_FontBitmap **bmp)
+{
+	int ret;
+	LCUI_FontBitmap bmp_cache;
+
 	if (font_id <= 0) {
 		if (fontlib.default_font) {
 			font_id = fontlib.default_font->id;
@@ -583,36 +768,37 @@ int LCUIFont_GetBitmap(wchar_t ch, int font_id, int size,
 			font_id = fontlib.incore_font->id;
 		}
 	}
-	do {
-		if (!(ctx = SelectChar(ch))) {
-			break;
-		}
-		ctx = SelectFont(ctx, font_id);
-		if (!ctx) {
-			break;
-		}
-		*bmp = SelectBitmap(ctx, size);
-		if (*bmp) {
-			return 0;
-		}
-		break;
-	} while (0);
+	*bmp = FontBitmapCache_Select(ch, font_id, size);
+	if (*bmp) {
+		return 0;
+	}
 	if (ch == 0) {
 		return -1;
 	}
+	/* 光栅化较慢，在锁外进行，以免阻塞其它线程查询缓存 */
 	FontBitmap_Init(&bmp_cache);
 	ret = LCUIFont_RenderBitmap(&bmp_cache, ch, font_id, size);
 	if (ret == 0) {
-		*bmp = LCUIFont_AddBitmap(ch, font_id, size, &bmp_cache);
+		*bmp = FontBitmapCache_Put(ch, font_id, size, &bmp_cache);
 		return 0;
 	}
-	ret = LCUIFont_GetBitmap(0, font_id, size, bmp);
+	ret = FontBitmapCache_Get(0, font_id, size, bmp);
 	if (ret != 0) {
-		*bmp = LCUIFont_AddBitmap(0, font_id, size, &bmp_cache);
+		*bmp = FontBitmapCache_Put(0, font_id, size, &bmp_cache);
 	}
 	return -1;
 }
 
+int LCUIFont_GetBitmap(wchar_t ch, int font_id, int size,
+		       const LCUI_FontBitmap **bmp)
+{
+	*bmp = NULL;
+	if (!fontlib.active) {
+		return -2;
+	}
+	return FontBitmapCache_Get(ch, font_id, size, bmp);
+}
+
 static int LCUIFont_LoadFileEx(LCUI_FontEngine *engine, const char *file)
 {
 	LCUI_Font *fonts;
@@ -731,8 +917,16 @@ static void FontBitmap_MixARGB(LCUI_Graph *graph, LCUI_Rect *write_rect,
 		px = px_row_des;
 		byte_ptr = byte_row_ptr;
 		for (x = 0; x < read_rect->width; ++x, ++byte_ptr, ++px) {
+			/* 字形之间的空白较多，跳过它们能减少混合的次数 */
+			if (*byte_ptr == 0) {
+				continue;
+			}
 			c = color;
-			c.alpha = (uchar_t)(*byte_ptr * color.alpha / 255.0);
+			c.alpha = (uchar_t)(*byte_ptr * color.alpha / 255);
+			if (c.alpha == 255) {
+				*px = c;
+				continue;
+			}
 			LCUI_OverPixel(px, &c);
 		}
 		px_row_des += graph->width;
@@ -833,6 +1027,13 @@ static void LCUIFont_InitBase(void)
 	Dict_InitStringKeyType(&fontlib.font_families_type);
 	fontlib.font_families_type.valDestructor = DestroyFontFamilyNode;
 	fontlib.font_families = Dict_Create(&fontlib.font_families_type, NULL);
+	memset(&fontlib.font_stacks_type, 0, sizeof(DictType));
+	fontlib.font_stacks_type.hashFunction = FontStack_KeyHash;
+	fontlib.font_stacks_type.keyCompare = FontStack_KeyCompare;
+	fontlib.font_stacks_type.valDestructor = FontStack_Uncache;
+	fontlib.font_stacks = Dict_Create(&fontlib.font_stacks_type, NULL);
+	LCUIMutex_Init(&fontlib.font_stacks_mutex);
+	LCUIMutex_Init(&fontlib.bitmap_cache_mutex);
 	RBTree_OnDestroy(&fontlib.bitmap_cache, DestroyTreeNode);
 	fontlib.active = TRUE;
 }
@@ -871,8 +1072,11 @@ static void LCUIFont_FreeBase(void)
 		--fontlib.font_cache_num;
 		DeleteFontCache(fontlib.font_cache[fontlib.font_cache_num]);
 	}
+	Dict_Release(fontlib.font_stacks);
 	Dict_Release(fontlib.font_families);
 	RBTree_Destroy(&fontlib.bitmap_cache);
+	LCUIMutex_Destroy(&fontlib.font_stacks_mutex);
+	LCUIMutex_Destroy(&fontlib.bitmap_cache_mutex);
 	free(fontlib.font_cache);
 	fontlib.font_cache = NULL;
 }
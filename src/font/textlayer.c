@@ -29,6 +29,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <wctype.h>
 #include <LCUI_Build.h>
 #include <LCUI/types.h>
@@ -47,6 +48,9 @@ typedef enum { TEXT_ACTION_INSERT, TEXT_ACTION_APPEND } TextAction;
 #define GetDefaultLineHeight(H) iround(H * 1.42857143)
 #define ISALPHA(CH) (CH >= 'a' && CH <= 'z') || (CH >= 'A' && CH <= 'Z')
 
+/* 每个文本图层中的字形位图缓存的最大字节数 */
+#define MAX_ROW_CACHE_SIZE (4 * 1024 * 1024)
+
 /* 根据对齐方式，计算文本行的起始X轴位置 */
 static int TextLayer_GetRowStartX(LCUI_TextLayer layer, LCUI_TextRow txtrow)
 {
@@ -109,11 +113,23 @@ static void TextRow_Init(LCUI_TextRow txtrow)
 	txtrow->string = NULL;
 	txtrow->eol = LCUI_EOL_NONE;
 	txtrow->text_height = 0;
+	FontBitmap_Init(&txtrow->bitmap);
+}
+
+/** 清除文本行的字形位图缓存 */
+static void TextRowList_ClearCache(LCUI_TextRowList rowlist,
+				   LCUI_TextRow txtrow)
+{
+	if (txtrow->bitmap.buffer) {
+		rowlist->cache_size -= txtrow->bitmap.width * txtrow->bitmap.rows;
+		FontBitmap_Free(&txtrow->bitmap);
+	}
 }
 
 static void TextRow_Destroy(LCUI_TextRow txtrow)
 {
 	int i;
+	FontBitmap_Free(&txtrow->bitmap);
 	for (i = 0; i < txtrow->length; ++i) {
 		if (txtrow->string[i]) {
 			free(txtrow->string[i]);
@@ -160,12 +176,51 @@ static LCUI_TextRow TextRowList_InsertNewRow(LCUI_TextRowList rowlist,
 	return txtrow;
 }
 
+/** 在文本行列表的指定位置一次插入多个新文本行 */
+static int TextRowList_InsertNewRows(LCUI_TextRowList rowlist, int i_row,
+				     int n_rows)
+{
+	int i;
+	LCUI_TextRow *txtrows;
+
+	if (i_row > rowlist->length) {
+		i_row = rowlist->length;
+	}
+	txtrows = realloc(rowlist->rows, sizeof(LCUI_TextRow) *
+						 (rowlist->length + n_rows + 1));
+	if (!txtrows) {
+		return -1;
+	}
+	rowlist->rows = txtrows;
+	memmove(txtrows + i_row + n_rows, txtrows + i_row,
+		sizeof(LCUI_TextRow) * (rowlist->length - i_row));
+	for (i = 0; i < n_rows; ++i) {
+		txtrows[i_row + i] = malloc(sizeof(LCUI_TextRowRec));
+		if (!txtrows[i_row + i]) {
+			break;
+		}
+		TextRow_Init(txtrows[i_row + i]);
+	}
+	if (i < n_rows) {
+		while (i-- > 0) {
+			free(txtrows[i_row + i]);
+		}
+		memmove(txtrows + i_row, txtrows + i_row + n_rows,
+			sizeof(LCUI_TextRow) * (rowlist->length - i_row));
+		return -1;
+	}
+	rowlist->length += n_rows;
+	txtrows[rowlist->length] = NULL;
+	return 0;
+}
+
 /** 从文本行列表中删除指定文本行 */
 static int TextRowList_RemoveRow(LCUI_TextRowList rowlist, int i_row)
 {
 	if (i_row < 0 || i_row >= rowlist->length) {
 		return -1;
 	}
+	TextRowList_ClearCache(rowlist, rowlist->rows[i_row]);
 	TextRow_Destroy(rowlist->rows[i_row]);
 	free(rowlist->rows[i_row]);
 	for (; i_row < rowlist->length - 1; ++i_row) {
@@ -181,6 +236,7 @@ static void TextLayer_UpdateRowSize(LCUI_TextLayer layer, LCUI_TextRow txtrow)
 {
 	int i;
 	LCUI_TextChar txtchar;
+	TextRowList_ClearCache(&layer->text_rows, txtrow);
 	txtrow->width = 0;
 	txtrow->text_height = layer->text_default_style.pixel_size;
 	for (i = 0; i < txtrow->length; ++i) {
@@ -293,10 +349,12 @@ LCUI_TextLayer TextLayer_New(void)
 	layer->line_height = -1;
 	layer->text_rows.length = 0;
 	layer->text_rows.rows = NULL;
+	layer->text_rows.cache_size = 0;
 	layer->text_align = SV_LEFT;
 	layer->enable_autowrap = FALSE;
 	layer->enable_mulitiline = FALSE;
 	layer->enable_style_tag = FALSE;
+	layer->enable_row_cache = TRUE;
 	layer->word_break = LCUI_WORD_BREAK_NORMAL;
 	TextStyle_Init(&layer->text_default_style);
 	LinkedList_Init(&layer->text_styles);
@@ -318,6 +376,7 @@ static void TextRowList_Destroy(LCUI_TextRowList list)
 		list->rows[row] = NULL;
 	}
 	list->length = 0;
+	list->cache_size = 0;
 	if (list->rows) {
 		free(list->rows);
 	}
@@ -404,8 +463,11 @@ static void TextLayer_InvalidateRowRect(LCUI_TextLayer layer, int row,
 void TextLayer_InvalidateRowsRect(LCUI_TextLayer layer, int start_row,
 				  int end_row)
 {
-	int i, y;
+	int i, x, y;
+	int top = 0, bottom = 0, left = 0, right = 0;
+	LCUI_BOOL found = FALSE;
 	LCUI_Rect rect;
+	LCUI_TextRow txtrow;
 
 	if (end_row < 0 || end_row >= layer->text_rows.length) {
 		end_row = layer->text_rows.length - 1;
@@ -419,14 +481,37 @@ void TextLayer_InvalidateRowsRect(LCUI_TextLayer layer, int start_row,
 			break;
 		}
 	}
+	/*
+	 * 各行是连续排列的，只记录它们的外接矩形，以免文本行很多时逐行计算坐标和
+	 * 添加大量矩形
+	 */
 	for (; i <= end_row; ++i) {
-		TextLayer_GetRowRect(layer, i, 0, -1, &rect);
-		RectList_Add(&layer->dirty_rects, &rect);
-		y += layer->text_rows.rows[i]->height;
+		txtrow = layer->text_rows.rows[i];
+		if (txtrow->width > 0 && txtrow->height > 0) {
+			x = layer->offset_x +
+			    TextLayer_GetRowStartX(layer, txtrow);
+			if (!found) {
+				top = y;
+				left = x;
+				right = x + txtrow->width;
+				found = TRUE;
+			}
+			left = min(left, x);
+			right = max(right, x + txtrow->width);
+			bottom = y + txtrow->height;
+		}
+		y += txtrow->height;
 		if (y >= layer->max_height) {
 			break;
 		}
 	}
+	if (found) {
+		rect.x = left;
+		rect.y = top;
+		rect.width = right - left;
+		rect.height = bottom - top;
+		RectList_Add(&layer->dirty_rects, &rect);
+	}
 }
 
 /** 设置插入点的行列坐标 */
@@ -802,6 +887,131 @@ static int TextLayer_ProcessText(LCUI_TextLayer layer, const wchar_t *wstr,
 	return 0;
 }
 
+/**
+ * 批量处理文本
+ * 结果与 TextLayer_ProcessText() 相同，但不处理样式标签。先统计换行符数量，
+ * 一次性插入所需的文本行，每行的字符串也只调整一次长度，避免逐个字符插入和
+ * 逐次断行带来的重复内存分配和字符移动。
+ */
+static int TextLayer_ProcessTextBulk(LCUI_TextLayer layer, const wchar_t *wstr,
+				     size_t len, TextAction action)
+{
+	size_t i, j;
+	int k, n, n_rows, cur_row, cur_col, ins_x, ins_y;
+	LCUI_TextRow txtrow, last;
+	LCUI_TextChar txtchar;
+	LCUI_BOOL cached[128] = { 0 };
+	const LCUI_FontBitmap *bitmaps[128];
+
+	if (!wstr) {
+		return -1;
+	}
+	if (action == TEXT_ACTION_APPEND) {
+		if (layer->text_rows.length > 0) {
+			cur_row = layer->text_rows.length - 1;
+		} else {
+			cur_row = 0;
+		}
+		txtrow = TextLayer_GetRow(layer, cur_row);
+		if (!txtrow) {
+			txtrow = TextRowList_AddNewRow(&layer->text_rows);
+		}
+		cur_col = txtrow->length;
+	} else {
+		cur_row = layer->insert_y;
+		cur_col = layer->insert_x;
+		txtrow = TextLayer_GetRow(layer, cur_row);
+		if (!txtrow) {
+			txtrow = TextRowList_AddNewRow(&layer->text_rows);
+		}
+	}
+	for (n_rows = 0, i = 0; i < len; ++i) {
+		if (wstr[i] == '\r' || wstr[i] == '\n') {
+			++n_rows;
+		}
+	}
+	if (n_rows > 0) {
+		TextLayer_InvalidateRowsRect(layer, cur_row, -1);
+		if (TextRowList_InsertNewRows(&layer->text_rows, cur_row + 1,
+					      n_rows) != 0) {
+			return -1;
+		}
+		/* 将插入点后面的字符和行尾符转移至最后一个新行 */
+		txtrow = layer->text_rows.rows[cur_row];
+		last = layer->text_rows.rows[cur_row + n_rows];
+		last->eol = txtrow->eol;
+		n = txtrow->length - cur_col;
+		if (n > 0 && TextRow_SetLength(last, n) == 0) {
+			memcpy(last->string, txtrow->string + cur_col,
+			       sizeof(LCUI_TextChar) * n);
+			txtrow->string[cur_col] = NULL;
+			txtrow->length = cur_col;
+		}
+	}
+	ins_x = cur_col;
+	ins_y = cur_row;
+	for (i = 0;; i = j + 1) {
+		for (j = i; j < len && wstr[j] != '\r' && wstr[j] != '\n'; ++j)
+			;
+		txtrow = layer->text_rows.rows[ins_y];
+		k = (int)(j - i);
+		n = txtrow->length;
+		if (k > 0 && TextRow_SetLength(txtrow, n + k) == 0) {
+			memmove(txtrow->string + ins_x + k,
+				txtrow->string + ins_x,
+				sizeof(LCUI_TextChar) * (n - ins_x));
+			for (; i < j; ++i, ++ins_x) {
+				txtchar = malloc(sizeof(LCUI_TextCharRec));
+				txtchar->code = wstr[i];
+				txtchar->style = NULL;
+				/* 同一次调用中的 ASCII 字符只查找一次字形位图 */
+				if ((unsigned)wstr[i] >= 128) {
+					TextChar_UpdateBitmap(
+					    txtchar, &layer->text_default_style);
+				} else if (cached[wstr[i]]) {
+					txtchar->bitmap = bitmaps[wstr[i]];
+				} else {
+					TextChar_UpdateBitmap(
+					    txtchar, &layer->text_default_style);
+					bitmaps[wstr[i]] = txtchar->bitmap;
+					cached[wstr[i]] = TRUE;
+				}
+				txtrow->string[ins_x] = txtchar;
+			}
+		}
+		TextLayer_UpdateRowSize(layer, txtrow);
+		layer->width = max(layer->width, txtrow->width);
+		if (j >= len) {
+			break;
+		}
+		if (wstr[j] == '\r') {
+			if (j + 1 < len && wstr[j + 1] == '\n') {
+				txtrow->eol = LCUI_EOL_CR_LF;
+			} else {
+				txtrow->eol = LCUI_EOL_CR;
+			}
+		} else {
+			txtrow->eol = LCUI_EOL_LF;
+		}
+		ins_x = 0;
+		++ins_y;
+	}
+	layer->length += (int)len;
+	if (action == TEXT_ACTION_INSERT) {
+		layer->insert_x = ins_x;
+		layer->insert_y = ins_y;
+	}
+	if (layer->enable_autowrap || n_rows > 0) {
+		TextLayer_AddUpdateTypeset(layer, cur_row);
+	} else {
+		TextLayer_InvalidateRowRect(layer, cur_row, 0, -1);
+	}
+	if (n_rows > 0) {
+		TextLayer_InvalidateRowsRect(layer, cur_row, -1);
+	}
+	return 0;
+}
+
 /** 插入文本内容（宽字符版） */
 int TextLayer_InsertTextW(LCUI_TextLayer layer, const wchar_t *wstr,
 			  LinkedList *tags)
@@ -809,6 +1019,13 @@ int TextLayer_InsertTextW(LCUI_TextLayer layer, const wchar_t *wstr,
 	return TextLayer_ProcessText(layer, wstr, TEXT_ACTION_INSERT, tags);
 }
 
+/** 批量插入文本内容（宽字符版） */
+int TextLayer_InsertTextBulkW(LCUI_TextLayer layer, const wchar_t *wstr,
+			      size_t len)
+{
+	return TextLayer_ProcessTextBulk(layer, wstr, len, TEXT_ACTION_INSERT);
+}
+
 /** 插入文本内容 */
 int TextLayer_InsertTextA(LCUI_TextLayer layer, const char *str)
 {
@@ -829,6 +1046,13 @@ int TextLayer_AppendTextW(LCUI_TextLayer layer, const wchar_t *wstr,
 				     tag_stack);
 }
 
+/** 批量追加文本内容（宽字符版） */
+int TextLayer_AppendTextBulkW(LCUI_TextLayer layer, const wchar_t *wstr,
+			      size_t len)
+{
+	return TextLayer_ProcessTextBulk(layer, wstr, len, TEXT_ACTION_APPEND);
+}
+
 /** 追加文本内容 */
 int TextLayer_AppendTextA(LCUI_TextLayer layer, const char *ascii_text)
 {
@@ -875,17 +1099,19 @@ size_t TextLayer_GetTextW(LCUI_TextLayer layer, size_t start_pos,
 	}
 	/* 先根据一维坐标计算行列坐标 */
 	for (i = 0, row = 0, col = 0; row < layer->text_rows.length; ++row) {
-		if (i >= start_pos) {
+		row_ptr = layer->text_rows.rows[row];
+		if (i + row_ptr->length > start_pos) {
 			col = (int)(start_pos - i);
 			break;
 		}
-		i += layer->text_rows.rows[row]->length;
+		i += row_ptr->length;
 	}
 	for (i = 0; row < layer->text_rows.length && i < max_len; ++row) {
 		row_ptr = layer->text_rows.rows[row];
 		for (; col < row_ptr->length && i < max_len; ++col, ++i) {
 			wstr_buff[i] = row_ptr->string[col]->code;
 		}
+		col = 0;
 	}
 	wstr_buff[i] = 0;
 	return i;
@@ -1192,6 +1418,134 @@ void TextLayer_ReloadCharBitmap(LCUI_TextLayer layer)
 	}
 }
 
+/** 释放指定范围外的文本行的字形位图缓存 */
+static void TextLayer_ReleaseRowCache(LCUI_TextLayer layer, int start_row,
+				      int end_row)
+{
+	int row;
+
+	for (row = 0; row < layer->text_rows.length; ++row) {
+		if (row < start_row || row > end_row) {
+			TextRowList_ClearCache(&layer->text_rows,
+					       layer->text_rows.rows[row]);
+		}
+	}
+}
+
+/**
+ * 生成文本行的字形位图缓存
+ * 重叠的字形按 a + b - a * b / 255 合并覆盖率，与逐个混合文字的结果一致
+ * @returns 文本行不能使用缓存时返回 FALSE
+ */
+static LCUI_BOOL TextLayer_UpdateRowCache(LCUI_TextLayer layer,
+					  LCUI_TextRow txtrow, int start_row,
+					  int end_row)
+{
+	size_t size;
+	int col, x, y, i, baseline, left, top, right, bottom;
+	uchar_t *src, *dst;
+	LCUI_Pos pos;
+	LCUI_TextChar txtchar;
+	const LCUI_FontBitmap *bmp;
+	LCUI_FontBitmap *cache = &txtrow->bitmap;
+
+	if (cache->buffer) {
+		return TRUE;
+	}
+	left = top = 0;
+	right = txtrow->width;
+	bottom = txtrow->height;
+	baseline = txtrow->text_height * 4 / 5;
+	baseline += (txtrow->height - baseline) / 2;
+	for (x = 0, col = 0; col < txtrow->length; ++col) {
+		txtchar = txtrow->string[col];
+		if (txtchar->style && (txtchar->style->has_fore_color ||
+				       txtchar->style->has_back_color)) {
+			return FALSE;
+		}
+		bmp = txtchar->bitmap;
+		if (!bmp) {
+			continue;
+		}
+		left = min(left, x + bmp->left);
+		top = min(top, baseline - bmp->top);
+		right = max(right, x + bmp->left + bmp->width);
+		bottom = max(bottom, baseline - bmp->top + bmp->rows);
+		x += bmp->advance.x;
+	}
+	size = (size_t)(right - left) * (bottom - top);
+	if (size < 1 || size > MAX_ROW_CACHE_SIZE) {
+		return FALSE;
+	}
+	if (layer->text_rows.cache_size + size > MAX_ROW_CACHE_SIZE) {
+		TextLayer_ReleaseRowCache(layer, start_row, end_row);
+		if (layer->text_rows.cache_size + size > MAX_ROW_CACHE_SIZE) {
+			return FALSE;
+		}
+	}
+	if (FontBitmap_Create(cache, right - left, bottom - top) != 0) {
+		FontBitmap_Init(cache);
+		return FALSE;
+	}
+	memset(cache->buffer, 0, size);
+	cache->left = left;
+	cache->top = top;
+	for (x = 0, col = 0; col < txtrow->length; ++col) {
+		bmp = txtrow->string[col]->bitmap;
+		if (!bmp) {
+			continue;
+		}
+		pos.x = x + bmp->left - left;
+		pos.y = baseline - bmp->top - top;
+		for (y = 0; y < bmp->rows; ++y) {
+			src = bmp->buffer + y * bmp->width;
+			dst = cache->buffer + (pos.y + y) * cache->width + pos.x;
+			for (i = 0; i < bmp->width; ++i) {
+				dst[i] = (uchar_t)(dst[i] + src[i] -
+						   dst[i] * src[i] / 255);
+			}
+		}
+		x += bmp->advance.x;
+	}
+	layer->text_rows.cache_size += size;
+	return TRUE;
+}
+
+/**
+ * 生成可见文本行的字形位图缓存
+ * 缓存只在主线程更新文本图层时生成和释放，绘制时只读取缓存，所以渲染线程可以
+ * 同时绘制同一个文本图层的不同区域
+ */
+static void TextLayer_UpdateRowCaches(LCUI_TextLayer layer)
+{
+	int y, row, start_row, end_row;
+	LCUI_TextRow txtrow;
+
+	if (!layer->enable_row_cache) {
+		return;
+	}
+	start_row = -1;
+	end_row = -1;
+	y = layer->offset_y;
+	for (row = 0; row < layer->text_rows.length; ++row) {
+		txtrow = layer->text_rows.rows[row];
+		if (layer->fixed_height > 0 && y >= layer->fixed_height) {
+			break;
+		}
+		if (y + txtrow->height > 0) {
+			if (start_row < 0) {
+				start_row = row;
+			}
+			end_row = row;
+		}
+		y += txtrow->height;
+	}
+	for (row = start_row; start_row >= 0 && row <= end_row; ++row) {
+		TextLayer_UpdateRowCache(layer, layer->text_rows.rows[row],
+					 start_row, end_row);
+	}
+}
+
 void TextLayer_Update(LCUI_TextLayer layer, LinkedList *rects)
 {
 	if (layer->task.update_bitmap) {
@@ -1216,6 +1570,7 @@ void TextLayer_Update(LCUI_TextLayer layer, LinkedList *rects)
 		TextLayer_InvalidateRowsRect(layer, 0, -1);
 		layer->task.redraw_all = TRUE;
 	}
+	TextLayer_UpdateRowCaches(layer);
 	if (rects) {
 		LinkedList_Concat(rects, &layer->dirty_rects);
 	}
@@ -1252,6 +1607,27 @@ static void TextLayer_DrawChar(LCUI_TextLayer layer, LCUI_TextChar ch,
 	}
 }
 
+/** 用字形位图缓存绘制文本行，只绘制在区域内的部分 */
+static void TextLayer_DrawRowCache(LCUI_TextLayer layer, LCUI_Rect *area,
+				   LCUI_Graph *graph, LCUI_Pos layer_pos,
+				   LCUI_TextRow txtrow, int y)
+{
+	int x;
+	LCUI_Pos pos;
+	LCUI_Rect rect;
+	LCUI_Graph slot;
+
+	x = TextLayer_GetRowStartX(layer, txtrow) + layer->offset_x;
+	rect = *area;
+	rect.x += layer_pos.x;
+	rect.y += layer_pos.y;
+	Graph_Quote(&slot, graph, &rect);
+	pos.x = x + txtrow->bitmap.left - area->x;
+	pos.y = y + txtrow->bitmap.top - area->y;
+	FontBitmap_Mix(&slot, pos, &txtrow->bitmap,
+		       layer->text_default_style.fore_color);
+}
+
 static void TextLayer_DrawTextRow(LCUI_TextLayer layer, LCUI_Rect *area,
 				  LCUI_Graph *graph, LCUI_Pos layer_pos,
 				  LCUI_TextRow txtrow, int y)
@@ -1333,8 +1709,14 @@ int TextLayer_RenderTo(LCUI_TextLayer layer, LCUI_Rect area, LCUI_Pos layer_pos,
 	}
 	for (; row < layer->text_rows.length; ++row) {
 		txtrow = TextLayer_GetRow(layer, row);
-		TextLayer_DrawTextRow(layer, &area, canvas, layer_pos, txtrow,
-				      y);
+		/* 缓存只在更新时生成，这里只读取，以便多个线程同时绘制 */
+		if (layer->enable_row_cache && txtrow->bitmap.buffer) {
+			TextLayer_DrawRowCache(layer, &area, canvas, layer_pos,
+					       txtrow, y);
+		} else {
+			TextLayer_DrawTextRow(layer, &area, canvas, layer_pos,
+					      txtrow, y);
+		}
 		y += txtrow->height;
 		/* 超出绘制区域范围就不绘制了 */
 		if (y > area.y + area.height) {
@@ -1344,6 +1726,16 @@ int TextLayer_RenderTo(LCUI_TextLayer layer, LCUI_Rect area, LCUI_Pos layer_pos,
 	return 0;
 }
 
+void TextLayer_EnableRowCache(LCUI_TextLayer layer, LCUI_BOOL enabled)
+{
+	layer->enable_row_cache = enabled;
+	if (enabled) {
+		TextLayer_UpdateRowCaches(layer);
+	} else {
+		TextLayer_ReleaseRowCache(layer, 0, -1);
+	}
+}
+
 /** 清除已记录的无效矩形 */
 void TextLayer_ClearInvalidRect(LCUI_TextLayer layer)
 {
@@ -36,6 +36,143 @@
 #include <LCUI/types.h>
 #include <LCUI/util.h>
 #include <LCUI/graph.h>
+#include "graph_simd.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AtomicIncrement(P) _InterlockedIncrement(P)
+#define AtomicDecrement(P) _InterlockedDecrement(P)
+#ifdef _WIN64
+#define AtomicAdd(P, N) _InterlockedExchangeAdd64(P, N)
+typedef __int64 counter_t;
+#else
+#define AtomicAdd(P, N) _InterlockedExchangeAdd(P, N)
+typedef long counter_t;
+#endif
+#else
+#define AtomicIncrement(P) __sync_add_and_fetch(P, 1)
+#define AtomicDecrement(P) __sync_sub_and_fetch(P, 1)
+#define AtomicAdd(P, N) __sync_fetch_and_add(P, N)
+typedef long counter_t;
+#endif
+
+/**
+ * 像素数据存储
+ * 自行分配的像素数据紧跟在该结构体之后，外部的像素数据由 release() 释放
+ */
+typedef struct LCUI_GraphBufferRec_ {
+	volatile long refs;
+	unsigned long id;
+	size_t size;
+	uchar_t *bytes;
+	void (*release)(void *);
+	void *release_arg;
+} LCUI_GraphBufferRec;
+
+static struct GraphMemoryStats {
+	volatile counter_t buffers;
+	volatile counter_t shared_buffers;
+	volatile counter_t unique_bytes;
+	volatile counter_t shared_bytes;
+	volatile counter_t saved_bytes;
+} graph_stats;
+
+/** 最近分配的存储的标识号，每份存储的标识号都不同 */
+static volatile counter_t graph_buffer_id;
+
+#define GraphBuffer_GetBytes(BUF) ((BUF)->bytes)
+
+/**
+ * 填充的区域不小于这个字节数时，绕过缓存写入像素
+ * 这么大的区域在填充完后基本不在缓存中了，直接写入内存可以省去读取缓存行
+ */
+#define GRAPH_STREAM_FILL_SIZE (4 * 1024 * 1024)
+
+/** 翻转操作的源像素行和目标像素行 */
+typedef struct GraphFlipRec_ {
+	uchar_t *src;
+	uchar_t *des;
+	size_t src_bytes_per_row;
+	size_t des_bytes_per_row;
+	size_t row_size;
+	int width;
+	int height;
+	LCUI_BOOL in_place;
+} GraphFlipRec;
+
+static LCUI_GraphBuffer GraphBuffer_Create(size_t size)
+{
+	LCUI_GraphBuffer buf;
+
+	buf = calloc(1, sizeof(LCUI_GraphBufferRec) + size);
+	if (!buf) {
+		return NULL;
+	}
+	buf->refs = 1;
+	buf->id = (unsigned long)AtomicIncrement(&graph_buffer_id);
+	buf->size = size;
+	buf->bytes = (uchar_t *)(buf + 1);
+	buf->release = NULL;
+	buf->release_arg = NULL;
+	AtomicAdd(&graph_stats.buffers, 1);
+	AtomicAdd(&graph_stats.unique_bytes, (counter_t)size);
+	return buf;
+}
+
+static void GraphBuffer_Acquire(LCUI_GraphBuffer buf)
+{
+	counter_t size = (counter_t)buf->size;
+
+	if (AtomicIncrement(&buf->refs) == 2) {
+		AtomicAdd(&graph_stats.shared_buffers, 1);
+		AtomicAdd(&graph_stats.unique_bytes, -size);
+		AtomicAdd(&graph_stats.shared_bytes, size);
+	}
+	AtomicAdd(&graph_stats.saved_bytes, size);
+}
+
+static void GraphBuffer_Release(LCUI_GraphBuffer buf)
+{
+	long refs;
+	counter_t size = (counter_t)buf->size;
+
+	refs = AtomicDecrement(&buf->refs);
+	if (refs == 0) {
+		AtomicAdd(&graph_stats.buffers, -1);
+		AtomicAdd(&graph_stats.unique_bytes, -size);
+		if (buf->release) {
+			buf->release(buf->release_arg);
+		}
+		free(buf);
+		return;
+	}
+	if (refs == 1) {
+		AtomicAdd(&graph_stats.shared_buffers, -1);
+		AtomicAdd(&graph_stats.shared_bytes, -size);
+		AtomicAdd(&graph_stats.unique_bytes, size);
+	}
+	AtomicAdd(&graph_stats.saved_bytes, -size);
+}
+
+/** 将图像的像素数据替换为新的存储，并释放旧的存储 */
+static void Graph_SetBuffer(LCUI_Graph *graph, LCUI_GraphBuffer buf)
+{
+	if (graph->buffer) {
+		GraphBuffer_Release(graph->buffer);
+	}
+	graph->buffer = buf;
+	graph->bytes = GraphBuffer_GetBytes(buf);
+	graph->mem_size = buf->size;
+}
+
+void Graph_GetMemoryStats(LCUI_GraphMemoryStats stats)
+{
+	stats->buffers = (size_t)graph_stats.buffers;
+	stats->shared_buffers = (size_t)graph_stats.shared_buffers;
+	stats->unique_bytes = (size_t)graph_stats.unique_bytes;
+	stats->shared_bytes = (size_t)graph_stats.shared_bytes;
+	stats->saved_bytes = (size_t)graph_stats.saved_bytes;
+}
 
 void Graph_PrintInfo(LCUI_Graph *graph)
 {
@@ -64,6 +201,7 @@ void Graph_Init(LCUI_Graph *graph)
 	graph->palette = NULL;
 	graph->color_type = LCUI_COLOR_TYPE_RGB;
 	graph->bytes = NULL;
+	graph->buffer = NULL;
 	graph->opacity = 1.0;
 	graph->mem_size = 0;
 	graph->width = 0;
@@ -180,15 +318,16 @@ void PixelsFormat(const uchar_t *in_pixels, int in_color_type,
 static int Graph_RGBToARGB(LCUI_Graph *graph)
 {
 	size_t x, y;
-	LCUI_ARGB *px_des, *px_row_des, *buffer;
+	LCUI_ARGB *px_des, *px_row_des;
 	uchar_t *byte_row_src, *byte_src;
+	LCUI_GraphBuffer buffer;
 
-	graph->mem_size = sizeof(LCUI_ARGB) * graph->width * graph->height;
-	buffer = malloc(graph->mem_size);
+	buffer = GraphBuffer_Create(sizeof(LCUI_ARGB) * graph->width *
+				    graph->height);
 	if (!buffer) {
 		return -ENOMEM;
 	}
-	px_row_des = buffer;
+	px_row_des = (LCUI_ARGB *)GraphBuffer_GetBytes(buffer);
 	byte_row_src = graph->bytes;
 	for (y = 0; y < graph->height; ++y) {
 		px_des = px_row_des;
@@ -203,14 +342,85 @@ static int Graph_RGBToARGB(LCUI_Graph *graph)
 		byte_row_src += graph->bytes_per_row;
 		px_row_des += graph->width;
 	}
-	free(graph->argb);
-	graph->argb = buffer;
+	Graph_SetBuffer(graph, buffer);
 	graph->color_type = LCUI_COLOR_TYPE_ARGB8888;
+	graph->bytes_per_pixel = 4;
+	graph->bytes_per_row = graph->width * 4;
 	return 0;
 }
 
-static int Graph_CutRGB(const LCUI_Graph *graph, LCUI_Rect rect,
-			LCUI_Graph *buff)
+/**
+ * 准备翻转图像，buff 与 graph 相同时在原图像上翻转
+ * 如果 graph 是引用，则原地翻转的是引用源中的该区域
+ */
+static int Graph_BeginFlip(const LCUI_Graph *graph, LCUI_Graph *buff,
+			   GraphFlipRec *flip)
+{
+	LCUI_Rect rect;
+	LCUI_Graph *des;
+	const LCUI_Graph *src;
+
+	if (!Graph_IsValid(graph)) {
+		return -1;
+	}
+	Graph_GetValidRect(graph, &rect);
+	flip->in_place = graph == buff;
+	if (flip->in_place) {
+		if (!Graph_IsWritable(buff) || Graph_Detach(buff) != 0) {
+			return -2;
+		}
+	}
+	src = Graph_GetQuote(graph);
+	if (!flip->in_place) {
+		buff->opacity = src->opacity;
+		buff->color_type = src->color_type;
+		if (0 != Graph_Create(buff, rect.width, rect.height)) {
+			return -2;
+		}
+	}
+	des = Graph_GetQuote(buff);
+	flip->width = rect.width;
+	flip->height = rect.height;
+	flip->row_size = rect.width * src->bytes_per_pixel;
+	flip->src_bytes_per_row = src->bytes_per_row;
+	flip->des_bytes_per_row = des->bytes_per_row;
+	flip->src = src->bytes + rect.y * src->bytes_per_row;
+	flip->src += rect.x * src->bytes_per_pixel;
+	flip->des = flip->in_place ? flip->src : des->bytes;
+	return 0;
+}
+
+static int Graph_VertiFlipRows(const LCUI_Graph *graph, LCUI_Graph *buff)
+{
+	int y;
+	GraphFlipRec flip;
+	uchar_t *byte_src, *byte_des;
+	const GraphKernelsRec *kernels = Graph_GetKernels();
+
+	if (Graph_BeginFlip(graph, buff, &flip) != 0) {
+		return -1;
+	}
+	/* 引用最后一行像素 */
+	byte_src = flip.src + (flip.height - 1) * flip.src_bytes_per_row;
+	byte_des = flip.des;
+	/* 交换上下每行像素 */
+	if (flip.in_place) {
+		for (; byte_des < byte_src; byte_des += flip.des_bytes_per_row) {
+			kernels->swap(byte_des, byte_src, flip.row_size);
+			byte_src -= flip.src_bytes_per_row;
+		}
+		return 0;
+	}
+	for (y = 0; y < flip.height; ++y) {
+		memcpy(byte_des, byte_src, flip.row_size);
+		byte_src -= flip.src_bytes_per_row;
+		byte_des += flip.des_bytes_per_row;
+	}
+	return 0;
+}
+
+static int Graph_CutRows(const LCUI_Graph *graph, LCUI_Rect rect,
+			 LCUI_Graph *buff)
 {
 	int y;
 	uchar_t *byte_src_row, *byte_des_row;
@@ -224,7 +434,8 @@ static int Graph_CutRGB(const LCUI_Graph *graph, LCUI_Rect rect,
 	byte_src_row = graph->bytes + rect.y * graph->bytes_per_row;
 	byte_src_row += rect.x * graph->bytes_per_pixel;
 	for (y = 0; y < rect.height; ++y) {
-		memcpy(byte_des_row, byte_src_row, buff->bytes_per_row);
+		memcpy(byte_des_row, byte_src_row,
+		       rect.width * graph->bytes_per_pixel);
 		byte_des_row += buff->bytes_per_row;
 		byte_src_row += graph->bytes_per_row;
 	}
@@ -260,7 +471,7 @@ static void Graph_ReplaceRGB(LCUI_Graph *des, LCUI_Rect des_rect,
 	byte_row_src += src_x * src->bytes_per_pixel;
 	byte_row_des += des_rect.x * src->bytes_per_pixel;
 	for (y = 0; y < des_rect.height; ++y) {
-		memcpy(byte_row_des, byte_row_src, des->bytes_per_row);
+		memcpy(byte_row_des, byte_row_src, des_rect.width * 3);
 		byte_row_src += src->bytes_per_row;
 		byte_row_des += des->bytes_per_row;
 	}
@@ -271,60 +482,32 @@ static void Graph_ReplaceRGB(LCUI_Graph *des, LCUI_Rect des_rect,
 static int Graph_HorizFlipRGB(const LCUI_Graph *graph, LCUI_Graph *buff)
 {
 	int x, y;
-	size_t n_bytes;
-	LCUI_Rect rect;
+	uchar_t tmp[3];
+	GraphFlipRec flip;
 	uchar_t *byte_src, *byte_des;
 
-	if (!Graph_IsValid(graph)) {
+	if (Graph_BeginFlip(graph, buff, &flip) != 0) {
 		return -1;
 	}
-	Graph_GetValidRect(graph, &rect);
-	graph = Graph_GetQuote(graph);
-	buff->color_type = graph->color_type;
-	if (0 != Graph_Create(buff, rect.width, rect.height)) {
-		return -2;
-	}
-
-	for (y = 0; y < rect.height; ++y) {
-		byte_des = buff->bytes + y * buff->bytes_per_row;
-		n_bytes = (rect.y + y) * graph->bytes_per_row;
-		n_bytes += (rect.x + rect.width - 1) * 3;
-		byte_src = buff->bytes + n_bytes;
-		for (x = 0; x < rect.width; ++x) {
-			*byte_des++ = *byte_src--;
-			*byte_des++ = *byte_src--;
-			*byte_des++ = *byte_src--;
+	for (y = 0; y < flip.height; ++y) {
+		byte_des = flip.des;
+		byte_src = flip.src + flip.row_size - 3;
+		if (flip.in_place) {
+			for (; byte_des < byte_src; byte_des += 3) {
+				memcpy(tmp, byte_des, 3);
+				memcpy(byte_des, byte_src, 3);
+				memcpy(byte_src, tmp, 3);
+				byte_src -= 3;
+			}
+		} else {
+			for (x = 0; x < flip.width; ++x) {
+				memcpy(byte_des, byte_src, 3);
+				byte_des += 3;
+				byte_src -= 3;
+			}
 		}
-	}
-	return 0;
-}
-
-static int Graph_VertiFlipRGB(const LCUI_Graph *graph, LCUI_Graph *buff)
-{
-	int y;
-	LCUI_Rect rect;
-	uchar_t *byte_src, *byte_des;
-
-	if (!Graph_IsValid(graph)) {
-		return -1;
-	}
-	Graph_GetValidRect(graph, &rect);
-	graph = Graph_GetQuote(graph);
-	buff->opacity = graph->opacity;
-	buff->color_type = graph->color_type;
-	if (0 != Graph_Create(buff, rect.width, rect.height)) {
-		return -2;
-	}
-	/* 引用最后一行像素 */
-	byte_src = graph->bytes;
-	byte_src += (rect.y + rect.height - 1) * graph->bytes_per_row;
-	byte_src += rect.x * graph->bytes_per_pixel;
-	byte_des = buff->bytes;
-	/* 交换上下每行像素 */
-	for (y = 0; y < rect.height; ++y) {
-		memcpy(byte_des, byte_src, buff->bytes_per_row);
-		byte_src -= graph->bytes_per_row;
-		byte_des += buff->bytes_per_row;
+		flip.src += flip.src_bytes_per_row;
+		flip.des += flip.des_bytes_per_row;
 	}
 	return 0;
 }
@@ -332,9 +515,11 @@ static int Graph_VertiFlipRGB(const LCUI_Graph *graph, LCUI_Graph *buff)
 static int Graph_FillRectRGB(LCUI_Graph *graph, LCUI_Color color,
 			     LCUI_Rect rect)
 {
-	int x, y;
+	int y;
 	LCUI_Graph canvas;
-	uchar_t *rowbytep, *bytep;
+	uchar_t *rowbytep;
+	uchar_t bgr[3] = { color.blue, color.green, color.red };
+	const GraphKernelsRec *kernels = Graph_GetKernels();
 
 	if (!Graph_IsValid(graph)) {
 		return -1;
@@ -345,12 +530,7 @@ static int Graph_FillRectRGB(LCUI_Graph *graph, LCUI_Color color,
 	rowbytep = graph->bytes + rect.y * graph->bytes_per_row;
 	rowbytep += rect.x * graph->bytes_per_pixel;
 	for (y = 0; y < rect.height; ++y) {
-		bytep = rowbytep;
-		for (x = 0; x < rect.width; ++x) {
-			*bytep++ = color.blue;
-			*bytep++ = color.green;
-			*bytep++ = color.red;
-		}
+		kernels->fill24(rowbytep, bgr, rect.width);
 		rowbytep += graph->bytes_per_row;
 	}
 	return 0;
@@ -364,55 +544,32 @@ static int Graph_ARGBToRGB(LCUI_Graph *graph)
 {
 	size_t x, y;
 	LCUI_ARGB *px_src, *px_row_src;
-	uchar_t *buffer, *byte_row_des, *byte_des;
+	uchar_t *byte_row_des, *byte_des;
+	LCUI_GraphBuffer buffer;
 
-	graph->mem_size = sizeof(uchar_t) * graph->width * graph->height * 3;
-	buffer = malloc(graph->mem_size);
+	buffer = GraphBuffer_Create(sizeof(uchar_t) * graph->width *
+				    graph->height * 3);
 	if (!buffer) {
 		return -1;
 	}
-	byte_row_des = buffer;
+	byte_row_des = GraphBuffer_GetBytes(buffer);
 	px_row_src = graph->argb;
 	for (y = 0; y < graph->height; ++y) {
 		px_src = px_row_src;
 		byte_des = byte_row_des;
 		for (x = 0; x < graph->width; ++x) {
-			px_src->b = *byte_des++;
-			px_src->g = *byte_des++;
-			px_src->r = *byte_des++;
-			px_src->a = 255;
+			*byte_des++ = px_src->b;
+			*byte_des++ = px_src->g;
+			*byte_des++ = px_src->r;
 			++px_src;
 		}
-		byte_row_des += graph->bytes_per_row;
+		byte_row_des += graph->width * 3;
 		px_row_src += graph->width;
 	}
-	free(graph->argb);
-	graph->bytes = buffer;
+	Graph_SetBuffer(graph, buffer);
 	graph->color_type = LCUI_COLOR_TYPE_RGB888;
 	graph->bytes_per_pixel = 3;
-	return 0;
-}
-
-static int Graph_CutARGB(const LCUI_Graph *graph, LCUI_Rect rect,
-			 LCUI_Graph *buff)
-{
-	int x, y;
-	LCUI_ARGB *pixel_src, *pixel_des;
-
-	buff->color_type = graph->color_type;
-	if (0 != Graph_Create(buff, rect.width, rect.height)) {
-		return -1;
-	}
-
-	buff->opacity = graph->opacity;
-	for (y = 0; y < rect.height; ++y) {
-		pixel_des = buff->argb + y * buff->width;
-		pixel_src = graph->argb;
-		pixel_src += (rect.y + y) * graph->width + rect.x;
-		for (x = 0; x < rect.width; ++x) {
-			*pixel_des++ = *pixel_src++;
-		}
-	}
+	graph->bytes_per_row = graph->width * 3;
 	return 0;
 }
 
@@ -600,6 +757,8 @@ static int Graph_ReplaceARGB(LCUI_Graph *des, LCUI_Rect des_rect,
 			px_des->g = px_src->g;
 			px_des->r = px_src->r;
 			px_des->a = (uchar_t)(src->opacity * px_src->a);
+			++px_src;
+			++px_des;
 		}
 		px_row_src += src->width;
 		px_row_des += des->width;
@@ -608,57 +767,25 @@ static int Graph_ReplaceARGB(LCUI_Graph *des, LCUI_Rect des_rect,
 }
 
 static int Graph_HorizFlipARGB(const LCUI_Graph *graph, LCUI_Graph *buff)
-{
-	int x, y;
-	LCUI_Rect rect;
-	LCUI_ARGB *pixel_src, *pixel_des;
-
-	if (!Graph_IsValid(graph)) {
-		return -1;
-	}
-	Graph_GetValidRect(graph, &rect);
-	graph = Graph_GetQuote(graph);
-	buff->opacity = graph->opacity;
-	buff->color_type = graph->color_type;
-	if (0 != Graph_Create(buff, rect.width, rect.height)) {
-		return -2;
-	}
-
-	for (y = 0; y < rect.height; ++y) {
-		pixel_des = buff->argb + y * buff->width;
-		pixel_src = graph->argb + (rect.y + y) * graph->width;
-		pixel_src += rect.x + rect.width - 1;
-		for (x = 0; x < rect.width; ++x) {
-			*pixel_des++ = *pixel_src--;
-		}
-	}
-	return 0;
-}
-
-static int Graph_VertiFlipARGB(const LCUI_Graph *graph, LCUI_Graph *buff)
 {
 	int y;
-	LCUI_Rect rect;
-	uchar_t *byte_src, *byte_des;
+	GraphFlipRec flip;
+	const GraphKernelsRec *kernels = Graph_GetKernels();
 
-	if (!Graph_IsValid(graph)) {
+	if (Graph_BeginFlip(graph, buff, &flip) != 0) {
 		return -1;
 	}
-	Graph_GetValidRect(graph, &rect);
-	graph = Graph_GetQuote(graph);
-	buff->opacity = graph->opacity;
-	buff->color_type = graph->color_type;
-	if (0 != Graph_Create(buff, rect.width, rect.height)) {
-		return -2;
-	}
-	byte_src = graph->bytes;
-	byte_src += (rect.y + rect.height - 1) * graph->bytes_per_row;
-	byte_src += rect.x * graph->bytes_per_pixel;
-	byte_des = buff->bytes;
-	for (y = 0; y < rect.height; ++y) {
-		memcpy(byte_des, byte_src, buff->bytes_per_row);
-		byte_src -= graph->bytes_per_row;
-		byte_des += buff->bytes_per_row;
+	for (y = 0; y < flip.height; ++y) {
+		if (flip.in_place) {
+			kernels->reverse32_inplace((uint32_t *)flip.des,
+						   flip.width);
+		} else {
+			kernels->reverse32((uint32_t *)flip.des,
+					   (const uint32_t *)flip.src,
+					   flip.width);
+		}
+		flip.src += flip.src_bytes_per_row;
+		flip.des += flip.des_bytes_per_row;
 	}
 	return 0;
 }
@@ -666,9 +793,12 @@ static int Graph_VertiFlipARGB(const LCUI_Graph *graph, LCUI_Graph *buff)
 static int Graph_FillRectARGB(LCUI_Graph *graph, LCUI_Color color,
 			      LCUI_Rect rect, LCUI_BOOL with_alpha)
 {
-	int x, y;
+	int y;
 	LCUI_Graph canvas;
-	LCUI_ARGB *pixel, *pixel_row;
+	LCUI_ARGB *pixel_row;
+	uint32_t value = (uint32_t)color.value;
+	const GraphKernelsRec *kernels = Graph_GetKernels();
+	void (*fill)(uint32_t *, uint32_t, size_t) = kernels->fill32;
 
 	if (!Graph_IsValid(graph)) {
 		return -1;
@@ -677,23 +807,22 @@ static int Graph_FillRectARGB(LCUI_Graph *graph, LCUI_Color color,
 	Graph_GetValidRect(&canvas, &rect);
 	graph = Graph_GetQuote(&canvas);
 	pixel_row = graph->argb + rect.y * graph->width + rect.x;
-	if (with_alpha) {
-		for (y = 0; y < rect.height; ++y) {
-			pixel = pixel_row;
-			for (x = 0; x < rect.width; ++x) {
-				*pixel++ = color;
-			}
-			pixel_row += graph->width;
-		}
-	} else {
-		for (y = 0; y < rect.height; ++y) {
-			pixel = pixel_row;
-			for (x = 0; x < rect.width; ++x) {
-				color.alpha = pixel->alpha;
-				*pixel++ = color;
-			}
-			pixel_row += graph->width;
-		}
+	if (!with_alpha) {
+		value &= 0x00ffffff;
+		fill = kernels->fill32_rgb;
+	} else if ((size_t)rect.width * rect.height * 4 >=
+		   GRAPH_STREAM_FILL_SIZE) {
+		fill = kernels->fill32_stream;
+	}
+	/* 整行填充时，这些行的像素是连续的，可以一次填充完 */
+	if (rect.width == (int)graph->width) {
+		fill((uint32_t *)pixel_row, value,
+		     (size_t)rect.width * rect.height);
+		return 0;
+	}
+	for (y = 0; y < rect.height; ++y) {
+		fill((uint32_t *)pixel_row, value, rect.width);
+		pixel_row += graph->width;
 	}
 	return 0;
 }
@@ -750,8 +879,11 @@ int Graph_Create(LCUI_Graph *graph, unsigned width, unsigned height)
 	graph->bytes_per_row = graph->bytes_per_pixel * width;
 	size = graph->bytes_per_row * height;
 	if (Graph_IsValid(graph)) {
-		/* 如果现有图形尺寸大于要创建的图形的尺寸，直接改尺寸即可 */
-		if (graph->mem_size >= size) {
+		/*
+		 * 如果现有图形尺寸大于要创建的图形的尺寸，且像素数据没有被
+		 * 共享，直接改尺寸即可
+		 */
+		if (graph->mem_size >= size && !Graph_IsShared(graph)) {
 			memset(graph->bytes, 0, graph->mem_size);
 			graph->width = width;
 			graph->height = height;
@@ -759,13 +891,44 @@ int Graph_Create(LCUI_Graph *graph, unsigned width, unsigned height)
 		}
 		Graph_Free(graph);
 	}
-	graph->mem_size = size;
-	graph->bytes = calloc(1, size);
-	if (!graph->bytes) {
+	graph->buffer = GraphBuffer_Create(size);
+	if (!graph->buffer) {
 		graph->width = 0;
 		graph->height = 0;
 		return -2;
 	}
+	graph->bytes = GraphBuffer_GetBytes(graph->buffer);
+	graph->mem_size = size;
+	graph->width = width;
+	graph->height = height;
+	return 0;
+}
+
+int Graph_CreateFromMemory(LCUI_Graph *graph, unsigned width,
+			   unsigned height, void *bytes,
+			   void (*release)(void *), void *arg)
+{
+	LCUI_GraphBuffer buf;
+
+	if (width < 1 || height < 1 || width > 10000 || height > 10000) {
+		return -EINVAL;
+	}
+	buf = malloc(sizeof(LCUI_GraphBufferRec));
+	if (!buf) {
+		return -ENOMEM;
+	}
+	Graph_Free(graph);
+	buf->refs = 1;
+	buf->id = (unsigned long)AtomicIncrement(&graph_buffer_id);
+	buf->bytes = bytes;
+	buf->release = release;
+	buf->release_arg = arg;
+	graph->bytes_per_pixel = get_pixel_size(graph->color_type);
+	graph->bytes_per_row = graph->bytes_per_pixel * width;
+	buf->size = graph->bytes_per_row * height;
+	AtomicAdd(&graph_stats.buffers, 1);
+	AtomicAdd(&graph_stats.unique_bytes, (counter_t)buf->size);
+	Graph_SetBuffer(graph, buf);
 	graph->width = width;
 	graph->height = height;
 	return 0;
@@ -787,6 +950,25 @@ void Graph_Copy(LCUI_Graph *des, const LCUI_Graph *src)
 		return;
 	}
 	graph = Graph_GetQuote(src);
+	if (des == graph) {
+		return;
+	}
+	/* 如果复制的是整个图像，则共享像素数据，等到写入时再复制 */
+	if (graph->buffer && src->width == graph->width &&
+	    src->height == graph->height) {
+		GraphBuffer_Acquire(graph->buffer);
+		Graph_Free(des);
+		des->buffer = graph->buffer;
+		des->bytes = graph->bytes;
+		des->mem_size = graph->mem_size;
+		des->width = graph->width;
+		des->height = graph->height;
+		des->color_type = graph->color_type;
+		des->bytes_per_pixel = graph->bytes_per_pixel;
+		des->bytes_per_row = graph->bytes_per_row;
+		des->opacity = src->opacity;
+		return;
+	}
 	des->color_type = graph->color_type;
 	/* 创建合适尺寸的Graph */
 	Graph_Create(des, src->width, src->height);
@@ -802,15 +984,46 @@ void Graph_Free(LCUI_Graph *graph)
 		graph->quote.is_valid = FALSE;
 		return;
 	}
-	if (graph->bytes) {
-		free(graph->bytes);
-		graph->bytes = NULL;
+	/* 没有存储的像素数据来自外部，例如帧缓冲，不需要释放 */
+	if (graph->buffer) {
+		GraphBuffer_Release(graph->buffer);
+		graph->buffer = NULL;
 	}
+	graph->bytes = NULL;
 	graph->width = 0;
 	graph->height = 0;
 	graph->mem_size = 0;
 }
 
+unsigned long Graph_GetBufferId(const LCUI_Graph *graph)
+{
+	graph = Graph_GetQuote(graph);
+	return graph && graph->buffer ? graph->buffer->id : 0;
+}
+
+LCUI_BOOL Graph_IsShared(const LCUI_Graph *graph)
+{
+	graph = Graph_GetQuote(graph);
+	return graph && graph->buffer && graph->buffer->refs > 1;
+}
+
+int Graph_Detach(LCUI_Graph *graph)
+{
+	LCUI_GraphBuffer buf;
+
+	graph = Graph_GetQuote(graph);
+	if (!graph || !graph->buffer || graph->buffer->refs < 2) {
+		return 0;
+	}
+	buf = GraphBuffer_Create(graph->buffer->size);
+	if (!buf) {
+		return -ENOMEM;
+	}
+	memcpy(GraphBuffer_GetBytes(buf), graph->bytes, buf->size);
+	Graph_SetBuffer(graph, buf);
+	return 0;
+}
+
 int Graph_QuoteReadOnly(LCUI_Graph *self, const LCUI_Graph *source,
 			const LCUI_Rect *rect)
 {
@@ -843,6 +1056,7 @@ int Graph_QuoteReadOnly(LCUI_Graph *self, const LCUI_Graph *source,
 	}
 	self->opacity = 1.0;
 	self->bytes = NULL;
+	self->buffer = NULL;
 	self->mem_size = 0;
 	self->width = quote_rect.width;
 	self->height = quote_rect.height;
@@ -861,6 +1075,10 @@ int Graph_Quote(LCUI_Graph *self, LCUI_Graph *source, const LCUI_Rect *rect)
 {
 	int ret = Graph_QuoteReadOnly(self, source, rect);
 	self->quote.is_writable = TRUE;
+	/* 写入引用的区域前，需要让引用源独占像素数据 */
+	if (ret == 0) {
+		Graph_Detach(self->quote.source);
+	}
 	return ret;
 }
 
@@ -886,6 +1104,7 @@ int Graph_SetAlphaBits(LCUI_Graph *graph, uchar_t *a, size_t size)
 	if (graph->color_type != LCUI_COLOR_TYPE_ARGB) {
 		return -2;
 	}
+	Graph_Detach(graph);
 	for (i = 0; i < size; ++i) {
 		graph->argb[i].a = a[i];
 	}
@@ -900,6 +1119,7 @@ int Graph_SetRedBits(LCUI_Graph *graph, uchar_t *r, size_t size)
 	if (size > (size_t)(graph->width * graph->height)) {
 		size = (size_t)(graph->width * graph->height);
 	}
+	Graph_Detach(graph);
 	if (graph->color_type == LCUI_COLOR_TYPE_ARGB) {
 		for (i = 0; i < size; ++i) {
 			graph->argb[i].r = r[i];
@@ -922,6 +1142,7 @@ int Graph_SetGreenBits(LCUI_Graph *graph, uchar_t *g, size_t size)
 	if (size > (size_t)(graph->width * graph->height)) {
 		size = (size_t)(graph->width * graph->height);
 	}
+	Graph_Detach(graph);
 	if (graph->color_type == LCUI_COLOR_TYPE_ARGB) {
 		for (i = 0; i < size; ++i) {
 			graph->argb[i].g = g[i];
@@ -944,6 +1165,7 @@ int Graph_SetBlueBits(LCUI_Graph *graph, uchar_t *b, size_t size)
 	if (size > (size_t)(graph->width * graph->height)) {
 		size = (size_t)(graph->width * graph->height);
 	}
+	Graph_Detach(graph);
 	if (graph->color_type == LCUI_COLOR_TYPE_ARGB) {
 		for (i = 0; i < size; ++i) {
 			graph->argb[i].b = b[i];
@@ -1125,11 +1347,15 @@ int Graph_Cut(const LCUI_Graph *graph, LCUI_Rect rect, LCUI_Graph *buff)
 	if (rect.width <= 0 || rect.height <= 0) {
 		return -3;
 	}
+	if (graph->quote.is_valid) {
+		rect.x += graph->quote.left;
+		rect.y += graph->quote.top;
+		graph = graph->quote.source;
+	}
 	switch (graph->color_type) {
 	case LCUI_COLOR_TYPE_ARGB8888:
-		return Graph_CutARGB(graph, rect, buff);
 	case LCUI_COLOR_TYPE_RGB888:
-		return Graph_CutRGB(graph, rect, buff);
+		return Graph_CutRows(graph, rect, buff);
 	default:
 		break;
 	}
@@ -1153,9 +1379,8 @@ int Graph_VertiFlip(const LCUI_Graph *graph, LCUI_Graph *buff)
 {
 	switch (graph->color_type) {
 	case LCUI_COLOR_TYPE_RGB888:
-		return Graph_VertiFlipRGB(graph, buff);
 	case LCUI_COLOR_TYPE_ARGB8888:
-		return Graph_VertiFlipARGB(graph, buff);
+		return Graph_VertiFlipRows(graph, buff);
 	default:
 		break;
 	}
@@ -1198,6 +1423,7 @@ int Graph_FillAlpha(LCUI_Graph *graph, uchar_t alpha)
 	if (!Graph_HasAlpha(graph)) {
 		return -2;
 	}
+	Graph_Detach(graph);
 	pixel_row = graph->argb + rect.y * graph->width + rect.x;
 	for (y = 0; y < rect.height; ++y) {
 		pixel = pixel_row;
@@ -1210,6 +1436,44 @@ int Graph_FillAlpha(LCUI_Graph *graph, uchar_t alpha)
 	return 0;
 }
 
+/**
+ * 以替换的方式平铺时，每个图块都和第一个图块相同，所以只需要写入第一个图块，
+ * 然后在行内成倍地复制已写入的像素，再向下逐行复制
+ */
+static int Graph_TileReplace(LCUI_Graph *buff, const LCUI_Graph *graph)
+{
+	int ret, y, tile_height;
+	size_t x, size, row_size, tile_size;
+	LCUI_Rect rect;
+	LCUI_Graph *canvas;
+	uchar_t *row;
+
+	ret = Graph_Replace(buff, graph, 0, 0);
+	if (ret != 0) {
+		return ret;
+	}
+	Graph_GetValidRect(buff, &rect);
+	canvas = Graph_GetQuote(buff);
+	row = canvas->bytes + rect.y * canvas->bytes_per_row;
+	row += rect.x * canvas->bytes_per_pixel;
+	row_size = rect.width * canvas->bytes_per_pixel;
+	tile_size = min(graph->width, buff->width) * canvas->bytes_per_pixel;
+	tile_height = min(graph->height, buff->height);
+	for (y = 0; y < tile_height; ++y) {
+		for (x = tile_size; x < row_size; x += size) {
+			size = min(x, row_size - x);
+			memcpy(row + x, row, size);
+		}
+		row += canvas->bytes_per_row;
+	}
+	for (; y < rect.height; ++y) {
+		memcpy(row, row - tile_height * canvas->bytes_per_row,
+		       row_size);
+		row += canvas->bytes_per_row;
+	}
+	return 0;
+}
+
 int Graph_Tile(LCUI_Graph *buff, const LCUI_Graph *graph, LCUI_BOOL replace,
 	       LCUI_BOOL with_alpha)
 {
@@ -1219,13 +1483,12 @@ int Graph_Tile(LCUI_Graph *buff, const LCUI_Graph *graph, LCUI_BOOL replace,
 	if (!Graph_IsValid(graph) || !Graph_IsValid(buff)) {
 		return -1;
 	}
+	if (replace) {
+		return Graph_TileReplace(buff, graph);
+	}
 	for (y = 0; y < buff->height; y += graph->height) {
 		for (x = 0; x < buff->width; x += graph->width) {
-			if (replace) {
-				ret += Graph_Replace(buff, graph, y, x);
-				continue;
-			}
-			ret += Graph_Mix(buff, graph, y, x, with_alpha);
+			ret += Graph_Mix(buff, graph, x, y, with_alpha);
 		}
 	}
 	return ret;
@@ -1322,8 +1585,61 @@ int Graph_Replace(LCUI_Graph *back, const LCUI_Graph *fore, int left, int top)
 		break;
 	case LCUI_COLOR_TYPE_ARGB8888:
 		Graph_ReplaceARGB(back, write_rect, fore, left, top);
-	default:
 		break;
+	default:
+		return -1;
 	}
-	return -1;
+	return 0;
+}
+
+int Graph_CopyRect(LCUI_Graph *graph, const LCUI_Rect *rect, int x, int y)
+{
+	int row;
+	size_t size;
+	uchar_t *src, *dst;
+	LCUI_Graph *source;
+	LCUI_Rect valid_rect, read_rect, write_rect;
+
+	if (!Graph_IsWritable(graph)) {
+		return -1;
+	}
+	read_rect = *rect;
+	LCUIRect_ValidateArea(&read_rect, graph->width, graph->height);
+	write_rect = read_rect;
+	write_rect.x += x - rect->x;
+	write_rect.y += y - rect->y;
+	LCUIRect_ValidateArea(&write_rect, graph->width, graph->height);
+	if (write_rect.width <= 0 || write_rect.height <= 0) {
+		return -2;
+	}
+	read_rect = write_rect;
+	read_rect.x -= x - rect->x;
+	read_rect.y -= y - rect->y;
+	Graph_GetValidRect(graph, &valid_rect);
+	source = Graph_GetQuote(graph);
+	Graph_Detach(source);
+	size = source->bytes_per_pixel * read_rect.width;
+	src = source->bytes +
+	      (valid_rect.y + read_rect.y) * source->bytes_per_row +
+	      (valid_rect.x + read_rect.x) * source->bytes_per_pixel;
+	dst = source->bytes +
+	      (valid_rect.y + write_rect.y) * source->bytes_per_row +
+	      (valid_rect.x + write_rect.x) * source->bytes_per_pixel;
+	/* Copy from the bottom row if the rows will be overwritten */
+	if (write_rect.y > read_rect.y) {
+		src += (read_rect.height - 1) * source->bytes_per_row;
+		dst += (read_rect.height - 1) * source->bytes_per_row;
+		for (row = 0; row < read_rect.height; ++row) {
+			memmove(dst, src, size);
+			src -= source->bytes_per_row;
+			dst -= source->bytes_per_row;
+		}
+		return 0;
+	}
+	for (row = 0; row < read_rect.height; ++row) {
+		memmove(dst, src, size);
+		src += source->bytes_per_row;
+		dst += source->bytes_per_row;
+	}
+	return 0;
 }
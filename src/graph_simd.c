@@ -0,0 +1,524 @@
+﻿/*
+ * graph_simd.c -- SIMD kernels of the graphics processing module
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/types.h>
+#include <LCUI/util/cpu.h>
+#include "graph_simd.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#define GRAPH_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define GRAPH_NEON
+#include <arm_neon.h>
+#endif
+
+/*
+ * 只有选中的函数会用到对应的指令集，所以用 target 属性单独编译它们，而不是
+ * 给整个库加上 -mavx2 之类的编译参数
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET(X) __attribute__((target(X)))
+#else
+#define TARGET(X)
+#endif
+
+#define SWAP_CHUNK_SIZE 256
+
+/** 到 align 字节对齐的地址还差多少个像素 */
+#define PixelsToAlign(P, ALIGN) \
+	((((ALIGN) - ((uintptr_t)(P) & ((ALIGN)-1))) & ((ALIGN)-1)) / 4)
+
+/*---------------------------------- Scalar --------------------------------*/
+
+static void Fill32_C(uint32_t *dst, uint32_t value, size_t n)
+{
+	for (; n > 0; --n) {
+		*dst++ = value;
+	}
+}
+
+static void Fill32RGB_C(uint32_t *dst, uint32_t rgb, size_t n)
+{
+	for (; n > 0; --n, ++dst) {
+		*dst = (*dst & 0xff000000) | rgb;
+	}
+}
+
+static void Fill24_C(uchar_t *dst, const uchar_t bgr[3], size_t n)
+{
+	for (; n > 0; --n) {
+		*dst++ = bgr[0];
+		*dst++ = bgr[1];
+		*dst++ = bgr[2];
+	}
+}
+
+static void Reverse32_C(uint32_t *dst, const uint32_t *src, size_t n)
+{
+	src += n;
+	for (; n > 0; --n) {
+		*dst++ = *--src;
+	}
+}
+
+static void Reverse32InPlace_C(uint32_t *pixels, size_t n)
+{
+	uint32_t tmp;
+	uint32_t *end = pixels + n;
+
+	while (end - pixels > 1) {
+		tmp = *pixels;
+		*pixels++ = *--end;
+		*end = tmp;
+	}
+}
+
+static void Swap_C(uchar_t *a, uchar_t *b, size_t n)
+{
+	size_t size;
+	uchar_t tmp[SWAP_CHUNK_SIZE];
+
+	for (; n > 0; n -= size, a += size, b += size) {
+		size = n < SWAP_CHUNK_SIZE ? n : SWAP_CHUNK_SIZE;
+		memcpy(tmp, a, size);
+		memcpy(a, b, size);
+		memcpy(b, tmp, size);
+	}
+}
+
+static const GraphKernelsRec kernels_c = {
+	Fill32_C, Fill32_C, Fill32RGB_C,
+	Fill24_C, Reverse32_C, Reverse32InPlace_C, Swap_C
+};
+
+/*----------------------------------- SSE2 ---------------------------------*/
+
+#ifdef GRAPH_X86
+
+TARGET("sse2")
+static void Fill32_SSE2(uint32_t *dst, uint32_t value, size_t n)
+{
+	size_t head = PixelsToAlign(dst, 16);
+	__m128i v = _mm_set1_epi32((int)value);
+
+	if (n < head + 4) {
+		Fill32_C(dst, value, n);
+		return;
+	}
+	Fill32_C(dst, value, head);
+	dst += head;
+	n -= head;
+	for (; n >= 16; n -= 16, dst += 16) {
+		_mm_store_si128((__m128i *)dst, v);
+		_mm_store_si128((__m128i *)(dst + 4), v);
+		_mm_store_si128((__m128i *)(dst + 8), v);
+		_mm_store_si128((__m128i *)(dst + 12), v);
+	}
+	for (; n >= 4; n -= 4, dst += 4) {
+		_mm_store_si128((__m128i *)dst, v);
+	}
+	Fill32_C(dst, value, n);
+}
+
+TARGET("sse2")
+static void Fill32Stream_SSE2(uint32_t *dst, uint32_t value, size_t n)
+{
+	size_t head = PixelsToAlign(dst, 16);
+	__m128i v = _mm_set1_epi32((int)value);
+
+	if (n < head + 16) {
+		Fill32_SSE2(dst, value, n);
+		return;
+	}
+	Fill32_C(dst, value, head);
+	dst += head;
+	n -= head;
+	for (; n >= 16; n -= 16, dst += 16) {
+		_mm_stream_si128((__m128i *)dst, v);
+		_mm_stream_si128((__m128i *)(dst + 4), v);
+		_mm_stream_si128((__m128i *)(dst + 8), v);
+		_mm_stream_si128((__m128i *)(dst + 12), v);
+	}
+	/* 让其它线程能看到绕过缓存写入的数据 */
+	_mm_sfence();
+	Fill32_C(dst, value, n);
+}
+
+TARGET("sse2")
+static void Fill32RGB_SSE2(uint32_t *dst, uint32_t rgb, size_t n)
+{
+	__m128i v;
+	__m128i mask = _mm_set1_epi32((int)0xff000000);
+	__m128i color = _mm_set1_epi32((int)rgb);
+
+	for (; n >= 4; n -= 4, dst += 4) {
+		v = _mm_loadu_si128((__m128i *)dst);
+		v = _mm_or_si128(_mm_and_si128(v, mask), color);
+		_mm_storeu_si128((__m128i *)dst, v);
+	}
+	Fill32RGB_C(dst, rgb, n);
+}
+
+TARGET("sse2")
+static void Fill24_SSE2(uchar_t *dst, const uchar_t bgr[3], size_t n)
+{
+	__m128i v0, v1, v2;
+	uchar_t pattern[48];
+
+	/* 16 个像素正好是 3 个向量 */
+	Fill24_C(pattern, bgr, 16);
+	v0 = _mm_loadu_si128((__m128i *)pattern);
+	v1 = _mm_loadu_si128((__m128i *)(pattern + 16));
+	v2 = _mm_loadu_si128((__m128i *)(pattern + 32));
+	for (; n >= 16; n -= 16, dst += 48) {
+		_mm_storeu_si128((__m128i *)dst, v0);
+		_mm_storeu_si128((__m128i *)(dst + 16), v1);
+		_mm_storeu_si128((__m128i *)(dst + 32), v2);
+	}
+	Fill24_C(dst, bgr, n);
+}
+
+#define Reverse128(V) _mm_shuffle_epi32(V, _MM_SHUFFLE(0, 1, 2, 3))
+
+TARGET("sse2")
+static void Reverse32_SSE2(uint32_t *dst, const uint32_t *src, size_t n)
+{
+	__m128i v;
+	const uint32_t *end = src + n;
+
+	for (; n >= 4; n -= 4, dst += 4) {
+		end -= 4;
+		v = _mm_loadu_si128((const __m128i *)end);
+		_mm_storeu_si128((__m128i *)dst, Reverse128(v));
+	}
+	Reverse32_C(dst, src, n);
+}
+
+TARGET("sse2")
+static void Reverse32InPlace_SSE2(uint32_t *pixels, size_t n)
+{
+	__m128i a, b;
+	uint32_t *end = pixels + n;
+
+	while (end - pixels >= 8) {
+		end -= 4;
+		a = _mm_loadu_si128((__m128i *)pixels);
+		b = _mm_loadu_si128((__m128i *)end);
+		_mm_storeu_si128((__m128i *)pixels, Reverse128(b));
+		_mm_storeu_si128((__m128i *)end, Reverse128(a));
+		pixels += 4;
+	}
+	Reverse32InPlace_C(pixels, end - pixels);
+}
+
+TARGET("sse2")
+static void Swap_SSE2(uchar_t *a, uchar_t *b, size_t n)
+{
+	__m128i va, vb;
+
+	for (; n >= 16; n -= 16, a += 16, b += 16) {
+		va = _mm_loadu_si128((__m128i *)a);
+		vb = _mm_loadu_si128((__m128i *)b);
+		_mm_storeu_si128((__m128i *)a, vb);
+		_mm_storeu_si128((__m128i *)b, va);
+	}
+	Swap_C(a, b, n);
+}
+
+static const GraphKernelsRec kernels_sse2 = {
+	Fill32_SSE2, Fill32Stream_SSE2, Fill32RGB_SSE2,
+	Fill24_SSE2, Reverse32_SSE2, Reverse32InPlace_SSE2, Swap_SSE2
+};
+
+/*----------------------------------- AVX2 ---------------------------------*/
+
+TARGET("avx2")
+static void Fill32_AVX2(uint32_t *dst, uint32_t value, size_t n)
+{
+	size_t head = PixelsToAlign(dst, 32);
+	__m256i v = _mm256_set1_epi32((int)value);
+
+	if (n < head + 8) {
+		Fill32_C(dst, value, n);
+		return;
+	}
+	Fill32_C(dst, value, head);
+	dst += head;
+	n -= head;
+	for (; n >= 32; n -= 32, dst += 32) {
+		_mm256_store_si256((__m256i *)dst, v);
+		_mm256_store_si256((__m256i *)(dst + 8), v);
+		_mm256_store_si256((__m256i *)(dst + 16), v);
+		_mm256_store_si256((__m256i *)(dst + 24), v);
+	}
+	for (; n >= 8; n -= 8, dst += 8) {
+		_mm256_store_si256((__m256i *)dst, v);
+	}
+	Fill32_C(dst, value, n);
+}
+
+TARGET("avx2")
+static void Fill32Stream_AVX2(uint32_t *dst, uint32_t value, size_t n)
+{
+	size_t head = PixelsToAlign(dst, 32);
+	__m256i v = _mm256_set1_epi32((int)value);
+
+	if (n < head + 32) {
+		Fill32_AVX2(dst, value, n);
+		return;
+	}
+	Fill32_C(dst, value, head);
+	dst += head;
+	n -= head;
+	for (; n >= 32; n -= 32, dst += 32) {
+		_mm256_stream_si256((__m256i *)dst, v);
+		_mm256_stream_si256((__m256i *)(dst + 8), v);
+		_mm256_stream_si256((__m256i *)(dst + 16), v);
+		_mm256_stream_si256((__m256i *)(dst + 24), v);
+	}
+	_mm_sfence();
+	Fill32_C(dst, value, n);
+}
+
+TARGET("avx2")
+static void Fill32RGB_AVX2(uint32_t *dst, uint32_t rgb, size_t n)
+{
+	__m256i v;
+	__m256i mask = _mm256_set1_epi32((int)0xff000000);
+	__m256i color = _mm256_set1_epi32((int)rgb);
+
+	for (; n >= 8; n -= 8, dst += 8) {
+		v = _mm256_loadu_si256((__m256i *)dst);
+		v = _mm256_or_si256(_mm256_and_si256(v, mask), color);
+		_mm256_storeu_si256((__m256i *)dst, v);
+	}
+	Fill32RGB_C(dst, rgb, n);
+}
+
+TARGET("avx2")
+static void Fill24_AVX2(uchar_t *dst, const uchar_t bgr[3], size_t n)
+{
+	__m256i v0, v1, v2;
+	uchar_t pattern[96];
+
+	Fill24_C(pattern, bgr, 32);
+	v0 = _mm256_loadu_si256((__m256i *)pattern);
+	v1 = _mm256_loadu_si256((__m256i *)(pattern + 32));
+	v2 = _mm256_loadu_si256((__m256i *)(pattern + 64));
+	for (; n >= 32; n -= 32, dst += 96) {
+		_mm256_storeu_si256((__m256i *)dst, v0);
+		_mm256_storeu_si256((__m256i *)(dst + 32), v1);
+		_mm256_storeu_si256((__m256i *)(dst + 64), v2);
+	}
+	Fill24_C(dst, bgr, n);
+}
+
+TARGET("avx2")
+static void Reverse32_AVX2(uint32_t *dst, const uint32_t *src, size_t n)
+{
+	__m256i v;
+	const uint32_t *end = src + n;
+	const __m256i index = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+	for (; n >= 8; n -= 8, dst += 8) {
+		end -= 8;
+		v = _mm256_loadu_si256((const __m256i *)end);
+		v = _mm256_permutevar8x32_epi32(v, index);
+		_mm256_storeu_si256((__m256i *)dst, v);
+	}
+	Reverse32_C(dst, src, n);
+}
+
+TARGET("avx2")
+static void Reverse32InPlace_AVX2(uint32_t *pixels, size_t n)
+{
+	__m256i a, b;
+	uint32_t *end = pixels + n;
+	const __m256i index = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+	while (end - pixels >= 16) {
+		end -= 8;
+		a = _mm256_loadu_si256((__m256i *)pixels);
+		b = _mm256_loadu_si256((__m256i *)end);
+		a = _mm256_permutevar8x32_epi32(a, index);
+		b = _mm256_permutevar8x32_epi32(b, index);
+		_mm256_storeu_si256((__m256i *)pixels, b);
+		_mm256_storeu_si256((__m256i *)end, a);
+		pixels += 8;
+	}
+	Reverse32InPlace_C(pixels, end - pixels);
+}
+
+TARGET("avx2")
+static void Swap_AVX2(uchar_t *a, uchar_t *b, size_t n)
+{
+	__m256i va, vb;
+
+	for (; n >= 32; n -= 32, a += 32, b += 32) {
+		va = _mm256_loadu_si256((__m256i *)a);
+		vb = _mm256_loadu_si256((__m256i *)b);
+		_mm256_storeu_si256((__m256i *)a, vb);
+		_mm256_storeu_si256((__m256i *)b, va);
+	}
+	Swap_C(a, b, n);
+}
+
+static const GraphKernelsRec kernels_avx2 = {
+	Fill32_AVX2, Fill32Stream_AVX2, Fill32RGB_AVX2,
+	Fill24_AVX2, Reverse32_AVX2, Reverse32InPlace_AVX2, Swap_AVX2
+};
+
+#endif /* GRAPH_X86 */
+
+/*----------------------------------- NEON ---------------------------------*/
+
+#ifdef GRAPH_NEON
+
+static void Fill32_NEON(uint32_t *dst, uint32_t value, size_t n)
+{
+	uint32x4_t v = vdupq_n_u32(value);
+
+	for (; n >= 16; n -= 16, dst += 16) {
+		vst1q_u32(dst, v);
+		vst1q_u32(dst + 4, v);
+		vst1q_u32(dst + 8, v);
+		vst1q_u32(dst + 12, v);
+	}
+	for (; n >= 4; n -= 4, dst += 4) {
+		vst1q_u32(dst, v);
+	}
+	Fill32_C(dst, value, n);
+}
+
+static void Fill32RGB_NEON(uint32_t *dst, uint32_t rgb, size_t n)
+{
+	uint32x4_t v;
+	uint32x4_t mask = vdupq_n_u32(0xff000000);
+	uint32x4_t color = vdupq_n_u32(rgb);
+
+	for (; n >= 4; n -= 4, dst += 4) {
+		v = vld1q_u32(dst);
+		vst1q_u32(dst, vorrq_u32(vandq_u32(v, mask), color));
+	}
+	Fill32RGB_C(dst, rgb, n);
+}
+
+static void Fill24_NEON(uchar_t *dst, const uchar_t bgr[3], size_t n)
+{
+	uint8x16x3_t v;
+
+	v.val[0] = vdupq_n_u8(bgr[0]);
+	v.val[1] = vdupq_n_u8(bgr[1]);
+	v.val[2] = vdupq_n_u8(bgr[2]);
+	for (; n >= 16; n -= 16, dst += 48) {
+		vst3q_u8(dst, v);
+	}
+	Fill24_C(dst, bgr, n);
+}
+
+static uint32x4_t Reverse128(uint32x4_t v)
+{
+	v = vrev64q_u32(v);
+	return vcombine_u32(vget_high_u32(v), vget_low_u32(v));
+}
+
+static void Reverse32_NEON(uint32_t *dst, const uint32_t *src, size_t n)
+{
+	const uint32_t *end = src + n;
+
+	for (; n >= 4; n -= 4, dst += 4) {
+		end -= 4;
+		vst1q_u32(dst, Reverse128(vld1q_u32(end)));
+	}
+	Reverse32_C(dst, src, n);
+}
+
+static void Reverse32InPlace_NEON(uint32_t *pixels, size_t n)
+{
+	uint32x4_t a, b;
+	uint32_t *end = pixels + n;
+
+	while (end - pixels >= 8) {
+		end -= 4;
+		a = vld1q_u32(pixels);
+		b = vld1q_u32(end);
+		vst1q_u32(pixels, Reverse128(b));
+		vst1q_u32(end, Reverse128(a));
+		pixels += 4;
+	}
+	Reverse32InPlace_C(pixels, end - pixels);
+}
+
+static void Swap_NEON(uchar_t *a, uchar_t *b, size_t n)
+{
+	uint8x16_t va, vb;
+
+	for (; n >= 16; n -= 16, a += 16, b += 16) {
+		va = vld1q_u8(a);
+		vb = vld1q_u8(b);
+		vst1q_u8(a, vb);
+		vst1q_u8(b, va);
+	}
+	Swap_C(a, b, n);
+}
+
+/* NEON 没有通用的绕过缓存的写入指令，大面积填充也使用普通的写入 */
+static const GraphKernelsRec kernels_neon = {
+	Fill32_NEON, Fill32_NEON, Fill32RGB_NEON,
+	Fill24_NEON, Reverse32_NEON, Reverse32InPlace_NEON, Swap_NEON
+};
+
+#endif /* GRAPH_NEON */
+
+const GraphKernelsRec *Graph_GetKernels(void)
+{
+	unsigned features = LCUI_GetCPUFeatures();
+
+#ifdef GRAPH_X86
+	if (features & LCUI_CPU_AVX2) {
+		return &kernels_avx2;
+	}
+	if (features & LCUI_CPU_SSE2) {
+		return &kernels_sse2;
+	}
+#endif
+#ifdef GRAPH_NEON
+	if (features & LCUI_CPU_NEON) {
+		return &kernels_neon;
+	}
+#endif
+	(void)features;
+	return &kernels_c;
+}
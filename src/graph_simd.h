@@ -0,0 +1,60 @@
+﻿/*
+ * graph_simd.h -- SIMD kernels of the graphics processing module
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LCUI_GRAPH_SIMD_H
+#define LCUI_GRAPH_SIMD_H
+
+/** 像素处理函数集，按 CPU 特性选择 SIMD 实现 */
+typedef struct GraphKernelsRec_ {
+	/** 用一个 ARGB 颜色值填充 n 个像素 */
+	void (*fill32)(uint32_t *dst, uint32_t value, size_t n);
+
+	/** 同 fill32，但绕过缓存写入，适合填充大于缓存的区域 */
+	void (*fill32_stream)(uint32_t *dst, uint32_t value, size_t n);
+
+	/** 只填充颜色，保留像素原有的透明度 */
+	void (*fill32_rgb)(uint32_t *dst, uint32_t rgb, size_t n);
+
+	/** 用 B、G、R 三个字节填充 n 个 RGB888 像素 */
+	void (*fill24)(uchar_t *dst, const uchar_t bgr[3], size_t n);
+
+	/** 将 n 个像素倒序复制到 dst，dst 和 src 不能重叠 */
+	void (*reverse32)(uint32_t *dst, const uint32_t *src, size_t n);
+
+	/** 将 n 个像素原地倒序 */
+	void (*reverse32_inplace)(uint32_t *pixels, size_t n);
+
+	/** 交换两块不重叠的内存 */
+	void (*swap)(uchar_t *a, uchar_t *b, size_t n);
+} GraphKernelsRec;
+
+const GraphKernelsRec *Graph_GetKernels(void);
+
+#endif
@@ -247,20 +247,15 @@ static void OnComputeColor(LCUI_CSSFontStyle fs, LCUI_Style s)
 
 static void OnComputeFontFamily(LCUI_CSSFontStyle fs, LCUI_Style s)
 {
-	if (fs->font_ids) {
-		free(fs->font_ids);
-		fs->font_ids = NULL;
-	}
-	if (fs->font_family) {
-		free(fs->font_family);
-		fs->font_family = NULL;
+	if (fs->font_stack) {
+		LCUIFont_ReleaseStack(fs->font_stack);
+		fs->font_stack = NULL;
 	}
 	if (!s->is_valid) {
 		return;
 	}
-	fs->font_family = strdup2(s->string);
-	LCUIFont_GetIdByNames(&fs->font_ids, fs->font_style, fs->font_weight,
-			      fs->font_family);
+	fs->font_stack =
+	    LCUIFont_GetStack(s->string, fs->font_style, fs->font_weight);
 }
 
 static void OnComputeFontStyle(LCUI_CSSFontStyle fs, LCUI_Style s)
@@ -352,21 +347,16 @@ void CSSFontStyle_Init(LCUI_CSSFontStyle fs)
 {
 	fs->color.value = 0;
 	fs->content = NULL;
-	fs->font_ids = NULL;
-	fs->font_family = NULL;
+	fs->font_stack = NULL;
 	fs->font_style = FONT_STYLE_NORMAL;
 	fs->font_weight = FONT_WEIGHT_NORMAL;
 }
 
 void CSSFontStyle_Destroy(LCUI_CSSFontStyle fs)
 {
-	if (fs->font_ids) {
-		free(fs->font_ids);
-		fs->font_ids = NULL;
-	}
-	if (fs->font_family) {
-		free(fs->font_family);
-		fs->font_family = NULL;
+	if (fs->font_stack) {
+		LCUIFont_ReleaseStack(fs->font_stack);
+		fs->font_stack = NULL;
 	}
 	if (fs->content) {
 		free(fs->content);
@@ -379,11 +369,33 @@ int LCUI_GetFontStyleKey(int key)
 	return self.keys[key];
 }
 
+/**
+ * 比较两个字体栈
+ * 缓存中的字体栈是唯一的，只有在添加字体后，新旧字体栈才需要比较内容
+ */
+static LCUI_BOOL IsFontStackEquals(const LCUI_FontStack a,
+				   const LCUI_FontStack b)
+{
+	size_t i;
+
+	if (a == b) {
+		return TRUE;
+	}
+	if (!a || !b || a->length != b->length ||
+	    strcmp(a->family, b->family) != 0) {
+		return FALSE;
+	}
+	for (i = 0; i < a->length; ++i) {
+		if (a->font_ids[i] != b->font_ids[i]) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
 LCUI_BOOL CSSFontStyle_IsEquals(const LCUI_CSSFontStyle a,
 				const LCUI_CSSFontStyle b)
 {
-	int i;
-
 	if (a->color.value != b->color.value ||
 	    a->line_height != b->line_height ||
 	    a->text_align != b->text_align ||
@@ -393,11 +405,7 @@ LCUI_BOOL CSSFontStyle_IsEquals(const LCUI_CSSFontStyle a,
 	    a->font_size != b->font_size) {
 		return FALSE;
 	}
-	if (a->font_family && b->font_family) {
-		if (strcmp(a->font_family, b->font_family) != 0) {
-			return FALSE;
-		}
-	} else if (a->font_family != b->font_family) {
+	if (!IsFontStackEquals(a->font_stack, b->font_stack)) {
 		return FALSE;
 	}
 	if (a->content && b->content) {
@@ -407,15 +415,6 @@ LCUI_BOOL CSSFontStyle_IsEquals(const LCUI_CSSFontStyle a,
 	} else if (a->content != b->content) {
 		return FALSE;
 	}
-	if (a->font_ids && b->font_ids) {
-		for (i = 0; a->font_ids[i] && b->font_ids[i]; ++i) {
-			if (a->font_ids[i] != b->font_ids[i]) {
-				return FALSE;
-			}
-		}
-	} else if (a->font_ids != b->font_ids) {
-		return FALSE;
-	}
 	return TRUE;
 }
 
@@ -444,11 +443,11 @@ void CSSFontStyle_GetTextStyle(LCUI_CSSFontStyle fs, LCUI_TextStyle ts)
 	ts->pixel_size = fs->font_size;
 	ts->weight = fs->font_weight;
 	ts->style = fs->font_style;
-	if (fs->font_ids) {
-		for (len = 0; fs->font_ids[len]; ++len)
-			;
-		ts->font_ids = malloc(sizeof(int) * ++len);
-		memcpy(ts->font_ids, fs->font_ids, len * sizeof(int));
+	if (fs->font_stack && fs->font_stack->font_ids) {
+		len = fs->font_stack->length + 1;
+		ts->font_ids = malloc(sizeof(int) * len);
+		memcpy(ts->font_ids, fs->font_stack->font_ids,
+		       len * sizeof(int));
 		ts->has_family = TRUE;
 	}
 }
@@ -84,6 +84,7 @@ typedef struct StyleLinkGroupRec_ {
 typedef struct StyleNodeRec_ {
 	int rank;		/**< 权值，决定优先级 */
 	int batch_num;		/**< 批次号 */
+	unsigned status_positions;	/**< 含有状态（伪类）的选择器结点位置 */
 	char *space;		/**< 所属的空间 */
 	char *selector;		/**< 选择器 */
 	LCUI_StyleList list;	/**< 样式表 */
@@ -106,16 +107,22 @@ static struct {
 	Dict *names;			/**< 样式属性名称表，以值的名称索引 */
 	Dict *value_keys;		/**< 样式属性值表，以值的名称索引 */
 	Dict *value_names;		/**< 样式属性值名称表，以值索引 */
+	Dict *status_positions;		/**< 状态（伪类）所在的选择器结点位置表，以状态名称索引 */
 	DictType names_dict;		/**< 样式属性名称表的类型 */
 	DictType value_keys_dict;	/**< 样式属性值表的类型 */
 	DictType value_names_dict;	/**< 样式属性值名称表的类型 */
 	DictType style_link_dict;	/**< 样式链接表的类型 */
 	DictType style_group_dict;	/**< 样式组的类型 */
 	DictType cache_dict;		/**< 样式表缓存的类型 */
+	DictType status_positions_dict;	/**< 状态所在位置表的类型 */
 	strpool_t *strpool;		/**< 字符串池 */
 	int count;			/**< 当前记录的属性数量 */
 } library;
 
+/** 选择器的批次号计数器 */
+/* 选择器可能在解析 CSS 文件的工作线程中创建，批次号需要原子地递增 */
+static LCUI_AtomicInt selector_batch_num = 0;
+
 /** 样式字符串值与标识码 */
 typedef struct KeyNameGroupRec_ {
 	int key;
@@ -173,6 +180,14 @@ static KeyNameGroupRec style_name_map[] = {
 	{ key_border_top_right_radius, "border-top-right-radius" },
 	{ key_border_bottom_left_radius, "border-bottom-left-radius" },
 	{ key_border_bottom_right_radius, "border-bottom-right-radius" },
+	{ key_border_image_source, "border-image-source" },
+	{ key_border_image_slice_top, "border-image-slice-top" },
+	{ key_border_image_slice_right, "border-image-slice-right" },
+	{ key_border_image_slice_bottom, "border-image-slice-bottom" },
+	{ key_border_image_slice_left, "border-image-slice-left" },
+	{ key_border_image_slice_fill, "border-image-slice-fill" },
+	{ key_border_image_repeat_x, "border-image-repeat-x" },
+	{ key_border_image_repeat_y, "border-image-repeat-y" },
 	{ key_box_shadow_x, "box-shadow-x" },
 	{ key_box_shadow_y, "box-shadow-y" },
 	{ key_box_shadow_blur, "box-shadow-blur" },
@@ -238,7 +253,9 @@ static KeyNameGroupRec style_value_map[] = {
 	{ SV_NOWRAP, "nowrap" },
 	{ SV_WRAP, "wrap" },
 	{ SV_ROW, "row" },
-	{ SV_COLUMN, "column" }
+	{ SV_COLUMN, "column" },
+	{ SV_REPEAT, "repeat" },
+	{ SV_ROUND, "round" }
 };
 
 static int LCUI_DirectAddStyleName(int key, const char *name)
@@ -1011,13 +1028,12 @@ LCUI_Selector Selector(const char *selector)
 {
 	const char *p;
 	int ni, si, rank;
-	static int batch_num = 0;
 	char type = 0, name[MAX_NAME_LEN];
 	LCUI_BOOL is_saving = FALSE;
 	LCUI_SelectorNode node = NULL;
 	LCUI_Selector s = NEW(LCUI_SelectorRec, 1);
 
-	s->batch_num = ++batch_num;
+	s->batch_num = LCUIAtomic_Increment(&selector_batch_num);
 	s->nodes = NEW(LCUI_SelectorNode, MAX_SELECTOR_DEPTH);
 	if (!selector) {
 		s->length = 0;
@@ -1227,11 +1243,30 @@ static void DeleteStyleGroup(Dict *dict)
 	Dict_Release(dict);
 }
 
+/** 记录选择器结点中的状态所在的位置 */
+static void LCUI_AddStatusPositions(LCUI_SelectorNode sn, unsigned positions)
+{
+	int i;
+	unsigned *value;
+
+	for (i = 0; sn->status[i]; ++i) {
+		value = Dict_FetchValue(library.status_positions, sn->status[i]);
+		if (value) {
+			*value |= positions;
+			continue;
+		}
+		value = malloc(sizeof(unsigned));
+		*value = positions;
+		Dict_Add(library.status_positions, sn->status[i], value);
+	}
+}
+
 /** 根据选择器，选中匹配的样式表 */
 static LCUI_StyleList LCUI_SelectStyleList(LCUI_Selector selector,
 					   const char *space)
 {
 	int i, right;
+	unsigned status_positions = 0;
 	StyleLink link;
 	StyleNode snode;
 	StyleLinkGroup slg;
@@ -1249,6 +1284,10 @@ static LCUI_StyleList LCUI_SelectStyleList(LCUI_Selector selector,
 			LinkedList_Append(&library.groups, group);
 		}
 		sn = selector->nodes[right];
+		if (sn->status) {
+			status_positions |= 1u << i;
+			LCUI_AddStatusPositions(sn, 1u << i);
+		}
 		slg = Dict_FetchValue(group, sn->fullname);
 		if (!slg) {
 			slg = CreateStyleLinkGroup(sn);
@@ -1294,6 +1333,7 @@ static LCUI_StyleList LCUI_SelectStyleList(LCUI_Selector selector,
 	snode->node.data = snode;
 	snode->list = StyleList();
 	snode->rank = selector->rank;
+	snode->status_positions = status_positions;
 	snode->selector = strdup2(fullname);
 	snode->batch_num = selector->batch_num;
 	LinkedList_AppendNode(&link->styles, &snode->node);
@@ -1314,6 +1354,56 @@ int LCUI_PutStyleSheet(LCUI_Selector selector, LCUI_StyleSheet in_ss,
 	return 0;
 }
 
+LCUI_StyleRule StyleRule(void)
+{
+	LCUI_StyleRule rule;
+
+	rule = NEW(LCUI_StyleRuleRec, 1);
+	LinkedList_Init(&rule->selectors);
+	rule->sheet = NULL;
+	return rule;
+}
+
+void StyleRule_Delete(LCUI_StyleRule rule)
+{
+	LinkedList_Clear(&rule->selectors, (FuncPtr)Selector_Delete);
+	if (rule->sheet) {
+		StyleSheet_Delete(rule->sheet);
+	}
+	rule->sheet = NULL;
+	free(rule);
+}
+
+size_t LCUI_PutStyleRules(LinkedList *rules, const char *space)
+{
+	size_t count = 0;
+	LCUI_StyleRule rule;
+	LCUI_Selector selector;
+	LCUI_StyleList list;
+	LinkedListNode *node, *sel_node;
+
+	LCUIMutex_Lock(&library.mutex);
+	Dict_Empty(library.cache);
+	for (LinkedList_Each(node, rules)) {
+		rule = node->data;
+		if (!rule->sheet) {
+			continue;
+		}
+		for (LinkedList_Each(sel_node, &rule->selectors)) {
+			selector = sel_node->data;
+			selector->batch_num =
+			    LCUIAtomic_Increment(&selector_batch_num);
+			list = LCUI_SelectStyleList(selector, space);
+			if (list) {
+				StyleList_Merge(list, rule->sheet);
+				++count;
+			}
+		}
+	}
+	LCUIMutex_Unlock(&library.mutex);
+	return count;
+}
+
 static size_t StyleLink_GetStyleSheets(StyleLink link, LinkedList *outlist)
 {
 	size_t i;
@@ -1422,6 +1512,48 @@ int LCUI_FindStyleSheetFromGroup(int group, const char *name, LCUI_Selector s,
 	return (int)count;
 }
 
+unsigned LCUI_GetStatusPositions(const char *status)
+{
+	unsigned *value, positions = 0;
+
+	LCUIMutex_Lock(&library.mutex);
+	value = Dict_FetchValue(library.status_positions, status);
+	if (value) {
+		positions = *value;
+	}
+	LCUIMutex_Unlock(&library.mutex);
+	return positions;
+}
+
+int LCUI_FindStyleSubjectsFromGroup(int group, const char *name,
+				    LCUI_Selector s, LinkedList *subjects)
+{
+	int count;
+	char *subject;
+	StyleNode snode;
+	LinkedList list;
+	LinkedListNode *node, *sub_node;
+
+	LinkedList_Init(&list);
+	count = LCUI_FindStyleSheetFromGroup(group, name, s, &list);
+	for (LinkedList_Each(node, &list)) {
+		snode = node->data;
+		/* 选择器的最后一个结点是样式规则作用的对象 */
+		subject = strrchr(snode->selector, ' ');
+		subject = subject ? subject + 1 : snode->selector;
+		for (LinkedList_Each(sub_node, subjects)) {
+			if (strcmp(sub_node->data, subject) == 0) {
+				break;
+			}
+		}
+		if (!sub_node) {
+			LinkedList_Append(subjects, strdup2(subject));
+		}
+	}
+	LinkedList_Clear(&list, NULL);
+	return count;
+}
+
 static void PrintStyleName(int key)
 {
 	const char *name;
@@ -1701,6 +1833,26 @@ static void StyleLinkDestructor(void *privdata, void *data)
 	DeleteStyleLink(data);
 }
 
+static void StatusPositionsDestructor(void *privdata, void *val)
+{
+	free(val);
+}
+
+static void InitStatusPositionsDict(void)
+{
+	DictType *dt = &library.status_positions_dict;
+
+	Dict_InitStringCopyKeyType(dt);
+	dt->valDestructor = StatusPositionsDestructor;
+	library.status_positions = Dict_Create(dt, NULL);
+}
+
+static void DestroyStatusPositionsDict(void)
+{
+	Dict_Release(library.status_positions);
+	library.status_positions = NULL;
+}
+
 static void InitStyleLinkDict(void)
 {
 	Dict_InitStringCopyKeyType(&library.style_link_dict);
@@ -1758,6 +1910,7 @@ void LCUI_InitCSSLibrary(void)
 	InitStyleLinkDict();
 	InitStyleGroupDict();
 	InitStylesheetCache();
+	InitStatusPositionsDict();
 	InitStyleNameLibrary();
 	InitStyleValueLibrary();
 	LCUIMutex_Init(&library.mutex);
@@ -1778,6 +1931,7 @@ void LCUI_FreeCSSLibrary(void)
 {
 	library.active = FALSE;
 	DestroyStylesheetCache();
+	DestroyStatusPositionsDict();
 	DestroyStyleNameLibrary();
 	DestroyStyleValueLibrary();
 	LCUIMutex_Destroy(&library.mutex);
@@ -41,6 +41,13 @@
 #include <LCUI/gui/css_parser.h>
 #include <LCUI/font.h>
 
+#ifdef LCUI_BUILD_IN_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #define SPLIT_NUMBER 1
 #define SPLIT_COLOR (1 << 1)
 #define SPLIT_STYLE (1 << 2)
@@ -55,6 +62,16 @@ static struct CSSParserModule {
 	Dict *parsers;     /**< 解析器表，以名称进行索引 */
 } self;
 
+/** CSS 文件的异步载入器 */
+typedef struct CSSFileLoaderRec_ {
+	int result;                     /**< 解析结果 */
+	char *filepath;                 /**< 文件路径 */
+	LinkedList rules;               /**< 解析出的样式规则列表 */
+	LinkedList font_faces;          /**< 解析出的字体文件路径列表 */
+	LCUI_CSSLoadedCallback callback; /**< 载入完成后的回调函数 */
+	void *callback_arg;             /**< 回调函数的附加参数 */
+} CSSFileLoaderRec, *CSSFileLoader;
+
 void CSSStyleParser_SetCSSProperty(LCUI_CSSParserStyleContext ctx, int key,
 				   LCUI_Style s)
 {
@@ -450,6 +467,229 @@ static int OnParseBorderStyle(LCUI_CSSParserStyleContext ctx, const char *str)
 	return 0;
 }
 
+/** 按空白字符拆分值，括号内的空白字符不作为分隔符 */
+static int SplitTokens(const char *str, char **tokens, int max_tokens)
+{
+	int n = 0, depth = 0;
+	const char *p, *head = NULL;
+
+	for (p = str;; ++p) {
+		if (*p == '(') {
+			++depth;
+		} else if (*p == ')') {
+			--depth;
+		}
+		if (*p && (depth > 0 || !strchr(" \t\r\n", *p))) {
+			if (!head) {
+				head = p;
+			}
+			continue;
+		}
+		if (head) {
+			if (n >= max_tokens) {
+				break;
+			}
+			tokens[n] = malloc(sizeof(char) * (p - head + 1));
+			strncpy(tokens[n], head, p - head);
+			tokens[n][p - head] = 0;
+			head = NULL;
+			++n;
+		}
+		if (!*p) {
+			return n;
+		}
+	}
+	while (n > 0) {
+		free(tokens[--n]);
+	}
+	return -1;
+}
+
+static void FreeTokens(char **tokens, int n)
+{
+	while (n > 0) {
+		free(tokens[--n]);
+	}
+}
+
+static LCUI_BOOL ParseBorderImageSlice(LCUI_Style s, const char *str)
+{
+	if (!ParseNumber(s, str)) {
+		return FALSE;
+	}
+	switch (s->type) {
+	case LCUI_STYPE_INT:
+		return s->val_int >= 0;
+	case LCUI_STYPE_PX:
+		return s->px >= 0;
+	case LCUI_STYPE_SCALE:
+		return s->scale >= 0;
+	default:
+		break;
+	}
+	return FALSE;
+}
+
+static LCUI_BOOL ParseBorderImageRepeat(LCUI_Style s, const char *str)
+{
+	int v = LCUI_GetStyleValue(str);
+
+	if (v != SV_STRETCH && v != SV_REPEAT && v != SV_ROUND) {
+		return FALSE;
+	}
+	s->is_valid = TRUE;
+	s->type = LCUI_STYPE_STYLE;
+	s->val_style = v;
+	return TRUE;
+}
+
+/** 设置边框图像的切片线，值的数量为 1 ~ 4 个，展开方式与 padding 相同 */
+static void SetBorderImageSlice(LCUI_CSSParserStyleContext ctx,
+				LCUI_Style slist, int n, LCUI_BOOL fill)
+{
+	LCUI_StyleRec s;
+
+	s.is_valid = TRUE;
+	s.type = LCUI_STYPE_BOOL;
+	s.val_bool = fill;
+	SetCSSProperty(ctx, key_border_image_slice_top, &slist[0]);
+	SetCSSProperty(ctx, key_border_image_slice_right,
+		       &slist[n > 1 ? 1 : 0]);
+	SetCSSProperty(ctx, key_border_image_slice_bottom,
+		       &slist[n > 2 ? 2 : 0]);
+	SetCSSProperty(ctx, key_border_image_slice_left,
+		       &slist[n > 3 ? 3 : (n > 1 ? 1 : 0)]);
+	SetCSSProperty(ctx, key_border_image_slice_fill, &s);
+}
+
+static void SetBorderImageRepeat(LCUI_CSSParserStyleContext ctx,
+				 LCUI_Style slist, int n)
+{
+	SetCSSProperty(ctx, key_border_image_repeat_x, &slist[0]);
+	SetCSSProperty(ctx, key_border_image_repeat_y, &slist[n > 1 ? 1 : 0]);
+}
+
+static int OnParseBorderImageSource(LCUI_CSSParserStyleContext ctx,
+				    const char *str)
+{
+	LCUI_StyleRec s;
+
+	if (strcmp(str, "none") == 0) {
+		s.is_valid = TRUE;
+		s.type = LCUI_STYPE_NONE;
+		s.val_none = 0;
+		SetCSSProperty(ctx, key_border_image_source, &s);
+		return 0;
+	}
+	return OnParseImage(ctx, str);
+}
+
+static int OnParseBorderImageSlice(LCUI_CSSParserStyleContext ctx,
+				   const char *str)
+{
+	int i, n, count = 0;
+	char *tokens[5];
+	LCUI_BOOL fill = FALSE;
+	LCUI_StyleRec slist[4];
+
+	n = SplitTokens(str, tokens, 5);
+	for (i = 0; i < n; ++i) {
+		if (!fill && strcmp(tokens[i], "fill") == 0) {
+			fill = TRUE;
+		} else if (count >= 4 ||
+			   !ParseBorderImageSlice(&slist[count++], tokens[i])) {
+			break;
+		}
+	}
+	FreeTokens(tokens, n);
+	if (n < 1 || i < n || count < 1) {
+		return -1;
+	}
+	SetBorderImageSlice(ctx, slist, count, fill);
+	return 0;
+}
+
+static int OnParseBorderImageRepeat(LCUI_CSSParserStyleContext ctx,
+				    const char *str)
+{
+	int i, n;
+	char *tokens[2];
+	LCUI_StyleRec slist[2];
+
+	n = SplitTokens(str, tokens, 2);
+	for (i = 0; i < n; ++i) {
+		if (!ParseBorderImageRepeat(&slist[i], tokens[i])) {
+			break;
+		}
+	}
+	FreeTokens(tokens, n);
+	if (n < 1 || i < n) {
+		return -1;
+	}
+	SetBorderImageRepeat(ctx, slist, n);
+	return 0;
+}
+
+/**
+ * 解析 border-image 简写属性，支持源图像、切片线、fill 和重复方式，未指定的属
+ * 性将被重置为初始值。暂不支持 border-image-width 和 border-image-outset，图像
+ * 边框的宽度与 border-width 一致
+ */
+static int OnParseBorderImage(LCUI_CSSParserStyleContext ctx, const char *str)
+{
+	int i, n, n_slices = 0, n_repeats = 0;
+	char *tokens[8];
+	LCUI_BOOL fill = FALSE;
+	LCUI_StyleRec source = { 0 }, slices[4], repeats[2];
+
+	n = SplitTokens(str, tokens, 8);
+	for (i = 0; i < n; ++i) {
+		if (!source.is_valid && strcmp(tokens[i], "none") == 0) {
+			source.is_valid = TRUE;
+			source.type = LCUI_STYPE_NONE;
+		} else if (!source.is_valid &&
+			   strncmp(tokens[i], "url(", 4) == 0) {
+			if (!ParseUrl(&source, tokens[i], ctx->dirname)) {
+				break;
+			}
+		} else if (!fill && strcmp(tokens[i], "fill") == 0) {
+			fill = TRUE;
+		} else if (n_slices < 4 && n_repeats == 0 &&
+			   ParseBorderImageSlice(&slices[n_slices], tokens[i])) {
+			++n_slices;
+		} else if (n_repeats < 2 &&
+			   ParseBorderImageRepeat(&repeats[n_repeats],
+						  tokens[i])) {
+			++n_repeats;
+		} else {
+			break;
+		}
+	}
+	FreeTokens(tokens, n);
+	if (n < 1 || i < n) {
+		DestroyStyle(&source);
+		return -1;
+	}
+	if (!source.is_valid) {
+		source.is_valid = TRUE;
+		source.type = LCUI_STYPE_NONE;
+	}
+	if (n_slices < 1) {
+		slices[0].is_valid = TRUE;
+		slices[0].type = LCUI_STYPE_SCALE;
+		slices[0].scale = 1.0f;
+		n_slices = 1;
+	}
+	if (n_repeats < 1) {
+		ParseBorderImageRepeat(&repeats[0], "stretch");
+		n_repeats = 1;
+	}
+	SetCSSProperty(ctx, key_border_image_source, &source);
+	SetBorderImageSlice(ctx, slices, n_slices, fill);
+	SetBorderImageRepeat(ctx, repeats, n_repeats);
+	return 0;
+}
+
 static int OnParsePadding(LCUI_CSSParserStyleContext ctx, const char *str)
 {
 	LCUI_StyleRec s[4];
@@ -832,6 +1072,7 @@ static LCUI_CSSPropertyParserRec style_parser_map[] = {
 	{ key_border_top_right_radius, NULL, OnParseNumber },
 	{ key_border_bottom_left_radius, NULL, OnParseNumber },
 	{ key_border_bottom_right_radius, NULL, OnParseNumber },
+	{ key_border_image_source, NULL, OnParseBorderImageSource },
 	{ key_padding_top, NULL, OnParseNumber },
 	{ key_padding_right, NULL, OnParseNumber },
 	{ key_padding_bottom, NULL, OnParseNumber },
@@ -862,6 +1103,9 @@ static LCUI_CSSPropertyParserRec style_parser_map[] = {
 	{ -1, "border-width", OnParseBorderWidth },
 	{ -1, "border-style", OnParseBorderStyle },
 	{ -1, "border-radius", OnParseBorderRadius },
+	{ -1, "border-image", OnParseBorderImage },
+	{ -1, "border-image-slice", OnParseBorderImageSlice },
+	{ -1, "border-image-repeat", OnParseBorderImageRepeat },
 	{ -1, "padding", OnParsePadding },
 	{ -1, "margin", OnParseMargin },
 	{ -1, "box-shadow", OnParseBoxShadow },
@@ -886,6 +1130,11 @@ static int CSSParser_ParseComment(LCUI_CSSParserContext ctx)
 
 int CSSParser_BeginParseComment(LCUI_CSSParserContext ctx)
 {
+	/* 字符串末尾的 '/' 之后没有字符，不会开始注释 */
+	if (ctx->end && ctx->cur + 1 >= ctx->end) {
+		CSSParser_GetChar(ctx);
+		return -1;
+	}
 	switch (*(ctx->cur + 1)) {
 	case '/':
 		ctx->comment.is_line_comment = TRUE;
@@ -906,7 +1155,18 @@ int CSSParser_BeginParseComment(LCUI_CSSParserContext ctx)
 
 static void CSSParser_EndParseSheet(LCUI_CSSParserContext ctx)
 {
+	LCUI_StyleRule rule;
 	LinkedListNode *node;
+
+	/* 如果需要收集样式规则，则将选择器和样式表转移给新的样式规则 */
+	if (ctx->rules) {
+		rule = StyleRule();
+		rule->sheet = ctx->style.sheet;
+		LinkedList_Concat(&rule->selectors, &ctx->style.selectors);
+		LinkedList_Append(ctx->rules, rule);
+		ctx->style.sheet = NULL;
+		return;
+	}
 	/* 将记录的样式表添加至匹配到的选择器中 */
 	for (LinkedList_Each(node, &ctx->style.selectors)) {
 		LCUI_PutStyleSheet(node->data, ctx->style.sheet, ctx->space);
@@ -1082,12 +1342,13 @@ static void LoadFontFile(void *arg1, void *arg2)
 	LCUIWidget_RefreshTextView();
 }
 
-static void OnParsedFontFace(LCUI_CSSFontFace face)
+/** 载入字体文件，只能在主线程中调用，所有字体文件都在同一个工作线程中载入 */
+static void LoadFontFace(const char *src)
 {
 	static int worker_id = -1;
 	LCUI_TaskRec task = { 0 };
 	task.func = LoadFontFile;
-	task.arg[0] = strdup2(face->src);
+	task.arg[0] = strdup2(src);
 	task.destroy_arg[0] = free;
 	if (worker_id > -1) {
 		LCUI_PostAsyncTaskTo(&task, worker_id);
@@ -1096,6 +1357,16 @@ static void OnParsedFontFace(LCUI_CSSFontFace face)
 	}
 }
 
+static void OnLoadFontFace(void *arg1, void *arg2)
+{
+	LoadFontFace(arg1);
+}
+
+static void OnParsedFontFace(LCUI_CSSFontFace face)
+{
+	LoadFontFace(face->src);
+}
+
 static char *getdirname(const char *path)
 {
 	char *dirname;
@@ -1168,6 +1439,9 @@ LCUI_CSSParserContext CSSParser_Begin(size_t buffer_size, const char *space)
 	}
 	ctx->buffer = NEW(char, buffer_size);
 	ctx->buffer_size = buffer_size;
+	ctx->end = NULL;
+	ctx->rules = NULL;
+	ctx->font_faces = NULL;
 	ctx->target = CSS_TARGET_NONE;
 	ctx->style.space = ctx->space;
 	ctx->style.style_handler = NULL;
@@ -1207,6 +1481,7 @@ static size_t LCUI_LoadCSSBlock(LCUI_CSSParserContext ctx, const char *str)
 	size_t size = 0;
 
 	ctx->cur = str;
+	ctx->end = NULL;
 	while (*ctx->cur && size < ctx->buffer_size) {
 		ctx->parsers[ctx->target].parse(ctx);
 		++ctx->cur;
@@ -1215,6 +1490,88 @@ static size_t LCUI_LoadCSSBlock(LCUI_CSSParserContext ctx, const char *str)
 	return size;
 }
 
+/** 载入指定长度的CSS代码 */
+static void LCUI_LoadCSSBuffer(LCUI_CSSParserContext ctx, const char *str,
+			       size_t len)
+{
+	/* 映射到内存的文件内容不以空字符结尾，解析器不能读取结束位置之后的字符 */
+	ctx->end = str + len;
+	for (ctx->cur = str; ctx->cur < ctx->end && *ctx->cur; ++ctx->cur) {
+		ctx->parsers[ctx->target].parse(ctx);
+	}
+	ctx->end = NULL;
+}
+
+#ifdef LCUI_BUILD_IN_LINUX
+
+/** 将文件映射到内存后直接解析，省去读取文件时的复制 */
+static int LCUI_LoadMappedCSSFile(LCUI_CSSParserContext ctx,
+				  const char *filepath)
+{
+	int fd;
+	void *data;
+	struct stat st;
+
+	fd = open(filepath, O_RDONLY);
+	if (fd < 0) {
+		return -ENOENT;
+	}
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return -EIO;
+	}
+	if (st.st_size < 1) {
+		close(fd);
+		return 0;
+	}
+	data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		return -ENOSYS;
+	}
+	LCUI_LoadCSSBuffer(ctx, data, (size_t)st.st_size);
+	munmap(data, (size_t)st.st_size);
+	return 0;
+}
+
+#endif
+
+static int LCUI_LoadCSSFileWithContext(LCUI_CSSParserContext ctx,
+				       const char *filepath)
+{
+	long size;
+	FILE *fp;
+	char *data;
+
+#ifdef LCUI_BUILD_IN_LINUX
+	int ret = LCUI_LoadMappedCSSFile(ctx, filepath);
+	if (ret != -ENOSYS) {
+		return ret;
+	}
+#endif
+	fp = fopen(filepath, "rb");
+	if (!fp) {
+		return -ENOENT;
+	}
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if (size < 1) {
+		fclose(fp);
+		return 0;
+	}
+	data = malloc(sizeof(char) * size);
+	if (!data) {
+		fclose(fp);
+		return -ENOMEM;
+	}
+	size = (long)fread(data, 1, size, fp);
+	LCUI_LoadCSSBuffer(ctx, data, size);
+	fclose(fp);
+	free(data);
+	return 0;
+}
+
 LCUI_CSSPropertyParser LCUI_GetCSSPropertyParser(const char *name)
 {
 	return Dict_FetchValue(self.parsers, name);
@@ -1222,24 +1579,115 @@ LCUI_CSSPropertyParser LCUI_GetCSSPropertyParser(const char *name)
 
 int LCUI_LoadCSSFile(const char *filepath)
 {
-	size_t n;
-	FILE *fp;
-	char buff[512];
+	int ret;
 	LCUI_CSSParserContext ctx;
 
-	fp = fopen(filepath, "r");
-	if (!fp) {
-		return -1;
-	}
 	ctx = CSSParser_Begin(512, filepath);
-	n = fread(buff, 1, 511, fp);
-	while (n > 0) {
-		buff[n] = 0;
-		LCUI_LoadCSSBlock(ctx, buff);
-		n = fread(buff, 1, 511, fp);
-	}
+	ret = LCUI_LoadCSSFileWithContext(ctx, filepath);
 	CSSParser_End(ctx);
-	fclose(fp);
+	return ret == 0 ? 0 : -1;
+}
+
+static int CSSParser_ParseFile(const char *filepath, LinkedList *rules,
+			       LinkedList *font_faces)
+{
+	int ret;
+	LCUI_CSSParserContext ctx;
+
+	ctx = CSSParser_Begin(512, filepath);
+	ctx->rules = rules;
+	ctx->font_faces = font_faces;
+	ret = LCUI_LoadCSSFileWithContext(ctx, filepath);
+	CSSParser_End(ctx);
+	return ret == 0 ? 0 : -1;
+}
+
+int LCUI_ParseCSSFile(const char *filepath, LinkedList *rules)
+{
+	int ret;
+	LCUI_TaskRec task;
+	LinkedList font_faces;
+	LinkedListNode *node;
+
+	LinkedList_Init(&font_faces);
+	ret = CSSParser_ParseFile(filepath, rules, &font_faces);
+	/* 该函数可能在工作线程中调用，字体文件交给主线程载入 */
+	for (LinkedList_Each(node, &font_faces)) {
+		memset(&task, 0, sizeof(task));
+		task.func = OnLoadFontFace;
+		task.arg[0] = node->data;
+		task.destroy_arg[0] = free;
+		if (!LCUI_PostTask(&task)) {
+			LCUITask_Destroy(&task);
+		}
+	}
+	LinkedList_Clear(&font_faces, NULL);
+	return ret;
+}
+
+static void CSSFileLoader_Delete(void *arg)
+{
+	CSSFileLoader loader = arg;
+
+	LinkedList_Clear(&loader->rules, (FuncPtr)StyleRule_Delete);
+	LinkedList_Clear(&loader->font_faces, free);
+	free(loader->filepath);
+	free(loader);
+}
+
+/** 在主线程中将解析出的样式规则一次性导入至样式库 */
+static void CSSFileLoader_OnMerge(void *arg1, void *arg2)
+{
+	CSSFileLoader loader = arg1;
+	LinkedListNode *node;
+
+	if (loader->result == 0) {
+		for (LinkedList_Each(node, &loader->font_faces)) {
+			LoadFontFace(node->data);
+		}
+		LCUI_PutStyleRules(&loader->rules, loader->filepath);
+		LCUIWidget_RefreshStyle();
+	}
+	if (loader->callback) {
+		loader->callback(loader->filepath, loader->result,
+				 loader->callback_arg);
+	}
+}
+
+/** 在工作线程中解析文件 */
+static void CSSFileLoader_OnParse(void *arg1, void *arg2)
+{
+	LCUI_TaskRec task = { 0 };
+	CSSFileLoader loader = arg1;
+
+	loader->result = CSSParser_ParseFile(loader->filepath, &loader->rules,
+					     &loader->font_faces);
+	task.func = CSSFileLoader_OnMerge;
+	task.arg[0] = loader;
+	task.destroy_arg[0] = CSSFileLoader_Delete;
+	if (!LCUI_PostTask(&task)) {
+		LCUITask_Destroy(&task);
+	}
+}
+
+int LCUI_LoadCSSFileAsync(const char *filepath,
+			  LCUI_CSSLoadedCallback callback, void *arg)
+{
+	LCUI_TaskRec task = { 0 };
+	CSSFileLoader loader;
+
+	loader = NEW(CSSFileLoaderRec, 1);
+	if (!loader) {
+		return -ENOMEM;
+	}
+	loader->filepath = strdup2(filepath);
+	loader->callback = callback;
+	loader->callback_arg = arg;
+	LinkedList_Init(&loader->rules);
+	LinkedList_Init(&loader->font_faces);
+	task.func = CSSFileLoader_OnParse;
+	task.arg[0] = loader;
+	LCUI_PostAsyncTask(&task);
 	return 0;
 }
 
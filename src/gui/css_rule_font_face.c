@@ -122,7 +122,12 @@ static int FontFaceParser_ParseTail(LCUI_CSSParserContext ctx)
 {
 	FontFaceParserContext data;
 	data = GetParserContext(ctx);
-	if (data->callback) {
+	if (ctx->font_faces) {
+		if (data->face->src) {
+			LinkedList_Append(ctx->font_faces,
+					  strdup2(data->face->src));
+		}
+	} else if (data->callback) {
 		data->callback(data->face);
 	}
 	FontFaceParser_End(ctx);
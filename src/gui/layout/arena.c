@@ -0,0 +1,136 @@
+/*
+ * arena.c -- Per-thread memory arena for layout contexts
+ *
+ * Copyright (c) 2020, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include "arena.h"
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGN(SIZE) (((SIZE) + 15) & ~(size_t)15)
+#define ARENA_BLOCK_DATA(B) \
+	((char *)(B) + ARENA_ALIGN(sizeof(LCUI_LayoutArenaBlockRec)))
+
+typedef struct LCUI_LayoutArenaBlockRec_ {
+	size_t size;
+	size_t used;
+	struct LCUI_LayoutArenaBlockRec_ *next;
+} LCUI_LayoutArenaBlockRec, *LCUI_LayoutArenaBlock;
+
+/**
+ * Layout contexts are created and destroyed in a nested order, so the arena
+ * works like a stack: blocks after the current block are free and reused by
+ * the next allocation.
+ */
+static THREAD_LOCAL struct LCUI_LayoutArenaRec_ {
+	LCUI_LayoutArenaBlock first;
+	LCUI_LayoutArenaBlock current;
+} arena;
+
+static LCUI_LayoutArenaBlock LayoutArenaBlock_Create(size_t size)
+{
+	LCUI_LayoutArenaBlock block;
+
+	if (size < ARENA_BLOCK_SIZE) {
+		size = ARENA_BLOCK_SIZE;
+	}
+	block = malloc(ARENA_ALIGN(sizeof(LCUI_LayoutArenaBlockRec)) + size);
+	if (!block) {
+		return NULL;
+	}
+	block->size = size;
+	block->used = 0;
+	block->next = NULL;
+	return block;
+}
+
+void *LCUILayoutArena_Alloc(size_t size)
+{
+	LCUI_LayoutArenaBlock next, block = arena.current;
+
+	size = ARENA_ALIGN(size);
+	if (!block) {
+		if (!arena.first) {
+			arena.first = LayoutArenaBlock_Create(size);
+			if (!arena.first) {
+				return NULL;
+			}
+		}
+		block = arena.first;
+		block->used = 0;
+		arena.current = block;
+	}
+	while (block->size - block->used < size) {
+		if (!block->next || block->next->size < size) {
+			next = LayoutArenaBlock_Create(size);
+			if (!next) {
+				return NULL;
+			}
+			next->next = block->next;
+			block->next = next;
+		}
+		block = block->next;
+		block->used = 0;
+		arena.current = block;
+	}
+	block->used += size;
+	return ARENA_BLOCK_DATA(block) + block->used - size;
+}
+
+void LCUILayoutArena_Save(LCUI_LayoutArenaMark mark)
+{
+	mark->block = arena.current;
+	mark->used = arena.current ? arena.current->used : 0;
+}
+
+void LCUILayoutArena_Restore(LCUI_LayoutArenaMark mark)
+{
+	arena.current = mark->block;
+	if (arena.current) {
+		arena.current->used = mark->used;
+	}
+}
+
+void LCUILayoutArena_Free(void)
+{
+	LCUI_LayoutArenaBlock block, next;
+
+	for (block = arena.first; block; block = next) {
+		next = block->next;
+		free(block);
+	}
+	arena.first = NULL;
+	arena.current = NULL;
+}
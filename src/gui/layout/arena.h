@@ -0,0 +1,55 @@
+/*
+ * arena.h -- Per-thread memory arena for layout contexts
+ *
+ * Copyright (c) 2020, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LCUI_LAYOUT_ARENA_H
+#define LCUI_LAYOUT_ARENA_H
+
+typedef struct LCUI_LayoutArenaMarkRec_ {
+	struct LCUI_LayoutArenaBlockRec_ *block;
+	size_t used;
+} LCUI_LayoutArenaMarkRec, *LCUI_LayoutArenaMark;
+
+/**
+ * Allocate memory from the arena of the current thread
+ * The memory is valid until the arena is restored to a mark saved before it,
+ * memory allocated later does not move it.
+ */
+void *LCUILayoutArena_Alloc(size_t size);
+
+/** Save the current position of the arena */
+void LCUILayoutArena_Save(LCUI_LayoutArenaMark mark);
+
+/** Release all memory allocated after the mark was saved */
+void LCUILayoutArena_Restore(LCUI_LayoutArenaMark mark);
+
+/** Free the arena of the current thread */
+void LCUILayoutArena_Free(void);
+
+#endif
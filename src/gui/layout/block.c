@@ -34,13 +34,17 @@
 #include <LCUI/LCUI.h>
 #include <LCUI/gui/widget.h>
 #include "block.h"
+#include "arena.h"
 #include "../widget_util.h"
 #include "../widget_diff.h"
 
 typedef struct LCUI_BlockLayoutRowRec_ {
 	float width;
 	float height;
-	LinkedList elements;
+
+	/** A slice of the elements of the layout context */
+	LCUI_Widget *elements;
+	size_t length;
 } LCUI_BlockLayoutRowRec, *LCUI_BlockLayoutRow;
 
 typedef struct LCUI_BlockLayoutContextRec_ {
@@ -56,17 +60,27 @@ typedef struct LCUI_BlockLayoutContextRec_ {
 	int prev_display;
 
 	/*
-	 * LinkedList<LCUI_BlockLayoutRow> rows
 	 * Element rows in the static layout flow
+	 * They are allocated from the layout arena, a row is created for each
+	 * child at most, so the arrays are allocated once with enough space.
 	 */
-	LinkedList rows;
+	LCUI_BlockLayoutRow rows;
+	size_t rows_length;
 	LCUI_BlockLayoutRow row;
 
-	/*
-	 * LinkedList<LCUI_Widget> free_elements
-	 * A list of elements that do not exist in the static layout flow
-	 */
-	LinkedList free_elements;
+	/** The number of children that the arrays can hold */
+	size_t capacity;
+
+	/** Elements in the static layout flow, grouped by rows */
+	LCUI_Widget *elements;
+	size_t elements_length;
+
+	/** Elements that do not exist in the static layout flow */
+	LCUI_Widget *free_elements;
+	size_t free_elements_length;
+
+	/** The position of the layout arena before this context is created */
+	LCUI_LayoutArenaMarkRec mark;
 } LCUI_BlockLayoutContextRec, *LCUI_BlockLayoutContext;
 
 static void BlockLayout_UpdateElementPosition(LCUI_BlockLayoutContext ctx,
@@ -96,25 +110,6 @@ static void BlockLayout_UpdateElementPosition(LCUI_BlockLayoutContext ctx,
 	Widget_UpdateBoxPosition(w);
 }
 
-static LCUI_BlockLayoutRow BlockLayoutRow_Create(void)
-{
-	LCUI_BlockLayoutRow row;
-
-	row = malloc(sizeof(LCUI_BlockLayoutRowRec));
-	row->width = 0;
-	row->height = 0;
-	LinkedList_Init(&row->elements);
-	return row;
-}
-
-static void BlockLayoutRow_Destroy(void *arg)
-{
-	LCUI_BlockLayoutRow row = arg;
-
-	LinkedList_Clear(&row->elements, NULL);
-	free(row);
-}
-
 static void BlockLayout_NextRow(LCUI_BlockLayoutContext ctx)
 {
 	if (ctx->row) {
@@ -124,16 +119,39 @@ static void BlockLayout_NextRow(LCUI_BlockLayoutContext ctx)
 	}
 	ctx->prev_display = 0;
 	ctx->x = ctx->widget->padding.left;
-	ctx->row = BlockLayoutRow_Create();
-	LinkedList_Append(&ctx->rows, ctx->row);
+	ctx->row = &ctx->rows[ctx->rows_length++];
+	ctx->row->width = 0;
+	ctx->row->height = 0;
+	ctx->row->elements = ctx->elements + ctx->elements_length;
+	ctx->row->length = 0;
 }
 
 static LCUI_BlockLayoutContext BlockLayout_Begin(LCUI_Widget w,
 						 LCUI_LayoutRule rule)
 {
+	size_t n = w->children.length;
 	LCUI_WidgetStyle *style = &w->computed_style;
-	ASSIGN(ctx, LCUI_BlockLayoutContext);
+	LCUI_LayoutArenaMarkRec mark;
+	LCUI_BlockLayoutContext ctx;
 
+	LCUILayoutArena_Save(&mark);
+	ctx = LCUILayoutArena_Alloc(sizeof(LCUI_BlockLayoutContextRec));
+	if (!ctx) {
+		return NULL;
+	}
+	ctx->mark = mark;
+	ctx->rows = LCUILayoutArena_Alloc(sizeof(LCUI_BlockLayoutRowRec) *
+					  (n + 1));
+	ctx->elements = LCUILayoutArena_Alloc(sizeof(LCUI_Widget) * n);
+	ctx->free_elements = LCUILayoutArena_Alloc(sizeof(LCUI_Widget) * n);
+	if (!ctx->rows || !ctx->elements || !ctx->free_elements) {
+		LCUILayoutArena_Restore(&mark);
+		return NULL;
+	}
+	ctx->capacity = n;
+	ctx->rows_length = 0;
+	ctx->elements_length = 0;
+	ctx->free_elements_length = 0;
 	if (rule == LCUI_LAYOUT_RULE_AUTO) {
 		ctx->is_initiative = TRUE;
 		if (style->width_sizing == LCUI_SIZING_RULE_FIXED) {
@@ -182,12 +200,44 @@ static LCUI_BlockLayoutContext BlockLayout_Begin(LCUI_Widget w,
 	ctx->content_height = 0;
 	ctx->prev_display = 0;
 	ctx->prev = NULL;
-	LinkedList_Init(&ctx->free_elements);
-	LinkedList_Init(&ctx->rows);
 	BlockLayout_NextRow(ctx);
 	return ctx;
 }
 
+/**
+ * Grow the arrays to hold the children added during the layout
+ * The new arrays are allocated from the layout arena, the old arrays are
+ * released with the context.
+ */
+static LCUI_BOOL BlockLayout_Grow(LCUI_BlockLayoutContext ctx)
+{
+	size_t i, n = ctx->widget->children.length;
+	LCUI_BlockLayoutRow rows;
+	LCUI_Widget *elements, *free_elements;
+
+	rows = LCUILayoutArena_Alloc(sizeof(LCUI_BlockLayoutRowRec) * (n + 1));
+	elements = LCUILayoutArena_Alloc(sizeof(LCUI_Widget) * n);
+	free_elements = LCUILayoutArena_Alloc(sizeof(LCUI_Widget) * n);
+	if (!rows || !elements || !free_elements) {
+		return FALSE;
+	}
+	memcpy(rows, ctx->rows,
+	       sizeof(LCUI_BlockLayoutRowRec) * ctx->rows_length);
+	memcpy(elements, ctx->elements,
+	       sizeof(LCUI_Widget) * ctx->elements_length);
+	memcpy(free_elements, ctx->free_elements,
+	       sizeof(LCUI_Widget) * ctx->free_elements_length);
+	for (i = 0; i < ctx->rows_length; ++i) {
+		rows[i].elements = elements + (rows[i].elements - ctx->elements);
+	}
+	ctx->row = rows + (ctx->row - ctx->rows);
+	ctx->rows = rows;
+	ctx->elements = elements;
+	ctx->free_elements = free_elements;
+	ctx->capacity = n;
+	return TRUE;
+}
+
 static void UpdateBlockItemSize(LCUI_Widget w, LCUI_LayoutRule rule)
 {
 	float content_width = w->box.content.width;
@@ -211,6 +261,7 @@ static void UpdateBlockItemSize(LCUI_Widget w, LCUI_LayoutRule rule)
 
 static void BlockLayout_Load(LCUI_BlockLayoutContext ctx)
 {
+	size_t count = 0;
 	float max_row_width = -1;
 
 	LCUI_Widget child;
@@ -230,9 +281,16 @@ static void BlockLayout_Load(LCUI_BlockLayoutContext ctx)
 	DEBUG_MSG("%s, max_row_width: %g\n", ctx->widget->id, max_row_width);
 	for (LinkedList_Each(node, &w->children)) {
 		child = node->data;
-
+		/*
+		 * Children may be added during the layout, if the arrays are
+		 * full and cannot grow, lay them out in the next reflow
+		 */
+		if (count++ >= ctx->capacity && !BlockLayout_Grow(ctx)) {
+			Widget_AddTask(w, LCUI_WTASK_REFLOW);
+			break;
+		}
 		if (Widget_HasAbsolutePosition(child)) {
-			LinkedList_Append(&ctx->free_elements, child);
+			ctx->free_elements[ctx->free_elements_length++] = child;
 			continue;
 		}
 		/*
@@ -250,7 +308,7 @@ static void BlockLayout_Load(LCUI_BlockLayoutContext ctx)
 		}
 		DEBUG_MSG(
 		    "row %lu, child %lu, static size: (%g, %g), display: %d\n",
-		    ctx->rows.length, child->index, child->box.outer.width,
+		    ctx->rows_length, child->index, child->box.outer.width,
 		    child->box.outer.height, child->computed_style.display);
 		switch (child->computed_style.display) {
 		case SV_INLINE_BLOCK:
@@ -259,8 +317,7 @@ static void BlockLayout_Load(LCUI_BlockLayoutContext ctx)
 				DEBUG_MSG("next row\n");
 				BlockLayout_NextRow(ctx);
 			}
-			if (max_row_width != -1 &&
-			    ctx->row->elements.length > 0 &&
+			if (max_row_width != -1 && ctx->row->length > 0 &&
 			    ctx->row->width + child->box.outer.width -
 				    max_row_width >
 				0.4f) {
@@ -276,13 +333,14 @@ static void BlockLayout_Load(LCUI_BlockLayoutContext ctx)
 		default:
 			continue;
 		}
-		DEBUG_MSG("row %lu, xy: (%g, %g)\n", ctx->rows.length, ctx->x,
+		DEBUG_MSG("row %lu, xy: (%g, %g)\n", ctx->rows_length, ctx->x,
 			  ctx->y);
 		ctx->row->width += child->box.outer.width;
 		if (child->box.outer.height > ctx->row->height) {
 			ctx->row->height = child->box.outer.height;
 		}
-		LinkedList_Append(&ctx->row->elements, child);
+		ctx->row->elements[ctx->row->length++] = child;
+		ctx->elements_length++;
 		ctx->prev_display = child->computed_style.display;
 		ctx->prev = child;
 	}
@@ -313,13 +371,13 @@ static void BlockLayout_UpdateElementMargin(LCUI_BlockLayoutContext ctx,
 
 static void BlockLayout_ReflowRow(LCUI_BlockLayoutContext ctx, float row_y)
 {
+	size_t i;
 	float x = ctx->widget->padding.left;
 
 	LCUI_Widget w;
-	LinkedListNode *node;
 
-	for (LinkedList_Each(node, &ctx->row->elements)) {
-		w = node->data;
+	for (i = 0; i < ctx->row->length; ++i) {
+		w = ctx->row->elements[i];
 		UpdateBlockItemSize(w, LCUI_LAYOUT_RULE_FIXED);
 		BlockLayout_UpdateElementMargin(ctx, w);
 		BlockLayout_UpdateElementPosition(ctx, w, x, row_y);
@@ -330,24 +388,26 @@ static void BlockLayout_ReflowRow(LCUI_BlockLayoutContext ctx, float row_y)
 
 static void BlockLayout_ReflowFreeElements(LCUI_BlockLayoutContext ctx)
 {
-	LinkedListNode *node;
-	for (LinkedList_Each(node, &ctx->free_elements)) {
-		Widget_AutoReflow(node->data, LCUI_LAYOUT_RULE_FIXED);
+	size_t i;
+
+	for (i = 0; i < ctx->free_elements_length; ++i) {
+		Widget_AutoReflow(ctx->free_elements[i],
+				  LCUI_LAYOUT_RULE_FIXED);
 	}
 }
 
 static void BlockLayout_Reflow(LCUI_BlockLayoutContext ctx)
 {
+	size_t i;
 	float y;
 	LCUI_Widget w = ctx->widget;
-	LinkedListNode *node;
 
 	y = w->padding.top;
 	if (w->computed_style.display != SV_INLINE_BLOCK) {
 		ctx->content_width = w->box.content.width;
 	}
-	for (LinkedList_Each(node, &ctx->rows)) {
-		ctx->row = node->data;
+	for (i = 0; i < ctx->rows_length; ++i) {
+		ctx->row = &ctx->rows[i];
 		BlockLayout_ReflowRow(ctx, y);
 		y += ctx->row->height;
 	}
@@ -356,9 +416,9 @@ static void BlockLayout_Reflow(LCUI_BlockLayoutContext ctx)
 
 static void BlockLayout_End(LCUI_BlockLayoutContext ctx)
 {
-	LinkedList_Clear(&ctx->rows, BlockLayoutRow_Destroy);
-	LinkedList_Clear(&ctx->free_elements, NULL);
-	free(ctx);
+	LCUI_LayoutArenaMarkRec mark = ctx->mark;
+
+	LCUILayoutArena_Restore(&mark);
 }
 
 static void BlockLayout_ApplySize(LCUI_BlockLayoutContext ctx)
@@ -405,6 +465,10 @@ void LCUIBlockLayout_Reflow(LCUI_Widget w, LCUI_LayoutRule rule)
 	LCUI_BlockLayoutContext ctx;
 
 	ctx = BlockLayout_Begin(w, rule);
+	if (!ctx) {
+		Widget_AddTask(w, LCUI_WTASK_REFLOW);
+		return;
+	}
 	BlockLayout_Load(ctx);
 	BlockLayout_ApplySize(ctx);
 	BlockLayout_Reflow(ctx);
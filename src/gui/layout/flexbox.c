@@ -34,6 +34,7 @@
 #include <LCUI/LCUI.h>
 #include <LCUI/gui/widget.h>
 #include "flexbox.h"
+#include "arena.h"
 #include "../widget_util.h"
 #include "../widget_diff.h"
 
@@ -48,8 +49,9 @@ typedef struct LCUI_FlexBoxLineRec_ {
 	float sum_of_shrink_value;
 	size_t count_of_auto_margin_items;
 
-	/** LinkedList<LCUI_Widget> elements */
-	LinkedList elements;
+	/** A slice of the elements of the layout context */
+	LCUI_Widget *elements;
+	size_t length;
 } LCUI_FlexBoxLineRec, *LCUI_FlexBoxLine;
 
 typedef struct LCUI_FlexBoxLayoutContextRec_ {
@@ -62,44 +64,43 @@ typedef struct LCUI_FlexBoxLayoutContextRec_ {
 	float main_size;
 	float cross_size;
 
-	/** LinkedList<LCUI_FlexBoxLine> lines */
-	LinkedList lines;
+	/*
+	 * Lines of flex items
+	 * They are allocated from the layout arena, a line is created for each
+	 * child at most, so the arrays are allocated once with enough space.
+	 */
+	LCUI_FlexBoxLine lines;
+	size_t lines_length;
 	LCUI_FlexBoxLine line;
 
-	LinkedList free_elements;
-} LCUI_FlexBoxLayoutContextRec, *LCUI_FlexBoxLayoutContext;
-
-static LCUI_FlexBoxLine FlexBoxLine_Create(void)
-{
-	LCUI_FlexBoxLine line;
+	/** The number of children that the arrays can hold */
+	size_t capacity;
 
-	line = malloc(sizeof(LCUI_FlexBoxLineRec));
-	line->main_size = 0;
-	line->cross_size = 0;
-	line->sum_of_grow_value = 0;
-	line->sum_of_shrink_value = 0;
-	line->count_of_auto_margin_items = 0;
-	LinkedList_Init(&line->elements);
-	return line;
-}
+	/** Flex items, grouped by lines */
+	LCUI_Widget *elements;
+	size_t elements_length;
 
-static void FlexBoxLine_Destroy(void *arg)
-{
-	LCUI_FlexBoxLine line = arg;
+	/** Elements that do not exist in the flex layout flow */
+	LCUI_Widget *free_elements;
+	size_t free_elements_length;
 
-	LinkedList_Clear(&line->elements, NULL);
-	free(line);
-}
+	/** The position of the layout arena before this context is created */
+	LCUI_LayoutArenaMarkRec mark;
+} LCUI_FlexBoxLayoutContextRec, *LCUI_FlexBoxLayoutContext;
 
-static void FlexBoxLine_LoadElement(LCUI_FlexBoxLine line, LCUI_Widget w)
+static void FlexBoxLayout_LoadElement(LCUI_FlexBoxLayoutContext ctx,
+				      LCUI_Widget w)
 {
+	LCUI_FlexBoxLine line = ctx->line;
+
 	if (w->computed_style.flex.grow > 0) {
 		line->sum_of_grow_value += w->computed_style.flex.grow;
 	}
 	if (w->computed_style.flex.shrink > 0) {
 		line->sum_of_shrink_value += w->computed_style.flex.shrink;
 	}
-	LinkedList_Append(&line->elements, w);
+	line->elements[line->length++] = w;
+	ctx->elements_length++;
 }
 
 static void FlexBoxLayout_NextLine(LCUI_FlexBoxLayoutContext ctx)
@@ -115,16 +116,42 @@ static void FlexBoxLayout_NextLine(LCUI_FlexBoxLayoutContext ctx)
 		}
 	}
 	ctx->main_axis = ctx->widget->padding.left;
-	ctx->line = FlexBoxLine_Create();
-	LinkedList_Append(&ctx->lines, ctx->line);
+	ctx->line = &ctx->lines[ctx->lines_length++];
+	ctx->line->main_size = 0;
+	ctx->line->cross_size = 0;
+	ctx->line->sum_of_grow_value = 0;
+	ctx->line->sum_of_shrink_value = 0;
+	ctx->line->count_of_auto_margin_items = 0;
+	ctx->line->elements = ctx->elements + ctx->elements_length;
+	ctx->line->length = 0;
 }
 
 static LCUI_FlexBoxLayoutContext FlexBoxLayout_Begin(LCUI_Widget w,
 						     LCUI_LayoutRule rule)
 {
+	size_t n = w->children.length;
 	LCUI_WidgetStyle *style = &w->computed_style;
-	ASSIGN(ctx, LCUI_FlexBoxLayoutContext);
+	LCUI_LayoutArenaMarkRec mark;
+	LCUI_FlexBoxLayoutContext ctx;
 
+	LCUILayoutArena_Save(&mark);
+	ctx = LCUILayoutArena_Alloc(sizeof(LCUI_FlexBoxLayoutContextRec));
+	if (!ctx) {
+		return NULL;
+	}
+	ctx->mark = mark;
+	ctx->lines = LCUILayoutArena_Alloc(sizeof(LCUI_FlexBoxLineRec) *
+					   (n + 1));
+	ctx->elements = LCUILayoutArena_Alloc(sizeof(LCUI_Widget) * n);
+	ctx->free_elements = LCUILayoutArena_Alloc(sizeof(LCUI_Widget) * n);
+	if (!ctx->lines || !ctx->elements || !ctx->free_elements) {
+		LCUILayoutArena_Restore(&mark);
+		return NULL;
+	}
+	ctx->capacity = n;
+	ctx->lines_length = 0;
+	ctx->elements_length = 0;
+	ctx->free_elements_length = 0;
 	if (rule == LCUI_LAYOUT_RULE_AUTO) {
 		ctx->is_initiative = TRUE;
 		if (style->flex.direction == SV_COLUMN) {
@@ -175,17 +202,50 @@ static LCUI_FlexBoxLayoutContext FlexBoxLayout_Begin(LCUI_Widget w,
 	}
 	ctx->main_size = 0;
 	ctx->cross_size = 0;
-	LinkedList_Init(&ctx->free_elements);
-	LinkedList_Init(&ctx->lines);
 	FlexBoxLayout_NextLine(ctx);
 	return ctx;
 }
 
+/**
+ * Grow the arrays to hold the children added during the layout
+ * The new arrays are allocated from the layout arena, the old arrays are
+ * released with the context.
+ */
+static LCUI_BOOL FlexBoxLayout_Grow(LCUI_FlexBoxLayoutContext ctx)
+{
+	size_t i, n = ctx->widget->children.length;
+	LCUI_FlexBoxLine lines;
+	LCUI_Widget *elements, *free_elements;
+
+	lines = LCUILayoutArena_Alloc(sizeof(LCUI_FlexBoxLineRec) * (n + 1));
+	elements = LCUILayoutArena_Alloc(sizeof(LCUI_Widget) * n);
+	free_elements = LCUILayoutArena_Alloc(sizeof(LCUI_Widget) * n);
+	if (!lines || !elements || !free_elements) {
+		return FALSE;
+	}
+	memcpy(lines, ctx->lines,
+	       sizeof(LCUI_FlexBoxLineRec) * ctx->lines_length);
+	memcpy(elements, ctx->elements,
+	       sizeof(LCUI_Widget) * ctx->elements_length);
+	memcpy(free_elements, ctx->free_elements,
+	       sizeof(LCUI_Widget) * ctx->free_elements_length);
+	for (i = 0; i < ctx->lines_length; ++i) {
+		lines[i].elements =
+		    elements + (lines[i].elements - ctx->elements);
+	}
+	ctx->line = lines + (ctx->line - ctx->lines);
+	ctx->lines = lines;
+	ctx->elements = elements;
+	ctx->free_elements = free_elements;
+	ctx->capacity = n;
+	return TRUE;
+}
+
 static void FlexBoxLayout_End(LCUI_FlexBoxLayoutContext ctx)
 {
-	LinkedList_Clear(&ctx->lines, FlexBoxLine_Destroy);
-	LinkedList_Clear(&ctx->free_elements, NULL);
-	free(ctx);
+	LCUI_LayoutArenaMarkRec mark = ctx->mark;
+
+	LCUILayoutArena_Restore(&mark);
 }
 
 static void FlexBoxLayout_LoadRows(LCUI_FlexBoxLayoutContext ctx)
@@ -194,6 +254,7 @@ static void FlexBoxLayout_LoadRows(LCUI_FlexBoxLayoutContext ctx)
 	LCUI_FlexBoxLayoutStyle *flex = &ctx->widget->computed_style.flex;
 	LinkedListNode *node;
 
+	size_t count = 0;
 	float basis;
 	float max_main_size = -1;
 
@@ -204,11 +265,19 @@ static void FlexBoxLayout_LoadRows(LCUI_FlexBoxLayoutContext ctx)
 	DEBUG_MSG("%s, max_main_size: %g\n", ctx->widget->id, max_main_size);
 	for (LinkedList_Each(node, &ctx->widget->children)) {
 		child = node->data;
+		/*
+		 * Children may be added during the layout, if the arrays are
+		 * full and cannot grow, lay them out in the next reflow
+		 */
+		if (count++ >= ctx->capacity && !FlexBoxLayout_Grow(ctx)) {
+			Widget_AddTask(ctx->widget, LCUI_WTASK_REFLOW);
+			break;
+		}
 		if (child->computed_style.display == SV_NONE) {
 			continue;
 		}
 		if (Widget_HasAbsolutePosition(child)) {
-			LinkedList_Append(&ctx->free_elements, child);
+			ctx->free_elements[ctx->free_elements_length++] = child;
 			continue;
 		}
 		/* Clears the auto margin calculated on the last layout */
@@ -225,10 +294,10 @@ static void FlexBoxLayout_LoadRows(LCUI_FlexBoxLayoutContext ctx)
 		Widget_ComputeFlexBasisStyle(child);
 		basis = MarginX(child) + child->computed_style.flex.basis;
 		DEBUG_MSG("[line %lu][%lu] main_size: %g, basis: %g\n",
-			  ctx->lines.length, child->index, ctx->line->main_size,
+			  ctx->lines_length, child->index, ctx->line->main_size,
 			  basis);
 		/* Check line wrap */
-		if (flex->wrap == SV_WRAP && ctx->line->elements.length > 0 &&
+		if (flex->wrap == SV_WRAP && ctx->line->length > 0 &&
 		    max_main_size != -1) {
 			if (ctx->line->main_size + basis - max_main_size >
 			    0.4f) {
@@ -245,7 +314,7 @@ static void FlexBoxLayout_LoadRows(LCUI_FlexBoxLayoutContext ctx)
 			ctx->line->count_of_auto_margin_items++;
 		}
 		ctx->line->main_size += basis;
-		FlexBoxLine_LoadElement(ctx->line, child);
+		FlexBoxLayout_LoadElement(ctx, child);
 	}
 	ctx->main_size = max(ctx->main_size, ctx->line->main_size);
 	ctx->cross_size += ctx->line->cross_size;
@@ -259,6 +328,7 @@ static void FlexBoxLayout_LoadColumns(LCUI_FlexBoxLayoutContext ctx)
 	LCUI_FlexBoxLayoutStyle *flex = &ctx->widget->computed_style.flex;
 	LinkedListNode *node;
 
+	size_t count = 0;
 	float basis;
 	float max_main_size = -1;
 
@@ -269,20 +339,27 @@ static void FlexBoxLayout_LoadColumns(LCUI_FlexBoxLayoutContext ctx)
 	DEBUG_MSG("max_main_size: %g\n", max_main_size);
 	for (LinkedList_Each(node, &ctx->widget->children)) {
 		child = node->data;
-
+		/*
+		 * Children may be added during the layout, if the arrays are
+		 * full and cannot grow, lay them out in the next reflow
+		 */
+		if (count++ >= ctx->capacity && !FlexBoxLayout_Grow(ctx)) {
+			Widget_AddTask(ctx->widget, LCUI_WTASK_REFLOW);
+			break;
+		}
 		if (child->computed_style.display == SV_NONE) {
 			continue;
 		}
 		if (Widget_HasAbsolutePosition(child)) {
-			LinkedList_Append(&ctx->free_elements, child);
+			ctx->free_elements[ctx->free_elements_length++] = child;
 			continue;
 		}
 		Widget_ComputeFlexBasisStyle(child);
 		basis = MarginY(child) + child->computed_style.flex.basis;
 		DEBUG_MSG("[column %lu][%lu] main_size: %g, basis: %g\n",
-			  ctx->lines.length, child->index, ctx->line->main_size,
+			  ctx->lines_length, child->index, ctx->line->main_size,
 			  basis);
-		if (flex->wrap == SV_WRAP && ctx->line->elements.length > 0 &&
+		if (flex->wrap == SV_WRAP && ctx->line->length > 0 &&
 		    max_main_size != -1) {
 			if (ctx->line->main_size + basis - max_main_size >
 			    0.4f) {
@@ -299,7 +376,7 @@ static void FlexBoxLayout_LoadColumns(LCUI_FlexBoxLayoutContext ctx)
 			ctx->line->count_of_auto_margin_items++;
 		}
 		ctx->line->main_size += basis;
-		FlexBoxLine_LoadElement(ctx->line, child);
+		FlexBoxLayout_LoadElement(ctx, child);
 	}
 	ctx->main_size = max(ctx->main_size, ctx->line->main_size);
 	ctx->cross_size += ctx->line->cross_size;
@@ -328,17 +405,17 @@ static void FlexBoxLayout_ComputeJustifyContent(LCUI_FlexBoxLayoutContext ctx,
 	free_space -= ctx->line->main_size;
 	switch (ctx->widget->computed_style.flex.justify_content) {
 	case SV_SPACE_BETWEEN:
-		if (ctx->line->elements.length > 1) {
-			*space = free_space / (ctx->line->elements.length - 1);
+		if (ctx->line->length > 1) {
+			*space = free_space / (ctx->line->length - 1);
 		}
 		*start_axis -= *space;
 		break;
 	case SV_SPACE_AROUND:
-		*space = free_space / ctx->line->elements.length;
+		*space = free_space / ctx->line->length;
 		*start_axis -= *space * 0.5f;
 		break;
 	case SV_SPACE_EVENLY:
-		*space = free_space / (ctx->line->elements.length + 1);
+		*space = free_space / (ctx->line->length + 1);
 		*start_axis += *space;
 		break;
 	case SV_RIGHT:
@@ -391,7 +468,7 @@ static void FlexBoxLayout_ReflowRow(LCUI_FlexBoxLayoutContext ctx)
 
 	LCUI_Widget w;
 	LCUI_FlexBoxLayoutStyle *flex;
-	LinkedListNode *node;
+	size_t i;
 
 	free_space = ctx->widget->box.content.width - ctx->line->main_size;
 	if (free_space >= 0) {
@@ -404,8 +481,8 @@ static void FlexBoxLayout_ReflowRow(LCUI_FlexBoxLayoutContext ctx)
 
 	/* flex-grow and flex-shrink */
 	DEBUG_MSG("%s, free_space: %g\n", ctx->widget->id, free_space);
-	for (LinkedList_Each(node, &ctx->line->elements)) {
-		w = node->data;
+	for (i = 0; i < ctx->line->length; ++i) {
+		w = ctx->line->elements[i];
 		flex = &w->computed_style.flex;
 		if (w->computed_style.height_sizing != LCUI_SIZING_RULE_FIXED) {
 			Widget_ComputeHeightStyle(w);
@@ -437,8 +514,8 @@ static void FlexBoxLayout_ReflowRow(LCUI_FlexBoxLayoutContext ctx)
 	if (free_space > 0 && ctx->line->count_of_auto_margin_items > 0) {
 		main_axis = 0;
 		k = free_space / ctx->line->count_of_auto_margin_items;
-		for (LinkedList_Each(node, &ctx->line->elements)) {
-			w = node->data;
+		for (i = 0; i < ctx->line->length; ++i) {
+			w = ctx->line->elements[i];
 			if (Widget_HasAutoStyle(w, key_margin_left)) {
 				w->margin.left = k;
 				Widget_UpdateBoxSize(w);
@@ -457,8 +534,8 @@ static void FlexBoxLayout_ReflowRow(LCUI_FlexBoxLayoutContext ctx)
 
 	main_axis = ctx->widget->padding.left;
 	FlexBoxLayout_ComputeJustifyContent(ctx, &main_axis, &space);
-	for (LinkedList_Each(node, &ctx->line->elements)) {
-		w = node->data;
+	for (i = 0; i < ctx->line->length; ++i) {
+		w = ctx->line->elements[i];
 		main_axis += space;
 		w->layout_x = main_axis;
 		Widget_UpdateBoxPosition(w);
@@ -476,7 +553,7 @@ static void FlexBoxLayout_ReflowColumn(LCUI_FlexBoxLayoutContext ctx)
 
 	LCUI_Widget w;
 	LCUI_FlexBoxLayoutStyle *flex;
-	LinkedListNode *node;
+	size_t i;
 
 	free_space = ctx->widget->box.content.height - ctx->line->main_size;
 	if (free_space >= 0) {
@@ -487,8 +564,8 @@ static void FlexBoxLayout_ReflowColumn(LCUI_FlexBoxLayoutContext ctx)
 
 	/* flex-grow and flex-shrink */
 
-	for (LinkedList_Each(node, &ctx->line->elements)) {
-		w = node->data;
+	for (i = 0; i < ctx->line->length; ++i) {
+		w = ctx->line->elements[i];
 		flex = &w->computed_style.flex;
 		if (w->computed_style.width_sizing != LCUI_SIZING_RULE_FIXED) {
 			Widget_ComputeWidthStyle(w);
@@ -519,8 +596,8 @@ static void FlexBoxLayout_ReflowColumn(LCUI_FlexBoxLayoutContext ctx)
 	if (free_space > 0 && ctx->line->count_of_auto_margin_items > 0) {
 		main_axis = 0;
 		k = free_space / ctx->line->count_of_auto_margin_items;
-		for (LinkedList_Each(node, &ctx->line->elements)) {
-			w = node->data;
+		for (i = 0; i < ctx->line->length; ++i) {
+			w = ctx->line->elements[i];
 			if (Widget_HasAutoStyle(w, key_margin_top)) {
 				w->margin.top = k;
 				Widget_UpdateBoxSize(w);
@@ -538,8 +615,8 @@ static void FlexBoxLayout_ReflowColumn(LCUI_FlexBoxLayoutContext ctx)
 
 	main_axis = ctx->widget->padding.top;
 	FlexBoxLayout_ComputeJustifyContent(ctx, &main_axis, &space);
-	for (LinkedList_Each(node, &ctx->line->elements)) {
-		w = node->data;
+	for (i = 0; i < ctx->line->length; ++i) {
+		w = ctx->line->elements[i];
 		main_axis += space;
 		w->layout_y = main_axis;
 		Widget_UpdateBoxPosition(w);
@@ -551,12 +628,12 @@ static void FlexBoxLayout_ReflowColumn(LCUI_FlexBoxLayoutContext ctx)
 static void FlexBoxLayout_AlignItemsCenter(LCUI_FlexBoxLayoutContext ctx,
 					   float base_cross_axis)
 {
-	LinkedListNode *node;
+	size_t i;
 	LCUI_Widget child;
 
 	if (ctx->widget->computed_style.flex.direction == SV_COLUMN) {
-		for (LinkedList_Each(node, &ctx->line->elements)) {
-			child = node->data;
+		for (i = 0; i < ctx->line->length; ++i) {
+			child = ctx->line->elements[i];
 			child->layout_x =
 			    base_cross_axis +
 			    (ctx->line->cross_size - child->box.outer.width) *
@@ -565,8 +642,8 @@ static void FlexBoxLayout_AlignItemsCenter(LCUI_FlexBoxLayoutContext ctx,
 		}
 		return;
 	}
-	for (LinkedList_Each(node, &ctx->line->elements)) {
-		child = node->data;
+	for (i = 0; i < ctx->line->length; ++i) {
+		child = ctx->line->elements[i];
 		child->layout_y =
 		    base_cross_axis +
 		    (ctx->line->cross_size - child->box.outer.height) * 0.5f;
@@ -577,12 +654,12 @@ static void FlexBoxLayout_AlignItemsCenter(LCUI_FlexBoxLayoutContext ctx,
 static void FlexBoxLayout_AlignItemsStretch(LCUI_FlexBoxLayoutContext ctx,
 					    float base_cross_axis)
 {
-	LinkedListNode *node;
+	size_t i;
 	LCUI_Widget child;
 
 	if (ctx->widget->computed_style.flex.direction == SV_COLUMN) {
-		for (LinkedList_Each(node, &ctx->line->elements)) {
-			child = node->data;
+		for (i = 0; i < ctx->line->length; ++i) {
+			child = ctx->line->elements[i];
 			child->layout_x = base_cross_axis;
 			if (Widget_HasAutoStyle(child, key_width)) {
 				child->width =
@@ -594,8 +671,8 @@ static void FlexBoxLayout_AlignItemsStretch(LCUI_FlexBoxLayoutContext ctx,
 		}
 		return;
 	}
-	for (LinkedList_Each(node, &ctx->line->elements)) {
-		child = node->data;
+	for (i = 0; i < ctx->line->length; ++i) {
+		child = ctx->line->elements[i];
 		child->layout_y = base_cross_axis;
 		if (Widget_HasAutoStyle(child, key_height)) {
 			child->height = ctx->line->cross_size - MarginY(child);
@@ -608,19 +685,19 @@ static void FlexBoxLayout_AlignItemsStretch(LCUI_FlexBoxLayoutContext ctx,
 static void FlexBoxLayout_AlignItemsStart(LCUI_FlexBoxLayoutContext ctx,
 					  float base_cross_axis)
 {
-	LinkedListNode *node;
+	size_t i;
 	LCUI_Widget child;
 
 	if (ctx->widget->computed_style.flex.direction == SV_COLUMN) {
-		for (LinkedList_Each(node, &ctx->line->elements)) {
-			child = node->data;
+		for (i = 0; i < ctx->line->length; ++i) {
+			child = ctx->line->elements[i];
 			child->layout_x = base_cross_axis;
 			Widget_UpdateBoxPosition(child);
 		}
 		return;
 	}
-	for (LinkedList_Each(node, &ctx->line->elements)) {
-		child = node->data;
+	for (i = 0; i < ctx->line->length; ++i) {
+		child = ctx->line->elements[i];
 		child->layout_y = base_cross_axis;
 		Widget_UpdateBoxPosition(child);
 	}
@@ -629,12 +706,12 @@ static void FlexBoxLayout_AlignItemsStart(LCUI_FlexBoxLayoutContext ctx,
 static void FlexBoxLayout_AlignItemsEnd(LCUI_FlexBoxLayoutContext ctx,
 					float base_cross_axis)
 {
-	LinkedListNode *node;
+	size_t i;
 	LCUI_Widget child;
 
 	if (ctx->widget->computed_style.flex.direction == SV_COLUMN) {
-		for (LinkedList_Each(node, &ctx->line->elements)) {
-			child = node->data;
+		for (i = 0; i < ctx->line->length; ++i) {
+			child = ctx->line->elements[i];
 			child->layout_x = base_cross_axis +
 					  ctx->line->cross_size -
 					  child->box.outer.width;
@@ -642,8 +719,8 @@ static void FlexBoxLayout_AlignItemsEnd(LCUI_FlexBoxLayoutContext ctx,
 		}
 		return;
 	}
-	for (LinkedList_Each(node, &ctx->line->elements)) {
-		child = node->data;
+	for (i = 0; i < ctx->line->length; ++i) {
+		child = ctx->line->elements[i];
 		child->layout_y = base_cross_axis + ctx->line->cross_size -
 				  child->box.outer.height;
 		Widget_UpdateBoxPosition(child);
@@ -652,11 +729,11 @@ static void FlexBoxLayout_AlignItemsEnd(LCUI_FlexBoxLayoutContext ctx,
 
 static void FlexBoxLayout_AlignItems(LCUI_FlexBoxLayoutContext ctx)
 {
+	size_t i;
 	float cross_axis;
 	float free_space = 0;
 
 	LCUI_Widget w = ctx->widget;
-	LinkedListNode *node;
 
 	if (w->computed_style.flex.direction == SV_COLUMN) {
 		cross_axis = w->padding.left;
@@ -668,9 +745,9 @@ static void FlexBoxLayout_AlignItems(LCUI_FlexBoxLayoutContext ctx)
 	if (free_space < 0) {
 		free_space = 0;
 	}
-	for (LinkedList_Each(node, &ctx->lines)) {
-		ctx->line = node->data;
-		ctx->line->cross_size += free_space / ctx->lines.length;
+	for (i = 0; i < ctx->lines_length; ++i) {
+		ctx->line = &ctx->lines[i];
+		ctx->line->cross_size += free_space / ctx->lines_length;
 		switch (w->computed_style.flex.align_items) {
 		case SV_CENTER:
 			FlexBoxLayout_AlignItemsCenter(ctx, cross_axis);
@@ -698,12 +775,12 @@ static void FlexBoxLayout_AlignItems(LCUI_FlexBoxLayoutContext ctx)
 
 static void FlexBoxLayout_Reflow(LCUI_FlexBoxLayoutContext ctx)
 {
+	size_t i;
 	LCUI_Widget w = ctx->widget;
-	LinkedListNode *node;
 
 	DEBUG_MSG("widget: %s, start\n", w->id);
-	for (LinkedList_Each(node, &ctx->lines)) {
-		ctx->line = node->data;
+	for (i = 0; i < ctx->lines_length; ++i) {
+		ctx->line = &ctx->lines[i];
 		if (w->computed_style.flex.direction == SV_COLUMN) {
 			FlexBoxLayout_ReflowColumn(ctx);
 		} else {
@@ -716,9 +793,11 @@ static void FlexBoxLayout_Reflow(LCUI_FlexBoxLayoutContext ctx)
 
 static void FlexBoxLayout_ReflowFreeElements(LCUI_FlexBoxLayoutContext ctx)
 {
-	LinkedListNode *node;
-	for (LinkedList_Each(node, &ctx->free_elements)) {
-		Widget_AutoReflow(node->data, LCUI_LAYOUT_RULE_FIXED);
+	size_t i;
+
+	for (i = 0; i < ctx->free_elements_length; ++i) {
+		Widget_AutoReflow(ctx->free_elements[i],
+				  LCUI_LAYOUT_RULE_FIXED);
 	}
 }
 
@@ -803,6 +882,10 @@ void LCUIFlexBoxLayout_Reflow(LCUI_Widget w, LCUI_LayoutRule rule)
 	LCUI_FlexBoxLayoutContext ctx;
 
 	ctx = FlexBoxLayout_Begin(w, rule);
+	if (!ctx) {
+		Widget_AddTask(w, LCUI_WTASK_REFLOW);
+		return;
+	}
 	FlexBoxLayout_Load(ctx);
 	FlexBoxLayout_ApplySize(ctx);
 	FlexBoxLayout_Reflow(ctx);
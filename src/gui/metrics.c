@@ -30,12 +30,14 @@
 
 
 #include <LCUI_Build.h>
-#include <LCUI/types.h>
-#include <LCUI/util/math.h>
+#include <LCUI/LCUI.h>
 #include <LCUI/gui/metrics.h>
 
 static LCUI_MetricsRec metrics;
 
+/** 缩放比例的代数，每次改变缩放比例时加一 */
+static unsigned scale_generation;
+
 float LCUIMetrics_Compute(float value, LCUI_StyleType type)
 {
 	switch (type) {
@@ -92,6 +94,11 @@ float LCUIMetrics_GetScale(void)
 	return metrics.scale;
 }
 
+unsigned LCUIMetrics_GetScaleGeneration(void)
+{
+	return scale_generation;
+}
+
 static float ComputeDensityByLevel(LCUI_DensityLevel level)
 {
 	float density = metrics.dpi / 96.0f;
@@ -134,9 +141,17 @@ void LCUIMetrics_SetDpi(float dpi)
 
 void LCUIMetrics_SetScale(float scale)
 {
+	LCUI_SysEventRec e = { 0 };
+
 	scale = max(0.5f, scale);
 	scale = min(5.0f, scale);
+	if (scale == metrics.scale) {
+		return;
+	}
 	metrics.scale = scale;
+	scale_generation += 1;
+	e.type = LCUI_SCALE_CHANGE;
+	LCUI_TriggerEvent(&e, NULL);
 }
 
 void LCUI_InitMetrics(void)
@@ -41,6 +41,20 @@
 #include <LCUI/gui/widget/sidebar.h>
 #include <LCUI/gui/widget/scrollbar.h>
 #include "widget_background.h"
+#include "widget_border.h"
+#include "layout/arena.h"
+
+static int scale_change_handler_id = -1;
+
+/**
+ * 在缩放比例改变后，在工作线程上预先渲染新尺寸的字形
+ * 所有部件的样式会在下次更新时重新计算，内容缓存按缩放比例的代数失效，
+ * 不需要逐个清除。
+ */
+static void OnScaleChange(LCUI_SysEvent e, void *arg)
+{
+	LCUIWidget_PrerenderTextView();
+}
 
 void LCUI_InitWidget(void)
 {
@@ -50,6 +64,7 @@ void LCUI_InitWidget(void)
 	LCUIWidget_InitStyle();
 	LCUIWidget_InitRenderer();
 	LCUIWidget_InitImageLoader();
+	LCUIWidget_InitBorderImage();
 	LCUIWidget_AddTextView();
 	LCUIWidget_AddCanvas();
 	LCUIWidget_AddAnchor();
@@ -60,10 +75,14 @@ void LCUI_InitWidget(void)
 	LCUIWidget_AddTextEdit();
 	LCUIWidget_InitBase();
 	LCUIWidget_InitIdLibrary();
+	scale_change_handler_id =
+	    LCUI_BindEvent(LCUI_SCALE_CHANGE, OnScaleChange, NULL, NULL);
 }
 
 void LCUI_FreeWidget(void)
 {
+	LCUI_UnbindEvent(scale_change_handler_id);
+	scale_change_handler_id = -1;
 	LCUIWidget_FreeTextView();
 	LCUIWidget_FreeTasks();
 	LCUIWidget_FreeRoot();
@@ -72,6 +91,8 @@ void LCUI_FreeWidget(void)
 	LCUIWidget_FreePrototype();
 	LCUIWidget_FreeRenderer();
 	LCUIWidget_FreeImageLoader();
+	LCUIWidget_FreeBorderImage();
 	LCUIWidget_FreeIdLibrary();
 	LCUIWidget_FreeBase();
+	LCUILayoutArena_Free();
 }
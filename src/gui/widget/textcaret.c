@@ -37,19 +37,25 @@
 #include <LCUI/gui/css_parser.h>
 #include <LCUI/ime.h>
 
-typedef struct LCUI_TextCaretTaskRec_ {
-	LCUI_BOOL active;
-	LCUI_Widget widget;
-} LCUI_TextCaretTaskRec, *LCUI_TextCaretTask;
-
 /** 文本插入符相关数据 */
 typedef struct LCUI_TextCaretRec_ {
-	int timer_id;
-	int blink_interval;
 	LCUI_BOOL visible;
-	LCUI_TextCaretTask task;
 } LCUI_TextCaretRec, *LCUI_TextCaret;
 
+typedef struct LCUI_TextCaretBlinkerRec_ {
+	LCUI_Widget widget;
+	LCUI_TextCaretBlinkFunc func;
+	LinkedListNode node;
+} LCUI_TextCaretBlinkerRec, *LCUI_TextCaretBlinker;
+
+/** 共享的闪烁时钟 */
+static struct LCUI_TextCaretBlinkModule {
+	int timer_id;
+	unsigned int interval;
+	LCUI_BOOL visible;
+	LinkedList blinkers;
+} blink = { -1, 500, TRUE, { 0 } };
+
 static LCUI_WidgetPrototype prototype = NULL;
 
 static const char *textcaret_css = CodeToString(
@@ -65,6 +71,101 @@ textcaret {
 
 );
 
+static void TextCaret_SetBlinkVisible(LCUI_BOOL visible)
+{
+	LCUI_TextCaretBlinker blinker;
+	LinkedListNode *node, *next;
+
+	blink.visible = visible;
+	for (node = blink.blinkers.head.next; node; node = next) {
+		next = node->next;
+		blinker = node->data;
+		blinker->func(blinker->widget, visible);
+	}
+}
+
+static void TextCaret_OnBlinkTimer(void *arg)
+{
+	TextCaret_SetBlinkVisible(!blink.visible);
+}
+
+static LCUI_TextCaretBlinker TextCaret_GetBlinker(LCUI_Widget w)
+{
+	LinkedListNode *node;
+	LCUI_TextCaretBlinker blinker;
+
+	for (LinkedList_Each(node, &blink.blinkers)) {
+		blinker = node->data;
+		if (blinker->widget == w) {
+			return blinker;
+		}
+	}
+	return NULL;
+}
+
+void TextCaret_BindBlink(LCUI_Widget w, LCUI_TextCaretBlinkFunc func)
+{
+	LCUI_TextCaretBlinker blinker;
+
+	blinker = TextCaret_GetBlinker(w);
+	if (blinker) {
+		blinker->func = func;
+		return;
+	}
+	blinker = malloc(sizeof(LCUI_TextCaretBlinkerRec));
+	if (!blinker) {
+		return;
+	}
+	blinker->widget = w;
+	blinker->func = func;
+	blinker->node.data = blinker;
+	LinkedList_AppendNode(&blink.blinkers, &blinker->node);
+	if (blink.timer_id == -1) {
+		blink.visible = TRUE;
+		blink.timer_id = LCUI_SetInterval(blink.interval,
+						  TextCaret_OnBlinkTimer, NULL);
+	}
+}
+
+void TextCaret_UnbindBlink(LCUI_Widget w)
+{
+	LCUI_TextCaretBlinker blinker;
+
+	blinker = TextCaret_GetBlinker(w);
+	if (!blinker) {
+		return;
+	}
+	LinkedList_Unlink(&blink.blinkers, &blinker->node);
+	free(blinker);
+	if (blink.blinkers.length == 0 && blink.timer_id != -1) {
+		LCUITimer_Free(blink.timer_id);
+		blink.timer_id = -1;
+	}
+}
+
+void TextCaret_ResetBlink(void)
+{
+	if (blink.timer_id != -1) {
+		LCUITimer_Reset(blink.timer_id, blink.interval);
+	}
+	if (!blink.visible) {
+		TextCaret_SetBlinkVisible(TRUE);
+	}
+}
+
+LCUI_BOOL TextCaret_IsBlinkVisible(void)
+{
+	return blink.visible;
+}
+
+void TextCaret_SetBlinkInterval(unsigned int n_ms)
+{
+	blink.interval = n_ms;
+	if (blink.timer_id != -1) {
+		LCUITimer_Reset(blink.timer_id, blink.interval);
+	}
+}
+
 void TextCaret_Refresh(LCUI_Widget widget)
 {
 	float x, y;
@@ -75,26 +176,18 @@ void TextCaret_Refresh(LCUI_Widget widget)
 	if (!caret->visible) {
 		return;
 	}
-	LCUITimer_Reset(caret->timer_id, caret->blink_interval);
+	TextCaret_ResetBlink();
 	Widget_GetOffset(widget, LCUIWidget_GetRoot(), &x, &y);
 	LCUIIME_SetCaret((int)x, (int)y);
 	Widget_Show(widget);
 }
 
-static void TextCaret_OnBlink(void *arg)
+static void TextCaret_OnBlink(LCUI_Widget widget, LCUI_BOOL visible)
 {
-	LCUI_TextCaret caret;
-	LCUI_TextCaretTask task = arg;
-
-	if (!task->active) {
-		free(task);
-		return;
-	}
-	caret = Widget_GetData(task->widget, prototype);
-	if (!caret->visible || Widget_IsVisible(task->widget)) {
-		Widget_Hide(task->widget);
+	if (visible) {
+		Widget_Show(widget);
 	} else {
-		Widget_Show(task->widget);
+		Widget_Hide(widget);
 	}
 }
 
@@ -105,9 +198,10 @@ void TextCaret_SetVisible(LCUI_Widget widget, LCUI_BOOL visible)
 	caret = Widget_GetData(widget, prototype);
 	caret->visible = visible;
 	if (visible) {
+		TextCaret_BindBlink(widget, TextCaret_OnBlink);
 		TextCaret_Refresh(widget);
 	} else {
-		LCUITimer_Reset(caret->timer_id, caret->blink_interval);
+		TextCaret_UnbindBlink(widget);
 		Widget_Hide(widget);
 	}
 }
@@ -117,35 +211,17 @@ static void TextCaret_OnInit(LCUI_Widget widget)
 	LCUI_TextCaret caret;
 
 	caret = Widget_AddData(widget, prototype, sizeof(LCUI_TextCaretRec));
-	caret->task = malloc(sizeof(LCUI_TextCaretTaskRec));
-	caret->task->active = TRUE;
-	caret->task->widget = widget;
-	caret->blink_interval = 500;
 	caret->visible = FALSE;
-	caret->timer_id = LCUI_SetInterval(caret->blink_interval,
-		TextCaret_OnBlink, caret->task);
 }
 
 void TextCaret_SetBlinkTime(LCUI_Widget widget, unsigned int n_ms)
 {
-	LCUI_TextCaret caret;
-
-	caret = Widget_GetData(widget, prototype);
-	caret->blink_interval = n_ms;
-	LCUITimer_Reset(caret->timer_id, caret->blink_interval);
+	TextCaret_SetBlinkInterval(n_ms);
 }
 
 static void TextCaret_OnDestroy(LCUI_Widget widget)
 {
-	LCUI_TextCaret caret;
-
-	caret = Widget_GetData(widget, prototype);
-	caret->task->active = FALSE;
-	if (LCUITimer_Free(caret->timer_id) != -1) {
-		free(caret->task);
-		caret->task = NULL;
-	}
-	caret->timer_id = -1;
+	TextCaret_UnbindBlink(widget);
 }
 
 void LCUIWidget_AddTextCaret(void)
@@ -44,8 +44,12 @@
 #include <LCUI/ime.h>
 
 #define TEXT_BLOCK_SIZE 512
+#define TEXT_BULK_CHUNK_SIZE 65536
 #define DEFAULT_WIDTH 176.0f
 #define PLACEHOLDER_COLOR RGB(140, 140, 140)
+#define SELECTION_COLOR ARGB(80, 33, 150, 243)
+#define CARET_WIDTH 1.0f
+#define CARET_COLOR RGB(0, 0, 0)
 #define GetData(W) Widget_GetData(W, self.prototype)
 #define AddData(W) Widget_AddData(W, self.prototype, sizeof(LCUI_TextEditRec))
 #define TextBlocks_Clear(blocks) LinkedList_Clear(blocks, TextBlock_OnDestroy)
@@ -60,7 +64,17 @@ typedef struct LCUI_TextEditRec_ {
 	LCUI_TextLayer layer;             /**< 当前使用的文本层 */
 	LCUI_ObjectWatcher value_watcher;
 	LCUI_Widget scrollbars[2];      /**< 两个滚动条 */
-	LCUI_Widget caret;              /**< 文本插入符 */
+	struct {
+		LCUI_BOOL visible;      /**< 是否显示（获得焦点时） */
+		LCUI_Rect rect;         /**< 在内容框中的区域，单位为实际像素 */
+		float width;            /**< 宽度，取自 textcaret 的样式 */
+		LCUI_Color color;       /**< 颜色，取自 textcaret 的样式 */
+	} caret;                        /**< 文本插入符 */
+	struct {
+		LCUI_BOOL active;
+		int start_row, start_col;
+		int end_row, end_col;
+	} selection;                    /**< 选中的文本范围 */
 	LCUI_BOOL is_read_only;         /**< 是否只读 */
 	LCUI_BOOL is_multiline_mode;    /**< 是否为多行模式 */
 	LCUI_BOOL is_placeholder_shown; /**< 是否已经显示占位符 */
@@ -76,7 +90,8 @@ typedef struct LCUI_TextEditRec_ {
 typedef enum {
 	TEXT_BLOCK_BEGIN,
 	TEXT_BLOCK_BODY,
-	TEXT_BLOCK_END
+	TEXT_BLOCK_END,
+	TEXT_BLOCK_BULK
 } TextBlockType;
 
 typedef enum {
@@ -96,6 +111,9 @@ typedef struct LCUI_TextBlockRec_ {
 	TextBlockAction action; /**< 指定该文本块的添加方式 */
 	wchar_t *text;          /**< 文本块(段) */
 	size_t length;          /**< 文本块的长度 */
+	size_t offset;          /**< 已处理的长度，仅用于批量加载的文本块 */
+	LCUI_TextEditProgressFunc progress; /**< 批量加载进度的回调函数 */
+	void *progress_arg;                 /**< 回调函数的附加参数 */
 } LCUI_TextBlockRec, *LCUI_TextBlock;
 
 static struct LCUI_TextEditModule {
@@ -134,15 +152,141 @@ static void fillchar(wchar_t *str, wchar_t ch)
 	}
 }
 
+/** 标记插入符所在的区域，闪烁和移动时只需要重绘这一小块区域 */
+static void TextEdit_InvalidateCaret(LCUI_Widget w)
+{
+	LCUI_RectF rect;
+	LCUI_TextEdit edit = GetData(w);
+
+	if (edit->caret.rect.height > 0) {
+		LCUIRect_ToRectF(&edit->caret.rect, &rect,
+				 1.0f / LCUIMetrics_GetScale());
+		Widget_InvalidateArea(w, &rect, SV_CONTENT_BOX);
+	}
+}
+
+static void TextEdit_OnCaretBlink(LCUI_Widget w, LCUI_BOOL visible)
+{
+	TextEdit_InvalidateCaret(w);
+}
+
+static void TextEdit_SetCaretVisible(LCUI_Widget w, LCUI_BOOL visible)
+{
+	LCUI_TextEdit edit = GetData(w);
+
+	if (edit->caret.visible == visible) {
+		return;
+	}
+	edit->caret.visible = visible;
+	if (visible) {
+		TextCaret_BindBlink(w, TextEdit_OnCaretBlink);
+		TextCaret_ResetBlink();
+	} else {
+		TextCaret_UnbindBlink(w);
+	}
+	TextEdit_InvalidateCaret(w);
+}
+
+/**
+ * 获取选中的文本在某一行中的区域
+ * @param[out] rect 在内容框中的区域，单位为实际像素
+ * @returns 该行有选中的文本则返回 TRUE
+ */
+static LCUI_BOOL TextEdit_GetSelectionRect(LCUI_TextEdit edit, int row,
+					   LCUI_Rect *rect)
+{
+	int col;
+	LCUI_Pos start, end;
+	LCUI_TextLayer layer = edit->layer;
+
+	if (!edit->selection.active || row < edit->selection.start_row ||
+	    row > edit->selection.end_row ||
+	    row >= TextLayer_GetRowTotal(layer)) {
+		return FALSE;
+	}
+	col = 0;
+	if (row == edit->selection.start_row) {
+		col = edit->selection.start_col;
+	}
+	if (TextLayer_GetCharPixelPos(layer, row, col, &start) != 0) {
+		return FALSE;
+	}
+	col = TextLayer_GetRowTextLength(layer, row);
+	if (row == edit->selection.end_row) {
+		col = min(col, edit->selection.end_col);
+	}
+	if (TextLayer_GetCharPixelPos(layer, row, col, &end) != 0) {
+		return FALSE;
+	}
+	rect->x = start.x + layer->offset_x;
+	rect->y = start.y + layer->offset_y;
+	rect->width = end.x - start.x;
+	rect->height = TextLayer_GetRowHeight(layer, row);
+	return rect->width > 0;
+}
+
+/** 标记选中的文本所在的行 */
+static void TextEdit_InvalidateSelection(LCUI_Widget w)
+{
+	int row;
+	LCUI_Rect rect;
+	LCUI_RectF rectf;
+	LCUI_TextEdit edit = GetData(w);
+	float scale = LCUIMetrics_GetScale();
+
+	if (!edit->selection.active) {
+		return;
+	}
+	for (row = edit->selection.start_row; row <= edit->selection.end_row;
+	     ++row) {
+		if (TextEdit_GetSelectionRect(edit, row, &rect)) {
+			LCUIRect_ToRectF(&rect, &rectf, 1.0f / scale);
+			Widget_InvalidateArea(w, &rectf, SV_CONTENT_BOX);
+		}
+	}
+}
+
+void TextEdit_SetSelection(LCUI_Widget w, int start_row, int start_col,
+			   int end_row, int end_col)
+{
+	LCUI_TextEdit edit = GetData(w);
+
+	TextEdit_InvalidateSelection(w);
+	if (start_row > end_row ||
+	    (start_row == end_row && start_col > end_col)) {
+		edit->selection.start_row = end_row;
+		edit->selection.start_col = end_col;
+		edit->selection.end_row = start_row;
+		edit->selection.end_col = start_col;
+	} else {
+		edit->selection.start_row = start_row;
+		edit->selection.start_col = start_col;
+		edit->selection.end_row = end_row;
+		edit->selection.end_col = end_col;
+	}
+	edit->selection.active = TRUE;
+	TextEdit_InvalidateSelection(w);
+}
+
+void TextEdit_ClearSelection(LCUI_Widget w)
+{
+	LCUI_TextEdit edit = GetData(w);
+
+	TextEdit_InvalidateSelection(w);
+	edit->selection.active = FALSE;
+}
+
 static void TextEdit_UpdateCaret(LCUI_Widget widget)
 {
 	LCUI_TextEdit edit = GetData(widget);
 
 	int row = edit->layer->insert_y;
 	int offset_x, offset_y;
-	float height, width;
+	float height, width, caret_width, caret_height;
 	float scale = LCUIMetrics_GetScale();
 	float x, y, caret_x = 0, caret_y = 0;
+	float widget_x, widget_y;
+	LCUI_Rect rect;
 
 	if (!edit->is_placeholder_shown) {
 		LCUI_Pos pos;
@@ -158,7 +302,8 @@ static void TextEdit_UpdateCaret(LCUI_Widget widget)
 	y = caret_y + offset_y;
 	width = edit->layer->width / scale;
 	height = TextLayer_GetRowHeight(edit->layer, row) / scale;
-	Widget_SetStyle(edit->caret, key_height, height, px);
+	caret_width = edit->caret.width;
+	caret_height = height;
 	/* Keep the caret in the visible area */
 	if (x < 0) {
 		x = 0;
@@ -166,16 +311,16 @@ static void TextEdit_UpdateCaret(LCUI_Widget widget)
 	if (y < 0) {
 		y = 0;
 	}
-	if (x + edit->caret->width > widget->box.content.width) {
-		x = widget->box.content.width - edit->caret->width;
+	if (x + caret_width > widget->box.content.width) {
+		x = widget->box.content.width - caret_width;
 	}
-	if (y + edit->caret->height > widget->box.content.height) {
-		y = widget->box.content.height - edit->caret->height;
+	if (y + caret_height > widget->box.content.height) {
+		y = widget->box.content.height - caret_height;
 	}
 	/* Keep current line text in the visible area */
 	if (width < widget->box.content.width) {
 		x = caret_x;
-	} else if (edit->caret->width + offset_x + width <
+	} else if (caret_width + offset_x + width <
 		   widget->box.content.width) {
 		x = caret_x + widget->box.content.width -
 		    (edit->layer->width / scale);
@@ -186,10 +331,22 @@ static void TextEdit_UpdateCaret(LCUI_Widget widget)
 		edit->tasks[TASK_UPDATE] = TRUE;
 		Widget_AddTask(widget, LCUI_WTASK_USER);
 	}
-	x += widget->padding.left;
-	y += widget->padding.top;
-	Widget_Move(edit->caret, x, y);
-	TextCaret_Refresh(edit->caret);
+	rect.x = iround(x * scale);
+	rect.y = iround(y * scale);
+	rect.width = max(1, iround(caret_width * scale));
+	rect.height = iround(caret_height * scale);
+	if (!LCUIRect_IsEquals(&rect, &edit->caret.rect)) {
+		TextEdit_InvalidateCaret(widget);
+		edit->caret.rect = rect;
+		TextEdit_InvalidateCaret(widget);
+	}
+	if (edit->caret.visible) {
+		TextCaret_ResetBlink();
+		Widget_GetOffset(widget, LCUIWidget_GetRoot(), &widget_x,
+				 &widget_y);
+		LCUIIME_SetCaret((int)(widget_x + widget->padding.left + x),
+				 (int)(widget_y + widget->padding.top + y));
+	}
 	if (edit->password_char) {
 		TextLayer_SetCaretPos(edit->layer_source, edit->layer->insert_y,
 				      edit->layer->insert_x);
@@ -214,6 +371,43 @@ static void TextBlock_OnDestroy(void *arg)
 	free(blk);
 }
 
+/**
+ * 添加批量加载的文本块
+ * 整段文本作为一个文本块，处理时直接由它构建文本行，不再分割成小块
+ */
+static int TextEdit_AddBulkTextBlock(LCUI_Widget widget, const wchar_t *wtext,
+				     size_t len, TextBlockAction action,
+				     LCUI_TextEditProgressFunc func, void *arg)
+{
+	LCUI_TextEdit edit;
+	LCUI_TextBlock block;
+
+	edit = Widget_GetData(widget, self.prototype);
+	block = NEW(LCUI_TextBlockRec, 1);
+	if (!block) {
+		return -ENOMEM;
+	}
+	block->text = NEW(wchar_t, len + 1);
+	if (!block->text) {
+		free(block);
+		return -ENOMEM;
+	}
+	memcpy(block->text, wtext, sizeof(wchar_t) * len);
+	block->text[len] = 0;
+	block->length = len;
+	block->type = TEXT_BLOCK_BULK;
+	block->owner = TEXT_BLOCK_OWNER_SOURCE;
+	block->action = action;
+	block->progress = func;
+	block->progress_arg = arg;
+	LCUIMutex_Lock(&edit->mutex);
+	LinkedList_Append(&edit->text_blocks, block);
+	LCUIMutex_Unlock(&edit->mutex);
+	edit->tasks[TASK_SET_TEXT] = TRUE;
+	Widget_AddTask(widget, LCUI_WTASK_USER);
+	return 0;
+}
+
 static int TextEdit_AddTextBlock(LCUI_Widget widget, const wchar_t *wtext,
 				 TextBlockAction action, TextBlockOwner owner)
 {
@@ -227,6 +421,13 @@ static int TextEdit_AddTextBlock(LCUI_Widget widget, const wchar_t *wtext,
 	}
 	len = wcslen(wtext);
 	edit = Widget_GetData(widget, self.prototype);
+	/* 没有样式标签时，较长的文本（例如粘贴的文本）直接按批量方式加载 */
+	if (owner == TEXT_BLOCK_OWNER_SOURCE &&
+	    !edit->layer_source->enable_style_tag &&
+	    len > edit->text_block_size) {
+		return TextEdit_AddBulkTextBlock(widget, wtext, len, action,
+						 NULL, NULL);
+	}
 	for (i = 0; i < len; ++i) {
 		block = NEW(LCUI_TextBlockRec, 1);
 		if (!block) {
@@ -339,6 +540,62 @@ static void TextEdit_ProcTextBlock(LCUI_Widget widget, LCUI_TextBlock txtblk)
 	}
 }
 
+/**
+ * 处理批量加载的文本块
+ * 有进度回调时每次最多处理 TEXT_BULK_CHUNK_SIZE 个字符，剩余的留到下一帧处理，
+ * 以免长时间阻塞界面；没有进度回调时一次处理完，以免调用者读到不完整的文本。
+ * 返回值表示该文本块是否已经处理完。
+ */
+static LCUI_BOOL TextEdit_ProcBulkTextBlock(LCUI_Widget widget,
+					    LCUI_TextBlock txtblk)
+{
+	size_t i, len;
+	wchar_t *text, *mask;
+	LCUI_TextEdit edit;
+
+	edit = Widget_GetData(widget, self.prototype);
+	text = txtblk->text + txtblk->offset;
+	len = txtblk->length - txtblk->offset;
+	if (txtblk->progress) {
+		len = min(len, TEXT_BULK_CHUNK_SIZE);
+	}
+	/* 不在 CR 和 LF 之间截断文本，以免换行符被识别成两个 */
+	if (len > 0 && txtblk->offset + len < txtblk->length &&
+	    text[len - 1] == '\r' && text[len] == '\n') {
+		++len;
+	}
+	/* 先分配掩码文本，分配失败时留到下一帧再处理，以免两个图层的文本不一致 */
+	mask = NULL;
+	if (edit->password_char) {
+		mask = NEW(wchar_t, len + 1);
+		if (!mask) {
+			return FALSE;
+		}
+		for (i = 0; i < len; ++i) {
+			mask[i] = edit->password_char;
+		}
+	}
+	if (txtblk->action == TEXT_BLOCK_ACTION_INSERT) {
+		TextLayer_InsertTextBulkW(edit->layer_source, text, len);
+	} else {
+		TextLayer_AppendTextBulkW(edit->layer_source, text, len);
+	}
+	if (mask) {
+		if (txtblk->action == TEXT_BLOCK_ACTION_INSERT) {
+			TextLayer_InsertTextBulkW(edit->layer_mask, mask, len);
+		} else {
+			TextLayer_AppendTextBulkW(edit->layer_mask, mask, len);
+		}
+		free(mask);
+	}
+	txtblk->offset += len;
+	if (txtblk->progress) {
+		txtblk->progress(widget, txtblk->offset, txtblk->length,
+				 txtblk->progress_arg);
+	}
+	return txtblk->offset >= txtblk->length;
+}
+
 /** 更新文本框的文本图层 */
 static void TextEdit_UpdateTextLayer(LCUI_Widget w)
 {
@@ -360,6 +617,8 @@ static void TextEdit_UpdateTextLayer(LCUI_Widget w)
 	style.fore_color = PLACEHOLDER_COLOR;
 	TextLayer_SetTextStyle(edit->layer_placeholder, &style);
 	TextStyle_Destroy(&style);
+	/* 文本变化后选中区域的位置也会变化，新旧位置都需要重绘 */
+	TextEdit_InvalidateSelection(w);
 	TextLayer_Update(edit->layer, &rects);
 	for (LinkedList_Each(node, &rects)) {
 		LCUIRect_ToRectF(node->data, &rect, 1.0f / scale);
@@ -367,6 +626,7 @@ static void TextEdit_UpdateTextLayer(LCUI_Widget w)
 	}
 	TextLayer_ClearInvalidRect(edit->layer);
 	RectList_Clear(&rects);
+	TextEdit_InvalidateSelection(w);
 }
 
 static void TextEdit_OnTask(LCUI_Widget widget, int task)
@@ -378,14 +638,39 @@ static void TextEdit_OnTask(LCUI_Widget widget, int task)
 		LinkedListNode *node;
 		LCUI_WidgetEventRec ev;
 
+		LCUI_TextBlock block;
+
 		LinkedList_Init(&blocks);
 		LCUIMutex_Lock(&edit->mutex);
 		LinkedList_Concat(&blocks, &edit->text_blocks);
 		LCUIMutex_Unlock(&edit->mutex);
-		for (LinkedList_Each(node, &blocks)) {
-			TextEdit_ProcTextBlock(widget, node->data);
+		while (blocks.length > 0) {
+			node = LinkedList_GetNode(&blocks, 0);
+			block = node->data;
+			if (block->type != TEXT_BLOCK_BULK) {
+				TextEdit_ProcTextBlock(widget, block);
+			} else if (task != LCUI_WTASK_USER ||
+				   !TextEdit_ProcBulkTextBlock(widget, block)) {
+				/* 每帧只在用户任务中处理一段批量加载的文本 */
+				break;
+			}
+			TextBlock_OnDestroy(block);
+			LinkedList_DeleteNode(&blocks, node);
+		}
+		/*
+		 * 批量加载的文本还没处理完，将剩余的文本块放回缓冲区，稍后继续
+		 * 处理。插入符和排版等到文本全部加载完后再更新。
+		 */
+		if (blocks.length > 0) {
+			LCUIMutex_Lock(&edit->mutex);
+			LinkedList_Concat(&blocks, &edit->text_blocks);
+			LinkedList_Concat(&edit->text_blocks, &blocks);
+			LCUIMutex_Unlock(&edit->mutex);
+			if (task == LCUI_WTASK_USER) {
+				Widget_AddTask(widget, LCUI_WTASK_USER);
+			}
+			return;
 		}
-		TextBlocks_Clear(&blocks);
 		LCUI_InitWidgetEvent(&ev, "change");
 		Widget_TriggerEvent(widget, &ev, NULL);
 		edit->tasks[TASK_SET_TEXT] = FALSE;
@@ -424,6 +709,10 @@ static void TextEdit_OnResize(LCUI_Widget w, float width, float height)
 	LinkedList_Init(&rects);
 	TextLayer_SetFixedSize(edit->layer, (int)(width * scale), (int)(width * scale));
 	TextLayer_SetMaxSize(edit->layer, (int)(height * scale), (int)(height * scale));
+	/* 文本还在加载中，等加载完后再排版 */
+	if (edit->tasks[TASK_SET_TEXT]) {
+		return;
+	}
 	TextLayer_Update(edit->layer, &rects);
 	TextLayer_ClearInvalidRect(edit->layer);
 	for (LinkedList_Each(node, &rects)) {
@@ -612,6 +901,27 @@ int TextEdit_InsertTextW(LCUI_Widget w, const wchar_t *wstr)
 				     TEXT_BLOCK_OWNER_SOURCE);
 }
 
+int TextEdit_InsertTextBulkW(LCUI_Widget w, const wchar_t *wstr,
+			     LCUI_TextEditProgressFunc func, void *arg)
+{
+	if (!wstr) {
+		return -1;
+	}
+	return TextEdit_AddBulkTextBlock(w, wstr, wcslen(wstr),
+					 TEXT_BLOCK_ACTION_INSERT, func, arg);
+}
+
+int TextEdit_LoadTextW(LCUI_Widget w, const wchar_t *wstr,
+		       LCUI_TextEditProgressFunc func, void *arg)
+{
+	if (!wstr) {
+		return -1;
+	}
+	TextEdit_ClearText(w);
+	return TextEdit_AddBulkTextBlock(w, wstr, wcslen(wstr),
+					 TEXT_BLOCK_ACTION_APPEND, func, arg);
+}
+
 int TextEdit_SetPlaceHolderW(LCUI_Widget w, const wchar_t *wstr)
 {
 	LCUI_TextEdit edit = GetData(w);
@@ -643,9 +953,8 @@ int TextEdit_SetPlaceHolder(LCUI_Widget w, const char *str)
 
 void TextEdit_SetCaretBlink(LCUI_Widget w, LCUI_BOOL visible, int time)
 {
-	LCUI_TextEdit edit = GetData(w);
-	TextCaret_SetVisible(edit->caret, visible);
-	TextCaret_SetBlinkTime(edit->caret, time);
+	TextEdit_SetCaretVisible(w, visible);
+	TextCaret_SetBlinkInterval(time);
 }
 
 static void TextEdit_OnParseText(LCUI_Widget w, const char *text)
@@ -655,10 +964,7 @@ static void TextEdit_OnParseText(LCUI_Widget w, const char *text)
 
 static void TextEdit_OnFocus(LCUI_Widget widget, LCUI_WidgetEvent e, void *arg)
 {
-	LCUI_TextEdit edit;
-
-	edit = Widget_GetData(widget, self.prototype);
-	TextCaret_SetVisible(edit->caret, TRUE);
+	TextEdit_SetCaretVisible(widget, TRUE);
 	TextEdit_UpdateCaret(widget);
 }
 
@@ -667,7 +973,7 @@ static void TextEdit_OnBlur(LCUI_Widget widget, LCUI_WidgetEvent e, void *arg)
 	LCUI_TextEdit edit;
 
 	edit = Widget_GetData(widget, self.prototype);
-	TextCaret_SetVisible(edit->caret, FALSE);
+	TextEdit_SetCaretVisible(widget, FALSE);
 	/* In single-line editing mode, we should reset the caret position to
 	 * the head, otherwise it will mistakenly think that only the last part
 	 * is entered after inputting long text. */
@@ -687,7 +993,7 @@ static void TextEdit_TextBackspace(LCUI_Widget widget, int n_ch)
 	if (edit->password_char) {
 		TextLayer_TextBackspace(edit->layer_mask, n_ch);
 	}
-	TextCaret_Refresh(edit->caret);
+	TextCaret_ResetBlink();
 	edit->tasks[TASK_UPDATE] = TRUE;
 	Widget_AddTask(widget, LCUI_WTASK_USER);
 	LCUIMutex_Unlock(&edit->mutex);
@@ -706,7 +1012,7 @@ static void TextEdit_TextDelete(LCUI_Widget widget, int n_ch)
 	if (edit->password_char) {
 		TextLayer_TextDelete(edit->layer_mask, n_ch);
 	}
-	TextCaret_Refresh(edit->caret);
+	TextCaret_ResetBlink();
 	edit->tasks[TASK_UPDATE] = TRUE;
 	Widget_AddTask(widget, LCUI_WTASK_USER);
 	LCUIMutex_Unlock(&edit->mutex);
@@ -892,7 +1198,12 @@ static void TextEdit_OnInit(LCUI_Widget w)
 	edit->layer = edit->layer_source;
 	edit->value_watcher = NULL;
 	edit->text_block_size = TEXT_BLOCK_SIZE;
-	edit->caret = LCUIWidget_New("textcaret");
+	edit->caret.visible = FALSE;
+	edit->caret.rect.x = edit->caret.rect.y = 0;
+	edit->caret.rect.width = edit->caret.rect.height = 0;
+	edit->caret.width = CARET_WIDTH;
+	edit->caret.color = CARET_COLOR;
+	edit->selection.active = FALSE;
 	w->computed_style.focusable = TRUE;
 	memset(edit->tasks, 0, sizeof(edit->tasks));
 	LinkedList_Init(&edit->text_blocks);
@@ -908,8 +1219,6 @@ static void TextEdit_OnInit(LCUI_Widget w)
 	Widget_BindEvent(w, "focus", TextEdit_OnFocus, NULL, NULL);
 	Widget_BindEvent(w, "blur", TextEdit_OnBlur, NULL, NULL);
 	Widget_BindEvent(w, "ready", TextEdit_OnReady, NULL, NULL);
-	Widget_Append(w, edit->caret);
-	Widget_Hide(edit->caret);
 	LCUIMutex_Init(&edit->mutex);
 	CSSFontStyle_Init(&edit->style);
 }
@@ -918,6 +1227,7 @@ static void TextEdit_OnDestroy(LCUI_Widget widget)
 {
 	LCUI_TextEdit edit = GetData(widget);
 
+	TextCaret_UnbindBlink(widget);
 	edit->layer = NULL;
 	TextLayer_Destroy(edit->layer_source);
 	TextLayer_Destroy(edit->layer_placeholder);
@@ -930,6 +1240,96 @@ static void TextEdit_OnDestroy(LCUI_Widget widget)
 	}
 }
 
+/** 获取选中的文本在某一行中需要绘制的区域 */
+static LCUI_BOOL TextEdit_GetSelectionArea(LCUI_TextEdit edit, int row,
+					   const LCUI_Rect *content_rect,
+					   LCUI_Rect *clip, LCUI_Rect *area)
+{
+	LCUI_Rect rect;
+
+	if (!TextEdit_GetSelectionRect(edit, row, &rect)) {
+		return FALSE;
+	}
+	rect.x += content_rect->x;
+	rect.y += content_rect->y;
+	return LCUIRect_GetOverlayRect(&rect, clip, area);
+}
+
+/**
+ * 绘制选中区域
+ * 各行共用一个足够大的半透明图层，只在有选中的行需要绘制时创建一次
+ */
+static void TextEdit_PaintSelection(LCUI_TextEdit edit,
+				    LCUI_PaintContext paint,
+				    LCUI_Rect *content_rect, LCUI_Rect *clip)
+{
+	int row, width = 0, height = 0;
+	LCUI_Graph mask, part;
+	LCUI_Rect area, part_rect;
+
+	if (!edit->selection.active) {
+		return;
+	}
+	for (row = edit->selection.start_row; row <= edit->selection.end_row;
+	     ++row) {
+		if (TextEdit_GetSelectionArea(edit, row, content_rect, clip,
+					      &area)) {
+			width = max(width, area.width);
+			height = max(height, area.height);
+		}
+	}
+	if (width < 1 || height < 1) {
+		return;
+	}
+	Graph_Init(&mask);
+	mask.color_type = LCUI_COLOR_TYPE_ARGB;
+	if (Graph_Create(&mask, width, height) != 0) {
+		return;
+	}
+	Graph_FillRect(&mask, SELECTION_COLOR, NULL, TRUE);
+	for (row = edit->selection.start_row; row <= edit->selection.end_row;
+	     ++row) {
+		if (!TextEdit_GetSelectionArea(edit, row, content_rect, clip,
+					       &area)) {
+			continue;
+		}
+		part_rect.x = 0;
+		part_rect.y = 0;
+		part_rect.width = area.width;
+		part_rect.height = area.height;
+		Graph_QuoteReadOnly(&part, &mask, &part_rect);
+		Graph_Mix(&paint->canvas, &part, area.x - paint->rect.x,
+			  area.y - paint->rect.y, paint->with_alpha);
+	}
+	Graph_Free(&mask);
+}
+
+/** 将选中区域和插入符绘制在文本上面 */
+static void TextEdit_PaintOverlay(LCUI_Widget w, LCUI_PaintContext paint,
+				  LCUI_Rect *content_rect)
+{
+	LCUI_Rect rect, area, clip;
+	LCUI_TextEdit edit = GetData(w);
+
+	if (!LCUIRect_GetOverlayRect(content_rect, &paint->rect, &clip)) {
+		return;
+	}
+	TextEdit_PaintSelection(edit, paint, content_rect, &clip);
+	if (!edit->caret.visible || !TextCaret_IsBlinkVisible()) {
+		return;
+	}
+	rect = edit->caret.rect;
+	rect.x += content_rect->x;
+	rect.y += content_rect->y;
+	if (!LCUIRect_GetOverlayRect(&rect, &clip, &area)) {
+		return;
+	}
+	area.x -= paint->rect.x;
+	area.y -= paint->rect.y;
+	Graph_FillRect(&paint->canvas, edit->caret.color, &area,
+		       paint->with_alpha);
+}
+
 static void TextEdit_OnPaint(LCUI_Widget w, LCUI_PaintContext paint,
 			     LCUI_WidgetActualStyle style)
 {
@@ -954,6 +1354,52 @@ static void TextEdit_OnPaint(LCUI_Widget w, LCUI_PaintContext paint,
 	rect.x -= content_rect.x;
 	rect.y -= content_rect.y;
 	TextLayer_RenderTo(edit->layer, rect, pos, &canvas);
+	TextEdit_PaintOverlay(w, paint, &content_rect);
+}
+
+/**
+ * 计算插入符的样式
+ * 插入符已经不是子部件了，但为了兼容已有的 CSS，仍然按照 textedit 中的
+ * textcaret 子部件来匹配样式，取其中的 width 和 background-color
+ */
+static LCUI_BOOL TextEdit_ComputeCaretStyle(LCUI_Widget w)
+{
+	float width = CARET_WIDTH;
+	LCUI_Color color = CARET_COLOR;
+	LCUI_Style s;
+	LCUI_Selector selector;
+	LCUI_SelectorNode node;
+	LCUI_CachedStyleSheet sheet;
+	LCUI_TextEdit edit = GetData(w);
+
+	selector = Widget_GetSelector(w);
+	node = NEW(LCUI_SelectorNodeRec, 1);
+	if (node && selector->length < MAX_SELECTOR_DEPTH - 1) {
+		node->type = strdup2("textcaret");
+		SelectorNode_Update(node);
+		Selector_AppendNode(selector, node);
+		selector->rank += node->rank;
+		Selector_Update(selector);
+		sheet = LCUI_GetCachedStyleSheet(selector);
+		s = &sheet->sheet[key_width];
+		if (s->is_valid && s->type == LCUI_STYPE_PX) {
+			width = s->px;
+		}
+		s = &sheet->sheet[key_background_color];
+		if (s->is_valid && s->type == LCUI_STYPE_COLOR) {
+			color = s->color;
+		}
+	} else if (node) {
+		free(node);
+	}
+	Selector_Delete(selector);
+	if (width == edit->caret.width &&
+	    color.value == edit->caret.color.value) {
+		return FALSE;
+	}
+	edit->caret.width = width;
+	edit->caret.color = color;
+	return TRUE;
 }
 
 static void TextEdit_OnUpdateStyle(LCUI_Widget w)
@@ -966,6 +1412,11 @@ static void TextEdit_OnUpdateStyle(LCUI_Widget w)
 	LCUI_TextLayer layers[3] = { edit->layer_mask, edit->layer_placeholder,
 				     edit->layer_source };
 
+	if (TextEdit_ComputeCaretStyle(w)) {
+		TextEdit_InvalidateCaret(w);
+		edit->tasks[TASK_UPDATE] = TRUE;
+		Widget_AddTask(w, LCUI_WTASK_USER);
+	}
 	CSSFontStyle_Init(&style);
 	CSSFontStyle_Compute(&style, w->style);
 	if (CSSFontStyle_IsEquals(&style, &edit->style)) {
@@ -61,6 +61,14 @@ typedef struct LCUI_TextViewRec_ {
 	LinkedListNode node;
 } LCUI_TextViewRec, *LCUI_TextView;
 
+/** 需要预先渲染的字形，它们的字体和像素大小都相同 */
+typedef struct LCUI_TextViewGlyphsRec_ {
+	int size;
+	int *font_ids;
+	wchar_t *codes;
+	size_t length;
+} LCUI_TextViewGlyphsRec, *LCUI_TextViewGlyphs;
+
 static struct LCUI_TextViewModule {
 	int key_word_break;
 	LinkedList list;
@@ -405,6 +413,137 @@ size_t LCUIWidget_RefreshTextView(void)
 	return count;
 }
 
+static void TextViewGlyphs_Destroy(void *arg)
+{
+	LCUI_TextViewGlyphs glyphs = arg;
+
+	free(glyphs->font_ids);
+	free(glyphs->codes);
+	free(glyphs);
+}
+
+/** 在工作线程上渲染字形，选择字体的方式与文本图层相同 */
+static void TextViewGlyphs_Render(void *arg1, void *arg2)
+{
+	size_t i;
+	int *font_id;
+	const LCUI_FontBitmap *bmp;
+	LCUI_TextViewGlyphs glyphs = arg1;
+
+	for (i = 0; i < glyphs->length; ++i) {
+		for (font_id = glyphs->font_ids; font_id && *font_id > 0;
+		     ++font_id) {
+			if (LCUIFont_GetBitmap(glyphs->codes[i], *font_id,
+					       glyphs->size, &bmp) == 0) {
+				break;
+			}
+		}
+		if (!font_id || *font_id <= 0) {
+			LCUIFont_GetBitmap(glyphs->codes[i], -1, glyphs->size,
+					   &bmp);
+		}
+	}
+}
+
+static LCUI_BOOL TextView_IsShown(LCUI_TextView txt)
+{
+	LCUI_Widget w;
+	LCUI_Widget root = LCUIWidget_GetRoot();
+
+	for (w = txt->widget; w; w = w->parent) {
+		if (!Widget_IsVisible(w)) {
+			return FALSE;
+		}
+		if (w == root) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/**
+ * 收集文本视图中的字形
+ * 字体样式按当前的缩放比例重新计算，有自定义字体和大小的字符由样式标签决定，
+ * 不在预先渲染的范围内。
+ */
+static LCUI_TextViewGlyphs TextView_CollectGlyphs(LCUI_TextView txt)
+{
+	int i, j;
+	size_t len = 0;
+	LCUI_TextChar ch;
+	LCUI_TextRow row;
+	LCUI_TextViewGlyphs glyphs;
+	LCUI_CSSFontStyleRec style;
+	LCUI_TextRowList rows = &txt->layer->text_rows;
+
+	for (i = 0; i < rows->length; ++i) {
+		len += rows->rows[i]->length;
+	}
+	if (len < 1) {
+		return NULL;
+	}
+	glyphs = NEW(LCUI_TextViewGlyphsRec, 1);
+	if (!glyphs) {
+		return NULL;
+	}
+	glyphs->codes = malloc(sizeof(wchar_t) * len);
+	if (!glyphs->codes) {
+		free(glyphs);
+		return NULL;
+	}
+	CSSFontStyle_Init(&style);
+	CSSFontStyle_Compute(&style, txt->widget->style);
+	glyphs->size = style.font_size;
+	if (style.font_stack && style.font_stack->font_ids) {
+		len = style.font_stack->length + 1;
+		glyphs->font_ids = malloc(sizeof(int) * len);
+		if (glyphs->font_ids) {
+			memcpy(glyphs->font_ids, style.font_stack->font_ids,
+			       sizeof(int) * len);
+		}
+	}
+	CSSFontStyle_Destroy(&style);
+	for (i = 0; i < rows->length; ++i) {
+		row = rows->rows[i];
+		for (j = 0; j < row->length; ++j) {
+			ch = row->string[j];
+			if (ch->style &&
+			    (ch->style->has_family || ch->style->has_pixel_size)) {
+				continue;
+			}
+			glyphs->codes[glyphs->length++] = ch->code;
+		}
+	}
+	return glyphs;
+}
+
+size_t LCUIWidget_PrerenderTextView(void)
+{
+	size_t count = 0;
+	LCUI_TaskRec task = { 0 };
+	LCUI_TextView txt;
+	LCUI_TextViewGlyphs glyphs;
+	LinkedListNode *node;
+
+	for (LinkedList_Each(node, &self.list)) {
+		txt = node->data;
+		if (txt->widget->state == LCUI_WSTATE_DELETED ||
+		    !TextView_IsShown(txt)) {
+			continue;
+		}
+		glyphs = TextView_CollectGlyphs(txt);
+		if (!glyphs) {
+			continue;
+		}
+		count += glyphs->length;
+		task.func = TextViewGlyphs_Render;
+		task.arg[0] = glyphs;
+		task.destroy_arg[0] = TextViewGlyphs_Destroy;
+		LCUI_PostAsyncTask(&task);
+	}
+	return count;
+}
+
 static void TextVIew_OnTask(LCUI_Widget w, int task)
 {
 	LCUI_TextView txt;
@@ -46,11 +46,18 @@ typedef struct ImageCacheRec_ {
 	LinkedList refs;
 } ImageCacheRec, *ImageCache;
 
+/** 部件的图像样式对图像缓存的引用，以部件和样式键进行索引 */
 typedef struct ImageRefRec_ {
 	LCUI_Widget widget;
+	int key;
 	ImageCache cache;
 } ImageRefRec, *ImageRef;
 
+typedef struct ImageLoaderTaskRec_ {
+	int key;
+	char *path;
+} ImageLoaderTaskRec, *ImageLoaderTask;
+
 static struct LCUI_WidgetBackgroundModule {
 	LCUI_BOOL active;
 	DictType dtype;
@@ -58,15 +65,30 @@ static struct LCUI_WidgetBackgroundModule {
 	RBTree refs;
 } self;
 
+/** 获取部件中用于存放图像样式计算结果的图像 */
+static LCUI_Graph *Widget_GetImageStyle(LCUI_Widget w, int key)
+{
+	if (key == key_border_image_source) {
+		return &w->computed_style.border_image.source;
+	}
+	return &w->computed_style.background.image;
+}
+
 static void DestroyImageCache(ImageCache cache)
 {
+	int key;
+	LCUI_Widget w;
+	ImageRef ref;
 	LinkedListNode *node;
+
 	while ((node = LinkedList_GetNode(&cache->refs, 0))) {
-		LCUI_Widget w = node->data;
-		RBTree_CustomErase(&self.refs, node->data);
-		Widget_UnsetStyle(w, key_background_image);
-		Graph_Init(&w->computed_style.background.image);
+		ref = node->data;
+		w = ref->widget;
+		key = ref->key;
 		LinkedList_DeleteNode(&cache->refs, node);
+		RBTree_CustomErase(&self.refs, ref);
+		Widget_UnsetStyle(w, key);
+		Graph_Init(Widget_GetImageStyle(w, key));
 	}
 	Graph_Free(&cache->image);
 	free(cache->path);
@@ -79,42 +101,45 @@ static void ImageCacheDestructor(void *privdata, void *data)
 	DestroyImageCache(data);
 }
 
-static void AddImageRef(LCUI_Widget widget, ImageCache cache)
+static void AddImageRef(LCUI_Widget widget, int key, ImageCache cache)
 {
 	ASSIGN(ref, ImageRef);
 	ref->cache = cache;
 	ref->widget = widget;
-	RBTree_CustomInsert(&self.refs, widget, ref);
-	LinkedList_Append(&cache->refs, widget);
+	ref->key = key;
+	RBTree_CustomInsert(&self.refs, ref, ref);
+	LinkedList_Append(&cache->refs, ref);
 }
 
-static ImageRef GetImageRef(LCUI_Widget widget)
+static ImageRef GetImageRef(LCUI_Widget widget, int key)
 {
-	return RBTree_CustomGetData(&self.refs, widget);
+	ImageRefRec ref;
+
+	ref.widget = widget;
+	ref.key = key;
+	return RBTree_CustomGetData(&self.refs, &ref);
 }
 
-static void DeleteImageRef(LCUI_Widget widget)
+static void DeleteImageRef(LCUI_Widget widget, int key)
 {
 	ImageRef ref;
 	ImageCache cache;
 	LinkedListNode *node;
-	ref = GetImageRef(widget);
+
+	ref = GetImageRef(widget, key);
 	if (!ref) {
 		return;
 	}
 	cache = ref->cache;
 	for (LinkedList_Each(node, &cache->refs)) {
-		LCUI_Widget w = node->data;
-		if (w != widget) {
-			continue;
+		if (node->data == ref) {
+			LinkedList_DeleteNode(&cache->refs, node);
+			break;
 		}
-		RBTree_CustomErase(&self.refs, node->data);
-		Widget_UnsetStyle(w, key_background_image);
-		Graph_Init(&w->computed_style.background.image);
-		LinkedList_DeleteNode(&cache->refs, node);
-		break;
 	}
-	RBTree_CustomErase(&self.refs, widget);
+	RBTree_CustomErase(&self.refs, ref);
+	Widget_UnsetStyle(widget, key);
+	Graph_Init(Widget_GetImageStyle(widget, key));
 	if (cache->refs.length < 1) {
 		Dict_Delete(self.images, cache->path);
 	}
@@ -122,71 +147,82 @@ static void DeleteImageRef(LCUI_Widget widget)
 
 static void ExecLoadImage(void *arg1, void *arg2)
 {
-	char *path = arg2;
 	LCUI_Graph image;
 	LCUI_Widget w = arg1;
+	ImageLoaderTask task = arg2;
 	ImageCache cache;
 
 	Graph_Init(&image);
-	if (LCUI_ReadImageFile(path, &image) != 0) {
+	if (LCUI_ReadImageFile(task->path, &image) != 0) {
 		return;
 	}
 	cache = NEW(ImageCacheRec, 1);
 	cache->image = image;
-	cache->path = strdup2(path);
+	cache->path = strdup2(task->path);
 	LinkedList_Init(&cache->refs);
 	if (Dict_Add(self.images, cache->path, cache) == 0) {
-		AddImageRef(w, cache);
+		AddImageRef(w, task->key, cache);
 	} else {
 		DestroyImageCache(cache);
 	}
-	Graph_Quote(&w->computed_style.background.image, &cache->image, NULL);
+	Graph_Quote(Widget_GetImageStyle(w, task->key), &cache->image, NULL);
 	Widget_InvalidateArea(w, NULL, SV_BORDER_BOX);
 }
 
-static int OnCompareWidget(void *data, const void *keydata)
+static void DestroyImageLoaderTask(void *arg)
+{
+	ImageLoaderTask task = arg;
+
+	free(task->path);
+	free(task);
+}
+
+static int OnCompareImageRef(void *data, const void *keydata)
 {
 	ImageRef ref = data;
-	if (ref->widget == keydata) {
-		return 0;
-	}
-	if ((void *)ref->widget > keydata) {
-		return 1;
+	const ImageRefRec *key = keydata;
+
+	if (ref->widget != key->widget) {
+		return (void *)ref->widget > (void *)key->widget ? 1 : -1;
 	}
-	return -1;
+	return ref->key - key->key;
 }
 
-static void AsyncLoadImage(LCUI_Widget widget, const char *path)
+static void AsyncLoadImage(LCUI_Widget widget, int key, const char *path)
 {
 	ImageRef ref;
 	ImageCache cache;
+	ImageLoaderTask loader;
 	LCUI_TaskRec task = { 0 };
-	LCUI_Style s = &widget->style->sheet[key_background_image];
+	LCUI_Style s = &widget->style->sheet[key];
 
 	if (!self.active) {
 		return;
 	}
-	if (Widget_CheckStyleType(widget, key_background_image, string)) {
-		ref = GetImageRef(widget);
+	if (Widget_CheckStyleType(widget, key, string)) {
+		ref = GetImageRef(widget, key);
 		if (ref && strcmp(ref->cache->path, s->string) == 0) {
 			return;
 		}
 		if (ref) {
-			DeleteImageRef(widget);
+			DeleteImageRef(widget, key);
 		}
 	}
 	cache = Dict_FetchValue(self.images, path);
 	if (cache) {
-		AddImageRef(widget, cache);
-		Graph_Quote(&widget->computed_style.background.image,
-			    &cache->image, NULL);
+		AddImageRef(widget, key, cache);
+		Graph_Quote(Widget_GetImageStyle(widget, key), &cache->image,
+			    NULL);
 		Widget_InvalidateArea(widget, NULL, SV_BORDER_BOX);
 		return;
 	}
+	loader = NEW(ImageLoaderTaskRec, 1);
+	loader->key = key;
+	loader->path = strdup2(path);
 	task.func = ExecLoadImage;
 	task.arg[0] = widget;
-	task.arg[1] = strdup2(path);
-	task.destroy_arg[1] = free;
+	task.arg[1] = loader;
+	task.destroy_arg[1] = DestroyImageLoaderTask;
 	LCUI_PostAsyncTask(&task);
 }
 
@@ -196,7 +232,7 @@ void LCUIWidget_InitImageLoader(void)
 	Dict_InitStringKeyType(&self.dtype);
 	self.dtype.valDestructor = ImageCacheDestructor;
 	self.images = Dict_Create(&self.dtype, NULL);
-	RBTree_OnCompare(&self.refs, OnCompareWidget);
+	RBTree_OnCompare(&self.refs, OnCompareImageRef);
 	RBTree_OnDestroy(&self.refs, free);
 	self.active = TRUE;
 }
@@ -215,18 +251,52 @@ void Widget_InitBackground(LCUI_Widget w)
 	bg = &w->computed_style.background;
 	bg->color = RGB(255, 255, 255);
 	Graph_Init(&bg->image);
+	Graph_Init(&w->computed_style.border_image.source);
 	bg->size.using_value = TRUE;
 	bg->size.value = SV_AUTO;
 	bg->position.using_value = TRUE;
 	bg->position.value = SV_AUTO;
 }
 
+static void Widget_DestroyImageStyle(LCUI_Widget w, int key)
+{
+	Widget_UnsetStyle(w, key);
+	Graph_Init(Widget_GetImageStyle(w, key));
+	if (Widget_CheckStyleType(w, key, string)) {
+		DeleteImageRef(w, key);
+	}
+}
+
 void Widget_DestroyBackground(LCUI_Widget w)
 {
-	Widget_UnsetStyle(w, key_background_image);
-	Graph_Init(&w->computed_style.background.image);
-	if (Widget_CheckStyleType(w, key_background_image, string)) {
-		DeleteImageRef(w);
+	Widget_DestroyImageStyle(w, key_background_image);
+	Widget_DestroyImageStyle(w, key_border_image_source);
+}
+
+void Widget_ComputeImageStyle(LCUI_Widget w, int key)
+{
+	LCUI_Style s = &w->style->sheet[key];
+	LCUI_Graph *image = Widget_GetImageStyle(w, key);
+
+	if (!s->is_valid) {
+		Graph_Init(image);
+		return;
+	}
+	switch (s->type) {
+	case LCUI_STYPE_STRING:
+		AsyncLoadImage(w, key, s->string);
+		break;
+	case LCUI_STYPE_IMAGE:
+		if (!s->image) {
+			Graph_Init(image);
+			break;
+		}
+		DeleteImageRef(w, key);
+		Graph_Quote(image, s->image, NULL);
+		break;
+	default:
+		Graph_Init(image);
+		break;
 	}
 }
 
@@ -248,24 +318,7 @@ void Widget_ComputeBackgroundStyle(LCUI_Widget widget)
 			}
 			break;
 		case key_background_image:
-			if (!s->is_valid) {
-				Graph_Init(&bg->image);
-				break;
-			}
-			switch (s->type) {
-			case LCUI_STYPE_STRING:
-				AsyncLoadImage(widget, s->string);
-				break;
-			case LCUI_STYPE_IMAGE:
-				if (!s->image) {
-					Graph_Init(&bg->image);
-					break;
-				}
-				Graph_Quote(&bg->image, s->image, NULL);
-				DeleteImageRef(widget);
-			default:
-				break;
-			}
+			Widget_ComputeImageStyle(widget, key);
 			break;
 		case key_background_position:
 			if (s->is_valid && s->type != LCUI_STYPE_NONE) {
@@ -36,6 +36,9 @@ void Widget_InitBackground(LCUI_Widget w);
 
 void Widget_DestroyBackground(LCUI_Widget w);
 
+/** 计算图像样式，若样式值是图像路径则异步载入图像 */
+void Widget_ComputeImageStyle(LCUI_Widget w, int key);
+
 void Widget_ComputeBackgroundStyle(LCUI_Widget widget);
 
 void Widget_PaintBakcground(LCUI_Widget w, LCUI_PaintContext paint,
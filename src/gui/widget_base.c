@@ -39,6 +39,7 @@
 #include <LCUI/gui/metrics.h>
 #include "widget_util.h"
 #include "widget_background.h"
+#include "widget_border.h"
 #include "widget_shadow.h"
 
 static struct LCUI_WidgetModule {
@@ -96,6 +97,7 @@ static void Widget_Init(LCUI_Widget widget)
 	widget->node_show.data = widget;
 	widget->node.next = widget->node.prev = NULL;
 	widget->node_show.next = widget->node_show.prev = NULL;
+	Graph_Init(&widget->content_cache);
 	Widget_InitBackground(widget);
 }
 
@@ -129,12 +131,15 @@ LCUI_Widget LCUIWidget_New(const char *type)
 
 void Widget_ExecDestroy(LCUI_Widget w)
 {
+	Widget_RemoveFromInvalidJournal(w);
 	if (w->parent) {
 		Widget_AddTask(w->parent, LCUI_WTASK_REFLOW);
 		Widget_Unlink(w);
 	}
 	Widget_DestroyBackground(w);
+	Widget_DestroyBorderImage(w);
 	Widget_DestroyEventTrigger(w);
+	Widget_DestroyContentCache(w);
 	Widget_DestroyChildren(w);
 	Widget_ClearPrototype(w);
 	if (w->title) {
@@ -317,15 +322,22 @@ LCUI_BOOL Widget_InVisibleArea(LCUI_Widget w)
 
 int Widget_SetRules(LCUI_Widget w, const LCUI_WidgetRulesRec *rules)
 {
+	LCUI_BOOL cache_children_style = FALSE;
 	LCUI_WidgetRulesData data;
 
 	data = (LCUI_WidgetRulesData)w->rules;
 	if (data) {
-		Dict_Release(data->style_cache);
+		cache_children_style = data->rules.cache_children_style;
+		if (data->style_cache) {
+			Dict_Release(data->style_cache);
+		}
 		free(data);
 		w->rules = NULL;
 	}
 	if (!rules) {
+		if (cache_children_style) {
+			Widget_UpdateHash(w);
+		}
 		return 0;
 	}
 	data = malloc(sizeof(LCUI_WidgetRulesDataRec));
@@ -337,6 +349,9 @@ int Widget_SetRules(LCUI_Widget w, const LCUI_WidgetRulesRec *rules)
 	data->style_cache = NULL;
 	data->default_max_update_count = 2048;
 	w->rules = (LCUI_WidgetRules)data;
+	if (rules->cache_children_style != cache_children_style) {
+		Widget_UpdateHash(w);
+	}
 	return 0;
 }
 
@@ -490,16 +505,11 @@ void Widget_UpdateBoxPosition(LCUI_Widget w)
 	w->box.outer.y = y;
 	w->x = x + w->margin.left;
 	w->y = y + w->margin.top;
-	if (w->invalid_area_type == LCUI_INVALID_AREA_TYPE_NONE &&
+	if (w->invalid_area_type == LCUI_INVALID_AREA_TYPE_NONE && !w->moved &&
 	    (w->x != w->box.border.x || w->y != w->box.border.y)) {
-		LCUI_Widget parent = w->parent;
-
-		w->invalid_area = w->box.canvas;
-		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
-		while (parent) {
-			parent->has_child_invalid_area = TRUE;
-			parent = parent->parent;
-		}
+		w->moved = TRUE;
+		w->moved_from = w->box.canvas;
+		Widget_AddToInvalidJournal(w);
 	}
 	w->box.border.x = w->x;
 	w->box.border.y = w->y;
@@ -526,14 +536,9 @@ void Widget_UpdateBoxSize(LCUI_Widget w)
 	if (w->invalid_area_type == LCUI_INVALID_AREA_TYPE_NONE &&
 	    (w->width != w->box.border.width ||
 	     w->height != w->box.border.height)) {
-		LCUI_Widget parent = w->parent;
-
 		w->invalid_area = w->box.canvas;
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
-		while (parent) {
-			parent->has_child_invalid_area = TRUE;
-			parent = parent->parent;
-		}
+		Widget_AddToInvalidJournal(w);
 	}
 	w->box.border.width = w->width;
 	w->box.border.height = w->height;
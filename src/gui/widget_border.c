@@ -29,12 +29,17 @@
  */
 
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/gui/metrics.h>
 #include <LCUI/gui/widget.h>
 #include "widget_border.h"
+#include "widget_background.h"
+
+/** 保护各部件的边框图像的图块缓存，生成图块时不持有该锁 */
+static LCUI_Mutex border_image_mutex;
 
 static float ComputeXMetric(LCUI_Widget w, LCUI_Style s)
 {
@@ -52,6 +57,61 @@ static float ComputeYMetric(LCUI_Widget w, LCUI_Style s)
 	return LCUIMetrics_Compute(s->value, s->type);
 }
 
+static void Widget_ComputeBorderImageStyle(LCUI_Widget w)
+{
+	int key;
+	LCUI_Style s;
+	LCUI_BorderImageStyle *bi = &w->computed_style.border_image;
+
+	/* 初始值为 border-image-slice: 100%; border-image-repeat: stretch; */
+	bi->slice.top.is_valid = TRUE;
+	bi->slice.top.type = LCUI_STYPE_SCALE;
+	bi->slice.top.scale = 1.0f;
+	bi->slice.right = bi->slice.top;
+	bi->slice.bottom = bi->slice.top;
+	bi->slice.left = bi->slice.top;
+	bi->fill = FALSE;
+	bi->repeat_x = SV_STRETCH;
+	bi->repeat_y = SV_STRETCH;
+	for (key = key_border_image_slice_top; key <= key_border_image_repeat_y;
+	     ++key) {
+		s = &w->style->sheet[key];
+		if (!s->is_valid) {
+			continue;
+		}
+		switch (key) {
+		case key_border_image_slice_top:
+			bi->slice.top = *s;
+			break;
+		case key_border_image_slice_right:
+			bi->slice.right = *s;
+			break;
+		case key_border_image_slice_bottom:
+			bi->slice.bottom = *s;
+			break;
+		case key_border_image_slice_left:
+			bi->slice.left = *s;
+			break;
+		case key_border_image_slice_fill:
+			bi->fill = s->val_bool;
+			break;
+		case key_border_image_repeat_x:
+			bi->repeat_x = s->val_style;
+			break;
+		case key_border_image_repeat_y:
+			bi->repeat_y = s->val_style;
+			break;
+		default:
+			break;
+		}
+	}
+	/**
+	 * 图块缓存会在绘制时与新的参数比较，只有切片、宽度、重复方式、填充和
+	 * 源图像真正改变时才会重新生成，所以这里不释放它
+	 */
+	Widget_ComputeImageStyle(w, key_border_image_source);
+}
+
 void Widget_ComputeBorderStyle(LCUI_Widget w)
 {
 	int key;
@@ -117,6 +177,7 @@ void Widget_ComputeBorderStyle(LCUI_Widget w)
 			break;
 		}
 	}
+	Widget_ComputeBorderImageStyle(w);
 }
 
 static unsigned int ComputeActual(float width)
@@ -167,6 +228,113 @@ void Widget_PaintBorder(LCUI_Widget w, LCUI_PaintContext paint,
 	Border_Paint(&style->border, &box, paint);
 }
 
+/** 计算切片线的实际值，百分比相对于源图像的尺寸 */
+static int ComputeSlice(const LCUI_StyleRec *s, unsigned int size)
+{
+	switch (s->type) {
+	case LCUI_STYPE_SCALE:
+		return (int)(size * s->scale + 0.5f);
+	case LCUI_STYPE_PX:
+		return (int)(s->px + 0.5f);
+	case LCUI_STYPE_INT:
+		return s->val_int;
+	default:
+		break;
+	}
+	return 0;
+}
+
+void Widget_ComputeBorderImage(LCUI_Widget w, const LCUI_Border *border,
+			       LCUI_BorderImage *out)
+{
+	LCUI_BorderImageStyle *s = &w->computed_style.border_image;
+
+	out->source = &s->source;
+	out->slice.top = ComputeSlice(&s->slice.top, s->source.height);
+	out->slice.right = ComputeSlice(&s->slice.right, s->source.width);
+	out->slice.bottom = ComputeSlice(&s->slice.bottom, s->source.height);
+	out->slice.left = ComputeSlice(&s->slice.left, s->source.width);
+	out->width.top = border->top.width;
+	out->width.right = border->right.width;
+	out->width.bottom = border->bottom.width;
+	out->width.left = border->left.width;
+	out->fill = s->fill;
+	out->repeat_x = s->repeat_x;
+	out->repeat_y = s->repeat_y;
+}
+
+void Widget_PaintBorderImage(LCUI_Widget w, LCUI_PaintContext paint,
+			     LCUI_WidgetActualStyle style)
+{
+	LCUI_Rect box;
+	LCUI_BorderImage image;
+	LCUI_BorderImageTiles cache;
+	LCUI_BorderImageTilesRec tiles;
+
+	box.x = style->border_box.x - style->canvas_box.x;
+	box.y = style->border_box.y - style->canvas_box.y;
+	box.width = style->border_box.width;
+	box.height = style->border_box.height;
+	Widget_ComputeBorderImage(w, &style->border, &image);
+	BorderImageTiles_Init(&tiles);
+	/* 在锁内只复制缓存的图块，绘制和重新生成图块都在锁外进行 */
+	LCUIMutex_Lock(&border_image_mutex);
+	cache = w->border_image_cache;
+	if (cache &&
+	    BorderImageTiles_IsValid(cache, &image, box.width, box.height)) {
+		BorderImageTiles_Copy(&tiles, cache);
+		LCUIMutex_Unlock(&border_image_mutex);
+		BorderImageTiles_Paint(&tiles, &box, paint);
+		BorderImageTiles_Free(&tiles);
+		return;
+	}
+	LCUIMutex_Unlock(&border_image_mutex);
+	if (BorderImageTiles_Update(&tiles, &image, box.width, box.height) <
+	    0) {
+		return;
+	}
+	LCUIMutex_Lock(&border_image_mutex);
+	if (!w->border_image_cache) {
+		w->border_image_cache = NEW(LCUI_BorderImageTilesRec, 1);
+		if (w->border_image_cache) {
+			BorderImageTiles_Init(w->border_image_cache);
+		}
+	}
+	/* 如果其它线程已经保存了可用的图块，则保留已有的图块 */
+	cache = w->border_image_cache;
+	if (cache &&
+	    !BorderImageTiles_IsValid(cache, &image, box.width, box.height)) {
+		BorderImageTiles_Copy(cache, &tiles);
+	}
+	LCUIMutex_Unlock(&border_image_mutex);
+	BorderImageTiles_Paint(&tiles, &box, paint);
+	BorderImageTiles_Free(&tiles);
+}
+
+void Widget_DestroyBorderImage(LCUI_Widget w)
+{
+	LCUI_BorderImageTiles cache;
+
+	LCUIMutex_Lock(&border_image_mutex);
+	cache = w->border_image_cache;
+	w->border_image_cache = NULL;
+	LCUIMutex_Unlock(&border_image_mutex);
+	if (cache) {
+		BorderImageTiles_Free(cache);
+		free(cache);
+	}
+}
+
+void LCUIWidget_InitBorderImage(void)
+{
+	LCUIMutex_Init(&border_image_mutex);
+}
+
+void LCUIWidget_FreeBorderImage(void)
+{
+	LCUIMutex_Destroy(&border_image_mutex);
+}
+
 void Widget_CropContent(LCUI_Widget w, LCUI_PaintContext paint,
 			LCUI_WidgetActualStyle style)
 {
@@ -35,5 +35,21 @@ void Widget_ComputeBorderStyle(LCUI_Widget w);
 void Widget_PaintBorder(LCUI_Widget w, LCUI_PaintContext paint,
 				 LCUI_WidgetActualStyle style);
 
+void Widget_ComputeBorderImage(LCUI_Widget w, const LCUI_Border *border,
+			       LCUI_BorderImage *out);
+
+/**
+ * 绘制边框图像，图块缓存在部件中
+ * 访问缓存时会锁定边框图像的锁，但生成和绘制图块时不持有该锁
+ */
+void Widget_PaintBorderImage(LCUI_Widget w, LCUI_PaintContext paint,
+			     LCUI_WidgetActualStyle style);
+
+void Widget_DestroyBorderImage(LCUI_Widget w);
+
+void LCUIWidget_InitBorderImage(void);
+
+void LCUIWidget_FreeBorderImage(void);
+
 void Widget_CropContent(LCUI_Widget w, LCUI_PaintContext paint,
 				 LCUI_WidgetActualStyle style);
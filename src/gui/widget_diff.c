@@ -36,6 +36,29 @@
 
 #define MEMCMP(A, B) memcmp(A, B, sizeof(*(A)))
 
+#define IsRectMovedEquals(A, B, REF_A, REF_B)                 \
+	((A)->width == (B)->width && (A)->height == (B)->height && \
+	 (A)->x - (REF_A)->x == (B)->x - (REF_B)->x &&            \
+	 (A)->y - (REF_A)->y == (B)->y - (REF_B)->y)
+
+/**
+ * Check whether the widget has only been moved, all of its boxes keep their
+ * sizes and are moved by the same distance
+ */
+static LCUI_BOOL Widget_IsBoxOnlyMoved(LCUI_Widget w,
+				       const LCUI_WidgetBoxModelRec *box)
+{
+	const LCUI_RectF *a = &box->border;
+	const LCUI_RectF *b = &w->box.border;
+
+	return w->moved &&
+	       w->invalid_area_type == LCUI_INVALID_AREA_TYPE_NONE &&
+	       a->width == b->width && a->height == b->height &&
+	       IsRectMovedEquals(&box->content, &w->box.content, a, b) &&
+	       IsRectMovedEquals(&box->padding, &w->box.padding, a, b) &&
+	       IsRectMovedEquals(&box->canvas, &w->box.canvas, a, b);
+}
+
 void Widget_InitStyleDiff(LCUI_Widget w, LCUI_WidgetStyleDiff diff)
 {
 	diff->box = w->box;
@@ -76,6 +99,7 @@ void Widget_BeginStyleDiff(LCUI_Widget w, LCUI_WidgetStyleDiff diff)
 	diff->position = style->position;
 	diff->shadow = style->shadow;
 	diff->border = style->border;
+	diff->border_image = style->border_image;
 	diff->background = style->background;
 	diff->flex = style->flex;
 }
@@ -98,12 +122,86 @@ INLINE void Widget_AddReflowTaskToParent(LCUI_Widget w)
 	Widget_AddReflowTask(w->parent);
 }
 
+/** Check whether only the canvas box has been resized by the box shadow */
+static LCUI_BOOL Widget_IsOnlyCanvasResized(LCUI_Widget w,
+					    const LCUI_WidgetBoxModelRec *box)
+{
+	return LCUIRectF_IsEquals(&box->border, &w->box.border) &&
+	       LCUIRectF_IsEquals(&box->padding, &w->box.padding) &&
+	       LCUIRectF_IsEquals(&box->content, &w->box.content);
+}
+
+/**
+ * Mark the changed parts of the widget if only its background, border
+ * colors or box shadow have been changed, so that the content and children
+ * do not need to be repainted
+ */
+static LCUI_BOOL Widget_UpdateRepaintFlags(LCUI_Widget w,
+					   LCUI_WidgetStyleDiff diff)
+{
+	int flags = 0;
+	const LCUI_BorderStyle *a = &diff->border;
+	const LCUI_BorderStyle *b = &w->computed_style.border;
+
+	if (w->invalid_area_type != LCUI_INVALID_AREA_TYPE_NONE ||
+	    !Widget_IsOnlyCanvasResized(w, &diff->box)) {
+		return FALSE;
+	}
+	if (MEMCMP(a, b)) {
+		if (a->top.width != b->top.width ||
+		    a->right.width != b->right.width ||
+		    a->bottom.width != b->bottom.width ||
+		    a->left.width != b->left.width ||
+		    a->top_left_radius != b->top_left_radius ||
+		    a->top_right_radius != b->top_right_radius ||
+		    a->bottom_left_radius != b->bottom_left_radius ||
+		    a->bottom_right_radius != b->bottom_right_radius) {
+			return FALSE;
+		}
+		flags |= LCUI_WIDGET_REPAINT_BORDER;
+	}
+	if (MEMCMP(&diff->border_image, &w->computed_style.border_image)) {
+		/* The border image may be painted in the padding box */
+		flags |= LCUI_WIDGET_REPAINT_BORDER |
+			 LCUI_WIDGET_REPAINT_BACKGROUND;
+	}
+	if (MEMCMP(&diff->background, &w->computed_style.background)) {
+		flags |= LCUI_WIDGET_REPAINT_BACKGROUND;
+	}
+	if (MEMCMP(&diff->shadow, &w->computed_style.shadow)) {
+		if (w->repaint_flags & LCUI_WIDGET_REPAINT_SHADOW) {
+			LCUIRectF_MergeRect(&w->shadow_from, &w->shadow_from,
+					    &diff->box.canvas);
+		} else {
+			w->shadow_from = diff->box.canvas;
+		}
+		flags |= LCUI_WIDGET_REPAINT_SHADOW;
+	}
+	if (!flags) {
+		return FALSE;
+	}
+	if (flags & (LCUI_WIDGET_REPAINT_BACKGROUND |
+		     LCUI_WIDGET_REPAINT_BORDER)) {
+		w->enable_content_cache = TRUE;
+	}
+	w->repaint_flags |= flags;
+	Widget_AddToInvalidJournal(w);
+	return TRUE;
+}
+
 int Widget_EndStyleDiff(LCUI_Widget w, LCUI_WidgetStyleDiff diff)
 {
 	LinkedListNode *node;
 	const LCUI_WidgetStyle *style = &w->computed_style;
 
 	if (style->visible != diff->visible) {
+		/* Keep the old canvas box, it may be changed below */
+		if (w->invalid_area_type == LCUI_INVALID_AREA_TYPE_NONE) {
+			w->invalid_area = w->box.canvas;
+		} else {
+			LCUIRectF_MergeRect(&w->invalid_area, &w->invalid_area,
+					    &w->box.canvas);
+		}
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
 		if (style->visible) {
 			Widget_PostSurfaceEvent(w, LCUI_WEVENT_SHOW, TRUE);
@@ -116,14 +214,18 @@ int Widget_EndStyleDiff(LCUI_Widget w, LCUI_WidgetStyleDiff diff)
 
 	Widget_UpdateBoxSize(w);
 	Widget_UpdateBoxPosition(w);
-	if (MEMCMP(&diff->box.padding, &w->box.padding)) {
+	if (Widget_IsBoxOnlyMoved(w, &diff->box)) {
+		/* The children are positioned relative to the padding box, so
+		 * they do not need to be updated */
+	} else if (MEMCMP(&diff->box.padding, &w->box.padding)) {
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
 		for (LinkedList_Each(node, &w->children)) {
 			Widget_AddTask(node->data, LCUI_WTASK_POSITION);
 			Widget_AddTask(node->data, LCUI_WTASK_RESIZE);
 		}
 		Widget_AddReflowTask(w);
-	} else if (MEMCMP(&diff->box.canvas, &w->box.canvas)) {
+	} else if (MEMCMP(&diff->box.canvas, &w->box.canvas) &&
+		   !Widget_IsOnlyCanvasResized(w, &diff->box)) {
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
 	}
 	if (Widget_IsFlexLayoutStyleWorks(w)) {
@@ -166,6 +268,7 @@ int Widget_EndStyleDiff(LCUI_Widget w, LCUI_WidgetStyleDiff diff)
 	} else if (diff->z_index != style->z_index &&
 		   style->position != SV_STATIC) {
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
+	} else if (Widget_UpdateRepaintFlags(w, diff)) {
 	} else if (MEMCMP(&diff->shadow, &style->shadow)) {
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
 	} else if (w->invalid_area_type == LCUI_INVALID_AREA_TYPE_BORDER_BOX) {
@@ -198,17 +301,27 @@ void Widget_BeginLayoutDiff(LCUI_Widget w, LCUI_WidgetLayoutDiff diff)
 int Widget_EndLayoutDiff(LCUI_Widget w, LCUI_WidgetLayoutDiff diff)
 {
 	LCUI_WidgetEventRec e;
+	LCUI_BOOL moved_only;
 
 	if (w->invalid_area_type >= LCUI_INVALID_AREA_TYPE_BORDER_BOX) {
 		Widget_UpdateCanvasBox(w);
 	}
+	/* If the widget has only been moved, its painted pixels can be moved
+	 * together, so there is no need to invalidate the canvas box */
+	moved_only = Widget_IsBoxOnlyMoved(w, &diff->box);
 	if (w->invalid_area_type == LCUI_INVALID_AREA_TYPE_CANVAS_BOX) {
+	} else if (moved_only) {
+	} else if ((w->repaint_flags & LCUI_WIDGET_REPAINT_SHADOW) &&
+		   Widget_IsOnlyCanvasResized(w, &diff->box)) {
 	} else if (!LCUIRectF_IsEquals(&diff->box.canvas, &w->box.canvas)) {
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
 	}
 	if (diff->box.outer.x != w->box.outer.x ||
 	    diff->box.outer.y != w->box.outer.y) {
-		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
+		if (!moved_only) {
+			w->invalid_area_type =
+			    LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
+		}
 		Widget_PostSurfaceEvent(w, LCUI_WEVENT_MOVE,
 					!w->task.skip_surface_props_sync);
 		w->task.skip_surface_props_sync = TRUE;
@@ -229,6 +342,7 @@ int Widget_EndLayoutDiff(LCUI_Widget w, LCUI_WidgetLayoutDiff diff)
 	}
 	if (!diff->should_add_invalid_area) {
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_NONE;
+		w->moved = FALSE;
 		return 0;
 	}
 	if (w->invalid_area_type < LCUI_INVALID_AREA_TYPE_PADDING_BOX) {
@@ -245,9 +359,6 @@ int Widget_EndLayoutDiff(LCUI_Widget w, LCUI_WidgetLayoutDiff diff)
 		w->invalid_area = diff->box.canvas;
 		break;
 	}
-	while (w->parent) {
-		w->parent->has_child_invalid_area = TRUE;
-		w = w->parent;
-	}
+	Widget_AddToInvalidJournal(w);
 	return 1;
 }
@@ -44,6 +44,7 @@ typedef struct LCUI_WidgetStyleDiffRec_ {
 	LCUI_Rect2F padding;
 	LCUI_StyleValue position;
 	LCUI_BorderStyle border;
+	LCUI_BorderImageStyle border_image;
 	LCUI_BoxShadowStyle shadow;
 	LCUI_BackgroundStyle background;
 	LCUI_WidgetBoxModelRec box;
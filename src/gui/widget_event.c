@@ -249,14 +249,6 @@ static void WidgetEventTranslator(LCUI_Event e, LCUI_WidgetEventPack pack)
 	pack->event.type = e->type;
 	pack->event.data = handler->data;
 	handler->func(w, &pack->event, pack->data);
-	while (!pack->event.cancel_bubble && w->parent) {
-		w = w->parent;
-		if (w->trigger) {
-			pack->widget = w;
-			/** 向父级部件冒泡传递事件 */
-			EventTrigger_Trigger(w->trigger, e->type, pack);
-		}
-	}
 }
 
 /** 复制部件事件 */
@@ -515,6 +507,7 @@ static LCUI_Widget Widget_GetNextAt(LCUI_Widget widget, int x, int y)
 
 static int Widget_TriggerEventEx(LCUI_Widget widget, LCUI_WidgetEventPack pack)
 {
+	int ret;
 	LCUI_WidgetEvent e = &pack->event;
 
 	pack->widget = widget;
@@ -529,15 +522,19 @@ static int Widget_TriggerEventEx(LCUI_Widget widget, LCUI_WidgetEventPack pack)
 			break;
 		}
 	default:
+		ret = -1;
 		if (widget->trigger &&
 		    0 < EventTrigger_Trigger(widget->trigger, e->type, pack)) {
-			return 0;
+			ret = 0;
 		}
 		if (!widget->parent || e->cancel_bubble) {
-			return -1;
+			return ret;
+		}
+		/* 向父级部件冒泡，每个部件只会收到一次事件 */
+		if (Widget_TriggerEventEx(widget->parent, pack) == 0) {
+			ret = 0;
 		}
-		/* 如果事件投递失败，则向父级部件冒泡 */
-		return Widget_TriggerEventEx(widget->parent, pack);
+		return ret;
 	}
 	if (!widget->parent || e->cancel_bubble) {
 		return -1;
@@ -578,7 +575,7 @@ static int Widget_TriggerEventEx(LCUI_Widget widget, LCUI_WidgetEventPack pack)
 		if (!w) {
 			break;
 		}
-		return EventTrigger_Trigger(w->trigger, e->type, pack);
+		return Widget_TriggerEventEx(w, pack);
 	}
 	return Widget_TriggerEventEx(widget->parent, pack);
 }
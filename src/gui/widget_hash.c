@@ -33,42 +33,59 @@
 #include <LCUI/gui/widget.h>
 #include <LCUI/gui/widget_hash.h>
 
-void Widget_GenerateSelfHash(LCUI_Widget widget)
+#define IsHashRoot(W) ((W)->rules && (W)->rules->cache_children_style)
+
+/** 计算部件自身的类型、ID、类和状态的哈希值 */
+static void Widget_GenerateLocalHash(LCUI_Widget w)
 {
 	int i;
 	unsigned hash = 1080;
-	LCUI_Widget w;
 
-	for (w = widget; w; w = w->parent) {
-		if (w != widget) {
-			hash = strhash(hash, " ");
-		}
-		if (w->type) {
-			hash = strhash(hash, w->type);
-		} else {
-			hash = strhash(hash, "*");
-		}
-		if (w->id) {
-			hash = strhash(hash, "#");
-			hash = strhash(hash, w->id);
-		}
-		if (w->classes) {
-			for (i = 0; w->classes[i]; ++i) {
-				hash = strhash(hash, ".");
-				hash = strhash(hash, w->classes[i]);
-			}
-		}
-		if (w->status) {
-			for (i = 0; w->status[i]; ++i) {
-				hash = strhash(hash, ":");
-				hash = strhash(hash, w->status[i]);
-			}
+	if (w->type) {
+		hash = strhash(hash, w->type);
+	} else {
+		hash = strhash(hash, "*");
+	}
+	if (w->id) {
+		hash = strhash(hash, "#");
+		hash = strhash(hash, w->id);
+	}
+	if (w->classes) {
+		for (i = 0; w->classes[i]; ++i) {
+			hash = strhash(hash, ".");
+			hash = strhash(hash, w->classes[i]);
 		}
-		if (w->rules && w->rules->cache_children_style) {
-			break;
+	}
+	if (w->status) {
+		for (i = 0; w->status[i]; ++i) {
+			hash = strhash(hash, ":");
+			hash = strhash(hash, w->status[i]);
 		}
 	}
-	widget->hash = hash;
+	/* 0 表示哈希值需要重新计算 */
+	w->local_hash = hash ? hash : 1;
+}
+
+void Widget_GenerateSelfHash(LCUI_Widget w)
+{
+	unsigned hash;
+
+	if (!w->local_hash) {
+		Widget_GenerateLocalHash(w);
+	}
+	if (!w->parent || IsHashRoot(w)) {
+		w->hash = w->local_hash;
+		return;
+	}
+	/*
+	 * 父部件的哈希值已经包含了它的所有祖先部件，直接与它组合即可，不用
+	 * 再遍历祖先部件
+	 */
+	if (!w->parent->hash) {
+		Widget_GenerateSelfHash(w->parent);
+	}
+	hash = w->parent->hash;
+	w->hash = ((hash << 5) + hash) + w->local_hash;
 }
 
 void Widget_GenerateHash(LCUI_Widget w)
@@ -81,6 +98,31 @@ void Widget_GenerateHash(LCUI_Widget w)
 	}
 }
 
+/** 更新子部件的哈希值，跳过不依赖祖先部件的哈希根 */
+static void Widget_UpdateChildrenHash(LCUI_Widget w)
+{
+	LCUI_Widget child;
+	LinkedListNode *node;
+
+	for (LinkedList_Each(node, &w->children)) {
+		child = node->data;
+		if (!IsHashRoot(child)) {
+			Widget_GenerateSelfHash(child);
+			Widget_UpdateChildrenHash(child);
+		}
+	}
+}
+
+void Widget_UpdateHash(LCUI_Widget w)
+{
+	w->local_hash = 0;
+	if (!w->hash) {
+		return;
+	}
+	Widget_GenerateSelfHash(w);
+	Widget_UpdateChildrenHash(w);
+}
+
 size_t Widget_SetHashList(LCUI_Widget w, unsigned *hash_list, size_t len)
 {
 	size_t count = 0;
@@ -34,6 +34,7 @@
 #include <LCUI/thread.h>
 #include <LCUI/gui/widget_base.h>
 #include <LCUI/gui/widget_id.h>
+#include <LCUI/gui/widget_hash.h>
 
 static struct LCUI_WidgetIdLibraryModule {
 	Dict *ids;
@@ -103,6 +104,7 @@ int Widget_SetId(LCUI_Widget w, const char *idstr)
 		goto error_exit;
 	}
 	LCUIMutex_Unlock(&self.mutex);
+	Widget_UpdateHash(w);
 	return 0;
 
 error_exit:
@@ -111,6 +113,7 @@ error_exit:
 		free(w->id);
 		w->id = NULL;
 	}
+	Widget_UpdateHash(w);
 	return -2;
 }
 
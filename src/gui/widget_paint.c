@@ -29,12 +29,16 @@
  */
 
 //#define DEBUG
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/gui/widget.h>
 #include <LCUI/display.h>
+#include <LCUI/atomic.h>
 #include "widget_border.h"
 #include "widget_background.h"
 #include "widget_shadow.h"
@@ -45,6 +49,18 @@
 #define MAX_VISIBLE_WIDTH 20000
 #define MAX_VISIBLE_HEIGHT 20000
 
+/* The maximum number of pixels of the widget content cache */
+#define MAX_CONTENT_CACHE_PIXELS (256 * 1024)
+
+/* The maximum number of bytes of all content caches */
+#define MAX_CONTENT_CACHE_BYTES (16 * 1024 * 1024)
+
+/* Content caches not used in this number of frames will be freed */
+#define MAX_CONTENT_CACHE_IDLE_FRAMES 300
+
+/* The maximum number of opaque children used to occlude their siblings */
+#define MAX_OCCLUDERS 8
+
 #ifdef DEBUG_FRAME_RENDER
 #include <LCUI/image.h>
 #endif
@@ -54,6 +70,48 @@ typedef struct LCUI_RectGroupRec_ {
 	LinkedList rects;
 } LCUI_RectGroupRec, *LCUI_RectGroup;
 
+typedef struct LCUI_OccluderRec_ {
+	/* position in the children_show list, 0 is the topmost */
+	size_t index;
+
+	/* opaque rectangle, it relative to root canvas */
+	LCUI_Rect rect;
+} LCUI_OccluderRec, *LCUI_Occluder;
+
+/**
+ * Snapshot of a widget
+ * It is a copy of the widget with the computed styles, so it can be rendered
+ * by Widget_Render() on a worker thread while the widget is being changed.
+ */
+typedef struct LCUI_WidgetSnapshotRec_ {
+	/* copy of the widget, it must be the first member */
+	LCUI_WidgetRec widget;
+
+	LCUI_WidgetRulesRec rules;
+
+	/* content painted by the prototype of the widget */
+	LCUI_Graph content;
+} LCUI_WidgetSnapshotRec, *LCUI_WidgetSnapshot;
+
+/** Task of rendering a widget into a graph */
+typedef struct LCUI_WidgetRenderTaskRec_ {
+	/* target widget, it will be NULL after the widget is destroyed */
+	LCUI_Widget widget;
+	int handler_id;
+
+	/* the widget to be rendered, it may be a snapshot */
+	LCUI_Widget source;
+	LCUI_WidgetSnapshot snapshot;
+
+	/* area to be rendered, it relative to the canvas box in pixels */
+	LCUI_Rect rect;
+
+	/* size of the output graph */
+	int width, height;
+
+	LCUI_Graph graph;
+} LCUI_WidgetRenderTaskRec, *LCUI_WidgetRenderTask;
+
 typedef struct LCUI_WidgetRendererRec_ {
 	/* target widget position, it relative to root canvas */
 	float x, y;
@@ -103,13 +161,47 @@ typedef struct LCUI_WidgetRendererRec_ {
 	LCUI_BOOL has_layer_graph;
 	LCUI_BOOL can_render_self;
 	LCUI_BOOL can_render_centent;
+
+	/* whether it is rendering into the content cache of an ancestor */
+	LCUI_BOOL in_content_cache;
+
+	/* stats of the current Widget_Render() call */
+	LCUI_WidgetRepaintStats stats;
 } LCUI_WidgetRendererRec, *LCUI_WidgetRenderer;
 
 static struct LCUI_WidgetRenderModule {
 	LCUI_BOOL active;
 	LCUI_WidgetPrototype default_proto;
+	LCUI_WidgetPrototypeRec snapshot_proto;
 	RBTree groups;
 	LinkedList rects;
+
+	/* protect the repaint stats and the content cache of widgets */
+	LCUI_Mutex mutex;
+	LCUI_WidgetRepaintStatsRec stats;
+
+	/* widgets that have content caches, the least recently used first */
+	LinkedList content_caches;
+
+	/* number of the collected frames, used to find idle content caches */
+	unsigned frame;
+
+	/*
+	 * widgets that have been invalidated since the last flush, protected
+	 * by journal_mutex because images loaded by the worker thread also
+	 * invalidate widgets
+	 */
+	LinkedList journal;
+	LCUI_Mutex journal_mutex;
+	unsigned flush_id;
+	LCUI_WidgetInvalidationStatsRec invalidation_stats;
+
+	/*
+	 * calls and merged of invalidation_stats, they are counted outside
+	 * journal_mutex so they are atomic
+	 */
+	LCUI_AtomicInt invalidation_calls;
+	LCUI_AtomicInt invalidation_merges;
 } self = { 0 };
 
 /** 判断部件是否有可绘制内容 */
@@ -120,7 +212,7 @@ static LCUI_BOOL Widget_IsPaintable(LCUI_Widget w)
 	    Graph_IsValid(&s->background.image) || s->border.top.width > 0 ||
 	    s->border.right.width > 0 || s->border.bottom.width > 0 ||
 	    s->border.left.width > 0 || s->shadow.blur > 0 ||
-	    s->shadow.spread > 0) {
+	    s->shadow.spread > 0 || Graph_IsValid(&s->border_image.source)) {
 		return TRUE;
 	}
 	return w->proto != self.default_proto;
@@ -146,6 +238,69 @@ void RectToInvalidArea(const LCUI_Rect *rect, LCUI_Rect *area)
 	LCUIMetrics_ComputeRectActual(area, &rectf);
 }
 
+void Widget_AddToInvalidJournal(LCUI_Widget w)
+{
+	/*
+	 * The flush clears the node of the widget, so it must be checked
+	 * under the lock, otherwise a widget seen as recorded here may have
+	 * been flushed already and its ancestors would not be marked again
+	 */
+	LCUIMutex_Lock(&self.journal_mutex);
+	if (w->invalid_node.data) {
+		LCUIMutex_Unlock(&self.journal_mutex);
+		LCUIAtomic_Increment(&self.invalidation_merges);
+		return;
+	}
+	w->invalid_node.data = w;
+	LinkedList_AppendNode(&self.journal, &w->invalid_node);
+	self.invalidation_stats.records += 1;
+	LCUIMutex_Unlock(&self.journal_mutex);
+}
+
+void Widget_RemoveFromInvalidJournal(LCUI_Widget w)
+{
+	LCUIMutex_Lock(&self.journal_mutex);
+	if (w->invalid_node.data) {
+		LinkedList_Unlink(&self.journal, &w->invalid_node);
+		w->invalid_node.data = NULL;
+	}
+	LCUIMutex_Unlock(&self.journal_mutex);
+}
+
+size_t LCUIWidget_FlushInvalidJournal(void)
+{
+	size_t count;
+	LCUI_Widget w, parent;
+	LinkedListNode *node, *next;
+
+	LCUIMutex_Lock(&self.journal_mutex);
+	count = self.journal.length;
+	if (count < 1) {
+		LCUIMutex_Unlock(&self.journal_mutex);
+		return 0;
+	}
+	self.flush_id += 1;
+	for (node = self.journal.head.next; node; node = next) {
+		next = node->next;
+		w = node->data;
+		node->data = NULL;
+		node->prev = node->next = NULL;
+		/* Stop at the ancestor that has been marked in this flush,
+		 * because its ancestors have also been marked */
+		for (parent = w->parent;
+		     parent && parent->invalid_flush_id != self.flush_id;
+		     parent = parent->parent) {
+			parent->invalid_flush_id = self.flush_id;
+			parent->has_child_invalid_area = TRUE;
+			self.invalidation_stats.marked_ancestors += 1;
+		}
+	}
+	LinkedList_Init(&self.journal);
+	self.invalidation_stats.flushes += 1;
+	LCUIMutex_Unlock(&self.journal_mutex);
+	return count;
+}
+
 LCUI_BOOL Widget_InvalidateArea(LCUI_Widget w, LCUI_RectF *in_rect,
 				int box_type)
 {
@@ -155,6 +310,7 @@ LCUI_BOOL Widget_InvalidateArea(LCUI_Widget w, LCUI_RectF *in_rect,
 	if (!w->computed_style.visible) {
 		return FALSE;
 	}
+	LCUIAtomic_Increment(&self.invalidation_calls);
 	if (!in_rect) {
 		switch (box_type) {
 		case SV_BORDER_BOX:
@@ -173,10 +329,7 @@ LCUI_BOOL Widget_InvalidateArea(LCUI_Widget w, LCUI_RectF *in_rect,
 			return FALSE;
 		}
 		w->invalid_area_type = type;
-		while (w->parent) {
-			w->parent->has_child_invalid_area = TRUE;
-			w = w->parent;
-		}
+		Widget_AddToInvalidJournal(w);
 		return TRUE;
 	}
 
@@ -219,39 +372,359 @@ LCUI_BOOL Widget_InvalidateArea(LCUI_Widget w, LCUI_RectF *in_rect,
 	rect.y += w->box.canvas.y;
 	if (w->invalid_area_type > LCUI_INVALID_AREA_TYPE_NONE) {
 		LCUIRectF_MergeRect(&w->invalid_area, &rect, &w->invalid_area);
+		LCUIAtomic_Increment(&self.invalidation_merges);
 	} else {
 		w->invalid_area = rect;
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CUSTOM;
-		while (w->parent) {
-			w->parent->has_child_invalid_area = TRUE;
-			w = w->parent;
-		}
+		Widget_AddToInvalidJournal(w);
 	}
 	return TRUE;
 }
 
-#define AddInvalidArea()                                               \
-	do {                                                           \
-		rect.x += x;                                           \
-		rect.y += y;                                           \
-		LCUIRectF_GetOverlayRect(&rect, &visible_area, &rect); \
-		if (rect.width > 0 && rect.height > 0) {               \
-			actual_rect = malloc(sizeof(LCUI_Rect));       \
-			RectFToInvalidArea(&rect, actual_rect);        \
-			LinkedList_Append(rects, actual_rect);         \
-		}                                                      \
+/** 判断部件的内容缓存是否可用，调用前需锁定 self.mutex */
+static LCUI_BOOL ContentCache_IsValid(LCUI_Widget w, const LCUI_Rect *box)
+{
+	const LCUI_Graph *cache = &w->content_cache;
+
+	/* 缩放比例改变后，即使尺寸相同，缓存的内容也已失效 */
+	return Graph_IsValid(cache) && cache->width == box->width &&
+	       cache->height == box->height &&
+	       w->content_cache_generation == LCUIMetrics_GetScaleGeneration();
+}
+
+/** 释放部件的内容缓存，调用前需锁定 self.mutex */
+static void ContentCache_Remove(LCUI_Widget w)
+{
+	if (w->content_cache_node.data) {
+		LinkedList_Unlink(&self.content_caches, &w->content_cache_node);
+		w->content_cache_node.data = NULL;
+		self.stats.content_cache_bytes -= w->content_cache.mem_size;
+	}
+	Graph_Free(&w->content_cache);
+}
+
+/** 将内容缓存标记为最近使用的，调用前需锁定 self.mutex */
+static void ContentCache_Touch(LCUI_Widget w)
+{
+	w->content_cache_frame = self.frame;
+	LinkedList_Unlink(&self.content_caches, &w->content_cache_node);
+	LinkedList_AppendNode(&self.content_caches, &w->content_cache_node);
+}
+
+/** 释放最久未使用的内容缓存，直到能容纳指定的字节数 */
+static void ContentCache_Trim(size_t bytes)
+{
+	LCUI_Widget w;
+
+	while (self.content_caches.length > 0 &&
+	       self.stats.content_cache_bytes + bytes >
+		   MAX_CONTENT_CACHE_BYTES) {
+		w = self.content_caches.head.next->data;
+		ContentCache_Remove(w);
+		self.stats.content_cache_evictions += 1;
+	}
+}
+
+/**
+ * 释放长时间未使用的内容缓存
+ * 部件的背景或边框可能只是变化了一次，为节省内存，释放缓存后不再为它启用内容
+ * 缓存，等到下次变化时再启用。
+ */
+static void ContentCache_FreeIdle(void)
+{
+	LCUI_Widget w;
+
+	while (self.content_caches.length > 0) {
+		w = self.content_caches.head.next->data;
+		if (self.frame - w->content_cache_frame <
+		    MAX_CONTENT_CACHE_IDLE_FRAMES) {
+			break;
+		}
+		ContentCache_Remove(w);
+		w->enable_content_cache = FALSE;
+		self.stats.content_cache_evictions += 1;
+	}
+}
+
+/**
+ * 保存新绘制的内容缓存，调用前需锁定 self.mutex
+ * 若其它线程已经保存了可用的缓存，则保留已有的缓存
+ */
+static void ContentCache_Store(LCUI_Widget w, LCUI_Graph *cache,
+			       unsigned generation)
+{
+	LCUI_Graph *old = &w->content_cache;
+
+	if (Graph_IsValid(old) && old->width == cache->width &&
+	    old->height == cache->height &&
+	    w->content_cache_generation == generation) {
+		return;
+	}
+	ContentCache_Remove(w);
+	ContentCache_Trim(cache->mem_size);
+	Graph_Copy(&w->content_cache, cache);
+	w->content_cache_generation = generation;
+	w->content_cache_node.data = w;
+	w->content_cache_frame = self.frame;
+	LinkedList_AppendNode(&self.content_caches, &w->content_cache_node);
+	self.stats.content_cache_bytes += cache->mem_size;
+}
+
+void Widget_DestroyContentCache(LCUI_Widget w)
+{
+	LCUIMutex_Lock(&self.mutex);
+	ContentCache_Remove(w);
+	LCUIMutex_Unlock(&self.mutex);
+}
+
+#define AddInvalidArea(TYPE)                                             \
+	do {                                                             \
+		rect.x += x;                                             \
+		rect.y += y;                                             \
+		LCUIRectF_GetOverlayRect(&rect, &visible_area, &rect);   \
+		if (rect.width > 0 && rect.height > 0) {                 \
+			actual_rect = malloc(sizeof(LCUI_Rect));         \
+			RectFToInvalidArea(&rect, actual_rect);          \
+			LinkedList_Append(rects, actual_rect);           \
+			self.stats.TYPE##_pixels +=                      \
+			    actual_rect->width * actual_rect->height;    \
+		}                                                        \
 	} while (0)
 
-static void Widget_CollectInvalidArea(LCUI_Widget w, LinkedList *rects, float x,
-				      float y, LCUI_RectF visible_area)
+/** 收集部件中仅需重绘背景、边框或阴影的区域 */
+static void Widget_CollectRepaintArea(LCUI_Widget w, LinkedList *rects,
+				      float x, float y, LCUI_RectF visible_area)
+{
+	LCUI_RectF rect, area;
+	LCUI_Rect *actual_rect;
+	const LCUI_RectF *border = &w->box.border;
+	const LCUI_RectF *padding = &w->box.padding;
+
+	if (w->repaint_flags & LCUI_WIDGET_REPAINT_SHADOW) {
+		/* The box shadow will not be painted in the border box */
+		LCUIRectF_MergeRect(&area, &w->shadow_from, &w->box.canvas);
+		rect = area;
+		rect.height = border->y - area.y;
+		AddInvalidArea(shadow);
+		rect = area;
+		rect.y = border->y + border->height;
+		rect.height = area.y + area.height - rect.y;
+		AddInvalidArea(shadow);
+		rect = *border;
+		rect.x = area.x;
+		rect.width = border->x - area.x;
+		AddInvalidArea(shadow);
+		rect = *border;
+		rect.x = border->x + border->width;
+		rect.width = area.x + area.width - rect.x;
+		AddInvalidArea(shadow);
+	}
+	if ((w->repaint_flags & LCUI_WIDGET_REPAINT_BORDER) &&
+	    ((w->repaint_flags & LCUI_WIDGET_REPAINT_BACKGROUND) ||
+	     Widget_HasRoundBorder(w))) {
+		rect = *border;
+		AddInvalidArea(border);
+	} else if (w->repaint_flags & LCUI_WIDGET_REPAINT_BORDER) {
+		rect = *border;
+		rect.height = padding->y - border->y;
+		AddInvalidArea(border);
+		rect = *border;
+		rect.y = padding->y + padding->height;
+		rect.height = border->y + border->height - rect.y;
+		AddInvalidArea(border);
+		rect = *padding;
+		rect.x = border->x;
+		rect.width = padding->x - border->x;
+		AddInvalidArea(border);
+		rect = *padding;
+		rect.x = padding->x + padding->width;
+		rect.width = border->x + border->width - rect.x;
+		AddInvalidArea(border);
+	} else if (w->repaint_flags & LCUI_WIDGET_REPAINT_BACKGROUND) {
+		rect = *padding;
+		AddInvalidArea(background);
+	}
+}
+
+/** 判断部件是否会完全覆盖其画布区域内的像素 */
+static LCUI_BOOL Widget_IsOpaque(LCUI_Widget w)
+{
+	const LCUI_WidgetStyle *s = &w->computed_style;
+	const LCUI_BorderStyle *b = &s->border;
+
+	if (s->opacity < 1.0f || s->background.color.alpha < 255 ||
+	    Widget_HasRoundBorder(w) || Graph_IsValid(&s->border_image.source) ||
+	    !LCUIRectF_IsEquals(&w->box.canvas, &w->box.border)) {
+		return FALSE;
+	}
+	if ((b->top.width > 0 && b->top.color.alpha < 255) ||
+	    (b->right.width > 0 && b->right.color.alpha < 255) ||
+	    (b->bottom.width > 0 && b->bottom.color.alpha < 255) ||
+	    (b->left.width > 0 && b->left.color.alpha < 255)) {
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * Check whether the pixels painted for the widget before moving can be
+ * reused. It requires that the widget is opaque, no other widget is stacked
+ * above its old and new area, and its ancestors have no effects that depend
+ * on the content below them.
+ */
+static LCUI_BOOL Widget_CanReuseMovedArea(LCUI_Widget root, LCUI_Widget w,
+					  LCUI_RectF *area)
+{
+	LCUI_Widget child, parent, sibling;
+	LCUI_RectF rect = *area;
+	LinkedListNode *node;
+
+	if (!w->computed_style.visible || w->state != LCUI_WSTATE_NORMAL ||
+	    !Widget_IsOpaque(w)) {
+		return FALSE;
+	}
+	for (child = w; child != root; child = parent) {
+		parent = child->parent;
+		if (parent->computed_style.opacity < 1.0f ||
+		    Widget_HasRoundBorder(parent)) {
+			return FALSE;
+		}
+		for (LinkedList_Each(node, &parent->children_show)) {
+			sibling = node->data;
+			if (sibling == child) {
+				break;
+			}
+			if (sibling->computed_style.visible &&
+			    sibling->state == LCUI_WSTATE_NORMAL &&
+			    LCUIRectF_IsCoverRect(&sibling->box.canvas, &rect)) {
+				return FALSE;
+			}
+		}
+		rect.x += parent->box.padding.x;
+		rect.y += parent->box.padding.y;
+	}
+	return TRUE;
+}
+
+/**
+ * The widgets stacked above and the ancestors are collected before the
+ * widget, their dirty rects include the old areas of the changed siblings,
+ * such as hidden, moved and removed ones. The pixels in these rects have not
+ * been repainted yet, so they cannot be copied.
+ */
+static LCUI_BOOL MovedArea_HasDirtyRect(LCUI_MovedArea area, LinkedList *rects)
+{
+	LinkedListNode *node;
+
+	for (LinkedList_Each(node, rects)) {
+		if (LCUIRect_IsCoverRect(node->data, &area->from)) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static LCUI_BOOL Widget_CollectMovedArea(LCUI_Widget root, LCUI_Widget w,
+					 LinkedList *rects, LinkedList *areas,
+					 float x, float y,
+					 LCUI_RectF *visible_area)
+{
+	float dx, dy;
+	float scale = LCUIMetrics_GetScale();
+
+	LCUI_RectF from, to, area;
+	LCUI_MovedArea moved;
+
+	if (!areas || w == root || w->repaint_flags ||
+	    w->parent->invalid_area_type >= LCUI_INVALID_AREA_TYPE_PADDING_BOX) {
+		return FALSE;
+	}
+	from = w->moved_from;
+	to = w->box.canvas;
+	/* The children are positioned by rounding their absolute position, so
+	 * the offset must be an integer in actual pixels */
+	dx = (to.x - from.x) * scale;
+	dy = (to.y - from.y) * scale;
+	if (fabs(dx - iround(dx)) > 0.01 || fabs(dy - iround(dy)) > 0.01) {
+		return FALSE;
+	}
+	LCUIRectF_MergeRect(&area, &from, &to);
+	if (!Widget_CanReuseMovedArea(root, w, &area)) {
+		return FALSE;
+	}
+	from.x += x;
+	from.y += y;
+	to.x += x;
+	to.y += y;
+	if (!LCUIRectF_IsIncludeRect(visible_area, &from) ||
+	    !LCUIRectF_IsIncludeRect(visible_area, &to)) {
+		return FALSE;
+	}
+	moved = malloc(sizeof(LCUI_MovedAreaRec));
+	RectFToInvalidArea(&from, &moved->from);
+	moved->to.x = moved->from.x + iround(dx);
+	moved->to.y = moved->from.y + iround(dy);
+	moved->to.width = moved->from.width;
+	moved->to.height = moved->from.height;
+	if (MovedArea_HasDirtyRect(moved, rects)) {
+		free(moved);
+		return FALSE;
+	}
+	LinkedList_Append(areas, moved);
+	return TRUE;
+}
+
+static void Widget_CollectInvalidArea(LCUI_Widget root, LCUI_Widget w,
+				      LinkedList *rects, LinkedList *areas,
+				      float x, float y, LCUI_RectF visible_area)
 {
 	LCUI_RectF rect;
 	LCUI_Rect *actual_rect;
+	LCUI_BOOL parent_invalid;
 	LinkedListNode *node;
 
-	if (w->parent && w->parent->invalid_area_type >=
-			     LCUI_INVALID_AREA_TYPE_PADDING_BOX) {
+	if (w->moved) {
+		if (w->invalid_area_type == LCUI_INVALID_AREA_TYPE_NONE &&
+		    Widget_CollectMovedArea(root, w, rects, areas, x, y,
+					    &visible_area)) {
+			/* The children have been moved with their parent, the
+			 * changes in their old position is meaningless */
+			areas = NULL;
+		} else if (w->invalid_area_type ==
+			   LCUI_INVALID_AREA_TYPE_NONE) {
+			w->invalid_area = w->moved_from;
+			w->invalid_area_type =
+			    LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
+		} else {
+			rect = w->moved_from;
+			AddInvalidArea(full);
+			w->invalid_area_type =
+			    LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
+		}
+	}
+	/* The root of the collection has no parent to be repainted with */
+	parent_invalid = w != root && w->parent &&
+			 w->parent->invalid_area_type >=
+			     LCUI_INVALID_AREA_TYPE_PADDING_BOX;
+	if (parent_invalid) {
 		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
+	}
+	if (w->has_child_invalid_area ||
+	    w->invalid_area_type != LCUI_INVALID_AREA_TYPE_NONE) {
+		ContentCache_Remove(w);
+	}
+	if (!w->repaint_flags || parent_invalid) {
+	} else if (w->invalid_area_type < LCUI_INVALID_AREA_TYPE_PADDING_BOX) {
+		Widget_CollectRepaintArea(w, rects, x, y, visible_area);
+	} else if (w->repaint_flags & LCUI_WIDGET_REPAINT_SHADOW) {
+		rect = w->shadow_from;
+		AddInvalidArea(full);
+		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_CANVAS_BOX;
+	} else if (w->repaint_flags & LCUI_WIDGET_REPAINT_BORDER &&
+		   w->invalid_area_type < LCUI_INVALID_AREA_TYPE_BORDER_BOX) {
+		w->invalid_area_type = LCUI_INVALID_AREA_TYPE_BORDER_BOX;
+	}
+	if (parent_invalid) {
 	} else if (w->invalid_area_type >= LCUI_INVALID_AREA_TYPE_PADDING_BOX) {
 		switch (w->invalid_area_type) {
 		case LCUI_INVALID_AREA_TYPE_PADDING_BOX:
@@ -265,16 +738,16 @@ static void Widget_CollectInvalidArea(LCUI_Widget w, LinkedList *rects, float x,
 			break;
 		}
 		if (!LCUIRectF_IsCoverRect(&rect, &w->invalid_area)) {
-			AddInvalidArea();
+			AddInvalidArea(full);
 			rect = w->invalid_area;
-			AddInvalidArea();
+			AddInvalidArea(full);
 		} else {
 			LCUIRectF_MergeRect(&rect, &rect, &w->invalid_area);
-			AddInvalidArea();
+			AddInvalidArea(full);
 		}
 	} else if (w->invalid_area_type == LCUI_INVALID_AREA_TYPE_CUSTOM) {
 		rect = w->invalid_area;
-		AddInvalidArea();
+		AddInvalidArea(full);
 	}
 	if (w->has_child_invalid_area) {
 		visible_area.x -= x;
@@ -285,24 +758,119 @@ static void Widget_CollectInvalidArea(LCUI_Widget w, LinkedList *rects, float x,
 		visible_area.y += y;
 		for (LinkedList_Each(node, &w->children_show)) {
 			Widget_CollectInvalidArea(
-			    node->data, rects, x + w->box.padding.x,
-			    y + w->box.padding.y, visible_area);
+			    root, node->data, rects, areas,
+			    x + w->box.padding.x, y + w->box.padding.y,
+			    visible_area);
 		}
 	}
 	w->invalid_area_type = LCUI_INVALID_AREA_TYPE_NONE;
 	w->has_child_invalid_area = FALSE;
+	w->repaint_flags = 0;
+	w->moved = FALSE;
 }
 
-size_t Widget_GetInvalidArea(LCUI_Widget w, LinkedList *rects)
+static LCUI_BOOL MovedArea_IsOverlap(LCUI_MovedArea a, LCUI_MovedArea b)
+{
+	return LCUIRect_IsCoverRect(&a->from, &b->from) ||
+	       LCUIRect_IsCoverRect(&a->from, &b->to) ||
+	       LCUIRect_IsCoverRect(&a->to, &b->from) ||
+	       LCUIRect_IsCoverRect(&a->to, &b->to);
+}
+
+/** 将移动后露出的区域添加到无效区域列表中 */
+static void MovedArea_AddExposedRects(LCUI_MovedArea area, LinkedList *rects)
+{
+	LCUI_Rect rect;
+	int dx = area->to.x - area->from.x;
+	int dy = area->to.y - area->from.y;
+
+	if (abs(dx) >= area->from.width || abs(dy) >= area->from.height) {
+		RectList_Add(rects, &area->from);
+		return;
+	}
+	if (dx != 0) {
+		rect.x = dx > 0 ? area->from.x : area->to.x + area->to.width;
+		rect.y = area->from.y;
+		rect.width = abs(dx);
+		rect.height = area->from.height;
+		RectList_Add(rects, &rect);
+	}
+	if (dy != 0) {
+		rect.x = dx > 0 ? area->to.x : area->from.x;
+		rect.y = dy > 0 ? area->from.y : area->to.y + area->to.height;
+		rect.width = area->from.width - abs(dx);
+		rect.height = abs(dy);
+		RectList_Add(rects, &rect);
+	}
+}
+
+/**
+ * The moved areas are copied one by one, if an area overlaps with another
+ * one, the copy order will affect the result, so we fall back to repaint
+ * them.
+ */
+static void Widget_ResolveMovedAreas(LinkedList *areas, LinkedList *rects)
+{
+	LCUI_BOOL overlapped;
+	LCUI_MovedArea area;
+	LinkedList conflicts;
+	LinkedListNode *node, *other;
+
+	LinkedList_Init(&conflicts);
+	for (LinkedList_Each(node, areas)) {
+		overlapped = FALSE;
+		for (LinkedList_Each(other, areas)) {
+			if (other != node &&
+			    MovedArea_IsOverlap(node->data, other->data)) {
+				overlapped = TRUE;
+				break;
+			}
+		}
+		if (overlapped) {
+			LinkedList_Append(&conflicts, node);
+		}
+	}
+	for (LinkedList_Each(node, &conflicts)) {
+		other = node->data;
+		area = other->data;
+		RectList_Add(rects, &area->from);
+		RectList_Add(rects, &area->to);
+		LinkedList_DeleteNode(areas, other);
+		free(area);
+	}
+	LinkedList_Clear(&conflicts, NULL);
+	for (LinkedList_Each(node, areas)) {
+		MovedArea_AddExposedRects(node->data, rects);
+	}
+}
+
+size_t Widget_GetInvalidAreaEx(LCUI_Widget w, LinkedList *rects,
+			       LinkedList *areas)
 {
 	LCUI_Rect *rect;
+	LCUI_MovedArea area;
 	LinkedListNode *node;
 
 	float scale = LCUIMetrics_GetScale();
 	int x = iround(w->box.padding.x * scale);
 	int y = iround(w->box.padding.y * scale);
 
-	Widget_CollectInvalidArea(w, rects, 0, 0, w->box.padding);
+	LCUIWidget_FlushInvalidJournal();
+	LCUIMutex_Lock(&self.mutex);
+	self.frame += 1;
+	ContentCache_FreeIdle();
+	Widget_CollectInvalidArea(w, w, rects, areas, 0, 0, w->box.padding);
+	LCUIMutex_Unlock(&self.mutex);
+	if (areas) {
+		Widget_ResolveMovedAreas(areas, rects);
+		for (LinkedList_Each(node, areas)) {
+			area = node->data;
+			area->from.x -= x;
+			area->from.y -= y;
+			area->to.x -= x;
+			area->to.y -= y;
+		}
+	}
 	for (LinkedList_Each(node, rects)) {
 		rect = node->data;
 		rect->x -= x;
@@ -311,12 +879,31 @@ size_t Widget_GetInvalidArea(LCUI_Widget w, LinkedList *rects)
 	return rects->length;
 }
 
+size_t Widget_GetInvalidArea(LCUI_Widget w, LinkedList *rects)
+{
+	return Widget_GetInvalidAreaEx(w, rects, NULL);
+}
+
 static int OnCompareGroup(void *data, const void *keydata)
 {
 	LCUI_RectGroup group = data;
 	return (int)((char *)group->widget - (char *)keydata);
 }
 
+/** 将快照中预先绘制的内容绘制到画布上 */
+static void WidgetSnapshot_OnPaint(LCUI_Widget w, LCUI_PaintContext paint,
+				   LCUI_WidgetActualStyle style)
+{
+	LCUI_Graph slice;
+	LCUI_WidgetSnapshot snapshot = (LCUI_WidgetSnapshot)w;
+
+	if (!Graph_IsValid(&snapshot->content)) {
+		return;
+	}
+	Graph_QuoteReadOnly(&slice, &snapshot->content, &paint->rect);
+	Graph_Mix(&paint->canvas, &slice, 0, 0, paint->with_alpha);
+}
+
 static void OnDestroyGroup(void *data)
 {
 	LCUI_RectGroup group = data;
@@ -330,25 +917,77 @@ void LCUIWidget_InitRenderer(void)
 	RBTree_OnCompare(&self.groups, OnCompareGroup);
 	RBTree_OnDestroy(&self.groups, OnDestroyGroup);
 	LinkedList_Init(&self.rects);
+	LinkedList_Init(&self.journal);
+	LinkedList_Init(&self.content_caches);
+	LCUIMutex_Init(&self.mutex);
+	LCUIMutex_Init(&self.journal_mutex);
+	LCUIWidget_ResetRepaintStats();
+	LCUIWidget_ResetInvalidationStats();
 	self.default_proto = LCUIWidget_GetPrototype(NULL);
+	self.snapshot_proto = *self.default_proto;
+	self.snapshot_proto.name = "snapshot";
+	self.snapshot_proto.paint = WidgetSnapshot_OnPaint;
 	self.active = TRUE;
 }
 
 void LCUIWidget_FreeRenderer(void)
 {
 	self.active = FALSE;
+	LCUIWidget_FlushInvalidJournal();
 	RectList_Clear(&self.rects);
 	RBTree_Destroy(&self.groups);
+	LCUIMutex_Destroy(&self.mutex);
+	LCUIMutex_Destroy(&self.journal_mutex);
+}
+
+void LCUIWidget_GetRepaintStats(LCUI_WidgetRepaintStats stats)
+{
+	LCUIMutex_Lock(&self.mutex);
+	*stats = self.stats;
+	LCUIMutex_Unlock(&self.mutex);
+}
+
+void LCUIWidget_ResetRepaintStats(void)
+{
+	size_t bytes;
+
+	LCUIMutex_Lock(&self.mutex);
+	bytes = self.stats.content_cache_bytes;
+	memset(&self.stats, 0, sizeof(self.stats));
+	self.stats.content_cache_bytes = bytes;
+	LCUIMutex_Unlock(&self.mutex);
+}
+
+void LCUIWidget_GetInvalidationStats(LCUI_WidgetInvalidationStats stats)
+{
+	LCUIMutex_Lock(&self.journal_mutex);
+	*stats = self.invalidation_stats;
+	LCUIMutex_Unlock(&self.journal_mutex);
+	stats->calls = (size_t)LCUIAtomic_Load(&self.invalidation_calls);
+	stats->merged = (size_t)LCUIAtomic_Load(&self.invalidation_merges);
+}
+
+void LCUIWidget_ResetInvalidationStats(void)
+{
+	LCUIMutex_Lock(&self.journal_mutex);
+	memset(&self.invalidation_stats, 0, sizeof(self.invalidation_stats));
+	LCUIMutex_Unlock(&self.journal_mutex);
+	LCUIAtomic_Store(&self.invalidation_calls, 0);
+	LCUIAtomic_Store(&self.invalidation_merges, 0);
 }
 
 /** 当前部件的绘制函数 */
 static void Widget_OnPaint(LCUI_Widget w, LCUI_PaintContext paint,
-			   LCUI_WidgetActualStyle style)
+			   LCUI_WidgetActualStyle style, LCUI_BOOL with_content)
 {
 	Widget_PaintBakcground(w, paint, style);
-	Widget_PaintBorder(w, paint, style);
+	if (Graph_IsValid(&w->computed_style.border_image.source)) {
+		Widget_PaintBorderImage(w, paint, style);
+	} else {
+		Widget_PaintBorder(w, paint, style);
+	}
 	Widget_PaintBoxShadow(w, paint, style);
-	if (w->proto && w->proto->paint) {
+	if (with_content && w->proto && w->proto->paint) {
 		w->proto->paint(w, paint, style);
 	}
 }
@@ -418,12 +1057,16 @@ static LCUI_WidgetRenderer WidgetRenderer(LCUI_Widget w,
 	that->has_self_graph = FALSE;
 	that->has_layer_graph = FALSE;
 	that->has_content_graph = FALSE;
+	that->in_content_cache = FALSE;
 	if (parent) {
+		that->stats = parent->stats;
+		that->in_content_cache = parent->in_content_cache;
 		that->root_paint = parent->root_paint;
 		that->x = parent->x + parent->content_left + w->box.canvas.x;
 		that->y = parent->y + parent->content_top + w->box.canvas.y;
 	} else {
 		that->x = that->y = 0;
+		that->stats = NULL;
 		that->root_paint = that->paint;
 	}
 	if (w->computed_style.opacity < 1.0) {
@@ -546,9 +1189,143 @@ static void Widget_ComputeActualContentBox(LCUI_Widget w,
 	LCUIMetrics_ComputeRectActual(&s->content_box, &rect);
 }
 
+/** 判断部件是否可能遮挡下层的部件，用于在计算实际样式前快速排除 */
+static LCUI_BOOL Widget_CanOcclude(LCUI_Widget w)
+{
+	const LCUI_WidgetStyle *s = &w->computed_style;
+	const LCUI_Graph *image = &s->background.image;
+
+	if (!s->visible || w->state != LCUI_WSTATE_NORMAL ||
+	    s->opacity < 1.0f) {
+		return FALSE;
+	}
+	if (s->background.color.alpha == 255) {
+		return TRUE;
+	}
+	return Graph_IsValid(image) && image->opacity >= 1.0f &&
+	       image->color_type == LCUI_COLOR_TYPE_RGB;
+}
+
+/**
+ * 计算部件的不透明区域
+ * 背景色不透明时，背景色和不透明的边框所在的区域都会被覆盖，否则只有不透明的背
+ * 景图所在的区域会被覆盖。圆角处的像素不会被完全覆盖，所以按最大圆角半径向内收缩
+ */
+static LCUI_BOOL Widget_GetOpaqueRect(LCUI_Widget w, LCUI_WidgetActualStyle s,
+				      LCUI_Rect *rect)
+{
+	int radius;
+	LCUI_Rect image_rect;
+	const LCUI_Border *b = &s->border;
+	const LCUI_Background *bg = &s->background;
+
+	if (bg->color.alpha == 255) {
+		*rect = s->padding_box;
+		/* 边框图像可能是透明的，所以不考虑边框区域 */
+		if (!Graph_IsValid(&w->computed_style.border_image.source) &&
+		    (b->top.width == 0 || b->top.color.alpha == 255) &&
+		    (b->right.width == 0 || b->right.color.alpha == 255) &&
+		    (b->bottom.width == 0 || b->bottom.color.alpha == 255) &&
+		    (b->left.width == 0 || b->left.color.alpha == 255)) {
+			*rect = s->border_box;
+		}
+	} else {
+		if (!bg->image || !Graph_IsValid(bg->image)) {
+			return FALSE;
+		}
+		image_rect.x = s->padding_box.x + bg->position.x;
+		image_rect.y = s->padding_box.y + bg->position.y;
+		image_rect.width = bg->size.width;
+		image_rect.height = bg->size.height;
+		if (!LCUIRect_GetOverlayRect(&s->padding_box, &image_rect,
+					     rect)) {
+			return FALSE;
+		}
+	}
+	radius = (int)max(max(b->top_left_radius, b->top_right_radius),
+			  max(b->bottom_left_radius, b->bottom_right_radius));
+	rect->x += radius;
+	rect->y += radius;
+	rect->width -= radius * 2;
+	rect->height -= radius * 2;
+	return rect->width > 0 && rect->height > 0;
+}
+
+/** 收集能遮挡其它子部件的不透明子部件，按从上到下的顺序排列 */
+static size_t WidgetRenderer_GetOccluders(LCUI_WidgetRenderer that,
+					  LCUI_Occluder occluders)
+{
+	size_t n = 0, index = 0;
+	LCUI_Widget child;
+	LCUI_Rect rect;
+	LinkedListNode *node;
+	LCUI_WidgetActualStyleRec style;
+
+	for (LinkedList_Each(node, &that->target->children_show)) {
+		child = node->data;
+		if (!Widget_CanOcclude(child)) {
+			++index;
+			continue;
+		}
+		style.x = that->x + that->content_left;
+		style.y = that->y + that->content_top;
+		Widget_ComputeActualBorderBox(child, &style);
+		Widget_ComputeActualPaddingBox(child, &style);
+		if (Widget_GetOpaqueRect(child, &style, &rect) &&
+		    LCUIRect_GetOverlayRect(&that->actual_content_rect, &rect,
+					    &occluders[n].rect)) {
+			occluders[n].index = index;
+			if (++n >= MAX_OCCLUDERS) {
+				break;
+			}
+		}
+		++index;
+	}
+	return n;
+}
+
+/**
+ * 裁剪掉绘制区域中被上层部件遮挡的部分
+ * 只在遮挡的部分位于区域的一侧时裁剪，以保证裁剪后的区域仍是矩形
+ * @param[in] index 绘制区域所属的部件在 children_show 列表中的位置
+ * @returns 绘制区域被完全遮挡时返回 FALSE
+ */
+static LCUI_BOOL Occluders_ClipRect(LCUI_Occluder occluders, size_t n,
+				    size_t index, LCUI_Rect *rect)
+{
+	size_t i;
+	int right, bottom;
+	const LCUI_Rect *o;
+
+	for (i = 0; i < n && occluders[i].index < index; ++i) {
+		o = &occluders[i].rect;
+		right = rect->x + rect->width;
+		bottom = rect->y + rect->height;
+		if (o->x <= rect->x && o->x + o->width >= right) {
+			if (o->y <= rect->y && o->y + o->height >= bottom) {
+				return FALSE;
+			}
+			if (o->y <= rect->y && o->y + o->height > rect->y) {
+				rect->height = bottom - o->y - o->height;
+				rect->y = o->y + o->height;
+			} else if (o->y < bottom && o->y + o->height >= bottom) {
+				rect->height = o->y - rect->y;
+			}
+		} else if (o->y <= rect->y && o->y + o->height >= bottom) {
+			if (o->x <= rect->x && o->x + o->width > rect->x) {
+				rect->width = right - o->x - o->width;
+				rect->x = o->x + o->width;
+			} else if (o->x < right && o->x + o->width >= right) {
+				rect->width = o->x - rect->x;
+			}
+		}
+	}
+	return TRUE;
+}
+
 static size_t WidgetRenderer_RenderChildren(LCUI_WidgetRenderer that)
 {
-	size_t total = 0, count = 0;
+	size_t total = 0, count = 0, index, n_occluders = 0;
 	LCUI_Widget child;
 	LCUI_Rect paint_rect;
 	LCUI_RectF child_rect;
@@ -556,9 +1333,22 @@ static size_t WidgetRenderer_RenderChildren(LCUI_WidgetRenderer that)
 	LCUI_PaintContextRec child_paint;
 	LCUI_WidgetRenderer renderer;
 	LCUI_WidgetActualStyleRec style;
+	LCUI_OccluderRec occluders[MAX_OCCLUDERS];
 
+	/*
+	 * The children covered by the opaque siblings above them will be
+	 * overdrawn, so their covered area can be skipped. It is disabled when
+	 * only a part of children are rendered, because the occluders may not
+	 * be rendered.
+	 */
+	index = that->target->children_show.length;
+	if (index > 1 && !(that->target->rules &&
+			   that->target->rules->max_render_children_count)) {
+		n_occluders = WidgetRenderer_GetOccluders(that, occluders);
+	}
 	/* Render the child widgets from bottom to top in stack order */
 	for (LinkedList_EachReverse(node, &that->target->children_show)) {
+		--index;
 		child = node->data;
 		if (!child->computed_style.visible ||
 		    child->state != LCUI_WSTATE_NORMAL) {
@@ -600,6 +1390,18 @@ static size_t WidgetRenderer_RenderChildren(LCUI_WidgetRenderer that)
 					     &style.canvas_box, &paint_rect)) {
 			continue;
 		}
+		if (n_occluders > 0) {
+			size_t pixels = paint_rect.width * paint_rect.height;
+
+			if (!Occluders_ClipRect(occluders, n_occluders, index,
+						&paint_rect)) {
+				that->stats->occluded_pixels += pixels;
+				that->stats->occluded_widgets += 1;
+				continue;
+			}
+			that->stats->occluded_pixels +=
+			    pixels - paint_rect.width * paint_rect.height;
+		}
 		++count;
 		Widget_ComputeActualPaddingBox(child, &style);
 		Widget_ComputeActualContentBox(child, &style);
@@ -628,9 +1430,116 @@ static size_t WidgetRenderer_RenderChildren(LCUI_WidgetRenderer that)
 	return total;
 }
 
+/**
+ * 判断是否能够使用内容缓存
+ * 内容缓存包含部件自身内容和子部件的绘制结果，在仅背景或边框有变化时，可直接复
+ * 用它而无需重新绘制子部件。为保证子部件的像素位置不变，部件的实际位置须为整数。
+ */
+static LCUI_BOOL WidgetRenderer_CanUseContentCache(LCUI_WidgetRenderer that)
+{
+	float x, y;
+	float scale = LCUIMetrics_GetScale();
+	LCUI_Widget w = that->target;
+	const LCUI_Rect *box = &that->style->border_box;
+
+	if (!w->enable_content_cache || that->in_content_cache ||
+	    that->has_content_graph || !that->can_render_centent ||
+	    (w->rules && w->rules->max_render_children_count) ||
+	    box->width * box->height > MAX_CONTENT_CACHE_PIXELS) {
+		return FALSE;
+	}
+	if (w->children_show.length < 1 && !(w->proto && w->proto->paint)) {
+		return FALSE;
+	}
+	x = (that->style->x + w->box.border.x) * scale;
+	y = (that->style->y + w->box.border.y) * scale;
+	return fabs(x - iround(x)) < 0.01 && fabs(y - iround(y)) < 0.01;
+}
+
+/**
+ * 将部件自身内容和子部件绘制到新的内容缓存中
+ * 绘制时不锁定 self.mutex，以免阻塞其它线程的渲染
+ */
+static int WidgetRenderer_PaintContentCache(LCUI_WidgetRenderer that,
+					    LCUI_Graph *cache)
+{
+	LCUI_Widget w = that->target;
+	LCUI_PaintContextRec paint;
+	LCUI_WidgetRendererRec renderer;
+	const LCUI_Rect *box = &that->style->border_box;
+
+	cache->color_type = LCUI_COLOR_TYPE_ARGB;
+	if (Graph_Create(cache, box->width, box->height) != 0) {
+		return -ENOMEM;
+	}
+	paint.with_alpha = TRUE;
+	paint.rect = *box;
+	paint.rect.x -= that->style->canvas_box.x;
+	paint.rect.y -= that->style->canvas_box.y;
+	Graph_Quote(&paint.canvas, cache, NULL);
+	if (w->proto && w->proto->paint) {
+		w->proto->paint(w, &paint, that->style);
+	}
+	renderer = *that;
+	renderer.paint = &paint;
+	renderer.in_content_cache = TRUE;
+	renderer.actual_paint_rect = *box;
+	if (LCUIRect_GetOverlayRect(&that->style->padding_box, box,
+				    &renderer.actual_content_rect)) {
+		LCUIRect_ToRectF(&renderer.actual_content_rect,
+				 &renderer.content_rect,
+				 1.0f / LCUIMetrics_GetScale());
+		WidgetRenderer_RenderChildren(&renderer);
+	}
+	return 0;
+}
+
+/** 用内容缓存代替部件自身内容和子部件的绘制 */
+static void WidgetRenderer_RenderContentCache(LCUI_WidgetRenderer that)
+{
+	LCUI_Rect rect, slice_rect;
+	LCUI_Graph slice, cache;
+	LCUI_Widget w = that->target;
+	const LCUI_Rect *box = &that->style->border_box;
+	unsigned generation = LCUIMetrics_GetScaleGeneration();
+
+	if (!LCUIRect_GetOverlayRect(&that->actual_paint_rect, box, &rect)) {
+		return;
+	}
+	slice_rect = rect;
+	slice_rect.x -= box->x;
+	slice_rect.y -= box->y;
+	Graph_Init(&cache);
+	/* 共享缓存的像素数据，即使缓存在绘制期间被释放或替换也能继续使用 */
+	LCUIMutex_Lock(&self.mutex);
+	if (ContentCache_IsValid(w, box)) {
+		Graph_Copy(&cache, &w->content_cache);
+		ContentCache_Touch(w);
+	}
+	LCUIMutex_Unlock(&self.mutex);
+	if (!Graph_IsValid(&cache)) {
+		if (WidgetRenderer_PaintContentCache(that, &cache) != 0) {
+			return;
+		}
+		LCUIMutex_Lock(&self.mutex);
+		ContentCache_Store(w, &cache, generation);
+		self.stats.content_rendered_pixels += box->width * box->height;
+		LCUIMutex_Unlock(&self.mutex);
+	}
+	Graph_QuoteReadOnly(&slice, &cache, &slice_rect);
+	Graph_Mix(&that->paint->canvas, &slice,
+		  rect.x - that->actual_paint_rect.x,
+		  rect.y - that->actual_paint_rect.y, that->paint->with_alpha);
+	Graph_Free(&cache);
+	LCUIMutex_Lock(&self.mutex);
+	self.stats.content_reused_pixels += rect.width * rect.height;
+	LCUIMutex_Unlock(&self.mutex);
+}
+
 static size_t WidgetRenderer_Render(LCUI_WidgetRenderer renderer)
 {
 	size_t count = 0;
+	LCUI_BOOL use_content_cache;
 	LCUI_PaintContextRec self_paint;
 	LCUI_WidgetRenderer that = renderer;
 
@@ -643,13 +1552,17 @@ static size_t WidgetRenderer_Render(LCUI_WidgetRenderer renderer)
 #endif
 	DEBUG_MSG("[%d] %s: start render\n", that->target->index,
 		  that->target->type);
+	use_content_cache = WidgetRenderer_CanUseContentCache(that);
 	/* 如果部件有需要绘制的内容 */
 	if (that->can_render_self) {
 		count += 1;
+		that->stats->painted_pixels +=
+		    that->paint->rect.width * that->paint->rect.height;
 		self_paint = *that->paint;
 		self_paint.with_alpha = TRUE;
 		self_paint.canvas = that->self_graph;
-		Widget_OnPaint(that->target, &self_paint, that->style);
+		Widget_OnPaint(that->target, &self_paint, that->style,
+			       !use_content_cache);
 #ifdef DEBUG_FRAME_RENDER
 		sprintf(filename,
 			"frame-%lu-L%d-%s-self-paint-(%d,%d,%d,%d).png",
@@ -670,7 +1583,9 @@ static size_t WidgetRenderer_Render(LCUI_WidgetRenderer renderer)
 #endif
 		}
 	}
-	if (that->can_render_centent) {
+	if (use_content_cache) {
+		WidgetRenderer_RenderContentCache(that);
+	} else if (that->can_render_centent) {
 		count += WidgetRenderer_RenderChildren(that);
 	}
 	if (that->has_content_graph && Widget_HasRoundBorder(that->target)) {
@@ -735,29 +1650,307 @@ static size_t WidgetRenderer_Render(LCUI_WidgetRenderer renderer)
 	return count;
 }
 
+/** 计算部件的实际样式，各个框的位置相对于部件自身的呈现框 */
+static void Widget_ComputeActualStyle(LCUI_Widget w, LCUI_WidgetActualStyle s)
+{
+	/* compute actual canvas box */
+	s->x = s->y = 0;
+	Widget_ComputeActualBorderBox(w, s);
+	Widget_ComputeActualCanvasBox(w, s);
+	/* reset widget position to relative paint rect */
+	s->x = (float)-s->canvas_box.x;
+	s->y = (float)-s->canvas_box.y;
+	Widget_ComputeActualBorderBox(w, s);
+	Widget_ComputeActualCanvasBox(w, s);
+	Widget_ComputeActualPaddingBox(w, s);
+	Widget_ComputeActualContentBox(w, s);
+}
+
 size_t Widget_Render(LCUI_Widget w, LCUI_PaintContext paint)
 {
 	size_t count;
 	LCUI_WidgetRenderer renderer;
 	LCUI_WidgetActualStyleRec style;
+	LCUI_WidgetRepaintStatsRec stats = { 0 };
 
-	/* compute actual canvas box */
-	style.x = style.y = 0;
-	Widget_ComputeActualBorderBox(w, &style);
-	Widget_ComputeActualCanvasBox(w, &style);
-	/* reset widget position to relative paint rect */
-	style.x = (float)-style.canvas_box.x;
-	style.y = (float)-style.canvas_box.y;
-	Widget_ComputeActualBorderBox(w, &style);
-	Widget_ComputeActualCanvasBox(w, &style);
-	Widget_ComputeActualPaddingBox(w, &style);
-	Widget_ComputeActualContentBox(w, &style);
+	Widget_ComputeActualStyle(w, &style);
 	renderer = WidgetRenderer(w, paint, &style, NULL);
+	renderer->stats = &stats;
 	DEBUG_MSG("[%d] %s: start render\n", renderer->target->index,
 		  renderer->target->type);
 	count = WidgetRenderer_Render(renderer);
+	LCUIMutex_Lock(&self.mutex);
+	self.stats.painted_pixels += stats.painted_pixels;
+	self.stats.occluded_pixels += stats.occluded_pixels;
+	self.stats.occluded_widgets += stats.occluded_widgets;
+	LCUIMutex_Unlock(&self.mutex);
 	DEBUG_MSG("[%d] %s: end render, count: %lu\n", renderer->target->index,
 		  renderer->target->type, count);
 	WidgetRenderer_Delete(renderer);
 	return count;
 }
+
+static void WidgetSnapshot_Destroy(LCUI_WidgetSnapshot snapshot)
+{
+	LinkedListNode *node, *next;
+	LCUI_Widget w = &snapshot->widget;
+
+	for (node = w->children.head.next; node; node = next) {
+		next = node->next;
+		WidgetSnapshot_Destroy(node->data);
+	}
+	Widget_DestroyBorderImage(w);
+	Graph_Free(&w->computed_style.background.image);
+	Graph_Free(&w->computed_style.border_image.source);
+	Graph_Free(&snapshot->content);
+	free(snapshot);
+}
+
+/**
+ * 创建部件的快照
+ * 快照只包含绘制所需的数据，部件原型的绘制函数会在当前线程中执行，绘制结果保
+ * 存在快照中，因为它们可能会读取只能在主线程中访问的数据。
+ */
+static LCUI_WidgetSnapshot Widget_CreateSnapshot(LCUI_Widget w)
+{
+	LCUI_Widget c, child;
+	LinkedListNode *node;
+	LCUI_PaintContextRec paint;
+	LCUI_WidgetActualStyleRec style;
+	LCUI_WidgetSnapshot snapshot, child_snapshot;
+	const LCUI_WidgetStyle *s = &w->computed_style;
+
+	snapshot = NEW(LCUI_WidgetSnapshotRec, 1);
+	if (!snapshot) {
+		return NULL;
+	}
+	c = &snapshot->widget;
+	*c = *w;
+	c->id = NULL;
+	c->type = NULL;
+	c->classes = NULL;
+	c->status = NULL;
+	c->title = NULL;
+	c->attributes = NULL;
+	c->style = NULL;
+	c->custom_style = NULL;
+	c->inherited_style = NULL;
+	c->trigger = NULL;
+	c->parent = NULL;
+	c->border_image_cache = NULL;
+	c->enable_content_cache = FALSE;
+	memset(&c->data, 0, sizeof(c->data));
+	memset(&c->invalid_node, 0, sizeof(c->invalid_node));
+	memset(&c->content_cache_node, 0, sizeof(c->content_cache_node));
+	Graph_Init(&c->content_cache);
+	Graph_Init(&c->computed_style.background.image);
+	Graph_Init(&c->computed_style.border_image.source);
+	Graph_Copy(&c->computed_style.background.image, &s->background.image);
+	Graph_Copy(&c->computed_style.border_image.source,
+		   &s->border_image.source);
+	if (w->rules) {
+		snapshot->rules = *w->rules;
+		c->rules = &snapshot->rules;
+	}
+	Graph_Init(&snapshot->content);
+	c->proto = self.default_proto;
+	if (w->proto && w->proto->paint) {
+		c->proto = &self.snapshot_proto;
+		Widget_ComputeActualStyle(w, &style);
+		snapshot->content.color_type = LCUI_COLOR_TYPE_ARGB;
+		if (Graph_Create(&snapshot->content, style.canvas_box.width,
+				 style.canvas_box.height) == 0) {
+			paint.with_alpha = TRUE;
+			paint.rect.x = paint.rect.y = 0;
+			paint.rect.width = style.canvas_box.width;
+			paint.rect.height = style.canvas_box.height;
+			Graph_Quote(&paint.canvas, &snapshot->content, NULL);
+			w->proto->paint(w, &paint, &style);
+		}
+	}
+	LinkedList_Init(&c->children);
+	LinkedList_Init(&c->children_show);
+	for (LinkedList_Each(node, &w->children_show)) {
+		child = node->data;
+		if (!child->computed_style.visible ||
+		    child->state != LCUI_WSTATE_NORMAL) {
+			continue;
+		}
+		child_snapshot = Widget_CreateSnapshot(child);
+		if (!child_snapshot) {
+			break;
+		}
+		child_snapshot->widget.parent = c;
+		child_snapshot->widget.node.data = child_snapshot;
+		child_snapshot->widget.node_show.data = child_snapshot;
+		LinkedList_AppendNode(&c->children, &child_snapshot->widget.node);
+		LinkedList_AppendNode(&c->children_show,
+				      &child_snapshot->widget.node_show);
+	}
+	return snapshot;
+}
+
+static void WidgetRenderTask_Destroy(LCUI_WidgetRenderTask task)
+{
+	if (task->snapshot) {
+		WidgetSnapshot_Destroy(task->snapshot);
+	}
+	Graph_Free(&task->graph);
+	free(task);
+}
+
+static LCUI_WidgetRenderTask WidgetRenderTask_Create(LCUI_Widget w,
+						     float scale,
+						     const LCUI_RectF *rect)
+{
+	LCUI_RectF rectf;
+	LCUI_WidgetRenderTask task;
+
+	if (scale <= 0) {
+		return NULL;
+	}
+	if (rect) {
+		rectf = *rect;
+	} else {
+		rectf.x = rectf.y = 0;
+		rectf.width = w->box.border.width;
+		rectf.height = w->box.border.height;
+	}
+	task = NEW(LCUI_WidgetRenderTaskRec, 1);
+	if (!task) {
+		return NULL;
+	}
+	task->widget = w;
+	task->source = w;
+	task->snapshot = NULL;
+	task->handler_id = -1;
+	task->width = iround(rectf.width * scale);
+	task->height = iround(rectf.height * scale);
+	Graph_Init(&task->graph);
+	/* 区域是相对于边框盒的，需转换成相对于呈现框的 */
+	rectf.x += w->box.border.x - w->box.canvas.x;
+	rectf.y += w->box.border.y - w->box.canvas.y;
+	LCUIMetrics_ComputeRectActual(&task->rect, &rectf);
+	if (task->width < 1 || task->height < 1 || task->rect.width < 1 ||
+	    task->rect.height < 1) {
+		free(task);
+		return NULL;
+	}
+	return task;
+}
+
+static int WidgetRenderTask_Run(LCUI_WidgetRenderTask task)
+{
+	int ret;
+	LCUI_Graph canvas;
+	LCUI_Rect canvas_rect, rect;
+	LCUI_PaintContextRec paint;
+	LCUI_WidgetActualStyleRec style;
+
+	Graph_Init(&canvas);
+	canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+	ret = Graph_Create(&canvas, task->rect.width, task->rect.height);
+	if (ret != 0) {
+		return ret;
+	}
+	Widget_ComputeActualStyle(task->source, &style);
+	canvas_rect.x = canvas_rect.y = 0;
+	canvas_rect.width = style.canvas_box.width;
+	canvas_rect.height = style.canvas_box.height;
+	/* 只绘制区域中与呈现框重叠的部分，其余部分保持透明 */
+	if (LCUIRect_GetOverlayRect(&task->rect, &canvas_rect, &paint.rect)) {
+		rect = paint.rect;
+		rect.x -= task->rect.x;
+		rect.y -= task->rect.y;
+		paint.with_alpha = TRUE;
+		Graph_Quote(&paint.canvas, &canvas, &rect);
+		Widget_Render(task->source, &paint);
+	}
+	if (canvas.width == (unsigned)task->width &&
+	    canvas.height == (unsigned)task->height) {
+		Graph_Copy(&task->graph, &canvas);
+	} else {
+		ret = Graph_ZoomBilinear(&canvas, &task->graph, FALSE,
+					 task->width, task->height);
+	}
+	Graph_Free(&canvas);
+	return ret;
+}
+
+int Widget_RenderToGraph(LCUI_Widget w, float scale, const LCUI_RectF *rect,
+			 LCUI_Graph *out)
+{
+	int ret;
+	LCUI_WidgetRenderTask task;
+
+	task = WidgetRenderTask_Create(w, scale, rect);
+	if (!task) {
+		return -EINVAL;
+	}
+	ret = WidgetRenderTask_Run(task);
+	if (ret == 0) {
+		Graph_Free(out);
+		*out = task->graph;
+		Graph_Init(&task->graph);
+	}
+	WidgetRenderTask_Destroy(task);
+	return ret;
+}
+
+static void WidgetRenderTask_OnWidgetDestroy(LCUI_Widget w, LCUI_WidgetEvent e,
+					     void *arg)
+{
+	LCUI_WidgetRenderTask task = e->data;
+
+	task->widget = NULL;
+}
+
+/** 在主线程中完成渲染任务，触发部件的 rendered 事件 */
+static void WidgetRenderTask_OnDone(void *arg1, void *arg2)
+{
+	LCUI_WidgetEventRec e;
+	LCUI_WidgetRenderTask task = arg1;
+
+	if (task->widget) {
+		Widget_UnbindEventByHandlerId(task->widget, task->handler_id);
+		LCUI_InitWidgetEvent(&e, "rendered");
+		e.cancel_bubble = TRUE;
+		Widget_TriggerEvent(task->widget, &e, &task->graph);
+	}
+	WidgetRenderTask_Destroy(task);
+}
+
+static void WidgetRenderTask_Exec(void *arg1, void *arg2)
+{
+	LCUI_WidgetRenderTask task = arg1;
+
+	if (WidgetRenderTask_Run(task) != 0) {
+		Graph_Free(&task->graph);
+	}
+	LCUI_PostSimpleTask(WidgetRenderTask_OnDone, task, NULL);
+}
+
+int Widget_RenderToGraphAsync(LCUI_Widget w, float scale,
+			      const LCUI_RectF *rect)
+{
+	LCUI_TaskRec worker_task = { 0 };
+	LCUI_WidgetRenderTask task;
+
+	task = WidgetRenderTask_Create(w, scale, rect);
+	if (!task) {
+		return -EINVAL;
+	}
+	task->snapshot = Widget_CreateSnapshot(w);
+	if (!task->snapshot) {
+		WidgetRenderTask_Destroy(task);
+		return -ENOMEM;
+	}
+	task->source = &task->snapshot->widget;
+	task->handler_id =
+	    Widget_BindEvent(w, "destroy", WidgetRenderTask_OnWidgetDestroy,
+			     task, NULL);
+	worker_task.func = WidgetRenderTask_Exec;
+	worker_task.arg[0] = task;
+	LCUI_PostAsyncTask(&worker_task);
+	return 0;
+}
@@ -28,41 +28,116 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/gui/widget_base.h>
 #include <LCUI/gui/widget_status.h>
+#include <LCUI/gui/widget_hash.h>
 #include <LCUI/gui/widget_style.h>
 #include <LCUI/gui/widget_task.h>
 #include <LCUI/gui/widget_tree.h>
 
-static void Widget_MarkChildrenRefreshByStatus(LCUI_Widget w)
+/** 判断部件是否匹配选择器结点 */
+static LCUI_BOOL Widget_MatchSelectorNode(LCUI_Widget w, LCUI_SelectorNode sn)
 {
-	LinkedListNode *node;
+	int i;
 
-	if (w->rules && w->rules->ignore_status_change) {
-		return;
+	if (sn->id && (!w->id || strcmp(w->id, sn->id) != 0)) {
+		return FALSE;
+	}
+	if (sn->type && strcmp(sn->type, "*") != 0 &&
+	    (!w->type || strcmp(w->type, sn->type) != 0)) {
+		return FALSE;
+	}
+	for (i = 0; sn->classes && sn->classes[i]; ++i) {
+		if (!strlist_has(w->classes, sn->classes[i])) {
+			return FALSE;
+		}
+	}
+	for (i = 0; sn->status && sn->status[i]; ++i) {
+		if (!strlist_has(w->status, sn->status[i])) {
+			return FALSE;
+		}
 	}
-	Widget_AddTask(w, LCUI_WTASK_REFRESH_STYLE);
+	return TRUE;
+}
+
+/** 标记与样式表作用对象相匹配的子孙部件，让它们刷新样式 */
+static size_t Widget_MarkChildrenRefreshBySubjects(LCUI_Widget w,
+						   LinkedList *subjects)
+{
+	size_t count = 0;
+	LCUI_Widget child;
+	LCUI_Selector s;
+	LinkedListNode *node, *sub_node;
+
 	for (LinkedList_Each(node, &w->children)) {
-		Widget_MarkChildrenRefreshByStatus(node->data);
+		child = node->data;
+		if (child->rules && child->rules->ignore_status_change) {
+			continue;
+		}
+		for (LinkedList_Each(sub_node, subjects)) {
+			s = sub_node->data;
+			if (Widget_MatchSelectorNode(child, s->nodes[0])) {
+				Widget_AddTask(child, LCUI_WTASK_REFRESH_STYLE);
+				count += 1;
+				break;
+			}
+		}
+		count += Widget_MarkChildrenRefreshBySubjects(child, subjects);
 	}
+	return count;
 }
 
+/**
+ * 处理状态变化
+ * 根据样式表中含有该状态的选择器结点的位置，只刷新样式可能会变化的部件：若位
+ * 置为 0，则刷新部件自身，否则刷新与样式表作用对象相匹配的子孙部件。
+ */
 static int Widget_HandleStatusChange(LCUI_Widget w, const char *name)
 {
-	Widget_UpdateStyle(w, TRUE);
+	int group;
+	size_t count = 0;
+	unsigned positions;
+	LCUI_Selector s;
+	LinkedList names, subjects;
+	LinkedListNode *node;
+
 	if (w->state < LCUI_WSTATE_READY || w->state == LCUI_WSTATE_DELETED) {
+		Widget_UpdateStyle(w, TRUE);
 		return 1;
 	}
-	if (w->rules && w->rules->ignore_status_change) {
-		return 0;
+	positions = LCUI_GetStatusPositions(name);
+	if ((positions & 1) && Widget_GetStyleChanges(w, 0, 1, name, NULL) > 0) {
+		Widget_UpdateStyle(w, TRUE);
+		count += 1;
 	}
-	if (Widget_GetChildrenStyleChanges(w, 1, name) > 0) {
-		Widget_MarkChildrenRefreshByStatus(w);
-		return 1;
+	if ((w->rules && w->rules->ignore_status_change) || positions <= 1) {
+		return count > 0;
 	}
-	return 0;
+	LinkedList_Init(&names);
+	LinkedList_Init(&subjects);
+	for (group = 1; group < MAX_SELECTOR_DEPTH; ++group) {
+		if (positions & (1u << group)) {
+			Widget_GetStyleChanges(w, group, 1, name, &names);
+		}
+	}
+	for (LinkedList_Each(node, &names)) {
+		s = Selector(node->data);
+		if (s && s->length == 1) {
+			LinkedList_Append(&subjects, s);
+		} else if (s) {
+			Selector_Delete(s);
+		}
+	}
+	if (subjects.length > 0) {
+		count += Widget_MarkChildrenRefreshBySubjects(w, &subjects);
+	}
+	LinkedList_Clear(&subjects, (FuncPtr)Selector_Delete);
+	LinkedList_Clear(&names, free);
+	return count > 0;
 }
 
 int Widget_AddStatus(LCUI_Widget w, const char *status_name)
@@ -73,6 +148,7 @@ int Widget_AddStatus(LCUI_Widget w, const char *status_name)
 	if (strlist_add(&w->status, status_name) <= 0) {
 		return 0;
 	}
+	Widget_UpdateHash(w);
 	return Widget_HandleStatusChange(w, status_name);
 }
 
@@ -89,6 +165,7 @@ int Widget_RemoveStatus(LCUI_Widget w, const char *status_name)
 	if (strlist_has(w->status, status_name)) {
 		Widget_HandleStatusChange(w, status_name);
 		strlist_remove(&w->status, status_name);
+		Widget_UpdateHash(w);
 		return 1;
 	}
 	return 0;
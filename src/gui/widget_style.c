@@ -501,17 +501,14 @@ LCUI_Selector Widget_GetSelector(LCUI_Widget w)
 
 	s = Selector(NULL);
 	LinkedList_Init(&list);
-	for (parent = w; parent; parent = parent->parent) {
+	/* 选择器的结点数量有限，嵌套过深时只保留离部件最近的祖先结点 */
+	for (parent = w; parent && list.length < MAX_SELECTOR_DEPTH - 1;
+	     parent = parent->parent) {
 		if (parent->id || parent->type || parent->classes ||
 		    parent->status) {
 			LinkedList_Append(&list, parent);
 		}
 	}
-	if (list.length >= MAX_SELECTOR_DEPTH) {
-		LinkedList_Clear(&list, NULL);
-		Selector_Delete(s);
-		return NULL;
-	}
 	for (LinkedList_EachReverse(node, &list)) {
 		parent = node->data;
 		s->nodes[i] = Widget_GetSelectorNode(parent);
@@ -525,7 +522,8 @@ LCUI_Selector Widget_GetSelector(LCUI_Widget w)
 	return s;
 }
 
-size_t Widget_GetChildrenStyleChanges(LCUI_Widget w, int type, const char *name)
+size_t Widget_GetStyleChanges(LCUI_Widget w, int group, int type,
+			      const char *name, LinkedList *subjects)
 {
 	LCUI_Selector s;
 	LinkedList snames;
@@ -545,8 +543,11 @@ size_t Widget_GetChildrenStyleChanges(LCUI_Widget w, int type, const char *name)
 	default:
 		return 0;
 	}
-	LinkedList_Init(&snames);
 	s = Widget_GetSelector(w);
+	if (!s) {
+		return 0;
+	}
+	LinkedList_Init(&snames);
 	n = strsplit(name, " ", &names);
 	/* 为分割出来的字符串加上前缀 */
 	for (i = 0; i < n; ++i) {
@@ -576,9 +577,15 @@ size_t Widget_GetChildrenStyleChanges(LCUI_Widget w, int type, const char *name)
 				break;
 			}
 		}
-		if (i < n) {
-			count +=
-			    LCUI_FindStyleSheetFromGroup(1, sname, s, NULL);
+		if (i >= n) {
+			continue;
+		}
+		if (subjects) {
+			count += LCUI_FindStyleSubjectsFromGroup(group, sname,
+								 s, subjects);
+		} else {
+			count += LCUI_FindStyleSheetFromGroup(group, sname, s,
+							      NULL);
 		}
 	}
 	Selector_Delete(s);
@@ -590,6 +597,11 @@ size_t Widget_GetChildrenStyleChanges(LCUI_Widget w, int type, const char *name)
 	return count;
 }
 
+size_t Widget_GetChildrenStyleChanges(LCUI_Widget w, int type, const char *name)
+{
+	return Widget_GetStyleChanges(w, 1, type, name, NULL);
+}
+
 void Widget_PrintStyleSheets(LCUI_Widget w)
 {
 	LCUI_Selector s = Widget_GetSelector(w);
@@ -641,6 +653,54 @@ void Widget_SetStyleString(LCUI_Widget w, const char *name, const char *value)
 	Widget_UpdateStyle(w, FALSE);
 }
 
+static void OnCompileStyle(int key, LCUI_Style style, void *arg)
+{
+	LCUI_StyleList list = arg;
+	LCUI_StyleListNode node = StyleList_GetNode(list, key);
+
+	if (node) {
+		DestroyStyle(&node->style);
+	} else {
+		node = StyleList_AddNode(list, key);
+	}
+	node->style = *style;
+}
+
+int Widget_CompileStyleString(LCUI_StyleList list, const char *name,
+			      const char *value)
+{
+	LCUI_CSSParserStyleContextRec ctx = { 0 };
+
+	ctx.style_handler = OnCompileStyle;
+	ctx.style_handler_arg = list;
+	ctx.parser = LCUI_GetCSSPropertyParser(name);
+	if (!ctx.parser) {
+		return -ENOENT;
+	}
+	return ctx.parser->parse(&ctx, value);
+}
+
+void Widget_SetStyles(LCUI_Widget w, LCUI_StyleList list)
+{
+	LCUI_Style s;
+	LCUI_StyleListNode snode;
+	LinkedListNode *node;
+
+	for (LinkedList_Each(node, list)) {
+		snode = node->data;
+		if (!snode->style.is_valid) {
+			Widget_UnsetStyle(w, snode->key);
+			continue;
+		}
+		s = Widget_GetStyle(w, snode->key);
+		DestroyStyle(s);
+		/* 样式列表会被重复使用，字符串类型的值需要复制一份 */
+		MergeStyle(s, &snode->style);
+		Widget_AddTaskByStyle(w, snode->key);
+	}
+	Widget_UpdateStyle(w, FALSE);
+}
+
 void Widget_AddTaskByStyle(LCUI_Widget w, int key)
 {
 	size_t i;
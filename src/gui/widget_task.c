@@ -427,6 +427,13 @@ static void Widget_UpdateSelf(LCUI_Widget w, LCUI_WidgetTaskContext ctx)
 
 	states = w->task.states;
 	w->task.for_self = FALSE;
+	if (ctx->profile) {
+		if (states[LCUI_WTASK_REFRESH_STYLE]) {
+			ctx->profile->refresh_count += 1;
+		} else if (states[LCUI_WTASK_UPDATE_STYLE]) {
+			ctx->profile->update_count += 1;
+		}
+	}
 	for (i = 0; i < LCUI_WTASK_REFLOW; ++i) {
 		if (states[i]) {
 			if (w->proto && w->proto->runtask) {
@@ -475,7 +482,16 @@ static size_t Widget_UpdateWithContext(LCUI_Widget w,
 		count += Widget_UpdateChildren(w, self_ctx);
 	}
 	if (w->task.states[LCUI_WTASK_REFLOW]) {
-		Widget_Reflow(w, LCUI_LAYOUT_RULE_AUTO);
+		if (self_ctx->profile) {
+			int64_t start = LCUI_GetTimeNs();
+
+			Widget_Reflow(w, LCUI_LAYOUT_RULE_AUTO);
+			self_ctx->profile->layout_time +=
+			    LCUI_GetTimeNs() - start;
+			self_ctx->profile->layout_count += 1;
+		} else {
+			Widget_Reflow(w, LCUI_LAYOUT_RULE_AUTO);
+		}
 		w->task.states[LCUI_WTASK_REFLOW] = FALSE;
 	}
 	Widget_EndLayoutDiff(w, &self_ctx->layout_diff);
@@ -495,16 +511,24 @@ size_t Widget_Update(LCUI_Widget w)
 	return count;
 }
 
+/**
+ * 检查度量参数是否有变化，有则刷新所有部件的样式
+ * 缩放比例也包括在内，因为边框、阴影和尺寸等以 dp、px 为单位的样式都与它相关
+ */
+static void LCUIWidget_CheckMetrics(void)
+{
+	if (memcmp(LCUI_GetMetrics(), &self.metrics,
+		   sizeof(LCUI_MetricsRec))) {
+		self.refresh_all = TRUE;
+	}
+}
+
 size_t LCUIWidget_Update(void)
 {
 	size_t count;
 	LCUI_Widget root;
-	const LCUI_MetricsRec *metrics;
 
-	metrics = LCUI_GetMetrics();
-	if (memcmp(metrics, &self.metrics, sizeof(LCUI_MetricsRec))) {
-		self.refresh_all = TRUE;
-	}
+	LCUIWidget_CheckMetrics();
 	if (self.refresh_all) {
 		LCUIWidget_RefreshStyle();
 	}
@@ -512,7 +536,7 @@ size_t LCUIWidget_Update(void)
 	count = Widget_Update(root);
 	root->state = LCUI_WSTATE_NORMAL;
 	LCUIWidget_ClearTrash();
-	self.metrics = *metrics;
+	self.metrics = *LCUI_GetMetrics();
 	self.refresh_all = FALSE;
 	return count;
 }
@@ -530,16 +554,9 @@ void Widget_UpdateWithProfile(LCUI_Widget w, LCUI_WidgetTasksProfile profile)
 void LCUIWidget_UpdateWithProfile(LCUI_WidgetTasksProfile profile)
 {
 	LCUI_Widget root;
-	const LCUI_MetricsRec *metrics;
 
 	profile->time = clock();
-	metrics = LCUI_GetMetrics();
-	if (memcmp(metrics, &self.metrics, sizeof(LCUI_MetricsRec))) {
-		self.refresh_all = TRUE;
-	}
-	if (self.refresh_all) {
-		LCUIWidget_RefreshStyle();
-	}
+	LCUIWidget_CheckMetrics();
 	if (self.refresh_all) {
 		LCUIWidget_RefreshStyle();
 	}
@@ -550,6 +567,8 @@ void LCUIWidget_UpdateWithProfile(LCUI_WidgetTasksProfile profile)
 	profile->destroy_time = clock();
 	profile->destroy_count = LCUIWidget_ClearTrash();
 	profile->destroy_time = clock() - profile->destroy_time;
+	self.metrics = *LCUI_GetMetrics();
+	self.refresh_all = FALSE;
 }
 
 void LCUIWidget_RefreshStyle(void)
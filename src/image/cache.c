@@ -0,0 +1,186 @@
+﻿/*
+ * cache.c -- On-disk cache of decoded images
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <LCUI_Build.h>
+#include <LCUI/types.h>
+#include <LCUI/graph.h>
+#include <LCUI/image.h>
+#include <LCUI/thread.h>
+
+#ifdef LCUI_BUILD_IN_WIN32
+#include <direct.h>
+#define mkdir(PATH, MODE) _mkdir(PATH)
+#endif
+
+#define CACHE_FILE_SUFFIX ".lcri"
+#define CACHE_PATH_MAX 1024
+
+static struct LCUI_ImageCacheModule {
+	char *dir;
+} self;
+
+/** 用 FNV-1a 算法计算路径的哈希值，作为缓存文件名 */
+static uint64_t HashPath(const char *path)
+{
+	uint64_t hash = 14695981039346656037ULL;
+
+	for (; *path; ++path) {
+		hash ^= (uchar_t)*path;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+int LCUI_GetImageCacheFilePath(const char *filepath, char *buf, size_t max_len)
+{
+	int len;
+	uint64_t hash = HashPath(filepath);
+
+	if (!self.dir) {
+		return -ENOENT;
+	}
+
+	len = snprintf(buf, max_len, "%s/%08lx%08lx" CACHE_FILE_SUFFIX,
+		       self.dir, (unsigned long)(hash >> 32),
+		       (unsigned long)(hash & 0xffffffff));
+	if (len < 0 || (size_t)len >= max_len) {
+		return -ENAMETOOLONG;
+	}
+	return 0;
+}
+
+static int GetSourceInfo(const char *filepath, LCUI_RawImageSourceRec *source)
+{
+	struct stat st;
+
+	if (stat(filepath, &st) != 0) {
+		return -ENOENT;
+	}
+	source->path = filepath;
+	source->size = (uint64_t)st.st_size;
+	source->mtime = (int64_t)st.st_mtime;
+	return 0;
+}
+
+int LCUI_SetImageCacheDir(const char *dirpath)
+{
+	struct stat st;
+
+	if (self.dir) {
+		free(self.dir);
+		self.dir = NULL;
+	}
+	if (!dirpath) {
+		return 0;
+	}
+	if (stat(dirpath, &st) != 0 && mkdir(dirpath, 0755) != 0) {
+		return -EACCES;
+	}
+	self.dir = strdup(dirpath);
+	return self.dir ? 0 : -ENOMEM;
+}
+
+int LCUI_ReadCachedImageFile(const char *filepath, LCUI_Graph *out)
+{
+	char path[CACHE_PATH_MAX];
+	LCUI_RawImageSourceRec source;
+
+	if (!self.dir || GetSourceInfo(filepath, &source) != 0 ||
+	    LCUI_GetImageCacheFilePath(filepath, path, CACHE_PATH_MAX) != 0) {
+		return -ENOENT;
+	}
+	return LCUI_ReadRawImageFile(path, out, &source);
+}
+
+int LCUI_WriteCachedImageFile(const char *filepath, const LCUI_Graph *graph)
+{
+	int ret;
+	char path[CACHE_PATH_MAX], tmp_path[CACHE_PATH_MAX + 32];
+	LCUI_RawImageSourceRec source;
+
+	if (!self.dir) {
+		return -ENOENT;
+	}
+	ret = GetSourceInfo(filepath, &source);
+	if (ret != 0) {
+		return ret;
+	}
+	ret = LCUI_GetImageCacheFilePath(filepath, path, CACHE_PATH_MAX);
+	if (ret != 0) {
+		return ret;
+	}
+	/*
+	 * 先写入临时文件再重命名，避免其它线程读到写了一半的文件，正在使用
+	 * 旧文件映射的图像也不受影响
+	 */
+	snprintf(tmp_path, sizeof(tmp_path), "%s.%lu.tmp", path,
+		 (unsigned long)LCUIThread_SelfID());
+	ret = LCUI_WriteRawImageFile(tmp_path, graph,
+				     LCUI_RAW_IMAGE_UNCOMPRESSED, &source);
+	if (ret != 0) {
+		remove(tmp_path);
+		return ret;
+	}
+#ifdef LCUI_BUILD_IN_WIN32
+	remove(path);
+#endif
+	if (rename(tmp_path, path) != 0) {
+		remove(tmp_path);
+		return -EIO;
+	}
+	return 0;
+}
+
+int LCUI_CacheImageFile(const char *filepath)
+{
+	int ret;
+	LCUI_Graph graph;
+
+	if (!self.dir) {
+		return -ENOENT;
+	}
+	Graph_Init(&graph);
+	if (LCUI_ReadCachedImageFile(filepath, &graph) == 0) {
+		Graph_Free(&graph);
+		return 0;
+	}
+	ret = LCUI_DecodeImageFile(filepath, &graph);
+	if (ret == 0) {
+		ret = LCUI_WriteCachedImageFile(filepath, &graph);
+	}
+	Graph_Free(&graph);
+	return ret;
+}
@@ -0,0 +1,437 @@
+﻿/*
+ * raw.c -- LCUI raw image file, stores decoded pixels for fast loading
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/types.h>
+#include <LCUI/graph.h>
+#include <LCUI/image.h>
+
+#ifdef LCUI_BUILD_IN_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define RAW_IMAGE_MAGIC "LCRI"
+#define RAW_IMAGE_VERSION 1
+#define RAW_IMAGE_BYTE_ORDER 0x01020304
+#define RAW_IMAGE_MAX_RUN 128
+
+/* clang-format off */
+
+/**
+ * 文件头
+ * 文件头之后是来源文件的路径，然后填充到 16 字节对齐，之后是逐行紧密排列的
+ * 像素数据，像素格式与内存中的 LCUI_Graph 相同，未压缩的像素数据可以直接
+ * 映射到内存中使用
+ */
+typedef struct RawImageHeaderRec_ {
+	char magic[4];		/**< 标识，固定为 "LCRI" */
+	uint16_t version;	/**< 格式版本 */
+	uint16_t header_size;	/**< 像素数据的偏移量 */
+	uint32_t byte_order;	/**< 用于检查字节序是否与当前平台一致 */
+	uint8_t color_type;	/**< 色彩类型 */
+	uint8_t compression;	/**< 像素数据的压缩方式 */
+	uint16_t path_length;	/**< 来源文件路径的长度 */
+	uint32_t width, height;
+	uint32_t bytes_per_row;
+	uint32_t data_size;	/**< 像素数据的字节数 */
+	uint64_t source_size;	/**< 来源文件的大小 */
+	int64_t source_mtime;	/**< 来源文件的修改时间 */
+} RawImageHeaderRec, *RawImageHeader;
+
+/* clang-format on */
+
+#define PixelEquals(P, I, J, BPP) \
+	(memcmp((P) + (I) * (BPP), (P) + (J) * (BPP), (BPP)) == 0)
+
+/**
+ * 以像素为单位做游程编码
+ * 每段数据以一个字节开头，最高位为 1 时表示接下来的一个像素重复 n 次，否则
+ * 表示接下来有 n 个原样保存的像素，n 为低 7 位的值加 1
+ */
+static size_t RLE_Encode(const uchar_t *pixels, size_t n, unsigned bpp,
+			 uchar_t *out)
+{
+	size_t i, run, start;
+	uchar_t *p = out;
+
+	for (i = 0; i < n;) {
+		for (run = 1; i + run < n && run < RAW_IMAGE_MAX_RUN; ++run) {
+			if (!PixelEquals(pixels, i, i + run, bpp)) {
+				break;
+			}
+		}
+		if (run > 1) {
+			*p++ = (uchar_t)(0x80 | (run - 1));
+			memcpy(p, pixels + i * bpp, bpp);
+			p += bpp;
+			i += run;
+			continue;
+		}
+		start = i;
+		do {
+			++i;
+		} while (i < n && i - start < RAW_IMAGE_MAX_RUN &&
+			 !(i + 1 < n && PixelEquals(pixels, i, i + 1, bpp)));
+		*p++ = (uchar_t)(i - start - 1);
+		memcpy(p, pixels + start * bpp, (i - start) * bpp);
+		p += (i - start) * bpp;
+	}
+	return p - out;
+}
+
+static int RLE_Decode(const uchar_t *data, size_t size, unsigned bpp,
+		      uchar_t *out, size_t out_size)
+{
+	size_t count;
+	const uchar_t *end = data + size;
+	uchar_t *out_end = out + out_size;
+
+	while (out < out_end) {
+		if (data >= end) {
+			return -EINVAL;
+		}
+		count = ((*data & 0x7f) + 1) * bpp;
+		if ((size_t)(out_end - out) < count) {
+			return -EINVAL;
+		}
+		if (*data++ & 0x80) {
+			if ((size_t)(end - data) < bpp) {
+				return -EINVAL;
+			}
+			for (; count > 0; count -= bpp) {
+				memcpy(out, data, bpp);
+				out += bpp;
+			}
+			data += bpp;
+			continue;
+		}
+		if ((size_t)(end - data) < count) {
+			return -EINVAL;
+		}
+		memcpy(out, data, count);
+		data += count;
+		out += count;
+	}
+	return 0;
+}
+
+static int RawImage_CheckHeader(RawImageHeader header, const char *path,
+				size_t file_size,
+				const LCUI_RawImageSourceRec *source)
+{
+	unsigned bpp;
+
+	if (memcmp(header->magic, RAW_IMAGE_MAGIC, 4) != 0 ||
+	    header->version != RAW_IMAGE_VERSION ||
+	    header->byte_order != RAW_IMAGE_BYTE_ORDER) {
+		return -EINVAL;
+	}
+	switch (header->color_type) {
+	case LCUI_COLOR_TYPE_ARGB8888:
+		bpp = 4;
+		break;
+	case LCUI_COLOR_TYPE_RGB888:
+		bpp = 3;
+		break;
+	default:
+		return -EINVAL;
+	}
+	if (header->width < 1 || header->height < 1 ||
+	    header->width > 10000 || header->height > 10000 ||
+	    header->bytes_per_row != header->width * bpp ||
+	    header->header_size < sizeof(RawImageHeaderRec) +
+				      header->path_length ||
+	    (size_t)header->header_size + header->data_size > file_size) {
+		return -EINVAL;
+	}
+	switch (header->compression) {
+	case LCUI_RAW_IMAGE_UNCOMPRESSED:
+		if (header->data_size !=
+		    header->bytes_per_row * header->height) {
+			return -EINVAL;
+		}
+		break;
+	case LCUI_RAW_IMAGE_RLE:
+		break;
+	default:
+		return -EINVAL;
+	}
+	if (!source) {
+		return 0;
+	}
+	if (header->source_size != source->size ||
+	    header->source_mtime != source->mtime ||
+	    header->path_length != strlen(source->path) ||
+	    memcmp(path, source->path, header->path_length) != 0) {
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static int RawImage_ReadPixels(RawImageHeader header, const uchar_t *data,
+			       LCUI_Graph *out)
+{
+	out->color_type = header->color_type;
+	if (Graph_Create(out, header->width, header->height) != 0) {
+		return -ENOMEM;
+	}
+	if (header->compression == LCUI_RAW_IMAGE_UNCOMPRESSED) {
+		memcpy(out->bytes, data, header->data_size);
+		return 0;
+	}
+	if (RLE_Decode(data, header->data_size, out->bytes_per_pixel,
+		       out->bytes, out->bytes_per_row * out->height) != 0) {
+		Graph_Free(out);
+		return -EINVAL;
+	}
+	return 0;
+}
+
+#ifdef LCUI_BUILD_IN_LINUX
+
+typedef struct MappedFileRec_ {
+	void *data;
+	size_t size;
+} MappedFileRec, *MappedFile;
+
+static void MappedFile_Release(void *arg)
+{
+	MappedFile file = arg;
+
+	munmap(file->data, file->size);
+	free(file);
+}
+
+/**
+ * 将文件映射到内存中，未压缩的像素数据直接作为图像的像素数据使用
+ * 映射是私有的，写入图像时只会复制被写入的内存页，不会修改文件
+ */
+static int LCUI_ReadMappedRawImageFile(const char *filepath, LCUI_Graph *out,
+				       const LCUI_RawImageSourceRec *source)
+{
+	int fd, ret;
+	uchar_t *data;
+	struct stat st;
+	MappedFile file;
+	RawImageHeader header;
+
+	fd = open(filepath, O_RDONLY);
+	if (fd < 0) {
+		return -ENOENT;
+	}
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return -EIO;
+	}
+	if ((size_t)st.st_size < sizeof(RawImageHeaderRec)) {
+		close(fd);
+		return -EINVAL;
+	}
+	data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		return -ENOSYS;
+	}
+	header = (RawImageHeader)data;
+	ret = RawImage_CheckHeader(header, (char *)(header + 1),
+				   (size_t)st.st_size, source);
+	if (ret == 0 && header->compression == LCUI_RAW_IMAGE_UNCOMPRESSED) {
+		file = malloc(sizeof(MappedFileRec));
+		if (file) {
+			file->data = data;
+			file->size = (size_t)st.st_size;
+			out->color_type = header->color_type;
+			ret = Graph_CreateFromMemory(
+			    out, header->width, header->height,
+			    data + header->header_size, MappedFile_Release,
+			    file);
+			if (ret == 0) {
+				return 0;
+			}
+			free(file);
+		}
+		ret = RawImage_ReadPixels(header, data + header->header_size,
+					  out);
+	} else if (ret == 0) {
+		ret = RawImage_ReadPixels(header, data + header->header_size,
+					  out);
+	}
+	munmap(data, (size_t)st.st_size);
+	return ret;
+}
+
+#endif
+
+int LCUI_ReadRawImageFile(const char *filepath, LCUI_Graph *out,
+			  const LCUI_RawImageSourceRec *source)
+{
+	int ret;
+	long size;
+	size_t n;
+	FILE *fp;
+	char *path = NULL;
+	uchar_t *data = NULL;
+	RawImageHeaderRec header;
+
+#ifdef LCUI_BUILD_IN_LINUX
+	ret = LCUI_ReadMappedRawImageFile(filepath, out, source);
+	if (ret != -ENOSYS) {
+		return ret;
+	}
+#endif
+	fp = fopen(filepath, "rb");
+	if (!fp) {
+		return -ENOENT;
+	}
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if (size < (long)sizeof(header) ||
+	    fread(&header, sizeof(header), 1, fp) != 1) {
+		fclose(fp);
+		return -EINVAL;
+	}
+	if (header.header_size < sizeof(header)) {
+		fclose(fp);
+		return -EINVAL;
+	}
+	path = malloc(header.header_size);
+	if (!path) {
+		fclose(fp);
+		return -ENOMEM;
+	}
+	ret = -EINVAL;
+	n = header.header_size - sizeof(header);
+	if (n == 0 || fread(path, n, 1, fp) == 1) {
+		ret = RawImage_CheckHeader(&header, path, size, source);
+	}
+	if (ret == 0) {
+		data = malloc(header.data_size);
+		ret = -ENOMEM;
+	}
+	if (data) {
+		ret = -EINVAL;
+		if (fread(data, header.data_size, 1, fp) == 1) {
+			ret = RawImage_ReadPixels(&header, data, out);
+		}
+		free(data);
+	}
+	free(path);
+	fclose(fp);
+	return ret;
+}
+
+int LCUI_WriteRawImageFile(const char *filepath, const LCUI_Graph *graph,
+			   int compression,
+			   const LCUI_RawImageSourceRec *source)
+{
+	int ret = 0;
+	FILE *fp;
+	size_t n, size;
+	uchar_t *data = NULL;
+	char padding[16] = { 0 };
+	RawImageHeaderRec header = { 0 };
+	LCUI_Graph buffer;
+
+	if (!Graph_IsValid(graph) ||
+	    (compression != LCUI_RAW_IMAGE_RLE &&
+	     compression != LCUI_RAW_IMAGE_UNCOMPRESSED)) {
+		return -EINVAL;
+	}
+	switch (Graph_GetQuote(graph)->color_type) {
+	case LCUI_COLOR_TYPE_ARGB8888:
+	case LCUI_COLOR_TYPE_RGB888:
+		break;
+	default:
+		return -EINVAL;
+	}
+	/* 引用的图像区域在内存中不连续，需要先复制出来 */
+	Graph_Init(&buffer);
+	Graph_Copy(&buffer, graph);
+	if (!Graph_IsValid(&buffer)) {
+		return -ENOMEM;
+	}
+	memcpy(header.magic, RAW_IMAGE_MAGIC, 4);
+	header.version = RAW_IMAGE_VERSION;
+	header.byte_order = RAW_IMAGE_BYTE_ORDER;
+	header.color_type = (uint8_t)buffer.color_type;
+	header.compression = (uint8_t)compression;
+	header.width = buffer.width;
+	header.height = buffer.height;
+	header.bytes_per_row = buffer.bytes_per_row;
+	header.data_size = buffer.bytes_per_row * buffer.height;
+	if (source) {
+		header.path_length = (uint16_t)strlen(source->path);
+		header.source_size = source->size;
+		header.source_mtime = source->mtime;
+	}
+	n = sizeof(header) + header.path_length;
+	header.header_size = (uint16_t)((n + 15) / 16 * 16);
+	if (compression == LCUI_RAW_IMAGE_RLE) {
+		n = buffer.width * buffer.height;
+		size = n * buffer.bytes_per_pixel;
+		data = malloc(size + (n + RAW_IMAGE_MAX_RUN - 1) /
+					 RAW_IMAGE_MAX_RUN);
+		if (!data) {
+			Graph_Free(&buffer);
+			return -ENOMEM;
+		}
+		header.data_size = (uint32_t)RLE_Encode(
+		    buffer.bytes, n, buffer.bytes_per_pixel, data);
+	}
+	fp = fopen(filepath, "wb");
+	if (!fp) {
+		free(data);
+		Graph_Free(&buffer);
+		return -EACCES;
+	}
+	n = header.header_size - sizeof(header) - header.path_length;
+	if (fwrite(&header, sizeof(header), 1, fp) != 1 ||
+	    (header.path_length > 0 &&
+	     fwrite(source->path, header.path_length, 1, fp) != 1) ||
+	    (n > 0 && fwrite(padding, n, 1, fp) != 1) ||
+	    fwrite(data ? data : buffer.bytes, header.data_size, 1, fp) != 1) {
+		ret = -EIO;
+	}
+	if (fclose(fp) != 0) {
+		ret = -EIO;
+	}
+	free(data);
+	Graph_Free(&buffer);
+	return ret;
+}
@@ -163,7 +163,7 @@ int LCUI_ReadImage(LCUI_ImageReader reader, LCUI_Graph *out)
 	return -2;
 }
 
-int LCUI_ReadImageFile(const char *filepath, LCUI_Graph *out)
+int LCUI_DecodeImageFile(const char *filepath, LCUI_Graph *out)
 {
 	int ret;
 	FILE *fp;
@@ -194,6 +194,20 @@ int LCUI_ReadImageFile(const char *filepath, LCUI_Graph *out)
 	return ret;
 }
 
+int LCUI_ReadImageFile(const char *filepath, LCUI_Graph *out)
+{
+	int ret;
+
+	if (LCUI_ReadCachedImageFile(filepath, out) == 0) {
+		return 0;
+	}
+	ret = LCUI_DecodeImageFile(filepath, out);
+	if (ret == 0) {
+		LCUI_WriteCachedImageFile(filepath, out);
+	}
+	return ret;
+}
+
 int LCUI_GetImageSize(const char *filepath, int *width, int *height)
 {
 	int ret;
@@ -113,6 +113,12 @@ static struct LCUI_App {
 	LCUI_ProfileRec profile;
 	LCUI_FrameProfile frame;
 	int settings_change_handler_id;
+	struct {
+		LCUI_Mutex mutex;
+		size_t jank_frames;
+		LCUI_HistogramRec frame;
+		LCUI_HistogramRec phases[LCUI_FRAME_PHASE_TOTAL_NUM];
+	} stats;				/**< 帧的统计数据 */
 } MainApp;
 
 /* clang-format on */
@@ -188,38 +194,131 @@ static void OnSettingsChangeEvent(LCUI_SysEvent e, void *arg)
 	StepTimer_SetFrameLimit(MainApp.timer, MainApp.settings.frame_rate_cap);
 }
 
+/**
+ * 记录一帧的统计数据
+ * @param[in] times 各阶段的开始时间和帧的结束时间，样式和布局共用开始时间
+ * @param[in] layout_time 布局耗时
+ */
+static void LCUIFrameStats_Record(const int64_t *times, int64_t layout_time)
+{
+	int64_t total, budget = 0;
+	LCUI_Histogram phases = MainApp.stats.phases;
+
+	if (!MainApp.active) {
+		return;
+	}
+	total = times[5] - times[0];
+	if (MainApp.settings.frame_rate_cap > 0) {
+		budget = 1000000000 / MainApp.settings.frame_rate_cap;
+	}
+	LCUIMutex_Lock(&MainApp.stats.mutex);
+	Histogram_Record(&MainApp.stats.frame, total);
+	Histogram_Record(&phases[LCUI_FRAME_PHASE_TIMERS], times[1] - times[0]);
+	Histogram_Record(&phases[LCUI_FRAME_PHASE_EVENTS], times[2] - times[1]);
+	Histogram_Record(&phases[LCUI_FRAME_PHASE_STYLE],
+			 times[3] - times[2] - layout_time);
+	Histogram_Record(&phases[LCUI_FRAME_PHASE_LAYOUT], layout_time);
+	Histogram_Record(&phases[LCUI_FRAME_PHASE_RENDER], times[4] - times[3]);
+	Histogram_Record(&phases[LCUI_FRAME_PHASE_PRESENT],
+			 times[5] - times[4]);
+	if (budget > 0 && total > budget) {
+		MainApp.stats.jank_frames += 1;
+	}
+	LCUIMutex_Unlock(&MainApp.stats.mutex);
+}
+
+static void LCUIFrameStats_Get(LCUI_Histogram h, LCUI_FramePhaseStats stats)
+{
+	stats->p50 = Histogram_GetPercentile(h, 50);
+	stats->p95 = Histogram_GetPercentile(h, 95);
+	stats->p99 = Histogram_GetPercentile(h, 99);
+	stats->max = h->max;
+	stats->mean = h->total > 0 ? h->sum / (int64_t)h->total : 0;
+}
+
+void LCUI_GetFrameStats(LCUI_FrameStats stats)
+{
+	int i;
+
+	memset(stats, 0, sizeof(LCUI_FrameStatsRec));
+	if (MainApp.settings.frame_rate_cap > 0) {
+		stats->budget = 1000000000 / MainApp.settings.frame_rate_cap;
+	}
+	LCUIMutex_Lock(&MainApp.stats.mutex);
+	stats->frames = MainApp.stats.frame.total;
+	stats->jank_frames = MainApp.stats.jank_frames;
+	LCUIFrameStats_Get(&MainApp.stats.frame, &stats->frame);
+	for (i = 0; i < LCUI_FRAME_PHASE_TOTAL_NUM; ++i) {
+		LCUIFrameStats_Get(&MainApp.stats.phases[i], &stats->phases[i]);
+	}
+	LCUIMutex_Unlock(&MainApp.stats.mutex);
+}
+
+void LCUI_ResetFrameStats(void)
+{
+	int i;
+
+	LCUIMutex_Lock(&MainApp.stats.mutex);
+	MainApp.stats.jank_frames = 0;
+	Histogram_Init(&MainApp.stats.frame);
+	for (i = 0; i < LCUI_FRAME_PHASE_TOTAL_NUM; ++i) {
+		Histogram_Init(&MainApp.stats.phases[i]);
+	}
+	LCUIMutex_Unlock(&MainApp.stats.mutex);
+}
+
 void LCUI_RunFrameWithProfile(LCUI_FrameProfile profile)
 {
+	int64_t times[6];
+
+	times[0] = LCUI_GetTimeNs();
 	profile->timers_time = clock();
 	profile->timers_count = LCUI_ProcessTimers();
 	profile->timers_time = clock() - profile->timers_time;
 
+	times[1] = LCUI_GetTimeNs();
 	profile->events_time = clock();
 	profile->events_count = LCUI_ProcessEvents();
 	profile->events_time = clock() - profile->events_time;
 
+	times[2] = LCUI_GetTimeNs();
 	LCUICursor_Update();
 	LCUIWidget_UpdateWithProfile(&profile->widget_tasks);
 
+	times[3] = LCUI_GetTimeNs();
 	profile->render_time = clock();
 	LCUIDisplay_Update();
 	profile->render_count = LCUIDisplay_Render();
 	profile->render_time = clock() - profile->render_time;
 
+	times[4] = LCUI_GetTimeNs();
 	profile->present_time = clock();
 	LCUIDisplay_Present();
 	profile->present_time = clock() - profile->present_time;
+	times[5] = LCUI_GetTimeNs();
+	LCUIFrameStats_Record(times, profile->widget_tasks.layout_time);
 }
 
 void LCUI_RunFrame(void)
 {
+	int64_t times[6];
+	LCUI_WidgetTasksProfileRec tasks = { 0 };
+
+	times[0] = LCUI_GetTimeNs();
 	LCUI_ProcessTimers();
+	times[1] = LCUI_GetTimeNs();
 	LCUI_ProcessEvents();
+	times[2] = LCUI_GetTimeNs();
 	LCUICursor_Update();
-	LCUIWidget_Update();
+	/* 借助任务统计数据获取布局耗时，以便将样式和布局的耗时分开统计 */
+	LCUIWidget_UpdateWithProfile(&tasks);
+	times[3] = LCUI_GetTimeNs();
 	LCUIDisplay_Update();
 	LCUIDisplay_Render();
+	times[4] = LCUI_GetTimeNs();
 	LCUIDisplay_Present();
+	times[5] = LCUI_GetTimeNs();
+	LCUIFrameStats_Record(times, tasks.layout_time);
 }
 
 static void LCUI_InitEvent(void)
@@ -359,13 +458,13 @@ LCUI_BOOL LCUI_PostTask(LCUI_Task task)
 
 void LCUI_PostAsyncTaskTo(LCUI_Task task, int worker_id)
 {
-	int id = 0;
+	int id = worker_id;
 	if (!MainApp.active) {
 		LCUITask_Run(task);
 		LCUITask_Destroy(task);
 		return;
 	}
-	if (id >= LCUI_WORKER_NUM) {
+	if (id < 0 || id >= LCUI_WORKER_NUM) {
 		id = 0;
 	}
 	LCUIWorker_PostTask(MainApp.workers[id], task);
@@ -472,7 +571,9 @@ void LCUI_InitApp(LCUI_AppDriver app)
 	MainApp.timer = StepTimer_Create();
 	LCUICond_Init(&MainApp.loop_changed);
 	LCUIMutex_Init(&MainApp.loop_mutex);
+	LCUIMutex_Init(&MainApp.stats.mutex);
 	LinkedList_Init(&MainApp.loops);
+	LCUI_ResetFrameStats();
 	LCUIProfile_Init(&MainApp.profile);
 	LCUI_ResetSettings();
 	MainApp.settings_change_handler_id = LCUI_BindEvent(
@@ -523,6 +624,7 @@ static void LCUI_FreeApp(void)
 	}
 	StepTimer_Destroy(MainApp.timer);
 	LCUIMutex_Destroy(&MainApp.loop_mutex);
+	LCUIMutex_Destroy(&MainApp.stats.mutex);
 	LCUICond_Destroy(&MainApp.loop_changed);
 	LinkedList_Clear(&MainApp.loops, OnDeleteMainLoop);
 	if (MainApp.driver_ready) {
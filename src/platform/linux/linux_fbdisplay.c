@@ -207,6 +207,22 @@ static void FBSurface_EndPaint(LCUI_Surface surface, LCUI_PaintContext paint)
 	LCUIPainter_End(paint);
 }
 
+static int FBSurface_CopyRect(LCUI_Surface surface, LCUI_Rect *rect, int x,
+			      int y)
+{
+	LCUI_Rect dst_rect;
+
+	if (Graph_CopyRect(&surface->canvas, rect, x, y) != 0) {
+		return -1;
+	}
+	dst_rect.x = x;
+	dst_rect.y = y;
+	dst_rect.width = rect->width;
+	dst_rect.height = rect->height;
+	RectList_Add(&surface->rects, &dst_rect);
+	return 0;
+}
+
 static void FBDisplay_SyncRect16(LCUI_Graph *canvas, int x, int y)
 {
 	uint32_t iy, ix;
@@ -527,6 +543,7 @@ LCUI_DisplayDriver LCUI_CreateLinuxFBDisplayDriver(void)
 	driver->getHandle = FBSurface_GetHandle;
 	driver->beginPaint = FBSurface_BeginPaint;
 	driver->endPaint = FBSurface_EndPaint;
+	driver->copyRect = FBSurface_CopyRect;
 	driver->bindEvent = FBDisplay_BindEvent;
 	display.trigger = EventTrigger();
 	display.active = TRUE;
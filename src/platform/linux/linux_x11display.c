@@ -362,6 +362,27 @@ static void X11Surface_EndPaint(LCUI_Surface surface, LCUI_PaintContext paint)
 	LCUIMutex_Unlock(&surface->mutex);
 }
 
+static int X11Surface_CopyRect(LCUI_Surface surface, LCUI_Rect *rect, int x,
+			       int y)
+{
+	int ret;
+	LCUI_Rect *r;
+
+	LCUIMutex_Lock(&surface->mutex);
+	ret = Graph_CopyRect(&surface->fb, rect, x, y);
+	if (ret == 0) {
+		r = NEW(LCUI_Rect, 1);
+		r->x = x;
+		r->y = y;
+		r->width = rect->width;
+		r->height = rect->height;
+		LCUIRect_ValidateArea(r, surface->width, surface->height);
+		LinkedList_Append(&surface->rects, r);
+	}
+	LCUIMutex_Unlock(&surface->mutex);
+	return ret;
+}
+
 /** 将帧缓存中的数据呈现至Surface的窗口内 */
 static void X11Surface_Present(LCUI_Surface surface)
 {
@@ -487,6 +508,7 @@ LCUI_DisplayDriver LCUI_CreateLinuxX11DisplayDriver(void)
 	driver->getHandle = X11Surface_GetHandle;
 	driver->beginPaint = X11Surface_BeginPaint;
 	driver->endPaint = X11Surface_EndPaint;
+	driver->copyRect = X11Surface_CopyRect;
 	driver->bindEvent = X11Display_BindEvent;
 	driver->getSurfaceWidth = X11Surface_GetWidth;
 	driver->getSurfaceHeight = X11Surface_GetHeight;
@@ -272,6 +272,7 @@ LCUI_DisplayDriver LCUI_CreateUWPDisplay(void)
 	driver->getHandle = NULL;
 	driver->beginPaint = UWPSurface_BeginPaint;
 	driver->endPaint = UWPSurface_EndPaint;
+	driver->copyRect = NULL;
 	driver->bindEvent = UWPDisplay_BindEvent;
 	Graph_Init(&display.frame);
 	display.frame.color_type = LCUI_COLOR_TYPE_ARGB;
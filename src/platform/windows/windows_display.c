@@ -362,6 +362,12 @@ static void WinSurface_EndPaint(LCUI_Surface surface, LCUI_PaintContext paint)
 	LCUIPainter_End(paint);
 }
 
+static int WinSurface_CopyRect(LCUI_Surface surface, LCUI_Rect *rect, int x,
+			       int y)
+{
+	return Graph_CopyRect(&surface->fb, rect, x, y);
+}
+
 /** 将帧缓存中的数据呈现至Surface的窗口内 */
 static void WinSurface_Present(LCUI_Surface surface)
 {
@@ -559,6 +565,7 @@ LCUI_DisplayDriver LCUI_CreateWinDisplay(void)
 	driver->getHandle = WinSurface_GetHandle;
 	driver->beginPaint = WinSurface_BeginPaint;
 	driver->endPaint = WinSurface_EndPaint;
+	driver->copyRect = WinSurface_CopyRect;
 	driver->bindEvent = WinDisplay_BindEvent;
 	LCUI_BindSysEvent(WM_SIZE, OnWMSize, NULL, NULL);
 	LCUI_BindSysEvent(WM_PAINT, OnWMPaint, NULL, NULL);
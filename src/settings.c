@@ -30,6 +30,7 @@
 #include <LCUI/types.h>
 #include <LCUI/util.h>
 #include <LCUI/main.h>
+#include <LCUI/thread.h>
 #include <LCUI/settings.h>
 
 static LCUI_SettingsRec self;
@@ -54,6 +55,10 @@ void LCUI_ApplySettings(LCUI_Settings settings)
 	self.frame_rate_cap = max(self.frame_rate_cap, 1);
 	self.parallel_rendering_threads =
 	    max(self.parallel_rendering_threads, 1);
+	if (self.parallel_rendering_priority < LCUI_THREAD_PRIORITY_LOW ||
+	    self.parallel_rendering_priority > LCUI_THREAD_PRIORITY_HIGH) {
+		self.parallel_rendering_priority = LCUI_THREAD_PRIORITY_NORMAL;
+	}
 	TriggerSettingsChangedEvent();
 }
 
@@ -62,6 +67,8 @@ void LCUI_ResetSettings(void)
 {
 	self.frame_rate_cap = LCUI_MAX_FRAMES_PER_SEC;
 	self.parallel_rendering_threads = 4;
+	self.parallel_rendering_cpu_mask = 0;
+	self.parallel_rendering_priority = LCUI_THREAD_PRIORITY_NORMAL;
 	self.record_profile = FALSE;
 	self.fps_meter = FALSE;
 	self.paint_flashing = FALSE;
@@ -0,0 +1,289 @@
+﻿/*
+ * pool.c -- persistent fork-join thread pool
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+
+/**
+ * 等待新任务时自旋的次数
+ * 每帧的多个渲染任务之间间隔很短，先自旋可以省去休眠和唤醒的开销
+ */
+#define SPIN_COUNT 2000
+
+/** 统计信息的间隔，避免不同线程的统计信息位于同一缓存行 */
+#define CACHE_LINE_SIZE 64
+
+typedef struct ThreadPoolWorkerRec_ {
+	int index;
+	LCUI_Thread thread;
+	LCUI_ThreadPool pool;
+	LCUI_ThreadPoolStatsRec stats;
+	char padding[CACHE_LINE_SIZE];
+} ThreadPoolWorkerRec, *ThreadPoolWorker;
+
+struct LCUI_ThreadPoolRec_ {
+	LCUI_ThreadPoolOptionsRec options;
+
+	/** 每次分发任务时递增，工作线程在它上面等待 */
+	LCUI_AtomicInt generation;
+
+	/** 尚未完成本轮任务的工作线程数量，调用者在它上面等待 */
+	LCUI_AtomicInt running;
+
+	/** 下一个要执行的任务的序号 */
+	LCUI_AtomicInt next;
+
+	LCUI_AtomicInt stop;
+
+	LCUI_ThreadPoolFunc func;
+	void *arg;
+	int count;
+
+	/** 是否已唤醒工作线程，需要在 LCUIThreadPool_Wait() 中等待它们 */
+	LCUI_BOOL parallel;
+
+	/** 线程列表，第一个是调用者 */
+	ThreadPoolWorkerRec *workers;
+	int n_workers;
+};
+
+/** 获取掩码中第 n 个为 1 的位对应的 CPU */
+static int GetMaskedCPU(unsigned mask, int n)
+{
+	int cpu, bits = 0;
+
+	for (cpu = 0; cpu < (int)sizeof(mask) * 8; ++cpu) {
+		bits += (mask >> cpu) & 1;
+	}
+	if (bits == 0) {
+		return -1;
+	}
+	n %= bits;
+	for (cpu = 0; cpu < (int)sizeof(mask) * 8; ++cpu) {
+		if (((mask >> cpu) & 1) && n-- == 0) {
+			break;
+		}
+	}
+	return cpu;
+}
+
+static LCUI_BOOL ThreadPool_RunTask(LCUI_ThreadPool pool,
+				     ThreadPoolWorker worker)
+{
+	int64_t start;
+	int index = LCUIAtomic_Increment(&pool->next) - 1;
+
+	if (index >= pool->count) {
+		return FALSE;
+	}
+	start = LCUI_GetTimeNs();
+	pool->func(pool->arg, index);
+	worker->stats.busy_time += LCUI_GetTimeNs() - start;
+	worker->stats.tasks += 1;
+	return TRUE;
+}
+
+static void ThreadPool_WorkerThread(void *arg)
+{
+	int i, cpu;
+	int generation, seen = 0;
+	int64_t start;
+	ThreadPoolWorker worker = arg;
+	LCUI_ThreadPool pool = worker->pool;
+
+	cpu = GetMaskedCPU(pool->options.cpu_mask, worker->index - 1);
+	if (cpu >= 0 && LCUIThread_SetAffinity(cpu) != 0) {
+		Logger_Warning("[thread] cannot bind worker %d to cpu %d\n",
+			       worker->index, cpu);
+	}
+	if (pool->options.priority != LCUI_THREAD_PRIORITY_NORMAL &&
+	    LCUIThread_SetPriority(pool->options.priority) != 0) {
+		Logger_Warning("[thread] cannot set the priority of worker %d\n",
+			       worker->index);
+	}
+	while (1) {
+		start = LCUI_GetTimeNs();
+		for (i = 0; (generation = LCUIAtomic_Load(&pool->generation)) ==
+			    seen;
+		     ++i) {
+			if (i < SPIN_COUNT) {
+				LCUIAtomic_Pause();
+			} else {
+				LCUIFutex_Wait(&pool->generation, seen);
+			}
+		}
+		seen = generation;
+		worker->stats.idle_time += LCUI_GetTimeNs() - start;
+		if (LCUIAtomic_Load(&pool->stop)) {
+			break;
+		}
+		while (ThreadPool_RunTask(pool, worker));
+		worker->stats.runs += 1;
+		if (LCUIAtomic_Decrement(&pool->running) == 0) {
+			LCUIFutex_Wake(&pool->running, FALSE);
+		}
+	}
+	LCUIThread_Exit(NULL);
+}
+
+LCUI_ThreadPool LCUIThreadPool_New(const LCUI_ThreadPoolOptionsRec *options)
+{
+	int i;
+	LCUI_ThreadPool pool;
+
+	pool = malloc(sizeof(struct LCUI_ThreadPoolRec_));
+	if (!pool) {
+		return NULL;
+	}
+	pool->options = *options;
+	pool->options.threads = max(1, options->threads);
+	pool->workers = calloc(pool->options.threads,
+			       sizeof(ThreadPoolWorkerRec));
+	if (!pool->workers) {
+		free(pool);
+		return NULL;
+	}
+	pool->func = NULL;
+	pool->arg = NULL;
+	pool->count = 0;
+	pool->parallel = FALSE;
+	pool->n_workers = 0;
+	LCUIAtomic_Store(&pool->generation, 0);
+	LCUIAtomic_Store(&pool->running, 0);
+	LCUIAtomic_Store(&pool->next, 0);
+	LCUIAtomic_Store(&pool->stop, 0);
+	for (i = 0; i < pool->options.threads; ++i) {
+		pool->workers[i].index = i;
+		pool->workers[i].pool = pool;
+	}
+	for (i = 1; i < pool->options.threads; ++i) {
+		if (LCUIThread_Create(&pool->workers[i].thread,
+				      ThreadPool_WorkerThread,
+				      &pool->workers[i]) != 0) {
+			Logger_Warning("[thread] cannot create worker %d\n", i);
+			break;
+		}
+		pool->n_workers += 1;
+	}
+	pool->options.threads = pool->n_workers + 1;
+	return pool;
+}
+
+void LCUIThreadPool_Destroy(LCUI_ThreadPool pool)
+{
+	int i;
+
+	LCUIAtomic_Store(&pool->stop, 1);
+	LCUIAtomic_Increment(&pool->generation);
+	LCUIFutex_Wake(&pool->generation, TRUE);
+	for (i = 1; i <= pool->n_workers; ++i) {
+		LCUIThread_Join(pool->workers[i].thread, NULL);
+	}
+	free(pool->workers);
+	free(pool);
+}
+
+int LCUIThreadPool_GetThreads(LCUI_ThreadPool pool)
+{
+	return pool->options.threads;
+}
+
+void LCUIThreadPool_Start(LCUI_ThreadPool pool, LCUI_ThreadPoolFunc func,
+			  void *arg, int count)
+{
+	pool->func = func;
+	pool->arg = arg;
+	pool->count = count;
+	pool->parallel = pool->n_workers > 0 && count > 1;
+	LCUIAtomic_Store(&pool->next, 0);
+	if (pool->parallel) {
+		LCUIAtomic_Store(&pool->running, pool->n_workers);
+		LCUIAtomic_Increment(&pool->generation);
+		LCUIFutex_Wake(&pool->generation, TRUE);
+	}
+}
+
+LCUI_BOOL LCUIThreadPool_RunNext(LCUI_ThreadPool pool)
+{
+	return ThreadPool_RunTask(pool, &pool->workers[0]);
+}
+
+void LCUIThreadPool_Wait(LCUI_ThreadPool pool)
+{
+	int running;
+	int64_t start;
+
+	while (ThreadPool_RunTask(pool, &pool->workers[0]));
+	pool->workers[0].stats.runs += 1;
+	if (!pool->parallel) {
+		return;
+	}
+	start = LCUI_GetTimeNs();
+	while ((running = LCUIAtomic_Load(&pool->running)) > 0) {
+		LCUIFutex_Wait(&pool->running, running);
+	}
+	pool->workers[0].stats.idle_time += LCUI_GetTimeNs() - start;
+	pool->parallel = FALSE;
+}
+
+void LCUIThreadPool_Run(LCUI_ThreadPool pool, LCUI_ThreadPoolFunc func,
+			void *arg, int count)
+{
+	if (count < 1) {
+		return;
+	}
+	LCUIThreadPool_Start(pool, func, arg, count);
+	LCUIThreadPool_Wait(pool);
+}
+
+int LCUIThreadPool_GetStats(LCUI_ThreadPool pool, int index,
+			    LCUI_ThreadPoolStats stats)
+{
+	if (index < 0 || index >= pool->options.threads) {
+		return -EINVAL;
+	}
+	*stats = pool->workers[index].stats;
+	return 0;
+}
+
+void LCUIThreadPool_ResetStats(LCUI_ThreadPool pool)
+{
+	int i;
+
+	for (i = 0; i < pool->options.threads; ++i) {
+		memset(&pool->workers[i].stats, 0,
+		       sizeof(LCUI_ThreadPoolStatsRec));
+	}
+}
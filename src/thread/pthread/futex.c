@@ -0,0 +1,114 @@
+/*
+ * futex.c -- futex wait and wake for pthread
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+
+#ifdef LCUI_THREAD_PTHREAD
+
+#ifdef __linux__
+
+#include <limits.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+void LCUIFutex_Wait(LCUI_AtomicInt *addr, int expected)
+{
+	syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+void LCUIFutex_Wake(LCUI_AtomicInt *addr, LCUI_BOOL wake_all)
+{
+	syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, wake_all ? INT_MAX : 1,
+		NULL, NULL, 0);
+}
+
+#else
+
+/*
+ * 没有 futex 的平台上，用按地址散列的互斥锁和条件变量模拟，检查值和休眠在
+ * 同一把锁内完成，所以不会错过唤醒
+ */
+
+#define PARKING_LOT_SIZE 64
+
+typedef struct ParkingSlotRec_ {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+} ParkingSlotRec, *ParkingSlot;
+
+static ParkingSlotRec parking_lot[PARKING_LOT_SIZE];
+static pthread_once_t parking_lot_once = PTHREAD_ONCE_INIT;
+
+static void ParkingLot_Init(void)
+{
+	int i;
+
+	for (i = 0; i < PARKING_LOT_SIZE; ++i) {
+		pthread_mutex_init(&parking_lot[i].mutex, NULL);
+		pthread_cond_init(&parking_lot[i].cond, NULL);
+	}
+}
+
+static ParkingSlot ParkingLot_Get(LCUI_AtomicInt *addr)
+{
+	size_t key = (size_t)addr;
+
+	pthread_once(&parking_lot_once, ParkingLot_Init);
+	return &parking_lot[(key >> 4) % PARKING_LOT_SIZE];
+}
+
+void LCUIFutex_Wait(LCUI_AtomicInt *addr, int expected)
+{
+	ParkingSlot slot = ParkingLot_Get(addr);
+
+	pthread_mutex_lock(&slot->mutex);
+	if (LCUIAtomic_Load(addr) == expected) {
+		pthread_cond_wait(&slot->cond, &slot->mutex);
+	}
+	pthread_mutex_unlock(&slot->mutex);
+}
+
+void LCUIFutex_Wake(LCUI_AtomicInt *addr, LCUI_BOOL wake_all)
+{
+	ParkingSlot slot = ParkingLot_Get(addr);
+
+	/* 不同地址共用一个条件变量，只能全部唤醒 */
+	pthread_mutex_lock(&slot->mutex);
+	pthread_cond_broadcast(&slot->cond);
+	pthread_mutex_unlock(&slot->mutex);
+}
+
+#endif
+
+#endif
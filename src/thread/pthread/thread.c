@@ -30,6 +30,12 @@
 #include "config.h"
 #include <stdlib.h>
 #include <errno.h>
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#endif
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/thread.h>
@@ -143,4 +149,66 @@ int LCUIThread_Join(LCUI_Thread thread, void **retval)
 {
 	return pthread_join(thread, retval);
 }
+
+int LCUIThread_SetAffinity(int cpu)
+{
+#ifdef __linux__
+	cpu_set_t set;
+
+	if (cpu < 0 || cpu >= CPU_SETSIZE) {
+		return -EINVAL;
+	}
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return -pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+	return -ENOSYS;
+#endif
+}
+
+int LCUIThread_SetPriority(LCUI_ThreadPriority priority)
+{
+#ifdef __linux__
+	/* 普通调度策略下所有线程的静态优先级都是 0，只能通过 nice 值调整 */
+	static const int nice_values[] = { 10, 0, -5 };
+
+	if (priority < LCUI_THREAD_PRIORITY_LOW ||
+	    priority > LCUI_THREAD_PRIORITY_HIGH) {
+		return -EINVAL;
+	}
+	if (setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid),
+			nice_values[priority]) != 0) {
+		return -errno;
+	}
+	return 0;
+#else
+	int policy, min, max;
+	struct sched_param param;
+
+	if (pthread_getschedparam(pthread_self(), &policy, &param) != 0) {
+		return -ENOSYS;
+	}
+	min = sched_get_priority_min(policy);
+	max = sched_get_priority_max(policy);
+	switch (priority) {
+	case LCUI_THREAD_PRIORITY_LOW:
+		param.sched_priority = min;
+		break;
+	case LCUI_THREAD_PRIORITY_NORMAL:
+		param.sched_priority = (min + max) / 2;
+		break;
+	case LCUI_THREAD_PRIORITY_HIGH:
+		param.sched_priority = max;
+		break;
+	default:
+		return -EINVAL;
+	}
+	return -pthread_setschedparam(pthread_self(), policy, &param);
+#endif
+}
+
+void LCUIThread_Yield(void)
+{
+	sched_yield();
+}
 #endif
@@ -0,0 +1,246 @@
+﻿/*
+ * sync.c -- lightweight synchronization primitives built on futex
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include "config.h"
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+
+/** 争用时自旋的次数，短小的临界区通常能在自旋期间释放 */
+#define SPIN_COUNT 100
+
+/* 互斥锁的状态 */
+enum MutexState { MUTEX_UNLOCKED, MUTEX_LOCKED, MUTEX_CONTENDED };
+
+/* 一次性初始化的状态 */
+enum OnceState { ONCE_INIT, ONCE_RUNNING, ONCE_WAITING, ONCE_DONE };
+
+void LCUIFastMutex_Init(LCUI_FastMutex *mutex)
+{
+	LCUIAtomic_Store(&mutex->state, MUTEX_UNLOCKED);
+}
+
+int LCUIFastMutex_TryLock(LCUI_FastMutex *mutex)
+{
+	if (LCUIAtomic_CompareExchange(&mutex->state, MUTEX_UNLOCKED,
+				       MUTEX_LOCKED)) {
+		return 0;
+	}
+	return -EBUSY;
+}
+
+void LCUIFastMutex_Lock(LCUI_FastMutex *mutex)
+{
+	int i;
+
+	if (LCUIAtomic_CompareExchange(&mutex->state, MUTEX_UNLOCKED,
+				       MUTEX_LOCKED)) {
+		return;
+	}
+	for (i = 0; i < SPIN_COUNT; ++i) {
+		if (LCUIAtomic_Load(&mutex->state) == MUTEX_UNLOCKED &&
+		    LCUIAtomic_CompareExchange(&mutex->state, MUTEX_UNLOCKED,
+					       MUTEX_LOCKED)) {
+			return;
+		}
+		LCUIAtomic_Pause();
+	}
+	/*
+	 * 标记为有线程在等待，让解锁的线程负责唤醒。被唤醒后仍然标记为有
+	 * 线程等待，因为无法知道是否还有其它线程在休眠
+	 */
+	while (LCUIAtomic_Exchange(&mutex->state, MUTEX_CONTENDED) !=
+	       MUTEX_UNLOCKED) {
+		LCUIFutex_Wait(&mutex->state, MUTEX_CONTENDED);
+	}
+}
+
+void LCUIFastMutex_Unlock(LCUI_FastMutex *mutex)
+{
+	if (LCUIAtomic_Exchange(&mutex->state, MUTEX_UNLOCKED) ==
+	    MUTEX_CONTENDED) {
+		LCUIFutex_Wake(&mutex->state, FALSE);
+	}
+}
+
+void LCUIRWLock_Init(LCUI_RWLock *lock)
+{
+	LCUIAtomic_Store(&lock->state, 0);
+	LCUIAtomic_Store(&lock->writers, 0);
+	LCUIAtomic_Store(&lock->waiters, 0);
+	LCUIAtomic_Store(&lock->seq, 0);
+}
+
+int LCUIRWLock_TryReadLock(LCUI_RWLock *lock)
+{
+	int state = LCUIAtomic_Load(&lock->state);
+
+	if (state >= 0 && LCUIAtomic_Load(&lock->writers) == 0 &&
+	    LCUIAtomic_CompareExchange(&lock->state, state, state + 1)) {
+		return 0;
+	}
+	return -EBUSY;
+}
+
+int LCUIRWLock_TryWriteLock(LCUI_RWLock *lock)
+{
+	if (LCUIAtomic_CompareExchange(&lock->state, 0, -1)) {
+		return 0;
+	}
+	return -EBUSY;
+}
+
+/**
+ * 等待锁被释放
+ * 先记录序号再检查条件，释放锁的线程会先修改状态再递增序号，所以在检查
+ * 之后发生的释放一定会让 futex 的值与 seq 不同，不会错过唤醒
+ */
+static void RWLock_Wait(LCUI_RWLock *lock, int (*trylock)(LCUI_RWLock *))
+{
+	int i, seq;
+
+	for (i = 0; i < SPIN_COUNT; ++i) {
+		if (trylock(lock) == 0) {
+			return;
+		}
+		LCUIAtomic_Pause();
+	}
+	while (1) {
+		LCUIAtomic_Increment(&lock->waiters);
+		seq = LCUIAtomic_Load(&lock->seq);
+		if (trylock(lock) == 0) {
+			LCUIAtomic_Decrement(&lock->waiters);
+			return;
+		}
+		LCUIFutex_Wait(&lock->seq, seq);
+		LCUIAtomic_Decrement(&lock->waiters);
+		if (trylock(lock) == 0) {
+			return;
+		}
+	}
+}
+
+static void RWLock_WakeAll(LCUI_RWLock *lock)
+{
+	LCUIAtomic_Increment(&lock->seq);
+	if (LCUIAtomic_Load(&lock->waiters) > 0) {
+		LCUIFutex_Wake(&lock->seq, TRUE);
+	}
+}
+
+void LCUIRWLock_ReadLock(LCUI_RWLock *lock)
+{
+	if (LCUIRWLock_TryReadLock(lock) != 0) {
+		RWLock_Wait(lock, LCUIRWLock_TryReadLock);
+	}
+}
+
+void LCUIRWLock_ReadUnlock(LCUI_RWLock *lock)
+{
+	if (LCUIAtomic_Decrement(&lock->state) == 0) {
+		RWLock_WakeAll(lock);
+	}
+}
+
+void LCUIRWLock_WriteLock(LCUI_RWLock *lock)
+{
+	if (LCUIRWLock_TryWriteLock(lock) == 0) {
+		return;
+	}
+	LCUIAtomic_Increment(&lock->writers);
+	RWLock_Wait(lock, LCUIRWLock_TryWriteLock);
+	LCUIAtomic_Decrement(&lock->writers);
+}
+
+void LCUIRWLock_WriteUnlock(LCUI_RWLock *lock)
+{
+	LCUIAtomic_Store(&lock->state, 0);
+	RWLock_WakeAll(lock);
+}
+
+void LCUIOnce(LCUI_Once *once, void (*func)(void))
+{
+	int state;
+
+	if (LCUIAtomic_Load(once) == ONCE_DONE) {
+		return;
+	}
+	if (LCUIAtomic_CompareExchange(once, ONCE_INIT, ONCE_RUNNING)) {
+		func();
+		if (LCUIAtomic_Exchange(once, ONCE_DONE) == ONCE_WAITING) {
+			LCUIFutex_Wake(once, TRUE);
+		}
+		return;
+	}
+	while ((state = LCUIAtomic_Load(once)) != ONCE_DONE) {
+		if (state == ONCE_RUNNING &&
+		    !LCUIAtomic_CompareExchange(once, ONCE_RUNNING,
+						ONCE_WAITING)) {
+			continue;
+		}
+		LCUIFutex_Wait(once, ONCE_WAITING);
+	}
+}
+
+void LCUISeqLock_Init(LCUI_SeqLock *lock)
+{
+	LCUIAtomic_Store(&lock->seq, 0);
+	LCUIFastMutex_Init(&lock->mutex);
+}
+
+int LCUISeqLock_ReadBegin(LCUI_SeqLock *lock)
+{
+	int seq;
+
+	/* 序号为奇数时表示正在写入 */
+	while ((seq = LCUIAtomic_Load(&lock->seq)) & 1) {
+		LCUIAtomic_Pause();
+	}
+	return seq;
+}
+
+LCUI_BOOL LCUISeqLock_ReadRetry(LCUI_SeqLock *lock, int seq)
+{
+	LCUIAtomic_Fence();
+	return LCUIAtomic_Load(&lock->seq) != seq;
+}
+
+void LCUISeqLock_WriteBegin(LCUI_SeqLock *lock)
+{
+	LCUIFastMutex_Lock(&lock->mutex);
+	LCUIAtomic_Increment(&lock->seq);
+}
+
+void LCUISeqLock_WriteEnd(LCUI_SeqLock *lock)
+{
+	LCUIAtomic_Increment(&lock->seq);
+	LCUIFastMutex_Unlock(&lock->mutex);
+}
@@ -197,4 +197,40 @@ int LCUIThread_Join(LCUI_Thread thread, void **retval)
 	return -1;
 }
 
+int LCUIThread_SetAffinity(int cpu)
+{
+#ifdef WINAPI_FAMILY_APP
+	return -ENOSYS;
+#else
+	if (cpu < 0 || cpu >= (int)sizeof(DWORD_PTR) * 8) {
+		return -EINVAL;
+	}
+	if (!SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu)) {
+		return -EINVAL;
+	}
+	return 0;
+#endif
+}
+
+int LCUIThread_SetPriority(LCUI_ThreadPriority priority)
+{
+	static const int values[] = { THREAD_PRIORITY_BELOW_NORMAL,
+				      THREAD_PRIORITY_NORMAL,
+				      THREAD_PRIORITY_ABOVE_NORMAL };
+
+	if (priority < LCUI_THREAD_PRIORITY_LOW ||
+	    priority > LCUI_THREAD_PRIORITY_HIGH) {
+		return -EINVAL;
+	}
+	if (!SetThreadPriority(GetCurrentThread(), values[priority])) {
+		return -EPERM;
+	}
+	return 0;
+}
+
+void LCUIThread_Yield(void)
+{
+	SwitchToThread();
+}
+
 #endif
@@ -0,0 +1,134 @@
+﻿/*
+ * cpu.c -- CPU feature detection
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <LCUI_Build.h>
+#include <LCUI/types.h>
+#include <LCUI/util/cpu.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#define CPU_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#define FEATURES_UNKNOWN (~0u)
+
+static volatile unsigned cpu_features = FEATURES_UNKNOWN;
+static volatile unsigned cpu_features_mask = ~0u;
+
+#ifdef CPU_X86
+
+static void GetCPUID(unsigned leaf, unsigned regs[4])
+{
+#ifdef _MSC_VER
+	int info[4];
+
+	__cpuidex(info, (int)leaf, 0);
+	regs[0] = (unsigned)info[0];
+	regs[1] = (unsigned)info[1];
+	regs[2] = (unsigned)info[2];
+	regs[3] = (unsigned)info[3];
+#else
+	regs[0] = regs[1] = regs[2] = regs[3] = 0;
+	__cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/** 检查操作系统是否会在切换线程时保存 AVX 寄存器 */
+static int IsAVXStateEnabled(void)
+{
+	unsigned lo;
+#ifdef _MSC_VER
+	lo = (unsigned)_xgetbv(0);
+#else
+	unsigned hi;
+	__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+#endif
+	return (lo & 0x6) == 0x6;
+}
+
+static unsigned DetectCPUFeatures(void)
+{
+	unsigned regs[4];
+	unsigned features = 0;
+
+	GetCPUID(0, regs);
+	if (regs[0] < 1) {
+		return 0;
+	}
+	GetCPUID(1, regs);
+	if (regs[3] & (1 << 26)) {
+		features |= LCUI_CPU_SSE2;
+	}
+	/* OSXSAVE 和 AVX */
+	if ((regs[2] & (1 << 27)) == 0 || (regs[2] & (1 << 28)) == 0 ||
+	    !IsAVXStateEnabled()) {
+		return features;
+	}
+	GetCPUID(0, regs);
+	if (regs[0] >= 7) {
+		GetCPUID(7, regs);
+		if (regs[1] & (1 << 5)) {
+			features |= LCUI_CPU_AVX2;
+		}
+	}
+	return features;
+}
+
+#else
+
+static unsigned DetectCPUFeatures(void)
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+	return LCUI_CPU_NEON;
+#else
+	return 0;
+#endif
+}
+
+#endif
+
+unsigned LCUI_GetCPUFeatures(void)
+{
+	/* 检测结果总是相同的，多个线程同时检测也没有问题 */
+	if (cpu_features == FEATURES_UNKNOWN) {
+		cpu_features = DetectCPUFeatures();
+	}
+	return cpu_features & cpu_features_mask;
+}
+
+void LCUI_SetCPUFeaturesMask(unsigned mask)
+{
+	cpu_features_mask = mask;
+}
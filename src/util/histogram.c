@@ -0,0 +1,163 @@
+﻿/*
+ * histogram.c -- HDR histogram, records the distribution of durations
+ * with a bounded relative error and a fixed memory size.
+ *
+ * Copyright (c) 2018, Liu chao <lc-soft@live.cn> All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of LCUI nor the names of its contributors may be used
+ *     to endorse or promote products derived from this software without
+ *     specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/types.h>
+#include <LCUI/util/histogram.h>
+
+/**
+ * 数值的桶按对数-线性的方式划分：小于 HISTOGRAM_SUB_BUCKET_COUNT 的数值各占一个
+ * 桶，更大的数值按最高位所在的 2 的幂区间分组，每组再平分为
+ * HISTOGRAM_SUB_BUCKET_HALF 个子桶，所以每个桶的宽度不超过其下界的 1/32
+ */
+static int GetHighestBit(uint64_t value)
+{
+#ifdef __GNUC__
+	return 63 - __builtin_clzll(value);
+#else
+	int bit = 0;
+
+	while (value >>= 1) {
+		++bit;
+	}
+	return bit;
+#endif
+}
+
+static size_t Histogram_GetIndex(int64_t value)
+{
+	int shift;
+	size_t index;
+
+	if (value < HISTOGRAM_SUB_BUCKET_COUNT) {
+		return (size_t)value;
+	}
+	shift = GetHighestBit((uint64_t)value) - HISTOGRAM_SUB_BUCKET_BITS + 1;
+	index = HISTOGRAM_SUB_BUCKET_COUNT +
+		(shift - 1) * HISTOGRAM_SUB_BUCKET_HALF +
+		(size_t)(value >> shift) - HISTOGRAM_SUB_BUCKET_HALF;
+	if (index >= HISTOGRAM_BUCKETS) {
+		return HISTOGRAM_BUCKETS - 1;
+	}
+	return index;
+}
+
+/** 获取桶内的最大值 */
+static int64_t Histogram_GetUpperValue(size_t index)
+{
+	int shift;
+	int64_t sub;
+
+	if (index < HISTOGRAM_SUB_BUCKET_COUNT) {
+		return (int64_t)index;
+	}
+	index -= HISTOGRAM_SUB_BUCKET_COUNT;
+	shift = (int)(index / HISTOGRAM_SUB_BUCKET_HALF) + 1;
+	sub = (int64_t)(index % HISTOGRAM_SUB_BUCKET_HALF) +
+	      HISTOGRAM_SUB_BUCKET_HALF;
+	return ((sub + 1) << shift) - 1;
+}
+
+void Histogram_Init(LCUI_Histogram h)
+{
+	memset(h, 0, sizeof(LCUI_HistogramRec));
+}
+
+void Histogram_Record(LCUI_Histogram h, int64_t value)
+{
+	if (value < 0) {
+		value = 0;
+	}
+	if (h->total == 0 || value < h->min) {
+		h->min = value;
+	}
+	if (value > h->max) {
+		h->max = value;
+	}
+	h->sum += value;
+	h->total += 1;
+	h->counts[Histogram_GetIndex(value)] += 1;
+}
+
+int64_t Histogram_GetPercentile(LCUI_Histogram h, double percentile)
+{
+	size_t i, count, target;
+	int64_t value;
+	double rank;
+
+	if (h->total == 0) {
+		return 0;
+	}
+	if (percentile >= 100.0) {
+		return h->max;
+	}
+	if (percentile < 0) {
+		percentile = 0;
+	}
+	/* 目标是第 ceil(total * percentile / 100) 个数值，至少是第一个 */
+	rank = h->total * percentile / 100.0;
+	target = (size_t)rank;
+	if (target < rank) {
+		target += 1;
+	}
+	if (target < 1) {
+		target = 1;
+	}
+	for (i = 0, count = 0; i < HISTOGRAM_BUCKETS; ++i) {
+		count += h->counts[i];
+		if (count >= target) {
+			break;
+		}
+	}
+	value = Histogram_GetUpperValue(i);
+	return value > h->max ? h->max : value;
+}
+
+void Histogram_Merge(LCUI_Histogram dst, LCUI_Histogram src)
+{
+	size_t i;
+
+	if (src->total == 0) {
+		return;
+	}
+	if (dst->total == 0 || src->min < dst->min) {
+		dst->min = src->min;
+	}
+	if (src->max > dst->max) {
+		dst->max = src->max;
+	}
+	dst->sum += src->sum;
+	dst->total += src->total;
+	for (i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+		dst->counts[i] += src->counts[i];
+	}
+}
@@ -31,9 +31,14 @@
 #define LCUI_UTIL_STEPTIMER_C
 
 #include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/thread.h>
+#include <LCUI/atomic.h>
+
+/** 落后于截止时间多少帧后不再追赶，而是以当前时间重新开始计时 */
+#define MAX_LATE_FRAMES 1
 
 enum StepTimerState {
 	STATE_RUN,
@@ -42,15 +47,22 @@ enum StepTimerState {
 };
 
 typedef struct StepTimerRec_ {
-	int state;
+	/** 在锁内修改，在锁外读取时需用 LCUIAtomic_Load() */
+	LCUI_AtomicInt state;
 	LCUI_Cond cond;
 	LCUI_Mutex mutex;
 	unsigned int temp_fps;
 	unsigned int current_fps;
-	unsigned int one_frame_remain_time;
 	unsigned int pause_time;
-	int64_t prev_frame_start_time;
+	int64_t frame_period;		/**< 每帧的时长（纳秒） */
+	int64_t frame_deadline;		/**< 当前帧的截止时间（纳秒） */
+	int64_t prev_frame_time;	/**< 上一帧结束的时间（纳秒） */
 	int64_t prev_fps_update_time;
+
+	/** 最近的帧间隔（纳秒），以环形缓冲区的方式记录 */
+	int64_t intervals[STEPTIMER_INTERVALS_LEN];
+	size_t intervals_count;
+	size_t intervals_pos;
 } StepTimerRec;
 
 StepTimer StepTimer_Create(void)
@@ -60,9 +72,12 @@ StepTimer StepTimer_Create(void)
 	timer->temp_fps = 0;
 	timer->current_fps = 0;
 	timer->pause_time = 0;
-	timer->one_frame_remain_time = 10;
-	timer->prev_frame_start_time = LCUI_GetTime();
+	timer->frame_period = 10000000;
+	timer->prev_frame_time = LCUI_GetTimeNs();
+	timer->frame_deadline = timer->prev_frame_time + timer->frame_period;
 	timer->prev_fps_update_time = LCUI_GetTime();
+	timer->intervals_count = 0;
+	timer->intervals_pos = 0;
 	LCUICond_Init(&timer->cond);
 	LCUIMutex_Init(&timer->mutex);
 	return timer;
@@ -77,7 +92,9 @@ void StepTimer_Destroy(StepTimer timer)
 
 void StepTimer_SetFrameLimit(StepTimer timer, unsigned int max)
 {
-	timer->one_frame_remain_time = (int)(1000.0 / max);
+	LCUIMutex_Lock(&timer->mutex);
+	timer->frame_period = max > 0 ? 1000000000 / max : 0;
+	LCUIMutex_Unlock(&timer->mutex);
 }
 
 int StepTimer_GetFrameCount(StepTimer timer)
@@ -85,66 +102,109 @@ int StepTimer_GetFrameCount(StepTimer timer)
 	return timer->current_fps;
 }
 
+size_t StepTimer_GetFrameIntervals(StepTimer timer, int64_t *intervals,
+				   size_t max_count)
+{
+	size_t i, count, pos;
+
+	LCUIMutex_Lock(&timer->mutex);
+	count = min(max_count, timer->intervals_count);
+	pos = timer->intervals_pos + STEPTIMER_INTERVALS_LEN - count;
+	for (i = 0; i < count; ++i) {
+		intervals[i] =
+		    timer->intervals[(pos + i) % STEPTIMER_INTERVALS_LEN];
+	}
+	LCUIMutex_Unlock(&timer->mutex);
+	return count;
+}
+
+static void StepTimer_AddFrameInterval(StepTimer timer, int64_t interval)
+{
+	timer->intervals[timer->intervals_pos] = interval;
+	timer->intervals_pos =
+	    (timer->intervals_pos + 1) % STEPTIMER_INTERVALS_LEN;
+	if (timer->intervals_count < STEPTIMER_INTERVALS_LEN) {
+		++timer->intervals_count;
+	}
+}
+
 void StepTimer_Remain(StepTimer timer)
 {
-	int64_t current_time;
-	unsigned int n_ms, lost_ms;
+	int64_t now, deadline, wait_ms;
 
-	if (timer->state == STATE_QUIT) {
+	if (LCUIAtomic_Load(&timer->state) == STATE_QUIT) {
 		return;
 	}
-	lost_ms = 0;
-	current_time = LCUI_GetTime();
 	LCUIMutex_Lock(&timer->mutex);
-	n_ms = (unsigned int)(current_time - timer->prev_frame_start_time);
-	if (n_ms > timer->one_frame_remain_time) {
-		goto normal_exit;
-	}
-	n_ms = timer->one_frame_remain_time - n_ms;
-	if (n_ms < 1) {
-		goto normal_exit;
+	now = LCUI_GetTimeNs();
+	/**
+	 * 截止时间是按帧时长累加的绝对时间，睡眠的误差不会累积。
+	 * 但如果落后太多，则放弃追赶，避免之后连续多帧都不等待
+	 */
+	if (now - timer->frame_deadline > timer->frame_period * MAX_LATE_FRAMES) {
+		timer->frame_deadline = now;
 	}
-	/* 睡眠一段时间 */
-	while (lost_ms < n_ms && timer->state == STATE_RUN) {
-		LCUICond_TimedWait(&timer->cond, &timer->mutex, n_ms - lost_ms);
-		lost_ms = (unsigned int)LCUI_GetTimeDelta(current_time);
+	/* 先按毫秒睡眠，剩下的时间不足一毫秒 */
+	while (timer->state == STATE_RUN) {
+		wait_ms = (timer->frame_deadline - now) / 1000000;
+		if (wait_ms < 1) {
+			break;
+		}
+		LCUICond_TimedWait(&timer->cond, &timer->mutex,
+				   (unsigned int)wait_ms);
+		now = LCUI_GetTimeNs();
 	}
 	/* 睡眠结束后，如果当前状态为 PAUSE，则说明睡眠是因为要暂停而终止的 */
 	if (timer->state == STATE_PAUSE) {
-		current_time = LCUI_GetTime();
+		now = LCUI_GetTimeNs();
 		/* 等待状态改为“继续” */
 		while (timer->state == STATE_PAUSE) {
 			LCUICond_Wait(&timer->cond, &timer->mutex);
 		}
-		lost_ms = (unsigned int)LCUI_GetTimeDelta(current_time);
-		timer->pause_time = lost_ms;
-		timer->prev_frame_start_time += lost_ms;
+		timer->pause_time =
+		    (unsigned int)((LCUI_GetTimeNs() - now) / 1000000);
+		timer->prev_frame_time = LCUI_GetTimeNs();
+		timer->frame_deadline =
+		    timer->prev_frame_time + timer->frame_period;
 		LCUIMutex_Unlock(&timer->mutex);
 		return;
 	}
-
-normal_exit:;
-	current_time = LCUI_GetTime();
-	if (current_time - timer->prev_fps_update_time >= 1000) {
+	/**
+	 * 剩下不足一毫秒的时间通过让出时间片补齐，期间不持有锁，
+	 * 以免阻塞 StepTimer_Pause() 等调用
+	 */
+	deadline = timer->frame_deadline;
+	LCUIMutex_Unlock(&timer->mutex);
+	while (now < deadline &&
+	       LCUIAtomic_Load(&timer->state) == STATE_RUN) {
+		LCUIThread_Yield();
+		now = LCUI_GetTimeNs();
+	}
+	LCUIMutex_Lock(&timer->mutex);
+	StepTimer_AddFrameInterval(timer, now - timer->prev_frame_time);
+	timer->prev_frame_time = now;
+	timer->frame_deadline += timer->frame_period;
+	if (LCUI_GetTimeDelta(timer->prev_fps_update_time) >= 1000) {
 		timer->current_fps = timer->temp_fps;
-		timer->prev_fps_update_time = current_time;
+		timer->prev_fps_update_time = LCUI_GetTime();
 		timer->temp_fps = 0;
 	}
-	timer->prev_frame_start_time = current_time;
 	++timer->temp_fps;
 	LCUIMutex_Unlock(&timer->mutex);
 }
 
 void StepTimer_Pause(StepTimer timer, LCUI_BOOL need_pause)
 {
-	if (timer->state == STATE_RUN && need_pause) {
+	int state = LCUIAtomic_Load(&timer->state);
+
+	if (state == STATE_RUN && need_pause) {
 		LCUIMutex_Lock(&timer->mutex);
-		timer->state = STATE_PAUSE;
+		LCUIAtomic_Store(&timer->state, STATE_PAUSE);
 		LCUICond_Signal(&timer->cond);
 		LCUIMutex_Unlock(&timer->mutex);
-	} else if (timer->state == STATE_PAUSE && !need_pause) {
+	} else if (state == STATE_PAUSE && !need_pause) {
 		LCUIMutex_Lock(&timer->mutex);
-		timer->state = STATE_RUN;
+		LCUIAtomic_Store(&timer->state, STATE_RUN);
 		LCUICond_Signal(&timer->cond);
 		LCUIMutex_Unlock(&timer->mutex);
 	}
@@ -64,6 +64,21 @@ int64_t LCUI_GetTime(void)
 	return time / 1000 - 11644473600000;
 }
 
+int64_t LCUI_GetTimeNs(void)
+{
+	LARGE_INTEGER hires_now;
+
+	if (hires_timer_available) {
+		QueryPerformanceCounter(&hires_now);
+		/* 分开计算整数秒和余下的滴答数，避免乘法溢出 */
+		return hires_now.QuadPart / hires_ticks_per_second *
+			   1000000000 +
+		       hires_now.QuadPart % hires_ticks_per_second *
+			   1000000000 / hires_ticks_per_second;
+	}
+	return (int64_t)GetTickCount64() * 1000000;
+}
+
 #elif defined LCUI_BUILD_IN_LINUX
 #include <unistd.h>
 #include <sys/time.h>
@@ -84,6 +99,14 @@ int64_t LCUI_GetTime(void)
 	return t;
 }
 
+int64_t LCUI_GetTimeNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
 #endif
 
 int64_t LCUI_GetTimeDelta(int64_t start)
@@ -18,6 +18,10 @@ int main(void)
 	describe("test settings", test_settings);
 	describe("test object", test_object);
 	describe("test thread", test_thread);
+	describe("test steptimer", test_steptimer);
+	describe("test frame stats", test_frame_stats);
+	describe("test graph buffer", test_graph_buffer);
+	describe("test graph", test_graph);
 	describe("test font load", test_font_load);
 	describe("test image reader", test_image_reader);
 	describe("test xml parser", test_xml_parser);
@@ -25,11 +29,17 @@ int main(void)
 	describe("test widget opacity", test_widget_opacity);
 	describe("test textview resize", test_textview_resize);
 	describe("test textedit", test_textedit);
+	describe("test textlayer row cache", test_textlayer_row_cache);
 	describe("test scrollbar", test_scrollbar);
 	describe("test mainloop", test_mainloop);
 	describe("test css parser", test_css_parser);
 	describe("test block layout", test_block_layout);
 	describe("test flex layout", test_flex_layout);
 	describe("test widget rect", test_widget_rect);
+	describe("test widget style", test_widget_style);
+	describe("test widget hash", test_widget_hash);
+	describe("test scale change", test_scale_change);
+	describe("test border image", test_border_image);
+	describe("test widget render to graph", test_widget_render_to_graph);
 	return ret - print_test_result();
 }
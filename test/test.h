@@ -7,6 +7,10 @@ void test_string(void);
 void test_object(void);
 void test_settings(void);
 void test_thread(void);
+void test_steptimer(void);
+void test_frame_stats(void);
+void test_graph_buffer(void);
+void test_graph(void);
 void test_font_load(void);
 void test_xml_parser(void);
 void test_strpool(void);
@@ -23,3 +27,9 @@ void test_mainloop(void);
 void test_block_layout(void);
 void test_flex_layout(void);
 void test_widget_rect(void);
+void test_widget_style(void);
+void test_widget_hash(void);
+void test_scale_change(void);
+void test_border_image(void);
+void test_widget_render_to_graph(void);
+void test_textlayer_row_cache(void);
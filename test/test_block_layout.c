@@ -6,6 +6,59 @@
 #include <LCUI/gui/builder.h>
 #include <LCUI/gui/widget/textview.h>
 
+static LCUI_BOOL add_sibling_on_resize;
+static LCUI_Widget added_child;
+
+/** Add a sibling during the layout, like widgets that create items on resize */
+static void OnResizeAddSibling(LCUI_Widget w, float width, float height)
+{
+	if (!add_sibling_on_resize || added_child || !w->parent) {
+		return;
+	}
+	added_child = LCUIWidget_New(NULL);
+	Widget_SetStyleString(added_child, "height", "10px");
+	Widget_Append(w->parent, added_child);
+}
+
+static void test_children_added_during_layout(void)
+{
+	LCUI_Widget box, w;
+	LCUI_WidgetPrototype proto;
+
+	proto = LCUIWidget_NewPrototype("test-block-sibling-adder", NULL);
+	proto->resize = OnResizeAddSibling;
+	box = LCUIWidget_New(NULL);
+	Widget_SetStyleString(box, "position", "absolute");
+	Widget_SetStyleString(box, "width", "100px");
+	w = LCUIWidget_New("test-block-sibling-adder");
+	Widget_SetStyleString(w, "width", "50%");
+	Widget_SetStyleString(w, "height", "20px");
+	Widget_Append(box, w);
+	Widget_Append(LCUIWidget_GetRoot(), box);
+	LCUIWidget_Update();
+	/*
+	 * Resizing the box resizes the child while the box is loading its
+	 * children, and then the child adds a sibling
+	 */
+	added_child = NULL;
+	add_sibling_on_resize = TRUE;
+	Widget_SetStyleString(box, "width", "200px");
+	LCUIWidget_Update();
+	add_sibling_on_resize = FALSE;
+	it_b("the child added during the layout is laid out",
+	     added_child && added_child->box.border.y == 20 &&
+		 added_child->box.border.width == 200,
+	     TRUE);
+	/* The style of the added child is computed in the next update */
+	LCUIWidget_Update();
+	it_i("the height of the box includes the added child",
+	     (int)box->height, 30);
+	it_i("the added child is laid out after the style is computed",
+	     (int)added_child->box.border.height, 10);
+	Widget_Destroy(box);
+	LCUIWidget_Update();
+}
+
 static void test_dropdown(void)
 {
 	LCUI_Widget w;
@@ -752,6 +805,8 @@ void test_block_layout(void)
 	describe("root width 1280px", test_block_layout_1280);
 	describe("root width 600px", test_block_layout_600);
 	describe("root width 320px", test_block_layout_320);
+	describe("children added during layout",
+		 test_children_added_during_layout);
 
 #ifndef PREVIEW_MODE
 	LCUI_Destroy();
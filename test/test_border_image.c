@@ -0,0 +1,367 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/painter.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_parser.h>
+#include "test.h"
+#include "libtest.h"
+
+#define SLICE 10
+#define BOX_WIDTH 120
+#define BOX_HEIGHT 100
+
+/* clang-format off */
+
+static const char *css = CodeToString(
+
+.shorthand {
+	border-image: url(border.png) 10 20 fill repeat round;
+}
+
+.longhand {
+	border-image-source: url(border.png);
+	border-image-slice: 30%;
+	border-image-repeat: round;
+}
+
+.none {
+	border-image: none;
+}
+
+);
+
+/* clang-format on */
+
+static LCUI_Color GetRegionColor(int i)
+{
+	return ARGB(255, (uchar_t)(i * 25), (uchar_t)(255 - i * 25), 128);
+}
+
+/**
+ * Create a 30x30 image which is sliced into 9 regions with different colors,
+ * the left half of the top edge is red and the right half is blue, so that
+ * the repeat modes can be checked by the pixels of the top edge
+ */
+static void CreateSourceImage(LCUI_Graph *img)
+{
+	int i;
+	LCUI_Rect rect;
+
+	Graph_Init(img);
+	img->color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(img, SLICE * 3, SLICE * 3);
+	for (i = 0; i < 9; ++i) {
+		rect.x = (i % 3) * SLICE;
+		rect.y = (i / 3) * SLICE;
+		rect.width = SLICE;
+		rect.height = SLICE;
+		Graph_FillRect(img, GetRegionColor(i), &rect, TRUE);
+	}
+	rect.x = SLICE;
+	rect.y = 0;
+	rect.width = SLICE / 2;
+	Graph_FillRect(img, ARGB(255, 255, 0, 0), &rect, TRUE);
+	rect.x = SLICE + SLICE / 2;
+	Graph_FillRect(img, ARGB(255, 0, 0, 255), &rect, TRUE);
+}
+
+static void InitBorderImage(LCUI_BorderImage *image, LCUI_Graph *source,
+			    int repeat)
+{
+	image->source = source;
+	image->slice.top = SLICE;
+	image->slice.right = SLICE;
+	image->slice.bottom = SLICE;
+	image->slice.left = SLICE;
+	image->width.top = SLICE;
+	image->width.right = SLICE;
+	image->width.bottom = SLICE;
+	image->width.left = SLICE;
+	image->fill = TRUE;
+	image->repeat_x = repeat;
+	image->repeat_y = repeat;
+}
+
+static LCUI_BOOL CheckPixel(LCUI_Graph *canvas, int x, int y, LCUI_Color c)
+{
+	LCUI_Color color;
+
+	/* The mixed pixels may have a rounding error */
+	Graph_GetPixel(canvas, x, y, color);
+	return abs(color.r - c.r) < 4 && abs(color.g - c.g) < 4 &&
+	       abs(color.b - c.b) < 4;
+}
+
+static void PaintBorderImage(LCUI_Graph *canvas, int repeat)
+{
+	LCUI_Rect rect;
+	LCUI_Graph source;
+	LCUI_BorderImage image;
+	LCUI_PaintContext paint;
+
+	rect.x = 0;
+	rect.y = 0;
+	rect.width = BOX_WIDTH;
+	rect.height = BOX_HEIGHT;
+	Graph_Init(canvas);
+	canvas->color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(canvas, BOX_WIDTH, BOX_HEIGHT);
+	CreateSourceImage(&source);
+	InitBorderImage(&image, &source, repeat);
+	paint = LCUIPainter_Begin(canvas, &rect);
+	BorderImage_Paint(&image, &rect, paint);
+	LCUIPainter_End(paint);
+	Graph_Free(&source);
+}
+
+static void test_border_image_parser(void)
+{
+	LCUI_Widget root, w;
+	LCUI_BorderImageStyle *s;
+
+	LCUI_Init();
+	LCUI_LoadCSSString(css, __FILE__);
+	root = LCUIWidget_GetRoot();
+	w = LCUIWidget_New(NULL);
+	Widget_AddClass(w, "shorthand");
+	Widget_Append(root, w);
+	LCUIWidget_Update();
+	s = &w->computed_style.border_image;
+	it_b("border-image: url(...), the source is a path",
+	     Widget_CheckStyleType(w, key_border_image_source, string) &&
+		 strstr(w->style->sheet[key_border_image_source].string,
+			"border.png") != NULL,
+	     TRUE);
+	it_b("border-image: 10 20, the slice is expanded like padding",
+	     s->slice.top.val_int == 10 && s->slice.right.val_int == 20 &&
+		 s->slice.bottom.val_int == 10 && s->slice.left.val_int == 20,
+	     TRUE);
+	it_b("border-image: fill", s->fill, TRUE);
+	it_b("border-image: repeat round",
+	     s->repeat_x == SV_REPEAT && s->repeat_y == SV_ROUND, TRUE);
+
+	Widget_RemoveClass(w, "shorthand");
+	Widget_AddClass(w, "longhand");
+	LCUIWidget_Update();
+	it_b("border-image-slice: 30%",
+	     s->slice.top.type == LCUI_STYPE_SCALE &&
+		 s->slice.left.type == LCUI_STYPE_SCALE &&
+		 s->slice.left.scale > 0.29f && s->slice.left.scale < 0.31f,
+	     TRUE);
+	it_b("border-image-slice does not set fill", s->fill, FALSE);
+	it_b("border-image-repeat: round",
+	     s->repeat_x == SV_ROUND && s->repeat_y == SV_ROUND, TRUE);
+
+	Widget_RemoveClass(w, "longhand");
+	Widget_AddClass(w, "none");
+	LCUIWidget_Update();
+	it_b("border-image: none, the source is none",
+	     Widget_CheckStyleType(w, key_border_image_source, none), TRUE);
+	it_b("border-image: none, the slice is reset to 100%",
+	     s->slice.top.type == LCUI_STYPE_SCALE &&
+		 s->slice.top.scale == 1.0f,
+	     TRUE);
+	it_b("border-image: none, the repeat is reset to stretch",
+	     s->repeat_x == SV_STRETCH && s->repeat_y == SV_STRETCH, TRUE);
+	LCUI_Destroy();
+}
+
+static void test_border_image_paint(void)
+{
+	LCUI_Graph canvas;
+
+	PaintBorderImage(&canvas, SV_STRETCH);
+	it_b("the top left corner is painted",
+	     CheckPixel(&canvas, 2, 2, GetRegionColor(0)), TRUE);
+	it_b("the bottom right corner is painted",
+	     CheckPixel(&canvas, BOX_WIDTH - 2, BOX_HEIGHT - 2,
+			GetRegionColor(8)),
+	     TRUE);
+	it_b("the right edge is painted",
+	     CheckPixel(&canvas, BOX_WIDTH - 5, BOX_HEIGHT / 2,
+			GetRegionColor(5)),
+	     TRUE);
+	it_b("the center is painted with fill",
+	     CheckPixel(&canvas, BOX_WIDTH / 2, BOX_HEIGHT / 2,
+			GetRegionColor(4)),
+	     TRUE);
+	it_b("stretch: the top edge is stretched",
+	     CheckPixel(&canvas, SLICE + 2, 5, ARGB(255, 255, 0, 0)) &&
+		 CheckPixel(&canvas, SLICE + 80, 5, ARGB(255, 0, 0, 255)),
+	     TRUE);
+	Graph_Free(&canvas);
+
+	/* The top edge is 100px and the unit is 10px, so the repeated units
+	 * are centered and start at -5px */
+	PaintBorderImage(&canvas, SV_REPEAT);
+	it_b("repeat: the top edge is repeated from the center",
+	     CheckPixel(&canvas, SLICE + 1, 5, ARGB(255, 0, 0, 255)) &&
+		 CheckPixel(&canvas, SLICE + 7, 5, ARGB(255, 255, 0, 0)) &&
+		 CheckPixel(&canvas, SLICE + 11, 5, ARGB(255, 0, 0, 255)),
+	     TRUE);
+	Graph_Free(&canvas);
+
+	PaintBorderImage(&canvas, SV_ROUND);
+	it_b("round: the top edge is repeated from the start",
+	     CheckPixel(&canvas, SLICE + 1, 5, ARGB(255, 255, 0, 0)) &&
+		 CheckPixel(&canvas, SLICE + 7, 5, ARGB(255, 0, 0, 255)) &&
+		 CheckPixel(&canvas, SLICE + 91, 5, ARGB(255, 255, 0, 0)),
+	     TRUE);
+	Graph_Free(&canvas);
+}
+
+static void test_border_image_tiles(void)
+{
+	LCUI_Graph source;
+	LCUI_BorderImage image;
+	LCUI_BorderImageTilesRec tiles;
+
+	CreateSourceImage(&source);
+	InitBorderImage(&image, &source, SV_ROUND);
+	BorderImageTiles_Init(&tiles);
+	it_i("the tiles are built for the first time",
+	     BorderImageTiles_Update(&tiles, &image, BOX_WIDTH, BOX_HEIGHT),
+	     1);
+	it_i("the tiles are reused for the same size",
+	     BorderImageTiles_Update(&tiles, &image, BOX_WIDTH, BOX_HEIGHT),
+	     0);
+	it_i("the tiles are rebuilt for a new size",
+	     BorderImageTiles_Update(&tiles, &image, BOX_WIDTH + 20,
+				     BOX_HEIGHT),
+	     1);
+	it_b("the top edge tile is resized",
+	     tiles.graphs[1].width == BOX_WIDTH + 20 - SLICE * 2 &&
+		 tiles.graphs[1].height == SLICE,
+	     TRUE);
+	image.fill = FALSE;
+	it_i("the tiles are rebuilt for new parameters",
+	     BorderImageTiles_Update(&tiles, &image, BOX_WIDTH + 20,
+				     BOX_HEIGHT),
+	     1);
+	it_b("the center tile is not built without fill",
+	     Graph_IsValid(&tiles.graphs[4]), FALSE);
+	/* The border widths are scaled down when they do not fit the box */
+	BorderImageTiles_Update(&tiles, &image, 10, 10);
+	it_b("the border widths are scaled down to fit the box",
+	     tiles.rects[0].width == 5 && tiles.rects[8].x == 5, TRUE);
+	/*
+	 * A new source image in the same graph may get the address of the
+	 * freed pixels, the tiles must not be reused for it
+	 */
+	BorderImageTiles_Update(&tiles, &image, BOX_WIDTH, BOX_HEIGHT);
+	Graph_Free(&source);
+	CreateSourceImage(&source);
+	it_i("the tiles are rebuilt for a new source image in the same graph",
+	     BorderImageTiles_Update(&tiles, &image, BOX_WIDTH, BOX_HEIGHT),
+	     1);
+	it_i("the tiles are reused after being rebuilt",
+	     BorderImageTiles_Update(&tiles, &image, BOX_WIDTH, BOX_HEIGHT),
+	     0);
+	image.source = NULL;
+	it_i("the tiles are released for an invalid source",
+	     BorderImageTiles_Update(&tiles, &image, BOX_WIDTH, BOX_HEIGHT),
+	     -1);
+	BorderImageTiles_Free(&tiles);
+	Graph_Free(&source);
+}
+
+static void test_widget_border_image(void)
+{
+	LCUI_Rect rect;
+	LCUI_Graph source, canvas;
+	LCUI_PaintContext paint;
+	LCUI_Widget root, w;
+	const uchar_t *bytes;
+
+	LCUI_Init();
+	CreateSourceImage(&source);
+	root = LCUIWidget_GetRoot();
+	w = LCUIWidget_New(NULL);
+	Widget_SetStyleString(w, "position", "absolute");
+	Widget_SetStyleString(w, "box-sizing", "border-box");
+	Widget_SetStyleString(w, "border", "10px solid #000");
+	Widget_SetStyleString(w, "border-image-slice", "10 fill");
+	Widget_SetStyle(w, key_border_image_source, &source, image);
+	Widget_Move(w, 0, 0);
+	Widget_Resize(w, BOX_WIDTH, BOX_HEIGHT);
+	Widget_Append(root, w);
+	Widget_Resize(root, 200, 200);
+	LCUIWidget_Update();
+
+	rect.x = 0;
+	rect.y = 0;
+	rect.width = 200;
+	rect.height = 200;
+	Graph_Init(&canvas);
+	canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&canvas, 200, 200);
+	paint = LCUIPainter_Begin(&canvas, &rect);
+	Widget_Render(root, paint);
+	LCUIPainter_End(paint);
+	it_b("the border image replaces the border",
+	     CheckPixel(&canvas, 2, 2, GetRegionColor(0)), TRUE);
+	it_b("the center of the border image is painted",
+	     CheckPixel(&canvas, BOX_WIDTH / 2, BOX_HEIGHT / 2,
+			GetRegionColor(4)),
+	     TRUE);
+	it_b("the tiles are cached in the widget",
+	     w->border_image_cache && w->border_image_cache->width ==
+	     BOX_WIDTH, TRUE);
+
+	bytes = w->border_image_cache->graphs[1].bytes;
+	rect.width = 50;
+	rect.height = 50;
+	paint = LCUIPainter_Begin(&canvas, &rect);
+	Widget_Render(root, paint);
+	LCUIPainter_End(paint);
+	it_b("the cached tiles are reused when repainting a part",
+	     w->border_image_cache->graphs[1].bytes == bytes, TRUE);
+
+	Widget_Resize(w, BOX_WIDTH + 40, BOX_HEIGHT);
+	LCUIWidget_Update();
+	rect.width = 200;
+	rect.height = 200;
+	paint = LCUIPainter_Begin(&canvas, &rect);
+	Widget_Render(root, paint);
+	LCUIPainter_End(paint);
+	it_b("the tiles are rebuilt after resizing",
+	     w->border_image_cache->width == BOX_WIDTH + 40, TRUE);
+	it_b("the resized border image is painted",
+	     CheckPixel(&canvas, BOX_WIDTH + 35, BOX_HEIGHT - 2,
+			GetRegionColor(8)),
+	     TRUE);
+
+	bytes = w->border_image_cache->graphs[1].bytes;
+	Widget_SetStyleString(w, "border-color", "#f00");
+	LCUIWidget_Update();
+	paint = LCUIPainter_Begin(&canvas, &rect);
+	Widget_Render(root, paint);
+	LCUIPainter_End(paint);
+	it_b("the cached tiles are kept after changing the border color",
+	     w->border_image_cache->graphs[1].bytes == bytes, TRUE);
+
+	Widget_SetStyleString(w, "border-image-slice", "20 fill");
+	LCUIWidget_Update();
+	paint = LCUIPainter_Begin(&canvas, &rect);
+	Widget_Render(root, paint);
+	LCUIPainter_End(paint);
+	it_b("the tiles are rebuilt after changing the slice",
+	     w->border_image_cache->image.slice.left == 20, TRUE);
+
+	Widget_Destroy(w);
+	LCUIWidget_Update();
+	Graph_Free(&canvas);
+	Graph_Free(&source);
+	LCUI_Destroy();
+}
+
+void test_border_image(void)
+{
+	describe("border-image parser", test_border_image_parser);
+	describe("border image painting", test_border_image_paint);
+	describe("border image tiles cache", test_border_image_tiles);
+	describe("widget border image", test_widget_border_image);
+}
@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/painter.h>
+
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 720
+#define PANEL_WIDTH 300
+#define PANEL_HEIGHT 200
+#define PANELS 12
+#define FRAMES 60
+#define SLICE 24
+
+typedef enum BenchMode {
+	MODE_MEMCPY,
+	MODE_UNCACHED,
+	MODE_CACHED,
+	MODE_CACHED_PARTIAL,
+	MODE_CACHED_RESIZE
+} BenchMode;
+
+/** Create a skin image with a gradient, so that the scaling is not trivial */
+static void CreateSkinImage(LCUI_Graph *img)
+{
+	int x, y;
+	LCUI_Color color;
+
+	Graph_Init(img);
+	img->color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(img, SLICE * 3, SLICE * 3);
+	for (y = 0; y < SLICE * 3; ++y) {
+		for (x = 0; x < SLICE * 3; ++x) {
+			color.r = (uchar_t)(x * 3);
+			color.g = (uchar_t)(y * 3);
+			color.b = (uchar_t)(255 - x - y);
+			color.a = (uchar_t)(x % 8 == 0 ? 128 : 255);
+			Graph_SetPixel(img, x, y, color);
+		}
+	}
+}
+
+static double RunBench(BenchMode mode, LCUI_Graph *skin, int repeat)
+{
+	int i, frame;
+	int64_t start;
+	LCUI_Rect box, rect;
+	LCUI_Graph canvas, rendered;
+	LCUI_BorderImage image;
+	LCUI_PaintContext paint;
+	LCUI_BorderImageTilesRec tiles[PANELS];
+
+	image.source = skin;
+	image.slice.top = image.slice.right = SLICE;
+	image.slice.bottom = image.slice.left = SLICE;
+	image.width.top = image.width.right = SLICE;
+	image.width.bottom = image.width.left = SLICE;
+	image.fill = TRUE;
+	image.repeat_x = repeat;
+	image.repeat_y = repeat;
+
+	Graph_Init(&canvas);
+	Graph_Init(&rendered);
+	canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&canvas, SCREEN_WIDTH, SCREEN_HEIGHT);
+	box.x = box.y = 0;
+	box.width = PANEL_WIDTH;
+	box.height = PANEL_HEIGHT;
+	if (mode == MODE_MEMCPY) {
+		/* The lower bound: copy a pre-rendered panel */
+		rendered.color_type = LCUI_COLOR_TYPE_ARGB;
+		Graph_Create(&rendered, PANEL_WIDTH, PANEL_HEIGHT);
+		paint = LCUIPainter_Begin(&rendered, &box);
+		BorderImage_Paint(&image, &box, paint);
+		LCUIPainter_End(paint);
+	}
+	for (i = 0; i < PANELS; ++i) {
+		BorderImageTiles_Init(&tiles[i]);
+	}
+	start = LCUI_GetTimeNs();
+	for (frame = 0; frame < FRAMES; ++frame) {
+		for (i = 0; i < PANELS; ++i) {
+			box.x = (i % 4) * (PANEL_WIDTH + 10);
+			box.y = (i / 4) * (PANEL_HEIGHT + 10);
+			box.width = PANEL_WIDTH;
+			box.height = PANEL_HEIGHT;
+			rect = box;
+			if (mode == MODE_CACHED_PARTIAL) {
+				/* Repaint a small dirty rect, like a caret */
+				rect.x += PANEL_WIDTH / 2;
+				rect.y += PANEL_HEIGHT / 2;
+				rect.width = 32;
+				rect.height = 32;
+			} else if (mode == MODE_CACHED_RESIZE) {
+				box.width -= frame % 2;
+				rect = box;
+			}
+			paint = LCUIPainter_Begin(&canvas, &rect);
+			switch (mode) {
+			case MODE_MEMCPY:
+				Graph_Mix(&paint->canvas, &rendered, 0, 0,
+					  paint->with_alpha);
+				break;
+			case MODE_UNCACHED:
+				BorderImage_Paint(&image, &box, paint);
+				break;
+			default:
+				BorderImageTiles_Update(&tiles[i], &image,
+							box.width, box.height);
+				BorderImageTiles_Paint(&tiles[i], &box, paint);
+				break;
+			}
+			LCUIPainter_End(paint);
+		}
+	}
+	start = LCUI_GetTimeNs() - start;
+	for (i = 0; i < PANELS; ++i) {
+		BorderImageTiles_Free(&tiles[i]);
+	}
+	Graph_Free(&rendered);
+	Graph_Free(&canvas);
+	return start / 1000.0 / FRAMES;
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	LCUI_Graph skin;
+	const char *names[] = { "stretch", "repeat", "round" };
+	const int modes[] = { SV_STRETCH, SV_REPEAT, SV_ROUND };
+
+	CreateSkinImage(&skin);
+	Logger_Info("paint %d skinned panels of %dx%d with a %dx%d border "
+		    "image, %d frames\n",
+		    PANELS, PANEL_WIDTH, PANEL_HEIGHT, SLICE * 3, SLICE * 3,
+		    FRAMES);
+	Logger_Info("%-10s%-12s%-12s%-12s%-12s%-12s\n", "repeat", "memcpy",
+		    "uncached", "cached", "partial", "resizing");
+	for (i = 0; i < 3; ++i) {
+		Logger_Info("%-10s%-12.1f%-12.1f%-12.1f%-12.1f%-12.1f\n",
+			    names[i], RunBench(MODE_MEMCPY, &skin, modes[i]),
+			    RunBench(MODE_UNCACHED, &skin, modes[i]),
+			    RunBench(MODE_CACHED, &skin, modes[i]),
+			    RunBench(MODE_CACHED_PARTIAL, &skin, modes[i]),
+			    RunBench(MODE_CACHED_RESIZE, &skin, modes[i]));
+	}
+	Logger_Info("(time in us per frame)\n");
+	Graph_Free(&skin);
+	return 0;
+}
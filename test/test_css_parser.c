@@ -1,8 +1,10 @@
 ﻿#include <stdio.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/display.h>
 #include <LCUI/gui/builder.h>
+#include <LCUI/gui/css_parser.h>
 #include "test.h"
 #include "libtest.h"
 
@@ -111,6 +113,58 @@ static void test_parse_flex_0_0_100px(void)
 	it_i("<flex-basis>", (int)s[key_flex_basis].val_px, 100);
 }
 
+static void OnCSSFileLoaded(const char *filepath, int result, void *arg)
+{
+	int *state = arg;
+
+	*state = result == 0 ? 1 : -1;
+}
+
+static void test_load_css_file_async(void)
+{
+	int i, state = 0;
+	LCUI_Style s;
+
+	it_i("should successfully post the loading task",
+	     LCUI_LoadCSSFileAsync("test_css_parser_async.css",
+				   OnCSSFileLoaded, &state),
+	     0);
+	for (i = 0; i < 100 && state == 0; ++i) {
+		LCUI_ProcessEvents();
+		if (state == 0) {
+			LCUI_MSleep(10);
+		}
+	}
+	it_i("should call the callback with a successful result", state, 1);
+	LCUIWidget_Update();
+	s = LCUIWidget_GetById("test-textview")->style->sheet;
+	it_i("top", (int)s[key_top].val_px, 24);
+	it_i("width", (int)s[key_width].val_px, 120);
+	it_i("height", (int)s[key_height].val_px, 60);
+}
+
+static void test_parse_css_file_ending_with_slash(void)
+{
+	FILE *fp;
+	LinkedList rules;
+	const char *css = "#test-textview { left: 8px; }\n"
+			  "@font-face { font-family: 'test'; src: url(none.ttf); }"
+			  "\n/";
+
+	fp = fopen("test_css_parser_slash.css", "wb");
+	if (!fp) {
+		return;
+	}
+	fwrite(css, 1, strlen(css), fp);
+	fclose(fp);
+	LinkedList_Init(&rules);
+	it_i("should successfully parse the file",
+	     LCUI_ParseCSSFile("test_css_parser_slash.css", &rules), 0);
+	it_i("should get the rule before the last '/'", (int)rules.length, 1);
+	LinkedList_Clear(&rules, (FuncPtr)StyleRule_Delete);
+	remove("test_css_parser_slash.css");
+}
+
 void test_css_parser(void)
 {
 	LCUI_Widget root, box, btn;
@@ -141,5 +195,8 @@ void test_css_parser(void)
 	describe("parse 'flex: 100px;'", test_parse_flex_100px);
 	describe("parse 'flex: 1 100px;'", test_parse_flex_1_100px);
 	describe("parse 'flex: 0 0 100px;'", test_parse_flex_0_0_100px);
+	describe("load css file async", test_load_css_file_async);
+	describe("parse css file ending with '/'",
+		 test_parse_css_file_ending_with_slash);
 	LCUI_Destroy();
 }
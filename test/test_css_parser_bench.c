@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_library.h>
+#include <LCUI/gui/css_parser.h>
+
+#define CSS_FILE "test_css_parser_bench.css"
+#define CSS_FILE_SIZE (5 * 1024 * 1024)
+
+typedef struct AsyncResultRec_ {
+	int state;
+	int64_t end_time;
+} AsyncResultRec, *AsyncResult;
+
+static size_t GenerateCSSFile(const char *filepath, size_t size)
+{
+	int i;
+	FILE *fp;
+	size_t total = 0;
+
+	fp = fopen(filepath, "wb");
+	if (!fp) {
+		return 0;
+	}
+	for (i = 0; total < size; ++i) {
+		total += fprintf(fp,
+				 ".theme-%d .list-%d .item-%d:hover,\n"
+				 ".theme-%d .item-%d.active {\n"
+				 "\twidth: %dpx;\n"
+				 "\theight: %dpx;\n"
+				 "\tdisplay: inline-block;\n"
+				 "\tmargin: %dpx;\n"
+				 "\tpadding: %dpx %dpx;\n"
+				 "\tborder: 1px solid #%06x;\n"
+				 "\tbackground-color: #%06x;\n"
+				 "}\n\n",
+				 i % 16, i % 64, i, i % 16, i, 10 + i % 200,
+				 10 + i % 100, i % 8, i % 4, i % 12,
+				 (i * 2654435761u) & 0xffffff,
+				 (i * 40503u) & 0xffffff);
+	}
+	fclose(fp);
+	return total;
+}
+
+static void OnLoaded(const char *filepath, int result, void *arg)
+{
+	AsyncResult res = arg;
+
+	res->state = result == 0 ? 1 : -1;
+	res->end_time = LCUI_GetTime();
+}
+
+static double GetSpeed(size_t size, int64_t time)
+{
+	if (time < 1) {
+		time = 1;
+	}
+	return size / 1024.0 / 1024.0 / (time / 1000.0);
+}
+
+int main(int argc, char **argv)
+{
+	size_t size, count;
+	int64_t start, blocked, sync_time, parse_time, merge_time;
+	LinkedList rules;
+	AsyncResultRec result = { 0 };
+
+	LCUI_Init();
+	size = GenerateCSSFile(CSS_FILE, CSS_FILE_SIZE);
+	if (size < 1) {
+		Logger_Error("cannot create %s\n", CSS_FILE);
+		LCUI_Destroy();
+		return -1;
+	}
+
+	start = LCUI_GetTime();
+	LCUI_LoadCSSFile(CSS_FILE);
+	sync_time = LCUI_GetTimeDelta(start);
+
+	LinkedList_Init(&rules);
+	start = LCUI_GetTime();
+	LCUI_ParseCSSFile(CSS_FILE, &rules);
+	parse_time = LCUI_GetTimeDelta(start);
+	start = LCUI_GetTime();
+	count = LCUI_PutStyleRules(&rules, CSS_FILE);
+	merge_time = LCUI_GetTimeDelta(start);
+	LinkedList_Clear(&rules, (FuncPtr)StyleRule_Delete);
+
+	/* Measure how long the main thread is blocked by the async loading */
+	blocked = 0;
+	start = LCUI_GetTime();
+	LCUI_LoadCSSFileAsync(CSS_FILE, OnLoaded, &result);
+	blocked += LCUI_GetTimeDelta(start);
+	while (result.state == 0) {
+		int64_t t = LCUI_GetTime();
+		LCUI_ProcessEvents();
+		blocked += LCUI_GetTimeDelta(t);
+		LCUI_MSleep(1);
+	}
+
+	Logger_Info("load a generated stylesheet of %.2f MB with %lu "
+		    "selectors\n",
+		    size / 1024.0 / 1024.0, (unsigned long)count);
+	Logger_Info("%-24s%-12s%-12s\n", "method", "time", "MB/s");
+	Logger_Info("%-24s%-12ld%-12.2f\n", "sync load", (long)sync_time,
+		    GetSpeed(size, sync_time));
+	Logger_Info("%-24s%-12ld%-12.2f\n", "parse only", (long)parse_time,
+		    GetSpeed(size, parse_time));
+	Logger_Info("%-24s%-12ld%-12.2f\n", "merge rules", (long)merge_time,
+		    GetSpeed(size, merge_time));
+	Logger_Info("%-24s%-12ld%-12.2f\n", "async load",
+		    (long)(result.end_time - start),
+		    GetSpeed(size, result.end_time - start));
+	Logger_Info("async load %s, the main thread was blocked for %ldms\n",
+		    result.state == 1 ? "succeeded" : "failed", (long)blocked);
+	remove(CSS_FILE);
+	LCUI_Destroy();
+	return 0;
+}
@@ -1,4 +1,5 @@
-﻿#include <LCUI_Build.h>
+﻿#include <string.h>
+#include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/font.h>
 #include <LCUI/gui/css_library.h>
@@ -121,6 +122,39 @@ void test_arial_font_load(void)
 	}
 }
 
+static void test_font_stack(void)
+{
+	const char *family = "icomoon, inconsolata";
+	LCUI_FontStack a, b, c, d;
+
+	LCUI_InitFontLibrary();
+	LCUI_InitCSSLibrary();
+	LCUI_InitCSSParser();
+	a = LCUIFont_GetStack(family, FONT_STYLE_NORMAL, FONT_WEIGHT_NORMAL);
+	b = LCUIFont_GetStack(family, FONT_STYLE_NORMAL, FONT_WEIGHT_NORMAL);
+	c = LCUIFont_GetStack(family, FONT_STYLE_NORMAL, FONT_WEIGHT_BOLD);
+	it_b("check the same font style shares the same stack", a && a == b,
+	     TRUE);
+	it_b("check a different font weight uses another stack", c && a != c,
+	     TRUE);
+	it_i("check the stack only has the loaded fonts", (int)a->length, 1);
+	LCUI_LoadCSSFile("test_font_load.css");
+	d = LCUIFont_GetStack(family, FONT_STYLE_NORMAL, FONT_WEIGHT_NORMAL);
+	it_b("check adding a font resolves a new stack", d && d != a, TRUE);
+	it_i("check the new stack has the added font", (int)d->length, 2);
+	it_b("check the old stack is still usable",
+	     strcmp(a->family, family) == 0 && a->font_ids[0] > 0, TRUE);
+	LCUIFont_ReleaseStack(a);
+	LCUIFont_ReleaseStack(b);
+	LCUIFont_ReleaseStack(c);
+	LCUI_FreeCSSParser();
+	LCUI_FreeCSSLibrary();
+	LCUI_FreeFontLibrary();
+	it_b("check the stack outlives the font library",
+	     strcmp(d->family, family) == 0, TRUE);
+	LCUIFont_ReleaseStack(d);
+}
+
 void test_font_load(void)
 {
 	LCUI_InitFontLibrary();
@@ -144,4 +178,6 @@ void test_font_load(void)
 	LCUI_FreeCSSParser();
 	LCUI_FreeCSSLibrary();
 	LCUI_FreeFontLibrary();
+
+	describe("test font stack", test_font_stack);
 }
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/timer.h>
+#include <LCUI/gui/widget.h>
+#include "test.h"
+#include "libtest.h"
+
+#define FRAMES 20
+#define SLOW_TIMER_TIME 40
+
+static void test_histogram(void)
+{
+	int64_t i, value;
+	LCUI_HistogramRec h, other;
+
+	Histogram_Init(&h);
+	it_i("the percentile of an empty histogram is zero",
+	     (int)Histogram_GetPercentile(&h, 50), 0);
+	for (i = 1; i <= 10; ++i) {
+		Histogram_Record(&h, i);
+	}
+	it_i("small values are recorded exactly",
+	     (int)Histogram_GetPercentile(&h, 50), 5);
+	it_i("p100 is the max value", (int)Histogram_GetPercentile(&h, 100),
+	     10);
+
+	Histogram_Init(&h);
+	for (i = 1; i <= 100000; ++i) {
+		Histogram_Record(&h, i * 1000);
+	}
+	value = Histogram_GetPercentile(&h, 50);
+	it_b("p50 of [1ms, 100s] is within 3.2% of 50ms",
+	     value >= 50000000 && value <= 51600000, TRUE);
+	value = Histogram_GetPercentile(&h, 99);
+	it_b("p99 of [1ms, 100s] is within 3.2% of 99ms",
+	     value >= 99000000 && value <= 102168000, TRUE);
+	it_b("the max value is recorded exactly", h.max == 100000000, TRUE);
+	it_b("the mean value is recorded exactly",
+	     h.sum / (int64_t)h.total == 50000500, TRUE);
+
+	Histogram_Init(&other);
+	Histogram_Record(&other, -1);
+	Histogram_Record(&other, (int64_t)1 << 50);
+	it_b("out of range values are clamped",
+	     other.min == 0 && other.max == (int64_t)1 << 50, TRUE);
+	Histogram_Merge(&h, &other);
+	it_i("Histogram_Merge() merges the count", (int)h.total, 100002);
+	it_b("Histogram_Merge() merges the max value",
+	     Histogram_GetPercentile(&h, 100) == (int64_t)1 << 50, TRUE);
+}
+
+static void OnSlowTimer(void *arg)
+{
+	LCUI_MSleep(SLOW_TIMER_TIME);
+}
+
+static void test_get_frame_stats(void)
+{
+	int i;
+	LCUI_FrameStatsRec stats;
+	LCUI_Widget root, w;
+
+	LCUI_Init();
+	root = LCUIWidget_GetRoot();
+	LCUI_RunFrame();
+	LCUI_ResetFrameStats();
+	LCUI_GetFrameStats(&stats);
+	it_i("LCUI_ResetFrameStats() clears the frames", (int)stats.frames, 0);
+	it_b("the budget is decided by the frame rate cap",
+	     stats.budget > 0 && stats.budget <= 1000000000, TRUE);
+
+	LCUI_SetTimeout(0, OnSlowTimer, NULL);
+	for (i = 0; i < FRAMES; ++i) {
+		w = LCUIWidget_New(NULL);
+		Widget_Resize(w, 10.0f + i, 10.0f);
+		Widget_Append(root, w);
+		LCUI_RunFrame();
+	}
+	LCUI_GetFrameStats(&stats);
+	it_i("every frame is recorded", (int)stats.frames, FRAMES);
+	it_b("the frame with the slow timer is a jank frame",
+	     stats.jank_frames >= 1, TRUE);
+	it_b("the max time of the timers phase includes the slow timer",
+	     stats.phases[LCUI_FRAME_PHASE_TIMERS].max >=
+		 SLOW_TIMER_TIME * 1000000,
+	     TRUE);
+	it_b("the max frame time is not less than the max timers time",
+	     stats.frame.max >= stats.phases[LCUI_FRAME_PHASE_TIMERS].max,
+	     TRUE);
+	it_b("the percentiles are in order",
+	     stats.frame.p50 <= stats.frame.p95 &&
+		 stats.frame.p95 <= stats.frame.p99 &&
+		 stats.frame.p99 <= stats.frame.max,
+	     TRUE);
+	it_b("the layout time is recorded",
+	     stats.phases[LCUI_FRAME_PHASE_LAYOUT].max > 0, TRUE);
+	LCUI_Destroy();
+}
+
+void test_frame_stats(void)
+{
+	describe("histogram", test_histogram);
+	describe("LCUI_GetFrameStats", test_get_frame_stats);
+}
@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include "test.h"
+#include "libtest.h"
+
+#define WIDTH 37
+#define HEIGHT 13
+
+static LCUI_Color GetPatternColor(int x, int y)
+{
+	return ARGB((uchar_t)(x * 7 + y), (uchar_t)x, (uchar_t)y,
+		    (uchar_t)(x ^ y));
+}
+
+/** Create a graph whose pixels are all different */
+static void CreatePattern(LCUI_Graph *g, int color_type, int width,
+			  int height)
+{
+	int x, y;
+
+	Graph_Init(g);
+	g->color_type = color_type;
+	Graph_Create(g, width, height);
+	for (y = 0; y < height; ++y) {
+		for (x = 0; x < width; ++x) {
+			Graph_SetPixel(g, x, y, GetPatternColor(x, y));
+		}
+	}
+}
+
+static LCUI_BOOL IsSameColor(const LCUI_Graph *g, LCUI_Color a, LCUI_Color b)
+{
+	if (g->color_type == LCUI_COLOR_TYPE_RGB) {
+		return a.r == b.r && a.g == b.g && a.b == b.b;
+	}
+	return a.value == b.value;
+}
+
+/** Count the pixels which are different from the pattern at (sx, sy) */
+static int CountMismatches(LCUI_Graph *g, int color_type, LCUI_BOOL flip_x,
+			   LCUI_BOOL flip_y, int sx, int sy)
+{
+	int x, y, px, py, count = 0;
+	LCUI_Color c;
+
+	for (y = 0; y < (int)g->height; ++y) {
+		for (x = 0; x < (int)g->width; ++x) {
+			px = flip_x ? (int)g->width - 1 - x : x;
+			py = flip_y ? (int)g->height - 1 - y : y;
+			Graph_GetPixel(g, x, y, c);
+			if (!IsSameColor(g, c, GetPatternColor(px + sx,
+							       py + sy))) {
+				count += 1;
+			}
+		}
+	}
+	return count;
+}
+
+static void test_fill_rect(int color_type)
+{
+	int x, y, inside = 0, outside = 0, alpha = 0;
+	LCUI_Graph g;
+	LCUI_Color c;
+	LCUI_Rect rect = { 3, 2, 29, 9 };
+	LCUI_Color color = ARGB(200, 10, 20, 30);
+
+	CreatePattern(&g, color_type, WIDTH, HEIGHT);
+	Graph_FillRect(&g, color, &rect, TRUE);
+	for (y = 0; y < HEIGHT; ++y) {
+		for (x = 0; x < WIDTH; ++x) {
+			Graph_GetPixel(&g, x, y, c);
+			if (LCUIRect_HasPoint(&rect, x, y)) {
+				inside += !IsSameColor(&g, c, color);
+			} else {
+				outside +=
+				    !IsSameColor(&g, c, GetPatternColor(x, y));
+			}
+		}
+	}
+	it_i("the pixels in the rect are filled", inside, 0);
+	it_i("the pixels outside the rect are not changed", outside, 0);
+	if (color_type == LCUI_COLOR_TYPE_ARGB) {
+		Graph_FillRect(&g, RGB(1, 2, 3), &rect, FALSE);
+		inside = 0;
+		for (y = rect.y; y < rect.y + rect.height; ++y) {
+			for (x = rect.x; x < rect.x + rect.width; ++x) {
+				Graph_GetPixel(&g, x, y, c);
+				inside += c.r != 1 || c.g != 2 || c.b != 3;
+				alpha += c.a != 200;
+			}
+		}
+		it_i("fill the color only", inside, 0);
+		it_i("the alpha channel is kept", alpha, 0);
+	}
+	Graph_Free(&g);
+}
+
+static void test_fill_large_rect(void)
+{
+	int count = 0;
+	LCUI_Graph g;
+	LCUI_Color c;
+	LCUI_Color color = ARGB(255, 1, 2, 3);
+	LCUI_Rect rect = { 1, 1, 1099, 999 };
+
+	/* It is large enough to use non-temporal stores */
+	Graph_Init(&g);
+	g.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&g, 1101, 1000);
+	Graph_FillRect(&g, ARGB(0, 0, 0, 0), NULL, TRUE);
+	Graph_FillRect(&g, color, &rect, TRUE);
+	Graph_GetPixel(&g, 1, 1, c);
+	count += c.value == color.value;
+	Graph_GetPixel(&g, 1099, 999, c);
+	count += c.value == color.value;
+	Graph_GetPixel(&g, 0, 0, c);
+	count += c.value == 0;
+	Graph_GetPixel(&g, 1100, 999, c);
+	count += c.value == 0;
+	it_i("fill a large rect", count, 4);
+	Graph_Free(&g);
+}
+
+static void test_flip(int color_type)
+{
+	LCUI_Graph g, buff, quote;
+	LCUI_Rect rect = { 2, 3, 31, 7 };
+
+	CreatePattern(&g, color_type, WIDTH, HEIGHT);
+	Graph_Init(&buff);
+	Graph_HorizFlip(&g, &buff);
+	it_i("flip horizontally", CountMismatches(&buff, color_type, TRUE,
+						  FALSE, 0, 0),
+	     0);
+	Graph_VertiFlip(&g, &buff);
+	it_i("flip vertically", CountMismatches(&buff, color_type, FALSE,
+						TRUE, 0, 0),
+	     0);
+	Graph_HorizFlip(&buff, &buff);
+	it_i("flip horizontally in place",
+	     CountMismatches(&buff, color_type, TRUE, TRUE, 0, 0), 0);
+	Graph_VertiFlip(&buff, &buff);
+	it_i("flip vertically in place",
+	     CountMismatches(&buff, color_type, TRUE, FALSE, 0, 0), 0);
+	Graph_Quote(&quote, &g, &rect);
+	Graph_HorizFlip(&quote, &buff);
+	it_i("flip a quoted area",
+	     CountMismatches(&buff, color_type, TRUE, FALSE, 2, 3), 0);
+	Graph_HorizFlip(&quote, &quote);
+	Graph_Cut(&g, rect, &buff);
+	it_i("flip a quoted area in place",
+	     CountMismatches(&buff, color_type, TRUE, FALSE, 2, 3), 0);
+	Graph_Free(&buff);
+	Graph_Free(&g);
+}
+
+static void test_cut(int color_type)
+{
+	LCUI_Graph g, buff, quote;
+	LCUI_Rect rect = { 5, 1, 20, 10 };
+	LCUI_Rect part = { 3, 2, 9, 5 };
+
+	CreatePattern(&g, color_type, WIDTH, HEIGHT);
+	Graph_Init(&buff);
+	Graph_Cut(&g, rect, &buff);
+	it_b("cut a rect", buff.width == 20 && buff.height == 10 &&
+	     CountMismatches(&buff, color_type, FALSE, FALSE, 5, 1) == 0,
+	     TRUE);
+	Graph_QuoteReadOnly(&quote, &g, &rect);
+	Graph_Cut(&quote, part, &buff);
+	it_b("cut a quoted graph", buff.width == 9 && buff.height == 5 &&
+	     CountMismatches(&buff, color_type, FALSE, FALSE, 8, 3) == 0,
+	     TRUE);
+	Graph_Free(&buff);
+	Graph_Free(&g);
+}
+
+static void test_tile(int color_type)
+{
+	int x, y, count = 0;
+	LCUI_Graph g, tile;
+	LCUI_Color a, b;
+
+	CreatePattern(&tile, color_type, 7, 5);
+	Graph_Init(&g);
+	g.color_type = color_type;
+	Graph_Create(&g, WIDTH, HEIGHT + 20);
+	Graph_Tile(&g, &tile, TRUE, TRUE);
+	for (y = 0; y < (int)g.height; ++y) {
+		for (x = 0; x < (int)g.width; ++x) {
+			Graph_GetPixel(&g, x, y, a);
+			Graph_GetPixel(&tile, x % 7, y % 5, b);
+			count += !IsSameColor(&g, a, b);
+		}
+	}
+	it_i("tile a graph", count, 0);
+	Graph_Free(&tile);
+	Graph_Free(&g);
+}
+
+static void test_graph_argb(void)
+{
+	test_fill_rect(LCUI_COLOR_TYPE_ARGB);
+	test_fill_large_rect();
+	test_flip(LCUI_COLOR_TYPE_ARGB);
+	test_cut(LCUI_COLOR_TYPE_ARGB);
+	test_tile(LCUI_COLOR_TYPE_ARGB);
+}
+
+static void test_graph_rgb(void)
+{
+	test_fill_rect(LCUI_COLOR_TYPE_RGB);
+	test_flip(LCUI_COLOR_TYPE_RGB);
+	test_cut(LCUI_COLOR_TYPE_RGB);
+	test_tile(LCUI_COLOR_TYPE_RGB);
+}
+
+static void test_graph_with_features(void)
+{
+	describe("ARGB graph", test_graph_argb);
+	describe("RGB graph", test_graph_rgb);
+}
+
+void test_graph(void)
+{
+	int i;
+	unsigned features;
+	const char *names[] = { "scalar", "sse2", "avx2", "neon" };
+	const unsigned masks[] = { 0, LCUI_CPU_SSE2,
+				   LCUI_CPU_SSE2 | LCUI_CPU_AVX2,
+				   LCUI_CPU_NEON };
+
+	LCUI_SetCPUFeaturesMask(~0u);
+	features = LCUI_GetCPUFeatures();
+	for (i = 0; i < 4; ++i) {
+		if ((features & masks[i]) != masks[i]) {
+			continue;
+		}
+		LCUI_SetCPUFeaturesMask(masks[i]);
+		describe(names[i], test_graph_with_features);
+	}
+	LCUI_SetCPUFeaturesMask(~0u);
+}
@@ -0,0 +1,262 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+
+/* The number of pixels processed by each test case */
+#define PIXELS (1 << 25)
+#define TILE_SIZE 24
+
+enum BenchOp {
+	OP_FILL,
+	OP_FILL_RGB,
+	OP_FILL_RGB888,
+	OP_HORIZ_FLIP,
+	OP_HORIZ_FLIP_IN_PLACE,
+	OP_VERTI_FLIP_IN_PLACE,
+	OP_TILE,
+	OP_CUT,
+	OP_TOTAL
+};
+
+static const char *op_names[OP_TOTAL] = {
+	"fill",	     "fill color",	 "fill rgb888", "hflip",
+	"hflip (in place)", "vflip (in place)", "tile",	"cut"
+};
+
+static const int sizes[][2] = {
+	{ 64, 64 }, { 256, 256 }, { 1280, 720 }, { 3840, 2160 }
+};
+
+static LCUI_Graph canvas, canvas_rgb, buffer, tile;
+static volatile unsigned checksum = 0;
+
+/* The implementations before the SIMD kernels, they are the baseline */
+
+static void FillARGB_Baseline(LCUI_Graph *g, LCUI_Color color,
+			      LCUI_BOOL with_alpha)
+{
+	size_t i, n = g->width * g->height;
+	LCUI_ARGB *pixel = g->argb;
+
+	if (with_alpha) {
+		for (i = 0; i < n; ++i) {
+			*pixel++ = color;
+		}
+		return;
+	}
+	for (i = 0; i < n; ++i) {
+		color.alpha = pixel->alpha;
+		*pixel++ = color;
+	}
+}
+
+static void FillRGB_Baseline(LCUI_Graph *g, LCUI_Color color)
+{
+	size_t i, n = g->width * g->height;
+	uchar_t *bytep = g->bytes;
+
+	for (i = 0; i < n; ++i) {
+		*bytep++ = color.blue;
+		*bytep++ = color.green;
+		*bytep++ = color.red;
+	}
+}
+
+static void HorizFlip_Baseline(LCUI_Graph *src, LCUI_Graph *des)
+{
+	unsigned x, y;
+	LCUI_ARGB *pixel_src, *pixel_des;
+
+	for (y = 0; y < src->height; ++y) {
+		pixel_des = des->argb + y * des->width;
+		pixel_src = src->argb + y * src->width + src->width - 1;
+		for (x = 0; x < src->width; ++x) {
+			*pixel_des++ = *pixel_src--;
+		}
+	}
+}
+
+static void Tile_Baseline(LCUI_Graph *g, LCUI_Graph *t)
+{
+	unsigned x, y;
+
+	for (y = 0; y < g->height; y += t->height) {
+		for (x = 0; x < g->width; x += t->width) {
+			Graph_Replace(g, t, x, y);
+		}
+	}
+}
+
+static void Cut_Baseline(LCUI_Graph *g, LCUI_Rect rect, LCUI_Graph *buff)
+{
+	int x, y;
+	LCUI_ARGB *pixel_src, *pixel_des;
+
+	for (y = 0; y < rect.height; ++y) {
+		pixel_des = buff->argb + y * buff->width;
+		pixel_src = g->argb + (rect.y + y) * g->width + rect.x;
+		for (x = 0; x < rect.width; ++x) {
+			*pixel_des++ = *pixel_src++;
+		}
+	}
+}
+
+static void CreateGraph(LCUI_Graph *g, int color_type, int width, int height)
+{
+	Graph_Init(g);
+	g->color_type = color_type;
+	Graph_Create(g, width, height);
+	Graph_FillRect(g, ARGB(255, 128, 128, 128), NULL, TRUE);
+}
+
+static void RunOp(int op, LCUI_BOOL baseline)
+{
+	LCUI_Rect rect;
+	LCUI_Color color = ARGB(255, 10, 20, 30);
+
+	rect.x = rect.y = 1;
+	rect.width = canvas.width - 2;
+	rect.height = canvas.height - 2;
+	switch (op) {
+	case OP_FILL:
+		if (baseline) {
+			FillARGB_Baseline(&canvas, color, TRUE);
+		} else {
+			Graph_FillRect(&canvas, color, NULL, TRUE);
+		}
+		break;
+	case OP_FILL_RGB:
+		if (baseline) {
+			FillARGB_Baseline(&canvas, color, FALSE);
+		} else {
+			Graph_FillRect(&canvas, color, NULL, FALSE);
+		}
+		break;
+	case OP_FILL_RGB888:
+		if (baseline) {
+			FillRGB_Baseline(&canvas_rgb, color);
+		} else {
+			Graph_FillRect(&canvas_rgb, color, NULL, TRUE);
+		}
+		break;
+	case OP_HORIZ_FLIP:
+		if (baseline) {
+			HorizFlip_Baseline(&canvas, &buffer);
+		} else {
+			Graph_HorizFlip(&canvas, &buffer);
+		}
+		break;
+	case OP_HORIZ_FLIP_IN_PLACE:
+		/* The baseline flips into a new graph and copies it back */
+		if (baseline) {
+			HorizFlip_Baseline(&canvas, &buffer);
+			memcpy(canvas.bytes, buffer.bytes, canvas.mem_size);
+		} else {
+			Graph_HorizFlip(&canvas, &canvas);
+		}
+		break;
+	case OP_VERTI_FLIP_IN_PLACE:
+		if (baseline) {
+			Graph_VertiFlip(&canvas, &buffer);
+			memcpy(canvas.bytes, buffer.bytes, canvas.mem_size);
+		} else {
+			Graph_VertiFlip(&canvas, &canvas);
+		}
+		break;
+	case OP_TILE:
+		if (baseline) {
+			Tile_Baseline(&canvas, &tile);
+		} else {
+			Graph_Tile(&canvas, &tile, TRUE, TRUE);
+		}
+		break;
+	case OP_CUT:
+		if (baseline) {
+			Cut_Baseline(&canvas, rect, &buffer);
+		} else {
+			Graph_Cut(&canvas, rect, &buffer);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/** Run an operation on the canvas, return the time in ns per pixel */
+static double RunBench(int op, int width, int height, LCUI_BOOL baseline)
+{
+	int i, n;
+	int64_t start;
+
+	CreateGraph(&canvas, LCUI_COLOR_TYPE_ARGB, width, height);
+	CreateGraph(&canvas_rgb, LCUI_COLOR_TYPE_RGB, width, height);
+	CreateGraph(&buffer, LCUI_COLOR_TYPE_ARGB, width, height);
+	CreateGraph(&tile, LCUI_COLOR_TYPE_ARGB, TILE_SIZE, TILE_SIZE);
+	n = PIXELS / (width * height);
+	if (n < 4) {
+		n = 4;
+	}
+	RunOp(op, baseline);
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < n; ++i) {
+		RunOp(op, baseline);
+	}
+	start = LCUI_GetTimeNs() - start;
+	checksum += canvas.bytes[0] + buffer.bytes[0] + canvas_rgb.bytes[0];
+	Graph_Free(&canvas);
+	Graph_Free(&canvas_rgb);
+	Graph_Free(&buffer);
+	Graph_Free(&tile);
+	return (double)start / n / ((double)width * height);
+}
+
+int main(int argc, char **argv)
+{
+	int i, op, size, n_modes = 0;
+	char name[64];
+	unsigned features;
+	double times[5];
+	const char *mode_names[4];
+	unsigned masks[4];
+	const char *names[] = { "scalar", "sse2", "avx2", "neon" };
+	const unsigned all_masks[] = { 0, LCUI_CPU_SSE2,
+				       LCUI_CPU_SSE2 | LCUI_CPU_AVX2,
+				       LCUI_CPU_NEON };
+
+	features = LCUI_GetCPUFeatures();
+	for (i = 0; i < 4; ++i) {
+		if ((features & all_masks[i]) == all_masks[i]) {
+			mode_names[n_modes] = names[i];
+			masks[n_modes++] = all_masks[i];
+		}
+	}
+	Logger_Info("%-28s%-12s", "operation", "baseline");
+	for (i = 0; i < n_modes; ++i) {
+		Logger_Info("%-12s", mode_names[i]);
+	}
+	Logger_Info("\n");
+	for (op = 0; op < OP_TOTAL; ++op) {
+		for (size = 0; size < 4; ++size) {
+			times[0] = RunBench(op, sizes[size][0], sizes[size][1],
+					    TRUE);
+			for (i = 0; i < n_modes; ++i) {
+				LCUI_SetCPUFeaturesMask(masks[i]);
+				times[i + 1] = RunBench(op, sizes[size][0],
+							sizes[size][1], FALSE);
+			}
+			LCUI_SetCPUFeaturesMask(~0u);
+			sprintf(name, "%s %dx%d", op_names[op], sizes[size][0],
+				sizes[size][1]);
+			Logger_Info("%-28s", name);
+			for (i = 0; i <= n_modes; ++i) {
+				Logger_Info("%-12.3f", times[i]);
+			}
+			Logger_Info("\n");
+		}
+	}
+	Logger_Info("(time in ns per pixel)\n");
+	return 0;
+}
@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include "test.h"
+#include "libtest.h"
+
+#define WIDTH 64
+#define HEIGHT 48
+#define SIZE (WIDTH * HEIGHT * 4)
+
+static LCUI_GraphMemoryStatsRec base;
+
+static void CreateGraph(LCUI_Graph *g, LCUI_Color color)
+{
+	Graph_Init(g);
+	g->color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(g, WIDTH, HEIGHT);
+	Graph_FillRect(g, color, NULL, TRUE);
+}
+
+static LCUI_BOOL CheckColor(LCUI_Graph *g, int x, int y, LCUI_Color color)
+{
+	LCUI_Color c;
+
+	Graph_GetPixel(g, x, y, c);
+	return c.value == color.value;
+}
+
+/** Get the statistics relative to the graphs created before the test */
+static void GetStats(LCUI_GraphMemoryStats stats)
+{
+	Graph_GetMemoryStats(stats);
+	stats->buffers -= base.buffers;
+	stats->shared_buffers -= base.shared_buffers;
+	stats->unique_bytes -= base.unique_bytes;
+	stats->shared_bytes -= base.shared_bytes;
+	stats->saved_bytes -= base.saved_bytes;
+}
+
+static void test_copy_on_write(void)
+{
+	LCUI_Graph a, b, c;
+	LCUI_GraphMemoryStatsRec stats;
+	LCUI_Color red = ARGB(255, 255, 0, 0);
+	LCUI_Color blue = ARGB(255, 0, 0, 255);
+
+	Graph_GetMemoryStats(&base);
+	CreateGraph(&a, red);
+	Graph_Init(&b);
+	Graph_Init(&c);
+	Graph_Copy(&b, &a);
+	Graph_Copy(&c, &b);
+	GetStats(&stats);
+	it_b("copies share the pixel data",
+	     a.bytes == b.bytes && b.bytes == c.bytes, TRUE);
+	it_b("the copied graph is shared", Graph_IsShared(&a), TRUE);
+	it_b("copies have the same buffer id",
+	     Graph_GetBufferId(&a) != 0 &&
+		 Graph_GetBufferId(&a) == Graph_GetBufferId(&c),
+	     TRUE);
+	it_i("the number of buffers", (int)stats.buffers, 1);
+	it_i("the number of shared buffers", (int)stats.shared_buffers, 1);
+	it_i("the shared bytes", (int)stats.shared_bytes, SIZE);
+	it_i("the unique bytes", (int)stats.unique_bytes, 0);
+	it_i("the saved bytes", (int)stats.saved_bytes, SIZE * 2);
+
+	Graph_FillRect(&b, blue, NULL, TRUE);
+	GetStats(&stats);
+	it_b("writing detaches the pixel data", a.bytes != b.bytes, TRUE);
+	it_b("the written copy has the new color", CheckColor(&b, 10, 10, blue),
+	     TRUE);
+	it_b("the other graphs keep the old color",
+	     CheckColor(&a, 10, 10, red) && CheckColor(&c, 10, 10, red), TRUE);
+	it_b("the detached graph is not shared", Graph_IsShared(&b), FALSE);
+	it_b("the detached graph has a new buffer id",
+	     Graph_GetBufferId(&a) != Graph_GetBufferId(&b), TRUE);
+	it_i("the number of buffers after detaching", (int)stats.buffers, 2);
+	it_i("the unique bytes after detaching", (int)stats.unique_bytes, SIZE);
+	it_i("the saved bytes after detaching", (int)stats.saved_bytes, SIZE);
+
+	Graph_Free(&a);
+	GetStats(&stats);
+	it_b("the pixel data outlives the source graph",
+	     CheckColor(&c, WIDTH - 1, HEIGHT - 1, red), TRUE);
+	it_b("the last owner is not shared", Graph_IsShared(&c), FALSE);
+	it_i("the shared bytes after freeing", (int)stats.shared_bytes, 0);
+	it_i("the unique bytes after freeing", (int)stats.unique_bytes,
+	     SIZE * 2);
+	Graph_Free(&b);
+	Graph_Free(&c);
+	GetStats(&stats);
+	it_i("all buffers are freed", (int)stats.buffers, 0);
+	it_i("all bytes are freed",
+	     (int)(stats.unique_bytes + stats.shared_bytes), 0);
+}
+
+static void test_quote(void)
+{
+	LCUI_Rect rect = { 8, 8, 16, 16 };
+	LCUI_Graph a, b, ro, rw, part;
+	LCUI_Color red = ARGB(255, 255, 0, 0);
+	LCUI_Color green = ARGB(255, 0, 255, 0);
+
+	CreateGraph(&a, red);
+	Graph_Init(&b);
+	Graph_Init(&ro);
+	Graph_Init(&rw);
+	Graph_Init(&part);
+	Graph_Copy(&b, &a);
+	Graph_QuoteReadOnly(&ro, &b, &rect);
+	it_b("a read-only quote keeps the pixel data shared",
+	     Graph_IsShared(&b), TRUE);
+	Graph_Quote(&rw, &b, &rect);
+	it_b("a writable quote detaches the source", Graph_IsShared(&b), FALSE);
+	Graph_FillRect(&rw, green, NULL, TRUE);
+	it_b("writing through the quote changes its source",
+	     CheckColor(&b, 10, 10, green), TRUE);
+	it_b("writing through the quote keeps the other copy",
+	     CheckColor(&a, 10, 10, red), TRUE);
+
+	Graph_Copy(&part, &ro);
+	it_b("copying a part of the graph makes a unique graph",
+	     Graph_IsShared(&part) == FALSE && part.width == 16, TRUE);
+	it_b("the partial copy has the quoted pixels",
+	     CheckColor(&part, 0, 0, green), TRUE);
+
+	Graph_Free(&ro);
+	Graph_Free(&rw);
+	Graph_Free(&part);
+	Graph_Free(&a);
+	Graph_Free(&b);
+}
+
+static void test_write_shared(void)
+{
+	uchar_t alpha[WIDTH * HEIGHT] = { 0 };
+	LCUI_Graph a, b;
+	LCUI_Color red = ARGB(255, 255, 0, 0);
+	LCUI_Rect rect = { 0, 0, 8, 8 };
+
+	CreateGraph(&a, red);
+	Graph_Init(&b);
+
+	Graph_Copy(&b, &a);
+	Graph_Create(&b, WIDTH / 2, HEIGHT / 2);
+	it_b("recreating a shared graph does not clear the other copy",
+	     a.bytes != b.bytes && CheckColor(&a, 0, 0, red), TRUE);
+
+	Graph_Copy(&b, &a);
+	Graph_SetAlphaBits(&b, alpha, WIDTH * HEIGHT);
+	it_b("setting the alpha bits detaches the pixel data",
+	     a.bytes != b.bytes && CheckColor(&a, 0, 0, red), TRUE);
+
+	Graph_Copy(&b, &a);
+	Graph_CopyRect(&b, &rect, 16, 16);
+	it_b("copying a rect detaches the pixel data", a.bytes != b.bytes,
+	     TRUE);
+
+	Graph_Copy(&b, &a);
+	Graph_SetColorType(&b, LCUI_COLOR_TYPE_RGB);
+	it_b("converting the color type keeps the other copy",
+	     a.color_type == LCUI_COLOR_TYPE_ARGB &&
+		 CheckColor(&a, 0, 0, red),
+	     TRUE);
+	it_b("the converted graph has the same color",
+	     b.color_type == LCUI_COLOR_TYPE_RGB &&
+		 b.bytes_per_row == WIDTH * 3 &&
+		 CheckColor(&b, WIDTH - 1, HEIGHT - 1, red),
+	     TRUE);
+	Graph_Free(&a);
+	Graph_Free(&b);
+}
+
+void test_graph_buffer(void)
+{
+	describe("copy on write", test_copy_on_write);
+	describe("quote shared graph", test_quote);
+	describe("write shared graph", test_write_shared);
+}
@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/image.h>
+
+#define CACHE_DIR "test_image_cache_bench"
+#define ASSETS 16
+#define ASSET_WIDTH 512
+#define ASSET_HEIGHT 512
+
+static volatile unsigned checksum = 0;
+
+/** Generate a set of assets like icons and backgrounds of an application */
+static void CreateAssets(void)
+{
+	int i, x, y;
+	char file[64];
+	LCUI_Color color;
+	LCUI_Graph img;
+
+	for (i = 0; i < ASSETS; ++i) {
+		Graph_Init(&img);
+		img.color_type = LCUI_COLOR_TYPE_ARGB;
+		Graph_Create(&img, ASSET_WIDTH, ASSET_HEIGHT);
+		for (y = 0; y < ASSET_HEIGHT; ++y) {
+			for (x = 0; x < ASSET_WIDTH; ++x) {
+				color.r = (uchar_t)(x + i * 16);
+				color.g = (uchar_t)(y ^ x);
+				color.b = (uchar_t)(y - i * 8);
+				color.a = (uchar_t)(i % 2 ? 255 : x / 2);
+				Graph_SetPixel(&img, x, y, color);
+			}
+		}
+		sprintf(file, "test_image_cache_bench_%d.png", i);
+		LCUI_WritePNGFile(file, &img);
+		Graph_Free(&img);
+	}
+}
+
+static void RemoveAssets(void)
+{
+	int i;
+	char file[64], path[512];
+
+	LCUI_SetImageCacheDir(CACHE_DIR);
+	for (i = 0; i < ASSETS; ++i) {
+		sprintf(file, "test_image_cache_bench_%d.png", i);
+		if (LCUI_GetImageCacheFilePath(file, path, 512) == 0) {
+			remove(path);
+		}
+		remove(file);
+		sprintf(file, "test_image_cache_bench_%d.lcri", i);
+		remove(file);
+	}
+	LCUI_SetImageCacheDir(NULL);
+	remove(CACHE_DIR);
+}
+
+/**
+ * Load all assets like the startup of an application, return the time in ms
+ * The pixels are read once, so that the lazily mapped pages are counted
+ */
+static double LoadAssets(int (*load)(const char *, LCUI_Graph *))
+{
+	int i;
+	size_t j;
+	unsigned sum = 0;
+	char file[64];
+	int64_t start;
+	LCUI_Graph imgs[ASSETS];
+
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < ASSETS; ++i) {
+		Graph_Init(&imgs[i]);
+		sprintf(file, "test_image_cache_bench_%d.png", i);
+		if (load(file, &imgs[i]) != 0) {
+			Logger_Error("cannot load %s\n", file);
+			continue;
+		}
+		for (j = 0; j < imgs[i].mem_size; j += 64) {
+			sum += imgs[i].bytes[j];
+		}
+	}
+	start = LCUI_GetTimeNs() - start;
+	checksum += sum;
+	for (i = 0; i < ASSETS; ++i) {
+		Graph_Free(&imgs[i]);
+	}
+	return start / 1000000.0;
+}
+
+static double CacheAssets(void)
+{
+	int i;
+	char file[64];
+	int64_t start;
+
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < ASSETS; ++i) {
+		sprintf(file, "test_image_cache_bench_%d.png", i);
+		LCUI_CacheImageFile(file);
+	}
+	return (LCUI_GetTimeNs() - start) / 1000000.0;
+}
+
+static int ReadRLEFile(const char *filepath, LCUI_Graph *out)
+{
+	int ret;
+	char file[64];
+
+	Graph_Init(out);
+	sprintf(file, "%.*s.lcri", (int)strlen(filepath) - 4, filepath);
+	ret = LCUI_ReadRawImageFile(file, out, NULL);
+	if (ret == 0) {
+		return 0;
+	}
+	ret = LCUI_DecodeImageFile(filepath, out);
+	if (ret == 0) {
+		ret = LCUI_WriteRawImageFile(file, out, LCUI_RAW_IMAGE_RLE,
+					     NULL);
+	}
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	double decode, populate, warm, rle;
+
+	RemoveAssets();
+	CreateAssets();
+	decode = LoadAssets(LCUI_DecodeImageFile);
+	LCUI_SetImageCacheDir(CACHE_DIR);
+	populate = CacheAssets();
+	warm = LoadAssets(LCUI_ReadImageFile);
+	LoadAssets(ReadRLEFile);
+	rle = LoadAssets(ReadRLEFile);
+	LCUI_SetImageCacheDir(NULL);
+	RemoveAssets();
+	Logger_Info("load %d PNG assets of %dx%d\n", ASSETS, ASSET_WIDTH,
+		    ASSET_HEIGHT);
+	Logger_Info("%-32s%-12s\n", "method", "time(ms)");
+	Logger_Info("%-32s%-12.2f\n", "cold start (decode)", decode);
+	Logger_Info("%-32s%-12.2f\n", "populate cache (install)", populate);
+	Logger_Info("%-32s%-12.2f\n", "warm start (mapped cache)", warm);
+	Logger_Info("%-32s%-12.2f\n", "warm start (RLE raw files)", rle);
+	return 0;
+}
@@ -1,4 +1,6 @@
 ﻿#include <stdio.h>
+#include <string.h>
+#include <errno.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
@@ -7,7 +9,128 @@
 #include "test.h"
 #include "libtest.h"
 
-void test_image_reader(void)
+#define CACHE_DIR "test_image_cache"
+#define RAW_FILE "test_image_reader.lcri"
+
+static LCUI_BOOL CompareGraph(LCUI_Graph *a, LCUI_Graph *b)
+{
+	unsigned y;
+
+	if (a->width != b->width || a->height != b->height ||
+	    a->color_type != b->color_type) {
+		return FALSE;
+	}
+	for (y = 0; y < a->height; ++y) {
+		if (memcmp(a->bytes + y * a->bytes_per_row,
+			   b->bytes + y * b->bytes_per_row,
+			   a->bytes_per_row) != 0) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/** Remove the cache files of the test images and the cache directory */
+static void RemoveCacheDir(void)
+{
+	int i;
+	char path[512];
+	const char *files[] = { "test_image_reader.png",
+				"test_image_reader.bmp",
+				"test_image_reader.jpg" };
+
+	LCUI_SetImageCacheDir(CACHE_DIR);
+	for (i = 0; i < 3; ++i) {
+		if (LCUI_GetImageCacheFilePath(files[i], path, 512) == 0) {
+			remove(path);
+		}
+	}
+	LCUI_SetImageCacheDir(NULL);
+	remove(CACHE_DIR);
+}
+
+static void test_raw_image_file(void)
+{
+	int i;
+	LCUI_Graph img, raw;
+	LCUI_RawImageSourceRec source = { "test_image_reader.png", 1, 2 };
+	LCUI_RawImageSourceRec other = { "test_image_reader.png", 1, 3 };
+	const char *names[] = { "uncompressed", "RLE compressed" };
+	int types[] = { LCUI_RAW_IMAGE_UNCOMPRESSED, LCUI_RAW_IMAGE_RLE };
+	char name[256];
+
+	Graph_Init(&img);
+	LCUI_DecodeImageFile("test_image_reader.png", &img);
+	/* Add some runs of identical pixels for the RLE encoder */
+	Graph_FillRect(&img, ARGB(255, 255, 0, 0), NULL, FALSE);
+	for (i = 0; i < 2; ++i) {
+		Graph_Init(&raw);
+		sprintf(name, "write an %s raw image file", names[i]);
+		it_i(name, LCUI_WriteRawImageFile(RAW_FILE, &img, types[i],
+						  &source),
+		     0);
+		sprintf(name, "read an %s raw image file", names[i]);
+		it_i(name, LCUI_ReadRawImageFile(RAW_FILE, &raw, &source), 0);
+		sprintf(name, "the pixels of the %s raw image are same",
+			names[i]);
+		it_b(name, CompareGraph(&img, &raw), TRUE);
+		Graph_Free(&raw);
+		sprintf(name, "an %s raw image file of another source is "
+			"rejected", names[i]);
+		it_i(name, LCUI_ReadRawImageFile(RAW_FILE, &raw, &other),
+		     -EINVAL);
+	}
+	Graph_Init(&raw);
+	LCUI_WriteRawImageFile(RAW_FILE, &img, LCUI_RAW_IMAGE_UNCOMPRESSED,
+			       NULL);
+	LCUI_ReadRawImageFile(RAW_FILE, &raw, NULL);
+	Graph_FillRect(&raw, ARGB(255, 0, 0, 255), NULL, TRUE);
+	Graph_Free(&raw);
+	Graph_Init(&raw);
+	LCUI_ReadRawImageFile(RAW_FILE, &raw, NULL);
+	it_b("writing a loaded raw image does not change the file",
+	     CompareGraph(&img, &raw), TRUE);
+	Graph_Free(&raw);
+	Graph_Free(&img);
+	remove(RAW_FILE);
+}
+
+static void test_image_cache(void)
+{
+	LCUI_Graph img, cached;
+	const char *file = "test_image_reader.jpg";
+
+	Graph_Init(&img);
+	Graph_Init(&cached);
+	RemoveCacheDir();
+	LCUI_DecodeImageFile(file, &img);
+	it_i("set the image cache directory",
+	     LCUI_SetImageCacheDir(CACHE_DIR), 0);
+	it_b("the image is not cached yet",
+	     LCUI_ReadCachedImageFile(file, &cached) != 0, TRUE);
+	it_i("read the image and write it to the cache",
+	     LCUI_ReadImageFile(file, &cached), 0);
+	Graph_Free(&cached);
+	it_i("read the image from the cache",
+	     LCUI_ReadCachedImageFile(file, &cached), 0);
+	it_b("the cached image has the same pixels", CompareGraph(&img, &cached),
+	     TRUE);
+	Graph_Free(&cached);
+	it_i("cache an image file in advance",
+	     LCUI_CacheImageFile("test_image_reader.bmp"), 0);
+	it_i("read the image cached in advance",
+	     LCUI_ReadCachedImageFile("test_image_reader.bmp", &cached), 0);
+	Graph_Free(&cached);
+	it_b("an image file that does not exist can not be cached",
+	     LCUI_CacheImageFile("test_image_reader.gif") != 0, TRUE);
+	LCUI_SetImageCacheDir(NULL);
+	it_b("the cache is not used after it is disabled",
+	     LCUI_ReadCachedImageFile(file, &cached) != 0, TRUE);
+	Graph_Free(&img);
+	RemoveCacheDir();
+}
+
+static void test_image_file(void)
 {
 	LCUI_Graph img;
 	int i, width, height;
@@ -30,3 +153,10 @@ void test_image_reader(void)
 		Graph_Free(&img);
 	}
 }
+
+void test_image_reader(void)
+{
+	describe("image file", test_image_file);
+	describe("raw image file", test_raw_image_file);
+	describe("image cache", test_image_cache);
+}
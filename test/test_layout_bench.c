@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+
+#define ITEMS 5000
+#define REFLOWS 200
+
+/** Create a grid of items, like a gallery or a list of icons */
+static LCUI_Widget CreateGrid(const char *display, const char *item_display)
+{
+	int i;
+	LCUI_Widget box, w;
+
+	box = LCUIWidget_New(NULL);
+	Widget_SetStyleString(box, "display", display);
+	Widget_SetStyleString(box, "flex-wrap", "wrap");
+	Widget_SetStyleString(box, "width", "1000px");
+	for (i = 0; i < ITEMS; ++i) {
+		w = LCUIWidget_New(NULL);
+		Widget_SetStyleString(w, "display", item_display);
+		Widget_SetStyleString(w, "width", "48px");
+		Widget_SetStyleString(w, "height", "48px");
+		Widget_SetStyleString(w, "margin", "2px");
+		Widget_Append(box, w);
+	}
+	Widget_Append(LCUIWidget_GetRoot(), box);
+	LCUIWidget_Update();
+	return box;
+}
+
+/** Return the time per reflow in ms */
+static double Reflow(LCUI_Widget box)
+{
+	int i;
+	int64_t start;
+
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < REFLOWS; ++i) {
+		Widget_Reflow(box, LCUI_LAYOUT_RULE_AUTO);
+	}
+	return (LCUI_GetTimeNs() - start) / 1000000.0 / REFLOWS;
+}
+
+int main(int argc, char **argv)
+{
+	double block, flex;
+	LCUI_Widget block_grid, flex_grid;
+
+	LCUI_Init();
+	block_grid = CreateGrid("block", "inline-block");
+	flex_grid = CreateGrid("flex", "block");
+	block = Reflow(block_grid);
+	flex = Reflow(flex_grid);
+	Logger_Info("reflow a grid of %d items in a 1000px wide box\n", ITEMS);
+	Logger_Info("%-32s%-12s\n", "layout", "time(ms)");
+	Logger_Info("%-32s%-12.3f\n", "block (inline-block items)", block);
+	Logger_Info("%-32s%-12.3f\n", "flex (flex-wrap: wrap)", flex);
+	Logger_Info("the last item is at (%g, %g) and (%g, %g)\n",
+		    Widget_GetChild(block_grid, ITEMS - 1)->x,
+		    Widget_GetChild(block_grid, ITEMS - 1)->y,
+		    Widget_GetChild(flex_grid, ITEMS - 1)->x,
+		    Widget_GetChild(flex_grid, ITEMS - 1)->y);
+	LCUI_Destroy();
+	return 0;
+}
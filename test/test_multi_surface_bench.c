@@ -0,0 +1,246 @@
+#define LCUI_SURFACE_C
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/painter.h>
+#include <LCUI/display.h>
+#include <LCUI/settings.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+
+#define MAX_WINDOWS 8
+#define WINDOW_WIDTH 640
+#define WINDOW_HEIGHT 480
+#define FRAMES 20
+
+/** A surface in memory, the presentation copies it like a blit */
+typedef struct LCUI_SurfaceRec_ {
+	int width, height;
+	LCUI_Graph fb;
+	LCUI_Graph front;
+} MemorySurfaceRec, *MemorySurface;
+
+static int MemoryDisplay_GetWidth(void)
+{
+	return 1920;
+}
+
+static int MemoryDisplay_GetHeight(void)
+{
+	return 1080;
+}
+
+static LCUI_Surface MemorySurface_New(void)
+{
+	MemorySurface surface = calloc(1, sizeof(MemorySurfaceRec));
+
+	Graph_Init(&surface->fb);
+	Graph_Init(&surface->front);
+	surface->fb.color_type = LCUI_COLOR_TYPE_ARGB;
+	surface->front.color_type = LCUI_COLOR_TYPE_ARGB;
+	return surface;
+}
+
+static void MemorySurface_Close(LCUI_Surface surface)
+{
+	Graph_Free(&surface->fb);
+	Graph_Free(&surface->front);
+	free(surface);
+}
+
+static void MemorySurface_Resize(LCUI_Surface surface, int w, int h)
+{
+	surface->width = w;
+	surface->height = h;
+	Graph_Create(&surface->fb, w, h);
+	Graph_Create(&surface->front, w, h);
+}
+
+static void MemorySurface_Present(LCUI_Surface surface)
+{
+	memcpy(surface->front.bytes, surface->fb.bytes, surface->fb.mem_size);
+}
+
+static LCUI_BOOL MemorySurface_IsReady(LCUI_Surface surface)
+{
+	return surface->fb.bytes != NULL;
+}
+
+static LCUI_PaintContext MemorySurface_BeginPaint(LCUI_Surface surface,
+						  LCUI_Rect *rect)
+{
+	LCUI_PaintContext paint = malloc(sizeof(LCUI_PaintContextRec));
+
+	paint->rect = *rect;
+	paint->with_alpha = FALSE;
+	Graph_Init(&paint->canvas);
+	LCUIRect_ValidateArea(&paint->rect, surface->width, surface->height);
+	Graph_Quote(&paint->canvas, &surface->fb, &paint->rect);
+	Graph_FillRect(&paint->canvas, RGB(255, 255, 255), NULL, TRUE);
+	return paint;
+}
+
+static void MemorySurface_EndPaint(LCUI_Surface surface,
+				   LCUI_PaintContext paint)
+{
+	free(paint);
+}
+
+static int MemorySurface_CopyRect(LCUI_Surface surface, LCUI_Rect *rect,
+				  int x, int y)
+{
+	return -1;
+}
+
+static int MemorySurface_GetWidth(LCUI_Surface surface)
+{
+	return surface->width;
+}
+
+static int MemorySurface_GetHeight(LCUI_Surface surface)
+{
+	return surface->height;
+}
+
+static void *MemorySurface_GetHandle(LCUI_Surface surface)
+{
+	return surface;
+}
+
+static void MemorySurface_Nop(LCUI_Surface surface)
+{
+}
+
+static void MemorySurface_Move(LCUI_Surface surface, int x, int y)
+{
+}
+
+static void MemorySurface_SetCaptionW(LCUI_Surface surface,
+				      const wchar_t *str)
+{
+}
+
+static void MemorySurface_SetRenderMode(LCUI_Surface surface, int mode)
+{
+}
+
+static void MemorySurface_SetOpacity(LCUI_Surface surface, float opacity)
+{
+}
+
+static int MemoryDisplay_BindEvent(int event_id, LCUI_EventFunc func,
+				   void *data, void (*destroy_data)(void *))
+{
+	return 0;
+}
+
+static LCUI_DisplayDriverRec driver = {
+	"memory",
+	MemoryDisplay_GetWidth,
+	MemoryDisplay_GetHeight,
+	MemorySurface_New,
+	MemorySurface_Close,
+	MemorySurface_Close,
+	MemorySurface_Resize,
+	MemorySurface_Move,
+	MemorySurface_Nop,
+	MemorySurface_Nop,
+	MemorySurface_Nop,
+	MemorySurface_Present,
+	MemorySurface_IsReady,
+	MemorySurface_BeginPaint,
+	MemorySurface_EndPaint,
+	MemorySurface_CopyRect,
+	MemorySurface_SetCaptionW,
+	MemorySurface_SetRenderMode,
+	MemorySurface_GetHandle,
+	MemorySurface_GetWidth,
+	MemorySurface_GetHeight,
+	MemorySurface_SetOpacity,
+	MemoryDisplay_BindEvent
+};
+
+static LCUI_Widget CreateWindow(void)
+{
+	int i;
+	LCUI_Widget window, item, text;
+
+	window = LCUIWidget_New(NULL);
+	Widget_SetStyleString(window, "position", "absolute");
+	Widget_SetStyleString(window, "background-color", "#fff");
+	Widget_SetStyleString(window, "padding", "10px");
+	Widget_SetStyleString(window, "box-sizing", "border-box");
+	Widget_Resize(window, WINDOW_WIDTH, WINDOW_HEIGHT);
+	for (i = 0; i < 60; ++i) {
+		item = LCUIWidget_New(NULL);
+		text = LCUIWidget_New("textview");
+		Widget_SetStyleString(item, "display", "inline-block");
+		Widget_SetStyleString(item, "background-color", "#eef");
+		Widget_SetStyleString(item, "border", "1px solid #88a");
+		Widget_SetStyleString(item, "border-radius", "4px");
+		Widget_SetStyleString(item, "box-shadow",
+				      "0 2px 4px rgba(0,0,0,0.2)");
+		Widget_SetStyleString(item, "margin", "4px");
+		Widget_Resize(item, 96, 48);
+		TextView_SetText(text, "list item");
+		Widget_Append(item, text);
+		Widget_Append(window, item);
+	}
+	return window;
+}
+
+/** Repaint all windows, return the average frame time in ms */
+static double RunBench(int n_windows, int threads)
+{
+	int i, frame;
+	int64_t start;
+	LCUI_SettingsRec settings;
+	LCUI_Widget windows[MAX_WINDOWS];
+
+	Settings_Init(&settings);
+	settings.parallel_rendering_threads = threads;
+	LCUI_ApplySettings(&settings);
+	for (i = 0; i < n_windows; ++i) {
+		windows[i] = CreateWindow();
+		Widget_Append(LCUIWidget_GetRoot(), windows[i]);
+	}
+	/* Bind the surfaces and render the first frame */
+	LCUI_RunFrame();
+	LCUI_RunFrame();
+	start = LCUI_GetTimeNs();
+	for (frame = 0; frame < FRAMES; ++frame) {
+		for (i = 0; i < n_windows; ++i) {
+			Widget_InvalidateArea(windows[i], NULL, SV_GRAPH_BOX);
+		}
+		LCUI_RunFrame();
+	}
+	start = LCUI_GetTimeNs() - start;
+	for (i = 0; i < n_windows; ++i) {
+		Widget_Destroy(windows[i]);
+	}
+	LCUI_RunFrame();
+	return start / 1000000.0 / FRAMES;
+}
+
+int main(int argc, char **argv)
+{
+	int n;
+
+	LCUI_Init();
+	/* Replace the platform display with the memory display */
+	LCUI_FreeDisplay();
+	LCUI_InitDisplay(&driver);
+	LCUIDisplay_SetMode(LCUI_DMODE_SEAMLESS);
+	Logger_Info("repaint %d frames of windows of %dx%d in seamless mode\n",
+		    FRAMES, WINDOW_WIDTH, WINDOW_HEIGHT);
+	Logger_Info("%-12s%-16s%-16s\n", "windows", "1 thread", "4 threads");
+	for (n = 1; n <= MAX_WINDOWS; n *= 2) {
+		Logger_Info("%-12d%-16.2f%-16.2f\n", n, RunBench(n, 1),
+			    RunBench(n, 4));
+	}
+	Logger_Info("(time in ms per frame)\n");
+	return 0;
+}
@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/metrics.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+#include <LCUI/painter.h>
+#include <LCUI/font.h>
+#include <LCUI/thread.h>
+#include "test.h"
+#include "libtest.h"
+
+#define GLYPH_THREADS 4
+#define GLYPH_SIZE 37
+
+static int scale_changes;
+static const LCUI_FontBitmap *glyph_bitmaps[GLYPH_THREADS];
+
+static void OnScaleChange(LCUI_SysEvent e, void *arg)
+{
+	scale_changes += 1;
+}
+
+static void test_scale_change_event(void)
+{
+	int id;
+	unsigned generation = LCUIMetrics_GetScaleGeneration();
+
+	scale_changes = 0;
+	id = LCUI_BindEvent(LCUI_SCALE_CHANGE, OnScaleChange, NULL, NULL);
+	LCUIMetrics_SetScale(1.5f);
+	it_i("the event is triggered once", scale_changes, 1);
+	it_b("the generation is increased",
+	     LCUIMetrics_GetScaleGeneration() == generation + 1, TRUE);
+	LCUIMetrics_SetScale(1.5f);
+	it_i("setting the same scale does not trigger the event",
+	     scale_changes, 1);
+	LCUIMetrics_SetScale(10.0f);
+	LCUIMetrics_SetScale(5.0f);
+	it_i("setting the same clamped scale does not trigger the event",
+	     scale_changes, 2);
+	LCUIMetrics_SetScale(1.0f);
+	it_b("the generation is increased for each change",
+	     LCUIMetrics_GetScaleGeneration() == generation + 3, TRUE);
+	LCUI_UnbindEvent(id);
+}
+
+static void test_text_scale(void)
+{
+	float width;
+	LCUI_Widget txt;
+
+	txt = LCUIWidget_New("textview");
+	Widget_SetStyleString(txt, "display", "inline-block");
+	Widget_SetStyleString(txt, "font-size", "16px");
+	TextView_SetText(txt, "hello");
+	Widget_Append(LCUIWidget_GetRoot(), txt);
+	LCUIWidget_Update();
+	width = txt->width;
+	it_b("the text has a width", width > 0, TRUE);
+
+	LCUIMetrics_SetScale(2.0f);
+	LCUIWidget_Update();
+	/* Lay out the text again, the scaled font should have the same width */
+	Widget_AddTask(txt, LCUI_WTASK_REFLOW);
+	LCUIWidget_Update();
+	it_b("the text keeps its width after the scale is changed",
+	     txt->width > width - 2 && txt->width < width + 2, TRUE);
+	it_i("the glyphs of a shown text are pre-rendered",
+	     (int)LCUIWidget_PrerenderTextView(), 5);
+
+	Widget_Hide(txt);
+	LCUIWidget_Update();
+	it_i("the glyphs of a hidden text are not pre-rendered",
+	     (int)LCUIWidget_PrerenderTextView(), 0);
+	LCUIMetrics_SetScale(1.0f);
+	Widget_Destroy(txt);
+}
+
+/** Count the red border pixels and the painted width in the middle row */
+static int CountBorderPixels(LCUI_Widget w, int *width)
+{
+	int x, count = 0;
+	float scale = LCUIMetrics_GetScale();
+	LCUI_Graph canvas;
+	LCUI_Color color;
+	LCUI_Rect rect = { 0, 0, 0, 0 };
+	LCUI_PaintContext paint;
+
+	rect.width = (int)(w->width * scale + 0.5f);
+	rect.height = (int)(w->height * scale + 0.5f);
+	Graph_Init(&canvas);
+	canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&canvas, rect.width, rect.height);
+	paint = LCUIPainter_Begin(&canvas, &rect);
+	Widget_Render(w, paint);
+	LCUIPainter_End(paint);
+	*width = 0;
+	for (x = 0; x < rect.width; ++x) {
+		Graph_GetPixel(&canvas, x, rect.height / 2, color);
+		if (color.r > 0 || color.g > 0 || color.b > 0) {
+			*width = x + 1;
+		}
+		if (color.r > 200 && color.g < 50 && color.b < 50) {
+			++count;
+		}
+	}
+	Graph_Free(&canvas);
+	return count;
+}
+
+static void test_box_scale(void)
+{
+	int width;
+	LCUI_Widget box;
+
+	box = LCUIWidget_New(NULL);
+	Widget_SetStyleString(box, "width", "40px");
+	Widget_SetStyleString(box, "height", "20px");
+	Widget_SetStyleString(box, "background-color", "#fff");
+	Widget_SetStyleString(box, "border", "2px solid #f00");
+	Widget_Append(LCUIWidget_GetRoot(), box);
+	LCUIWidget_Update();
+	it_i("the left and right borders are painted at scale 1",
+	     CountBorderPixels(box, &width), 4);
+	it_i("the box is painted at its size at scale 1", width, 44);
+
+	LCUIMetrics_SetScale(2.0f);
+	LCUIWidget_Update();
+	it_b("the computed border keeps its width in px",
+	     box->computed_style.border.left.width == 2, TRUE);
+	it_b("the computed size keeps its value in px",
+	     box->width == 44 && box->height == 24, TRUE);
+	it_i("the borders are painted twice as wide at scale 2",
+	     CountBorderPixels(box, &width), 8);
+	it_i("the box is painted twice as wide at scale 2", width, 88);
+
+	Widget_SetStyleString(box, "border", "3px solid #f00");
+	LCUIWidget_Update();
+	it_i("a border changed at scale 2 is painted at the new scale",
+	     CountBorderPixels(box, &width), 12);
+	LCUIMetrics_SetScale(1.0f);
+	LCUIWidget_Update();
+	it_i("the borders follow the scale back to 1",
+	     CountBorderPixels(box, &width), 6);
+	Widget_Destroy(box);
+}
+
+static void GlyphThread(void *arg)
+{
+	int i = *(int *)arg;
+
+	LCUIFont_GetBitmap(L'Q', 0, GLYPH_SIZE, &glyph_bitmaps[i]);
+	LCUIThread_Exit(NULL);
+}
+
+static void test_glyph_threads(void)
+{
+	int i, same = 0;
+	int ids[GLYPH_THREADS];
+	LCUI_Thread threads[GLYPH_THREADS];
+	const LCUI_FontBitmap *bmp;
+
+	for (i = 0; i < GLYPH_THREADS; ++i) {
+		ids[i] = i;
+		glyph_bitmaps[i] = NULL;
+		LCUIThread_Create(&threads[i], GlyphThread, &ids[i]);
+	}
+	for (i = 0; i < GLYPH_THREADS; ++i) {
+		LCUIThread_Join(threads[i], NULL);
+	}
+	LCUIFont_GetBitmap(L'Q', 0, GLYPH_SIZE, &bmp);
+	for (i = 0; i < GLYPH_THREADS; ++i) {
+		if (glyph_bitmaps[i] == bmp) {
+			same += 1;
+		}
+	}
+	it_b("the glyph is rendered", bmp && bmp->buffer, TRUE);
+	it_i("threads rendering the same glyph share one cached bitmap",
+	     same, GLYPH_THREADS);
+}
+
+void test_scale_change(void)
+{
+	LCUI_Init();
+	describe("scale change event", test_scale_change_event);
+	describe("text scale", test_text_scale);
+	describe("box scale", test_box_scale);
+	describe("glyph rendering on threads", test_glyph_threads);
+	LCUI_Destroy();
+}
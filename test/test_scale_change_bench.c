@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/metrics.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+
+#define ROWS 60
+#define BOXES_PER_ROW 16
+#define TEXT_LENGTH 64
+#define TOGGLES 20
+
+static LCUI_Widget texts[ROWS];
+
+static void CreatePage(void)
+{
+	int i, j;
+	LCUI_Widget root, row, box;
+
+	root = LCUIWidget_GetRoot();
+	for (i = 0; i < ROWS; ++i) {
+		row = LCUIWidget_New(NULL);
+		Widget_SetStyleString(row, "padding", "2px");
+		Widget_SetStyleString(row, "border", "1px solid #eee");
+		for (j = 0; j < BOXES_PER_ROW; ++j) {
+			box = LCUIWidget_New(NULL);
+			Widget_SetStyleString(box, "display", "inline-block");
+			Widget_SetStyleString(box, "width", "8px");
+			Widget_SetStyleString(box, "height", "8px");
+			Widget_SetStyleString(box, "margin-right", "2px");
+			Widget_SetStyleString(box, "background-color", "#f00");
+			Widget_Append(row, box);
+		}
+		texts[i] = LCUIWidget_New("textview");
+		Widget_SetStyleString(texts[i], "font-size", "14px");
+		Widget_Append(row, texts[i]);
+		Widget_Append(root, row);
+	}
+}
+
+/** Set texts with the given first char, so that their glyphs are not cached */
+static void SetTexts(wchar_t first_char)
+{
+	int i, j;
+	wchar_t text[TEXT_LENGTH + 1];
+
+	for (i = 0; i < ROWS; ++i) {
+		for (j = 0; j < TEXT_LENGTH; ++j) {
+			text[j] = j % 8 == 7 ? L' ' : first_char + (i + j) % 26;
+		}
+		text[TEXT_LENGTH] = 0;
+		TextView_SetTextW(texts[i], text);
+	}
+}
+
+/** The previous pipeline: all widgets were restyled after the scale changed */
+static void SetScaleAndRefreshAll(float scale)
+{
+	LCUIMetrics_SetScale(scale);
+	LCUIWidget_RefreshStyle();
+}
+
+typedef struct FrameTimeRec_ {
+	double update;
+	double frame;
+} FrameTimeRec;
+
+/** Change the scale, get the time to update widgets and the first frame */
+static void Measure(void (*set_scale)(float), float scale, FrameTimeRec *t)
+{
+	int64_t start, update;
+	LCUI_Graph frame;
+
+	Graph_Init(&frame);
+	start = LCUI_GetTimeNs();
+	set_scale(scale);
+	LCUIWidget_Update();
+	update = LCUI_GetTimeNs();
+	Widget_RenderToGraph(LCUIWidget_GetRoot(), scale, NULL, &frame);
+	t->update += (update - start) / 1000000.0;
+	t->frame += (LCUI_GetTimeNs() - start) / 1000000.0;
+	Graph_Free(&frame);
+}
+
+static void MeasureToggles(void (*set_scale)(float), FrameTimeRec *t)
+{
+	int i;
+
+	for (i = 0; i < TOGGLES; ++i) {
+		Measure(set_scale, i % 2 ? 1.0f : 1.5f, t);
+	}
+	t->update /= TOGGLES;
+	t->frame /= TOGGLES;
+}
+
+int main(int argc, char **argv)
+{
+	FrameTimeRec tmp = { 0 };
+	FrameTimeRec cold_legacy = { 0 }, cold = { 0 };
+	FrameTimeRec warm_legacy = { 0 }, warm = { 0 };
+
+	LCUI_Init();
+	Widget_Resize(LCUIWidget_GetRoot(), 800, 600);
+	CreatePage();
+	SetTexts(L'a');
+	Measure(LCUIMetrics_SetScale, 1.0f, &tmp);
+	Measure(SetScaleAndRefreshAll, 1.5f, &cold_legacy);
+
+	/* Use other glyphs, they are only cached at the scale of 1.0 */
+	Measure(LCUIMetrics_SetScale, 1.0f, &tmp);
+	SetTexts(L'A');
+	Measure(LCUIMetrics_SetScale, 1.0f, &tmp);
+	Measure(LCUIMetrics_SetScale, 1.5f, &cold);
+
+	MeasureToggles(SetScaleAndRefreshAll, &warm_legacy);
+	MeasureToggles(LCUIMetrics_SetScale, &warm);
+
+	Logger_Info("change the scale of a page of %d widgets with %d texts\n",
+		    ROWS * (BOXES_PER_ROW + 2), ROWS);
+	Logger_Info("%-36s%-12s%-16s\n", "case", "update(ms)",
+		    "first frame(ms)");
+	Logger_Info("%-36s%-12.2f%-16.2f\n", "new scale (restyle all)",
+		    cold_legacy.update, cold_legacy.frame);
+	Logger_Info("%-36s%-12.2f%-16.2f\n", "new scale (scale change event)",
+		    cold.update, cold.frame);
+	Logger_Info("%-36s%-12.2f%-16.2f\n", "cached scale (restyle all)",
+		    warm_legacy.update, warm_legacy.frame);
+	Logger_Info("%-36s%-12.2f%-16.2f\n",
+		    "cached scale (scale change event)", warm.update,
+		    warm.frame);
+	LCUI_Destroy();
+	return 0;
+}
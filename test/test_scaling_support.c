@@ -19,8 +19,12 @@ static void OnButtonClick(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
 		LCUIMetrics_SetScaledDensityLevel(data[1]);
 		break;
 	case TYPE_SCALE:
+		/*
+		 * The widgets are restyled on the next update, and the screen
+		 * is invalidated by the scale change event
+		 */
 		LCUIMetrics_SetScale(data[1] / 100.0f);
-		break;
+		return;
 	}
 	LCUIWidget_RefreshStyle();
 	LCUIDisplay_InvalidateArea(NULL);
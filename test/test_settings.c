@@ -1,5 +1,6 @@
 ﻿#include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
 #include <LCUI/settings.h>
 #include <LCUI/main.h>
 #include <LCUI/timer.h>
@@ -36,6 +37,10 @@ static void test_default_settings(void)
 	it_i("check default frame rate cap", settings.frame_rate_cap, 120);
 	it_i("check default parallel rendering threads",
 	     settings.parallel_rendering_threads, 4);
+	it_i("check default parallel rendering cpu mask",
+	     (int)settings.parallel_rendering_cpu_mask, 0);
+	it_i("check default parallel rendering priority",
+	     settings.parallel_rendering_priority, LCUI_THREAD_PRIORITY_NORMAL);
 	it_b("check default record profile", settings.record_profile, FALSE);
 	it_b("check default fps meter", settings.fps_meter, FALSE);
 	it_b("check default paint flashing", settings.paint_flashing, FALSE);
@@ -51,6 +56,8 @@ static void test_apply_settings(void)
 
 	settings.frame_rate_cap = 60;
 	settings.parallel_rendering_threads = 2;
+	settings.parallel_rendering_cpu_mask = 3;
+	settings.parallel_rendering_priority = LCUI_THREAD_PRIORITY_HIGH;
 	settings.record_profile = TRUE;
 	settings.fps_meter = TRUE;
 	settings.paint_flashing = TRUE;
@@ -60,6 +67,10 @@ static void test_apply_settings(void)
 	it_i("check frame rate cap", settings.frame_rate_cap, 60);
 	it_i("check parallel rendering threads",
 	     settings.parallel_rendering_threads, 2);
+	it_i("check parallel rendering cpu mask",
+	     (int)settings.parallel_rendering_cpu_mask, 3);
+	it_i("check parallel rendering priority",
+	     settings.parallel_rendering_priority, LCUI_THREAD_PRIORITY_HIGH);
 	it_b("check record profile", settings.record_profile, TRUE);
 	it_b("check fps meter", settings.fps_meter, TRUE);
 	it_b("check paint flashing", settings.paint_flashing, TRUE);
@@ -68,12 +79,15 @@ static void test_apply_settings(void)
 
 	settings.frame_rate_cap = -1;
 	settings.parallel_rendering_threads = -1;
+	settings.parallel_rendering_priority = 100;
 
 	LCUI_ApplySettings(&settings);
 	Settings_Init(&settings);
 	it_i("check frame rate cap minimum", settings.frame_rate_cap, 1);
 	it_i("check parallel rendering threads minimum",
 	     settings.parallel_rendering_threads, 1);
+	it_i("check invalid parallel rendering priority",
+	     settings.parallel_rendering_priority, LCUI_THREAD_PRIORITY_NORMAL);
 	it_i("check settings change count", settings_change_count, 2);
 
 	LCUI_ResetSettings();
@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include "test.h"
+#include "libtest.h"
+
+#define FRAMES 60
+
+static void test_get_time_ns(void)
+{
+	int64_t start, delta;
+
+	start = LCUI_GetTimeNs();
+	LCUI_MSleep(20);
+	delta = LCUI_GetTimeNs() - start;
+	it_b("LCUI_GetTimeNs() is monotonic", delta > 0, TRUE);
+	it_b("LCUI_GetTimeNs() measures a 20ms sleep in [20ms, 100ms)",
+	     delta >= 20000000 && delta < 100000000, TRUE);
+}
+
+/**
+ * The frames do some work of varying duration, and the pacing is checked by
+ * the average interval. A loaded machine can only make frames late, so late
+ * frames are tolerated up to 25%, while frames ending early, which are caused
+ * by the millisecond rounding and accumulated errors, are tolerated up to 2%.
+ * The precise accuracy is reported by test_steptimer_bench.
+ */
+static void test_frame_pacing(unsigned int fps)
+{
+	int i;
+	char name[128];
+	size_t count;
+	int64_t start, elapsed, period, error;
+	int64_t intervals[FRAMES];
+	StepTimer timer;
+
+	period = 1000000000 / fps;
+	timer = StepTimer_Create();
+	StepTimer_SetFrameLimit(timer, fps);
+	StepTimer_Remain(timer);
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < FRAMES; ++i) {
+		LCUI_MSleep(i % 4);
+		StepTimer_Remain(timer);
+	}
+	elapsed = LCUI_GetTimeNs() - start;
+	count = StepTimer_GetFrameIntervals(timer, intervals, FRAMES);
+	StepTimer_Destroy(timer);
+
+	error = elapsed / FRAMES - period;
+	sprintf(name, "%u fps: the number of recorded frame intervals", fps);
+	it_i(name, (int)count, FRAMES);
+	sprintf(name, "%u fps: the average frame interval is close to "
+		"%ldus (error: %ldus)", fps, (long)(period / 1000),
+		(long)(error / 1000));
+	it_b(name, error > -period / 50 && error < period / 4, TRUE);
+	for (i = 0, elapsed = 0; i < (int)count; ++i) {
+		elapsed += intervals[i];
+	}
+	error = elapsed / FRAMES - period;
+	sprintf(name, "%u fps: the recorded frame intervals are close to "
+		"%ldus", fps, (long)(period / 1000));
+	it_b(name, error > -period / 50 && error < period / 4, TRUE);
+}
+
+static void test_frame_pacing_60fps(void)
+{
+	test_frame_pacing(60);
+}
+
+static void test_frame_pacing_144fps(void)
+{
+	test_frame_pacing(144);
+}
+
+void test_steptimer(void)
+{
+	describe("LCUI_GetTimeNs", test_get_time_ns);
+	describe("60 fps frame pacing", test_frame_pacing_60fps);
+	describe("144 fps frame pacing", test_frame_pacing_144fps);
+}
@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+
+#define FRAMES 300
+
+/** Report the average and worst frame interval error of the step timer */
+static void RunFramePacing(unsigned int fps)
+{
+	int i;
+	size_t count;
+	int64_t period, error, max_error;
+	int64_t intervals[FRAMES];
+	StepTimer timer;
+
+	period = 1000000000 / fps;
+	timer = StepTimer_Create();
+	StepTimer_SetFrameLimit(timer, fps);
+	StepTimer_Remain(timer);
+	for (i = 0; i < FRAMES; ++i) {
+		LCUI_MSleep(i % 4);
+		StepTimer_Remain(timer);
+	}
+	count = StepTimer_GetFrameIntervals(timer, intervals, FRAMES);
+	StepTimer_Destroy(timer);
+	for (i = 0, error = 0, max_error = 0; i < (int)count; ++i) {
+		error += intervals[i] - period;
+		if (intervals[i] - period > max_error) {
+			max_error = intervals[i] - period;
+		} else if (period - intervals[i] > max_error) {
+			max_error = period - intervals[i];
+		}
+	}
+	error /= (int64_t)count;
+	printf("%-8u%-16ld%-20ld%-20ld%.2f%%\n", fps, (long)(period / 1000),
+	       (long)(error / 1000), (long)(max_error / 1000),
+	       error * 100.0 / period);
+}
+
+int main(int argc, char **argv)
+{
+	printf("%-8s%-16s%-20s%-20s%s\n", "fps", "period(us)",
+	       "avg error(us)", "max error(us)", "avg error");
+	RunFramePacing(30);
+	RunFramePacing(60);
+	RunFramePacing(120);
+	RunFramePacing(144);
+	return 0;
+}
@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+
+#define OPS 1000000
+#define MAX_THREADS 8
+
+typedef enum BenchMode {
+	MODE_MUTEX,
+	MODE_FAST_MUTEX,
+	MODE_ATOMIC,
+	MODE_MUTEX_READ,
+	MODE_RWLOCK_READ,
+	MODE_SEQLOCK_READ,
+	MODE_TOTAL
+} BenchMode;
+
+static const char *mode_names[MODE_TOTAL] = {
+	"LCUI_Mutex", "LCUI_FastMutex", "atomic add",
+	"LCUI_Mutex (read 95%)", "LCUI_RWLock (read 95%)",
+	"LCUI_SeqLock (read 95%)"
+};
+
+/** Shared state, like a settings or a stats struct read by every thread */
+static struct BenchData {
+	BenchMode mode;
+	int ops;
+	LCUI_Mutex mutex;
+	LCUI_FastMutex fast_mutex;
+	LCUI_RWLock rwlock;
+	LCUI_SeqLock seqlock;
+	LCUI_AtomicInt atomic_value;
+	int values[4];
+	volatile int sum;
+} bench;
+
+static void ReadValues(void)
+{
+	bench.sum += bench.values[0] + bench.values[1] + bench.values[2] +
+		     bench.values[3];
+}
+
+static void WriteValues(void)
+{
+	bench.values[0] += 1;
+	bench.values[1] += 1;
+	bench.values[2] += 1;
+	bench.values[3] += 1;
+}
+
+static void BenchThread(void *arg)
+{
+	int i, seq;
+	LCUI_BOOL write;
+
+	for (i = 0; i < bench.ops; ++i) {
+		write = i % 20 == 0;
+		switch (bench.mode) {
+		case MODE_MUTEX:
+			LCUIMutex_Lock(&bench.mutex);
+			WriteValues();
+			LCUIMutex_Unlock(&bench.mutex);
+			break;
+		case MODE_FAST_MUTEX:
+			LCUIFastMutex_Lock(&bench.fast_mutex);
+			WriteValues();
+			LCUIFastMutex_Unlock(&bench.fast_mutex);
+			break;
+		case MODE_ATOMIC:
+			LCUIAtomic_Increment(&bench.atomic_value);
+			break;
+		case MODE_MUTEX_READ:
+			LCUIMutex_Lock(&bench.mutex);
+			write ? WriteValues() : ReadValues();
+			LCUIMutex_Unlock(&bench.mutex);
+			break;
+		case MODE_RWLOCK_READ:
+			if (write) {
+				LCUIRWLock_WriteLock(&bench.rwlock);
+				WriteValues();
+				LCUIRWLock_WriteUnlock(&bench.rwlock);
+				break;
+			}
+			LCUIRWLock_ReadLock(&bench.rwlock);
+			ReadValues();
+			LCUIRWLock_ReadUnlock(&bench.rwlock);
+			break;
+		case MODE_SEQLOCK_READ:
+			if (write) {
+				LCUISeqLock_WriteBegin(&bench.seqlock);
+				WriteValues();
+				LCUISeqLock_WriteEnd(&bench.seqlock);
+				break;
+			}
+			do {
+				seq = LCUISeqLock_ReadBegin(&bench.seqlock);
+				ReadValues();
+			} while (LCUISeqLock_ReadRetry(&bench.seqlock, seq));
+			break;
+		default:
+			break;
+		}
+	}
+	LCUIThread_Exit(NULL);
+}
+
+/** Run the benchmark, return the throughput in millions of operations/s */
+static double RunBench(BenchMode mode, int n_threads)
+{
+	int i;
+	int64_t start;
+	LCUI_Thread threads[MAX_THREADS];
+
+	bench.mode = mode;
+	bench.ops = OPS / n_threads;
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < n_threads; ++i) {
+		LCUIThread_Create(&threads[i], BenchThread, NULL);
+	}
+	for (i = 0; i < n_threads; ++i) {
+		LCUIThread_Join(threads[i], NULL);
+	}
+	start = LCUI_GetTimeNs() - start;
+	return 1000.0 * bench.ops * n_threads / start;
+}
+
+int main(int argc, char **argv)
+{
+	int mode;
+
+	LCUIMutex_Init(&bench.mutex);
+	LCUIFastMutex_Init(&bench.fast_mutex);
+	LCUIRWLock_Init(&bench.rwlock);
+	LCUISeqLock_Init(&bench.seqlock);
+	Logger_Info("%d operations on a shared struct\n", OPS);
+	Logger_Info("%-28s%-10s%-10s%-10s%-10s\n", "lock", "1", "2", "4",
+		    "8");
+	for (mode = 0; mode < MODE_TOTAL; ++mode) {
+		Logger_Info("%-28s%-10.1f%-10.1f%-10.1f%-10.1f\n",
+			    mode_names[mode], RunBench(mode, 1),
+			    RunBench(mode, 2), RunBench(mode, 4),
+			    RunBench(mode, 8));
+	}
+	Logger_Info("(throughput in Mops/s for 1, 2, 4 and 8 threads)\n");
+	LCUIMutex_Destroy(&bench.mutex);
+	return 0;
+}
@@ -1,11 +1,171 @@
+#include <stdlib.h>
+#include <wchar.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/font.h>
+#include <LCUI/painter.h>
 #include <LCUI/gui/widget.h>
 #include <LCUI/gui/widget/textedit.h>
+#include <LCUI/gui/css_parser.h>
 #include "test.h"
 #include "libtest.h"
 
+#define BULK_TEXT_LINES 20000
+
+static size_t bulk_loaded;
+static size_t bulk_progress_calls;
+static size_t text_changes;
+
+/** Count the red pixels of the caret in the middle row of the textedit */
+static int CountCaretPixels(LCUI_Widget w)
+{
+	int x, count = 0;
+	LCUI_Graph canvas;
+	LCUI_Color color;
+	LCUI_Rect rect = { 0, 0, 0, 0 };
+	LCUI_PaintContext paint;
+
+	rect.width = (int)w->width;
+	rect.height = (int)w->height;
+	Graph_Init(&canvas);
+	canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&canvas, rect.width, rect.height);
+	paint = LCUIPainter_Begin(&canvas, &rect);
+	Widget_Render(w, paint);
+	LCUIPainter_End(paint);
+	for (x = 0; x < rect.width; ++x) {
+		Graph_GetPixel(&canvas, x, rect.height / 2, color);
+		if (color.r > 200 && color.g < 50 && color.b < 50) {
+			++count;
+		}
+	}
+	Graph_Free(&canvas);
+	return count;
+}
+
+static void OnBulkProgress(LCUI_Widget w, size_t loaded, size_t total,
+			   void *arg)
+{
+	bulk_loaded = loaded;
+	bulk_progress_calls += 1;
+}
+
+static void OnTextChange(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	text_changes += 1;
+}
+
+static LCUI_BOOL CompareTextLayers(LCUI_TextLayer a, LCUI_TextLayer b)
+{
+	int i, j;
+	LCUI_TextRow row_a, row_b;
+
+	if (a->length != b->length || a->insert_x != b->insert_x ||
+	    a->insert_y != b->insert_y ||
+	    a->text_rows.length != b->text_rows.length) {
+		return FALSE;
+	}
+	for (i = 0; i < a->text_rows.length; ++i) {
+		row_a = a->text_rows.rows[i];
+		row_b = b->text_rows.rows[i];
+		if (row_a->length != row_b->length || row_a->eol != row_b->eol) {
+			return FALSE;
+		}
+		for (j = 0; j < row_a->length; ++j) {
+			if (row_a->string[j]->code != row_b->string[j]->code) {
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+static void test_textlayer_bulk(void)
+{
+	LCUI_TextLayer layer, bulk_layer;
+	const wchar_t *text = L"first\r\nsecond\rthird\n\nfourth";
+
+	layer = TextLayer_New();
+	bulk_layer = TextLayer_New();
+	TextLayer_EnableStyleTag(layer, FALSE);
+	TextLayer_EnableStyleTag(bulk_layer, FALSE);
+	TextLayer_AppendTextW(layer, L"hello, world!", NULL);
+	TextLayer_AppendTextBulkW(bulk_layer, L"hello, world!", 13);
+	it_b("check the appended text of the bulk path",
+	     CompareTextLayers(layer, bulk_layer), TRUE);
+
+	TextLayer_SetCaretPos(layer, 0, 7);
+	TextLayer_SetCaretPos(bulk_layer, 0, 7);
+	TextLayer_InsertTextW(layer, text, NULL);
+	TextLayer_InsertTextBulkW(bulk_layer, text, wcslen(text));
+	it_b("check the inserted rows of the bulk path",
+	     CompareTextLayers(layer, bulk_layer), TRUE);
+
+	TextLayer_AppendTextW(layer, L"\nlast", NULL);
+	TextLayer_AppendTextBulkW(bulk_layer, L"\nlast", 5);
+	it_b("check the appended rows of the bulk path",
+	     CompareTextLayers(layer, bulk_layer), TRUE);
+	TextLayer_Destroy(layer);
+	TextLayer_Destroy(bulk_layer);
+}
+
+static void test_textedit_bulk(void)
+{
+	int i;
+	size_t len, total;
+	wchar_t *text, *buf;
+	LCUI_Widget w;
+
+	text = malloc(sizeof(wchar_t) * BULK_TEXT_LINES * 16);
+	for (len = 0, i = 0; i < BULK_TEXT_LINES; ++i) {
+		len += swprintf(text + len, 16, L"line %d\n", i);
+	}
+	total = len;
+	w = LCUIWidget_New("textedit");
+	TextEdit_SetTextW(w, text);
+	Widget_Update(w);
+	it_b("check a large text set by TextEdit_SetTextW is loaded at once",
+	     TextEdit_GetTextLength(w) == total, TRUE);
+	Widget_Destroy(w);
+
+	w = LCUIWidget_New("textedit");
+	Widget_BindEvent(w, "change", OnTextChange, NULL, NULL);
+	bulk_loaded = 0;
+	bulk_progress_calls = 0;
+	text_changes = 0;
+	TextEdit_LoadTextW(w, text, OnBulkProgress, NULL);
+	Widget_Update(w);
+	it_b("check a large text is loaded in many frames",
+	     bulk_loaded > 0 && bulk_loaded < total &&
+		 TextEdit_GetTextLength(w) == bulk_loaded,
+	     TRUE);
+	it_b("check the change event is deferred until the text is loaded",
+	     text_changes == 0, TRUE);
+	for (i = 0; i < 100 && bulk_loaded < total; ++i) {
+		Widget_Update(w);
+	}
+	it_b("check the progress reaches the total length",
+	     bulk_loaded == total && bulk_progress_calls > 1, TRUE);
+	it_b("check the change event is triggered once", text_changes == 1,
+	     TRUE);
+	it_b("check TextEdit_GetTextLength after TextEdit_LoadTextW",
+	     TextEdit_GetTextLength(w) == total, TRUE);
+
+	buf = malloc(sizeof(wchar_t) * (total + 1));
+	TextEdit_GetTextW(w, 0, total, buf);
+	for (len = 0, i = 0; text[i]; ++i) {
+		if (text[i] != '\n') {
+			text[len++] = text[i];
+		}
+	}
+	text[len] = 0;
+	it_b("check the text loaded by TextEdit_LoadTextW",
+	     wcscmp(text, buf) == 0, TRUE);
+	free(buf);
+	free(text);
+	Widget_Destroy(w);
+}
+
 void test_textedit(void)
 {
 	LCUI_Widget w;
@@ -58,6 +218,37 @@ void test_textedit(void)
 	it_b("check string retrieved from TextEdit_GetTextW",
 	     wcscmp(L"hello, world!", wcs) == 0, TRUE);
 
+	// the caret and selection are painted by the textedit itself
+	it_b("check the textedit has no caret widget", w->children.length == 0,
+	     TRUE);
+	TextEdit_SetCaretBlink(w, TRUE, 500);
+	TextEdit_MoveCaret(w, 0, 100);
+	w->invalid_area_type = LCUI_INVALID_AREA_TYPE_NONE;
+	TextEdit_MoveCaret(w, 0, 12);
+	it_b("check moving the caret only invalidates the caret area",
+	     w->invalid_area_type == LCUI_INVALID_AREA_TYPE_CUSTOM &&
+		 w->invalid_area.width < 20 &&
+		 w->invalid_area.height <= w->box.content.height,
+	     TRUE);
+	w->invalid_area_type = LCUI_INVALID_AREA_TYPE_NONE;
+	TextEdit_SetSelection(w, 0, 5, 0, 0);
+	it_b("check selecting text invalidates the selected area",
+	     w->invalid_area_type == LCUI_INVALID_AREA_TYPE_CUSTOM &&
+		 w->invalid_area.width > 0 &&
+		 w->invalid_area.width < w->box.content.width,
+	     TRUE);
+	TextEdit_ClearSelection(w);
+
+	// the caret still uses the styles for textcaret inside the textedit
+	LCUI_LoadCSSString("textedit textcaret { width: 3px; "
+			   "background-color: #f00; }", NULL);
+	Widget_UpdateStyle(w, TRUE);
+	Widget_Update(w);
+	TextEdit_MoveCaret(w, 0, 5);
+	it_i("check the caret painted with the textcaret styles",
+	     CountCaretPixels(w), 3);
+	TextEdit_SetCaretBlink(w, FALSE, 500);
+
 	// test property binding
 	value = String_New("property name is 'value'");
 	Widget_BindProperty(w, "value", value);
@@ -86,6 +277,9 @@ void test_textedit(void)
 	Widget_Destroy(w);
 	Object_Delete(value);
 
+	test_textlayer_bulk();
+	test_textedit_bulk();
+
 	LCUI_FreeWidget();
 	LCUI_FreeFontLibrary();
 }
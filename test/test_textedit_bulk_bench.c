@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <wchar.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/font.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textedit.h>
+
+#define LINES 40000
+#define LINE_SIZE 64
+
+static size_t frames;
+
+/** Generate a text like a log file */
+static wchar_t *CreateText(size_t *len)
+{
+	int i;
+	wchar_t *text;
+
+	text = malloc(sizeof(wchar_t) * LINES * LINE_SIZE);
+	for (*len = 0, i = 0; i < LINES; ++i) {
+		*len += swprintf(text + *len, LINE_SIZE,
+				 L"[%05d] INFO request handled in %d ms\n", i,
+				 i % 97);
+	}
+	return text;
+}
+
+/** The previous path: the text was split into blocks of 511 characters */
+static double LoadByBlocks(const wchar_t *text, size_t len)
+{
+	size_t i, n;
+	int64_t start;
+	wchar_t block[512];
+	LCUI_TextLayer layer;
+
+	layer = TextLayer_New();
+	TextLayer_EnableStyleTag(layer, FALSE);
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < len; i += n) {
+		n = min(len - i, 511);
+		wcsncpy(block, text + i, n);
+		block[n] = 0;
+		TextLayer_AppendTextW(layer, block, NULL);
+	}
+	start = LCUI_GetTimeNs() - start;
+	TextLayer_Destroy(layer);
+	return start / 1000000.0;
+}
+
+static double LoadByBulk(const wchar_t *text, size_t len)
+{
+	int64_t start;
+	LCUI_TextLayer layer;
+
+	layer = TextLayer_New();
+	start = LCUI_GetTimeNs();
+	TextLayer_AppendTextBulkW(layer, text, len);
+	start = LCUI_GetTimeNs() - start;
+	TextLayer_Destroy(layer);
+	return start / 1000000.0;
+}
+
+static void OnProgress(LCUI_Widget w, size_t loaded, size_t total, void *arg)
+{
+	frames += 1;
+}
+
+/** Load the text into a textedit, get the total time and the longest frame */
+static void LoadTextEdit(const wchar_t *text, double *total, double *frame)
+{
+	int64_t start, t;
+	LCUI_Widget w;
+
+	w = LCUIWidget_New("textedit");
+	TextEdit_EnableMultiline(w, TRUE);
+	Widget_Resize(w, 640, 480);
+	Widget_Append(LCUIWidget_GetRoot(), w);
+	LCUIWidget_Update();
+	frames = 0;
+	*frame = 0;
+	start = LCUI_GetTimeNs();
+	TextEdit_LoadTextW(w, text, OnProgress, NULL);
+	while (w->task.for_self) {
+		t = LCUI_GetTimeNs();
+		LCUIWidget_Update();
+		t = LCUI_GetTimeNs() - t;
+		*frame = max(*frame, t / 1000000.0);
+	}
+	*total = (LCUI_GetTimeNs() - start) / 1000000.0;
+	Widget_Destroy(w);
+	LCUIWidget_Update();
+}
+
+int main(int argc, char **argv)
+{
+	size_t len;
+	wchar_t *text;
+	double blocks, bulk, total, frame;
+
+	LCUI_Init();
+	text = CreateText(&len);
+	blocks = LoadByBlocks(text, len);
+	bulk = LoadByBulk(text, len);
+	LoadTextEdit(text, &total, &frame);
+	Logger_Info("load a text of %d lines, %lu characters\n", LINES,
+		    (unsigned long)len);
+	Logger_Info("%-36s%-12s\n", "method", "time(ms)");
+	Logger_Info("%-36s%-12.2f\n", "text blocks", blocks);
+	Logger_Info("%-36s%-12.2f\n", "bulk", bulk);
+	Logger_Info("%-36s%-12.2f\n", "textedit bulk load (total)", total);
+	Logger_Info("%-36s%-12.2f\n", "textedit bulk load (longest frame)",
+		    frame);
+	Logger_Info("textedit bulk load takes %lu frames\n",
+		    (unsigned long)frames);
+	free(text);
+	LCUI_Destroy();
+	return 0;
+}
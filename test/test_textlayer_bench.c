@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/font.h>
+
+#define WIDTH 800
+#define HEIGHT 600
+#define PARAGRAPHS 40
+#define FRAMES 50
+
+static const wchar_t *sentence =
+    L"LCUI is a freely available software library for building user "
+    L"interfaces, it is written in C and supports XML and CSS. ";
+
+/** Create a text layer with large paragraphs of static text */
+static LCUI_TextLayer CreateTextLayer(void)
+{
+	int i, j;
+	size_t len = wcslen(sentence);
+	wchar_t *text, *p;
+	LCUI_TextLayer layer;
+
+	text = malloc(sizeof(wchar_t) * ((len * 4 + 1) * PARAGRAPHS + 1));
+	for (p = text, i = 0; i < PARAGRAPHS; ++i) {
+		for (j = 0; j < 4; ++j, p += len) {
+			wcscpy(p, sentence);
+		}
+		*p++ = L'\n';
+	}
+	*p = 0;
+	layer = TextLayer_New();
+	TextLayer_SetMultiline(layer, TRUE);
+	TextLayer_SetAutoWrap(layer, TRUE);
+	TextLayer_SetFixedSize(layer, WIDTH, 0);
+	TextLayer_SetTextW(layer, text, NULL);
+	TextLayer_Update(layer, NULL);
+	TextLayer_ClearInvalidRect(layer);
+	free(text);
+	return layer;
+}
+
+/** Repaint the area like a scrolled view, return the time per frame in ms */
+static double Render(LCUI_TextLayer layer, LCUI_Graph *canvas,
+		     LCUI_Rect area)
+{
+	int i;
+	int64_t start;
+	LCUI_Pos pos = { 0, 0 };
+	LCUI_Graph part;
+
+	Graph_Init(&part);
+	Graph_Quote(&part, canvas, &area);
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < FRAMES; ++i) {
+		Graph_FillRect(&part, ARGB(255, 255, 255, 255), NULL, TRUE);
+		TextLayer_RenderTo(layer, area, pos, canvas);
+	}
+	return (LCUI_GetTimeNs() - start) / 1000000.0 / FRAMES;
+}
+
+int main(int argc, char **argv)
+{
+	LCUI_Graph canvas;
+	LCUI_TextLayer layer;
+	LCUI_Rect full = { 0, 0, WIDTH, HEIGHT };
+	LCUI_Rect part = { 200, 240, 160, 40 };
+	double full_off, full_on, part_off, part_on;
+
+	LCUI_Init();
+	layer = CreateTextLayer();
+	Graph_Init(&canvas);
+	canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&canvas, WIDTH, HEIGHT);
+
+	TextLayer_EnableRowCache(layer, FALSE);
+	full_off = Render(layer, &canvas, full);
+	part_off = Render(layer, &canvas, part);
+	/* Enabling the cache builds it for the visible rows */
+	TextLayer_EnableRowCache(layer, TRUE);
+	full_on = Render(layer, &canvas, full);
+	part_on = Render(layer, &canvas, part);
+
+	Logger_Info("render %d rows of static text in a %dx%d area\n",
+		    layer->text_rows.length, WIDTH, HEIGHT);
+	Logger_Info("%-40s%-12s\n", "case", "time(ms)");
+	Logger_Info("%-40s%-12.3f\n", "full repaint (per glyph)", full_off);
+	Logger_Info("%-40s%-12.3f\n", "full repaint (row cache)", full_on);
+	Logger_Info("%-40s%-12.3f\n", "partial repaint (per glyph)", part_off);
+	Logger_Info("%-40s%-12.3f\n", "partial repaint (row cache)", part_on);
+	Logger_Info("row cache size: %lu bytes\n",
+		    (unsigned long)layer->text_rows.cache_size);
+	Graph_Free(&canvas);
+	TextLayer_Destroy(layer);
+	LCUI_Destroy();
+	return 0;
+}
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/font.h>
+#include "test.h"
+#include "libtest.h"
+
+#define WIDTH 320
+#define HEIGHT 120
+
+static LCUI_TextLayer CreateTextLayer(void)
+{
+	LCUI_TextLayer layer;
+
+	layer = TextLayer_New();
+	TextLayer_SetMultiline(layer, TRUE);
+	TextLayer_EnableStyleTag(layer, TRUE);
+	TextLayer_SetFixedSize(layer, WIDTH, HEIGHT);
+	TextLayer_SetTextW(layer,
+			   L"The quick brown fox jumps over the lazy dog.\n"
+			   L"[color=#f00]Pack my box with five dozen liquor "
+			   L"jugs.[/color]\n"
+			   L"Sphinx of black quartz, judge my vow!\n"
+			   L"Jackdaws love my big sphinx of quartz.",
+			   NULL);
+	TextLayer_Update(layer, NULL);
+	TextLayer_ClearInvalidRect(layer);
+	return layer;
+}
+
+static void RenderTextLayer(LCUI_TextLayer layer, LCUI_Graph *canvas)
+{
+	LCUI_Pos pos = { 0, 0 };
+	LCUI_Rect area = { 0, 0, WIDTH, HEIGHT };
+
+	Graph_Init(canvas);
+	canvas->color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(canvas, WIDTH, HEIGHT);
+	Graph_FillRect(canvas, ARGB(255, 255, 255, 255), NULL, TRUE);
+	TextLayer_RenderTo(layer, area, pos, canvas);
+}
+
+/** Get the maximum difference of color channels between two graphs */
+static int GetMaxDiff(LCUI_Graph *a, LCUI_Graph *b)
+{
+	int x, y, diff = 0;
+	LCUI_Color ca, cb;
+
+	for (y = 0; y < (int)a->height; ++y) {
+		for (x = 0; x < (int)a->width; ++x) {
+			Graph_GetPixel(a, x, y, ca);
+			Graph_GetPixel(b, x, y, cb);
+			diff = max(diff, abs(ca.r - cb.r));
+			diff = max(diff, abs(ca.g - cb.g));
+			diff = max(diff, abs(ca.b - cb.b));
+		}
+	}
+	return diff;
+}
+
+static void test_row_cache_render(void)
+{
+	size_t size;
+	LCUI_Graph expected, actual, blank;
+	LCUI_TextLayer layer = CreateTextLayer();
+
+	TextLayer_EnableRowCache(layer, FALSE);
+	RenderTextLayer(layer, &expected);
+	it_b("the cache is not built when it is disabled",
+	     layer->text_rows.cache_size == 0, TRUE);
+	Graph_Init(&blank);
+	blank.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&blank, WIDTH, HEIGHT);
+	Graph_FillRect(&blank, ARGB(255, 255, 255, 255), NULL, TRUE);
+	it_b("the text is rendered", GetMaxDiff(&expected, &blank) > 128,
+	     TRUE);
+	Graph_Free(&blank);
+
+	TextLayer_EnableRowCache(layer, TRUE);
+	it_b("the rows are cached after enabling the cache",
+	     layer->text_rows.rows[0]->bitmap.buffer &&
+		 layer->text_rows.rows[2]->bitmap.buffer,
+	     TRUE);
+	size = layer->text_rows.cache_size;
+	RenderTextLayer(layer, &actual);
+	it_b("rendering does not change the cache",
+	     layer->text_rows.cache_size == size, TRUE);
+	it_b("the row with a color style is not cached",
+	     layer->text_rows.rows[1]->bitmap.buffer == NULL, TRUE);
+	it_b("the cache has the same pixels as the glyphs",
+	     GetMaxDiff(&expected, &actual) <= 2, TRUE);
+
+	Graph_Free(&actual);
+	RenderTextLayer(layer, &actual);
+	it_b("the cached rows are reused",
+	     GetMaxDiff(&expected, &actual) <= 2, TRUE);
+
+	TextLayer_EnableRowCache(layer, FALSE);
+	it_b("disabling the cache releases it",
+	     layer->text_rows.cache_size == 0 &&
+		 layer->text_rows.rows[0]->bitmap.buffer == NULL,
+	     TRUE);
+	Graph_Free(&actual);
+	Graph_Free(&expected);
+	TextLayer_Destroy(layer);
+}
+
+static void test_row_cache_invalidation(void)
+{
+	int width;
+	size_t size;
+	uchar_t *buffers[4];
+	LCUI_Graph expected, actual;
+	LCUI_TextLayer layer = CreateTextLayer();
+
+	buffers[0] = layer->text_rows.rows[0]->bitmap.buffer;
+	buffers[3] = layer->text_rows.rows[3]->bitmap.buffer;
+	width = layer->text_rows.rows[2]->bitmap.width;
+	size = layer->text_rows.cache_size;
+	TextLayer_SetCaretPos(layer, 2, 0);
+	TextLayer_InsertTextW(layer, L"Hello, ", NULL);
+	TextLayer_Update(layer, NULL);
+	it_b("the changed row is rebuilt in the update",
+	     layer->text_rows.rows[2]->bitmap.buffer &&
+		 layer->text_rows.rows[2]->bitmap.width > width,
+	     TRUE);
+	it_b("the other rows are kept",
+	     layer->text_rows.rows[0]->bitmap.buffer == buffers[0] &&
+		 layer->text_rows.rows[3]->bitmap.buffer == buffers[3],
+	     TRUE);
+	it_b("the size of the rebuilt cache is counted",
+	     layer->text_rows.cache_size > size, TRUE);
+
+	RenderTextLayer(layer, &actual);
+	TextLayer_EnableRowCache(layer, FALSE);
+	RenderTextLayer(layer, &expected);
+	it_b("the changed row is rendered with the new text",
+	     GetMaxDiff(&expected, &actual) <= 2, TRUE);
+	Graph_Free(&actual);
+	Graph_Free(&expected);
+	TextLayer_Destroy(layer);
+}
+
+void test_textlayer_row_cache(void)
+{
+	LCUI_InitFontLibrary();
+	describe("render with row cache", test_row_cache_render);
+	describe("invalidate row cache", test_row_cache_invalidation);
+	LCUI_FreeFontLibrary();
+}
@@ -7,6 +7,9 @@
 #include "test.h"
 #include "libtest.h"
 
+#define THREADS 4
+#define LOOPS 20000
+
 typedef struct TestWorkerRec_ {
 	char data[32];
 	int data_count;
@@ -62,7 +65,7 @@ static void TestWorker_Destroy(TestWorker worker)
 	LCUICond_Destroy(&worker->cond);
 }
 
-void test_thread(void)
+static void test_worker(void)
 {
 	TestWorkerRec worker;
 
@@ -85,3 +88,310 @@ void test_thread(void)
 	it_i("check worker data count", worker.data_count, 7);
 	it_b("check worker is no longer active", worker.active, FALSE);
 }
+
+static void test_atomic(void)
+{
+	int value;
+	LCUI_AtomicInt a = 0;
+	LCUI_AtomicPtr p = NULL;
+
+	LCUIAtomic_Store(&a, 10);
+	it_i("load the stored value", LCUIAtomic_Load(&a), 10);
+	it_i("add returns the new value", LCUIAtomic_Add(&a, 5), 15);
+	it_i("increment returns the new value", LCUIAtomic_Increment(&a), 16);
+	it_i("decrement returns the new value", LCUIAtomic_Decrement(&a), 15);
+	it_i("exchange returns the old value", LCUIAtomic_Exchange(&a, 1), 15);
+	it_b("compare exchange fails with an unexpected value",
+	     LCUIAtomic_CompareExchange(&a, 2, 3), FALSE);
+	it_b("compare exchange succeeds with the expected value",
+	     LCUIAtomic_CompareExchange(&a, 1, 3), TRUE);
+	it_i("compare exchange sets the value", LCUIAtomic_Load(&a), 3);
+	it_b("compare exchange pointer succeeds",
+	     LCUIAtomic_CompareExchangePtr(&p, NULL, &value), TRUE);
+	it_b("load the pointer", LCUIAtomic_LoadPtr(&p) == &value, TRUE);
+}
+
+typedef struct TestCounterRec_ {
+	int value;
+	LCUI_AtomicInt atomic_value;
+	LCUI_FastMutex mutex;
+	LCUI_RWLock rwlock;
+	LCUI_BOOL consistent;
+} TestCounterRec, *TestCounter;
+
+static void TestCounter_MutexThread(void *arg)
+{
+	int i;
+	TestCounter counter = arg;
+
+	for (i = 0; i < LOOPS; ++i) {
+		LCUIFastMutex_Lock(&counter->mutex);
+		counter->value += 1;
+		LCUIFastMutex_Unlock(&counter->mutex);
+		LCUIAtomic_Increment(&counter->atomic_value);
+	}
+	LCUIThread_Exit(NULL);
+}
+
+static void TestCounter_RWLockThread(void *arg)
+{
+	int i, value;
+	TestCounter counter = arg;
+
+	for (i = 0; i < LOOPS; ++i) {
+		if (i % 8 == 0) {
+			LCUIRWLock_WriteLock(&counter->rwlock);
+			/* 写者必须独占，读者不能看到中间状态 */
+			counter->value += 1;
+			LCUIAtomic_Increment(&counter->atomic_value);
+			LCUIRWLock_WriteUnlock(&counter->rwlock);
+			continue;
+		}
+		LCUIRWLock_ReadLock(&counter->rwlock);
+		value = counter->value;
+		if (LCUIAtomic_Load(&counter->atomic_value) != value) {
+			counter->consistent = FALSE;
+		}
+		LCUIRWLock_ReadUnlock(&counter->rwlock);
+	}
+	LCUIThread_Exit(NULL);
+}
+
+static void TestCounter_Run(TestCounter counter, void (*func)(void *))
+{
+	int i;
+	LCUI_Thread threads[THREADS];
+
+	counter->value = 0;
+	counter->consistent = TRUE;
+	LCUIAtomic_Store(&counter->atomic_value, 0);
+	LCUIFastMutex_Init(&counter->mutex);
+	LCUIRWLock_Init(&counter->rwlock);
+	for (i = 0; i < THREADS; ++i) {
+		LCUIThread_Create(&threads[i], func, counter);
+	}
+	for (i = 0; i < THREADS; ++i) {
+		LCUIThread_Join(threads[i], NULL);
+	}
+}
+
+static void test_fast_mutex(void)
+{
+	TestCounterRec counter;
+	LCUI_FastMutex mutex = LCUI_FAST_MUTEX_INIT;
+
+	it_i("try lock an unlocked mutex", LCUIFastMutex_TryLock(&mutex), 0);
+	it_b("try lock a locked mutex", LCUIFastMutex_TryLock(&mutex) != 0,
+	     TRUE);
+	LCUIFastMutex_Unlock(&mutex);
+	it_i("try lock after unlocking", LCUIFastMutex_TryLock(&mutex), 0);
+	LCUIFastMutex_Unlock(&mutex);
+
+	TestCounter_Run(&counter, TestCounter_MutexThread);
+	it_i("the counter protected by the mutex", counter.value,
+	     THREADS * LOOPS);
+	it_i("the atomic counter", LCUIAtomic_Load(&counter.atomic_value),
+	     THREADS * LOOPS);
+}
+
+static void test_rwlock(void)
+{
+	TestCounterRec counter;
+	LCUI_RWLock lock = LCUI_RWLOCK_INIT;
+
+	it_i("try read lock", LCUIRWLock_TryReadLock(&lock), 0);
+	it_i("try read lock again", LCUIRWLock_TryReadLock(&lock), 0);
+	it_b("try write lock with readers", LCUIRWLock_TryWriteLock(&lock) != 0,
+	     TRUE);
+	LCUIRWLock_ReadUnlock(&lock);
+	LCUIRWLock_ReadUnlock(&lock);
+	it_i("try write lock without readers", LCUIRWLock_TryWriteLock(&lock),
+	     0);
+	it_b("try read lock with a writer", LCUIRWLock_TryReadLock(&lock) != 0,
+	     TRUE);
+	LCUIRWLock_WriteUnlock(&lock);
+
+	TestCounter_Run(&counter, TestCounter_RWLockThread);
+	it_b("readers never see a partial write", counter.consistent, TRUE);
+	it_i("the counter protected by the write lock", counter.value,
+	     THREADS * ((LOOPS + 7) / 8));
+}
+
+static LCUI_Once test_once = LCUI_ONCE_INIT;
+static LCUI_AtomicInt test_once_calls = 0;
+static LCUI_AtomicInt test_once_ready = 0;
+static LCUI_AtomicInt test_once_errors = 0;
+
+static void TestOnce_Init(void)
+{
+	LCUIAtomic_Increment(&test_once_calls);
+	/* 让其它线程有机会进入等待 */
+	LCUI_MSleep(20);
+	LCUIAtomic_Store(&test_once_ready, 1);
+}
+
+static void TestOnce_Thread(void *arg)
+{
+	LCUIOnce(&test_once, TestOnce_Init);
+	if (!LCUIAtomic_Load(&test_once_ready)) {
+		LCUIAtomic_Increment(&test_once_errors);
+	}
+	LCUIThread_Exit(NULL);
+}
+
+static void test_once_func(void)
+{
+	int i;
+	LCUI_Thread threads[THREADS];
+
+	for (i = 0; i < THREADS; ++i) {
+		LCUIThread_Create(&threads[i], TestOnce_Thread, NULL);
+	}
+	for (i = 0; i < THREADS; ++i) {
+		LCUIThread_Join(threads[i], NULL);
+	}
+	LCUIOnce(&test_once, TestOnce_Init);
+	it_i("the function is called once", LCUIAtomic_Load(&test_once_calls),
+	     1);
+	it_i("all callers return after the function returns",
+	     LCUIAtomic_Load(&test_once_errors), 0);
+}
+
+typedef struct TestSeqDataRec_ {
+	LCUI_SeqLock lock;
+	int a, b;
+	LCUI_AtomicInt stop;
+	int torn_reads;
+	int reads;
+} TestSeqDataRec, *TestSeqData;
+
+static void TestSeqData_Writer(void *arg)
+{
+	int i;
+	TestSeqData data = arg;
+
+	for (i = 1; i <= LOOPS; ++i) {
+		LCUISeqLock_WriteBegin(&data->lock);
+		data->a = i;
+		data->b = -i;
+		LCUISeqLock_WriteEnd(&data->lock);
+	}
+	LCUIAtomic_Store(&data->stop, 1);
+	LCUIThread_Exit(NULL);
+}
+
+static void test_seqlock(void)
+{
+	int a, b, seq;
+	LCUI_Thread thread;
+	TestSeqDataRec data = { LCUI_SEQLOCK_INIT, 0, 0, 0, 0, 0 };
+
+	LCUIThread_Create(&thread, TestSeqData_Writer, &data);
+	while (!LCUIAtomic_Load(&data.stop)) {
+		do {
+			seq = LCUISeqLock_ReadBegin(&data.lock);
+			a = data.a;
+			b = data.b;
+		} while (LCUISeqLock_ReadRetry(&data.lock, seq));
+		if (a != -b) {
+			data.torn_reads += 1;
+		}
+		data.reads += 1;
+	}
+	LCUIThread_Join(thread, NULL);
+	it_b("read while writing", data.reads > 0, TRUE);
+	it_i("readers never see a partial write", data.torn_reads, 0);
+	it_i("read the last written data", data.a, LOOPS);
+}
+
+#define POOL_TASKS 64
+
+typedef struct TestPoolDataRec_ {
+	LCUI_AtomicInt calls[POOL_TASKS];
+	LCUI_AtomicInt total;
+} TestPoolDataRec, *TestPoolData;
+
+static void TestPool_Task(void *arg, int index)
+{
+	int i;
+	TestPoolData data = arg;
+
+	LCUIAtomic_Increment(&data->calls[index]);
+	for (i = 0; i < 1000; ++i) {
+		LCUIAtomic_Increment(&data->total);
+	}
+}
+
+static void test_thread_pool(void)
+{
+	int i, n, errors = 0;
+	size_t tasks = 0, runs = 0;
+	LCUI_ThreadPool pool;
+	LCUI_ThreadPoolStatsRec stats;
+	TestPoolDataRec data = { 0 };
+	LCUI_ThreadPoolOptionsRec options = { THREADS, 1,
+					      LCUI_THREAD_PRIORITY_LOW };
+
+	pool = LCUIThreadPool_New(&options);
+	it_b("create a thread pool", !!pool, TRUE);
+	it_i("the number of threads", LCUIThreadPool_GetThreads(pool),
+	     THREADS);
+	for (n = 0; n < 10; ++n) {
+		LCUIThreadPool_Run(pool, TestPool_Task, &data, POOL_TASKS);
+	}
+	for (i = 0; i < POOL_TASKS; ++i) {
+		if (LCUIAtomic_Load(&data.calls[i]) != 10) {
+			errors += 1;
+		}
+	}
+	it_i("every task runs once per run", errors, 0);
+	it_i("all tasks are finished when the run returns",
+	     LCUIAtomic_Load(&data.total), 10 * POOL_TASKS * 1000);
+	for (i = 0; i < THREADS; ++i) {
+		LCUIThreadPool_GetStats(pool, i, &stats);
+		tasks += stats.tasks;
+		runs += stats.runs;
+		if (stats.busy_time < 0 || stats.idle_time < 0) {
+			errors += 1;
+		}
+	}
+	it_i("the stats count all tasks", (int)tasks, 10 * POOL_TASKS);
+	it_i("the stats count the runs of each thread", (int)runs,
+	     10 * THREADS);
+	it_i("the times are valid", errors, 0);
+	it_b("get the stats of an invalid thread",
+	     LCUIThreadPool_GetStats(pool, THREADS, &stats) != 0, TRUE);
+	LCUIThreadPool_ResetStats(pool);
+	LCUIThreadPool_GetStats(pool, 0, &stats);
+	it_b("reset the stats", stats.tasks == 0 && stats.busy_time == 0,
+	     TRUE);
+	LCUIThreadPool_Run(pool, TestPool_Task, &data, 1);
+	it_i("run a single task", LCUIAtomic_Load(&data.calls[0]), 11);
+	LCUIThreadPool_Start(pool, TestPool_Task, &data, POOL_TASKS);
+	for (n = 0; LCUIThreadPool_RunNext(pool); ++n);
+	LCUIThreadPool_Wait(pool);
+	it_b("the caller helps to run the started tasks", n <= POOL_TASKS,
+	     TRUE);
+	it_i("all started tasks are finished after waiting",
+	     LCUIAtomic_Load(&data.total), (11 * POOL_TASKS + 1) * 1000);
+	LCUIThreadPool_Destroy(pool);
+
+	options.threads = 0;
+	pool = LCUIThreadPool_New(&options);
+	it_i("a pool has at least one thread", LCUIThreadPool_GetThreads(pool),
+	     1);
+	LCUIThreadPool_Run(pool, TestPool_Task, &data, POOL_TASKS);
+	it_i("run tasks without workers", LCUIAtomic_Load(&data.calls[1]), 12);
+	LCUIThreadPool_Destroy(pool);
+}
+
+void test_thread(void)
+{
+	describe("mutex and cond", test_worker);
+	describe("atomic", test_atomic);
+	describe("fast mutex", test_fast_mutex);
+	describe("rwlock", test_rwlock);
+	describe("once", test_once_func);
+	describe("seqlock", test_seqlock);
+	describe("thread pool", test_thread_pool);
+}
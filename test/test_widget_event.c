@@ -104,7 +104,40 @@ void test_widget_mouse_event(void)
 	LCUI_Destroy();
 }
 
+static void OnCountEvent(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	int *count = e->data;
+
+	*count += 1;
+}
+
+void test_widget_event_bubbling(void)
+{
+	int i;
+	int counts[3] = { 0 };
+	LCUI_Widget root, w;
+	LCUI_Widget widgets[3];
+	LCUI_WidgetEventRec ev;
+
+	LCUI_Init();
+	root = LCUIWidget_GetRoot();
+	for (w = root, i = 0; i < 3; ++i) {
+		widgets[i] = LCUIWidget_New(NULL);
+		Widget_BindEvent(widgets[i], "test", OnCountEvent, &counts[i],
+				 NULL);
+		Widget_Append(w, widgets[i]);
+		w = widgets[i];
+	}
+	LCUI_InitWidgetEvent(&ev, "test");
+	Widget_TriggerEvent(widgets[2], &ev, NULL);
+	it_i("the target receives the event once", counts[2], 1);
+	it_i("the parent receives the event once", counts[1], 1);
+	it_i("the grandparent receives the event once", counts[0], 1);
+	LCUI_Destroy();
+}
+
 void test_widget_event(void)
 {
 	describe("test widget mouse event", test_widget_mouse_event);
+	describe("test widget event bubbling", test_widget_event_bubbling);
 }
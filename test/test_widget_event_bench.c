@@ -0,0 +1,317 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/input.h>
+#include <LCUI/gui/widget.h>
+
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 720
+#define STREAM_LENGTH 20000
+#define FRAME_EVENTS 16
+
+/**
+ * Count the allocations of the whole process by wrapping the allocator of
+ * glibc, other platforms will report zero allocations
+ */
+#ifdef __GLIBC__
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static size_t alloc_count = 0;
+
+void *malloc(size_t size)
+{
+	++alloc_count;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size)
+{
+	++alloc_count;
+	return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	++alloc_count;
+	return __libc_realloc(ptr, size);
+}
+
+#else
+
+static size_t alloc_count = 0;
+
+#endif
+
+typedef struct BenchResultRec_ {
+	const char *name;
+	size_t widgets;
+	size_t events;
+	size_t handled_events;
+	size_t allocs;
+	int64_t total_time;
+	int64_t p50, p90, p99, max;
+} BenchResultRec, *BenchResult;
+
+static LCUI_SysEventRec input_stream[STREAM_LENGTH];
+static size_t handled_events = 0;
+
+static int64_t GetTimeNs(void)
+{
+#ifdef _WIN32
+	return LCUI_GetTime() * 1000000;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+static int CompareTime(const void *a, const void *b)
+{
+	int64_t ta = *(const int64_t *)a;
+	int64_t tb = *(const int64_t *)b;
+
+	return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+/**
+ * Record a deterministic input stream: the pointer wanders across the
+ * screen with small steps, like a real mouse, and clicks from time to time
+ */
+static void RecordInputStream(void)
+{
+	size_t i;
+	int x = SCREEN_WIDTH / 2, y = SCREEN_HEIGHT / 2, dx = 3, dy = 2;
+	unsigned seed = 20190101;
+	LCUI_SysEvent ev;
+
+	for (i = 0; i < STREAM_LENGTH; ++i) {
+		ev = &input_stream[i];
+		memset(ev, 0, sizeof(LCUI_SysEventRec));
+		seed = seed * 1103515245 + 12345;
+		if (i % 50 == 48) {
+			ev->type = LCUI_MOUSEDOWN;
+			ev->button.x = x;
+			ev->button.y = y;
+			ev->button.button = LCUI_KEY_LEFTBUTTON;
+			continue;
+		}
+		if (i % 50 == 49) {
+			ev->type = LCUI_MOUSEUP;
+			ev->button.x = x;
+			ev->button.y = y;
+			ev->button.button = LCUI_KEY_LEFTBUTTON;
+			continue;
+		}
+		if ((seed >> 16) % 32 == 0) {
+			dx = (int)((seed >> 8) % 13) - 6;
+			dy = (int)((seed >> 4) % 9) - 4;
+		}
+		if (x + dx < 0 || x + dx >= SCREEN_WIDTH) {
+			dx = -dx;
+		}
+		if (y + dy < 0 || y + dy >= SCREEN_HEIGHT) {
+			dy = -dy;
+		}
+		x += dx;
+		y += dy;
+		ev->type = LCUI_MOUSEMOVE;
+		ev->motion.x = x;
+		ev->motion.y = y;
+		ev->motion.xrel = dx;
+		ev->motion.yrel = dy;
+	}
+}
+
+static void OnWidgetEvent(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	++handled_events;
+}
+
+static void BindHandlers(LCUI_Widget w)
+{
+	Widget_BindEvent(w, "mousemove", OnWidgetEvent, NULL, NULL);
+	Widget_BindEvent(w, "mousedown", OnWidgetEvent, NULL, NULL);
+	Widget_BindEvent(w, "click", OnWidgetEvent, NULL, NULL);
+}
+
+static size_t CreateDeepTree(LCUI_Widget root)
+{
+	int i;
+	LCUI_Widget parent, w;
+
+	parent = root;
+	for (i = 0; i < 256; ++i) {
+		w = LCUIWidget_New(NULL);
+		Widget_SetStyleString(w, "padding", "1px");
+		Widget_SetStyleString(w, "box-sizing", "border-box");
+		Widget_Resize(w, SCREEN_WIDTH - i * 2.0f, SCREEN_HEIGHT - i * 2.0f);
+		if (i % 16 == 0) {
+			BindHandlers(w);
+		}
+		Widget_Append(parent, w);
+		parent = w;
+	}
+	return 256;
+}
+
+static size_t CreateWideTree(LCUI_Widget root)
+{
+	int i;
+	LCUI_Widget w;
+
+	for (i = 0; i < 80 * 45; ++i) {
+		w = LCUIWidget_New(NULL);
+		Widget_SetStyleString(w, "display", "inline-block");
+		Widget_Resize(w, 16, 16);
+		BindHandlers(w);
+		Widget_Append(root, w);
+	}
+	return 80 * 45;
+}
+
+static size_t CreateLayers(LCUI_Widget root, LCUI_BOOL pointer_events_none)
+{
+	int i, j;
+	LCUI_Widget layer, w;
+
+	for (i = 0; i < 64; ++i) {
+		layer = LCUIWidget_New(NULL);
+		Widget_SetStyleString(layer, "position", "absolute");
+		Widget_SetStyle(layer, key_z_index, i, int);
+		Widget_Move(layer, (float)(i * 97 % (SCREEN_WIDTH - 320)),
+			    (float)(i * 61 % (SCREEN_HEIGHT - 240)));
+		Widget_Resize(layer, 320, 240);
+		/* The upper half of layers let the pointer pass through */
+		if (pointer_events_none && i >= 32) {
+			Widget_SetStyleString(layer, "pointer-events", "none");
+		}
+		BindHandlers(layer);
+		for (j = 0; j < 16; ++j) {
+			w = LCUIWidget_New(NULL);
+			Widget_SetStyleString(w, "display", "inline-block");
+			Widget_Resize(w, 80, 60);
+			BindHandlers(w);
+			Widget_Append(layer, w);
+		}
+		Widget_Append(root, layer);
+	}
+	return 64 * 17;
+}
+
+static void RunBench(const char *name, size_t (*create)(LCUI_Widget),
+		     BenchResult result)
+{
+	size_t i, allocs;
+	int64_t start, *times;
+	LCUI_Widget root, container;
+
+	root = LCUIWidget_GetRoot();
+	container = LCUIWidget_New(NULL);
+	Widget_SetStyleString(container, "position", "absolute");
+	Widget_Move(container, 0, 0);
+	Widget_Resize(container, SCREEN_WIDTH, SCREEN_HEIGHT);
+	Widget_Append(root, container);
+	memset(result, 0, sizeof(BenchResultRec));
+	result->name = name;
+	result->widgets = create ? create(container) : 0;
+	LCUIWidget_Update();
+	times = malloc(sizeof(int64_t) * STREAM_LENGTH);
+	handled_events = 0;
+	allocs = 0;
+	for (i = 0; i < STREAM_LENGTH; ++i) {
+		alloc_count = 0;
+		start = GetTimeNs();
+		LCUI_TriggerEvent(&input_stream[i], NULL);
+		times[i] = GetTimeNs() - start;
+		allocs += alloc_count;
+		result->total_time += times[i];
+		/* Apply the style changes of the hovered widgets like a frame */
+		if (i % FRAME_EVENTS == FRAME_EVENTS - 1) {
+			LCUIWidget_Update();
+		}
+	}
+	qsort(times, STREAM_LENGTH, sizeof(int64_t), CompareTime);
+	result->events = STREAM_LENGTH;
+	result->handled_events = handled_events;
+	result->allocs = allocs;
+	result->p50 = times[STREAM_LENGTH * 50 / 100];
+	result->p90 = times[STREAM_LENGTH * 90 / 100];
+	result->p99 = times[STREAM_LENGTH * 99 / 100];
+	result->max = times[STREAM_LENGTH - 1];
+	free(times);
+	Widget_Destroy(container);
+	LCUIWidget_Update();
+}
+
+static size_t CreateLayersWithPointerEvents(LCUI_Widget root)
+{
+	return CreateLayers(root, FALSE);
+}
+
+static size_t CreateLayersWithoutPointerEvents(LCUI_Widget root)
+{
+	return CreateLayers(root, TRUE);
+}
+
+static void PrintResult(BenchResult r, LCUI_BOOL json)
+{
+	if (json) {
+		printf("{\"tree\": \"%s\", \"widgets\": %lu, \"events\": %lu, "
+		       "\"handled_events\": %lu, \"total_ns\": %ld, "
+		       "\"p50_ns\": %ld, \"p90_ns\": %ld, \"p99_ns\": %ld, "
+		       "\"max_ns\": %ld, \"allocs_per_event\": %.2f}\n",
+		       r->name, (unsigned long)r->widgets,
+		       (unsigned long)r->events,
+		       (unsigned long)r->handled_events, (long)r->total_time,
+		       (long)r->p50, (long)r->p90, (long)r->p99, (long)r->max,
+		       1.0 * r->allocs / r->events);
+		return;
+	}
+	Logger_Info("%-16s%-10lu%-12lu%-10ld%-10ld%-10ld%-10ld%-10.2f\n",
+		    r->name, (unsigned long)r->widgets,
+		    (unsigned long)r->handled_events, (long)r->p50 / 1000,
+		    (long)r->p90 / 1000, (long)r->p99 / 1000,
+		    (long)r->max / 1000, 1.0 * r->allocs / r->events);
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	LCUI_BOOL json = FALSE;
+	BenchResultRec results[5];
+
+	for (i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--json") == 0) {
+			json = TRUE;
+		}
+	}
+	LCUI_Init();
+	Widget_Resize(LCUIWidget_GetRoot(), SCREEN_WIDTH, SCREEN_HEIGHT);
+	RecordInputStream();
+	RunBench("empty", NULL, &results[0]);
+	RunBench("deep", CreateDeepTree, &results[1]);
+	RunBench("wide", CreateWideTree, &results[2]);
+	RunBench("layers", CreateLayersWithPointerEvents, &results[3]);
+	RunBench("pointer-none", CreateLayersWithoutPointerEvents,
+		 &results[4]);
+	if (!json) {
+		Logger_Info("replay %d input events on a %dx%d screen\n",
+			    STREAM_LENGTH, SCREEN_WIDTH, SCREEN_HEIGHT);
+		Logger_Info("%-16s%-10s%-12s%-10s%-10s%-10s%-10s%-10s\n",
+			    "tree", "widgets", "handled", "p50(us)",
+			    "p90(us)", "p99(us)", "max(us)", "allocs");
+	}
+	for (i = 0; i < 5; ++i) {
+		PrintResult(&results[i], json);
+	}
+	LCUI_Destroy();
+	return 0;
+}
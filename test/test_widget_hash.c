@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include "test.h"
+#include "libtest.h"
+
+#define BRANCHES 4
+#define DEPTH 4
+
+static LCUI_Widget box;
+
+static LCUI_Widget GetNode(int branch, int depth)
+{
+	LCUI_Widget w = Widget_GetChild(box, branch);
+
+	while (depth-- > 0) {
+		w = Widget_GetChild(w, 0);
+	}
+	return w;
+}
+
+static size_t GetHashes(LCUI_Widget w, unsigned *hashes)
+{
+	size_t count = 1;
+	LinkedListNode *node;
+
+	hashes[0] = w->hash;
+	for (LinkedList_Each(node, &w->children)) {
+		count += GetHashes(node->data, hashes + count);
+	}
+	return count;
+}
+
+static void ResetHashes(LCUI_Widget w)
+{
+	LinkedListNode *node;
+
+	w->hash = 0;
+	w->local_hash = 0;
+	for (LinkedList_Each(node, &w->children)) {
+		ResetHashes(node->data);
+	}
+}
+
+/** Check whether the current hashes are the same as freshly generated ones */
+static LCUI_BOOL CheckHashes(void)
+{
+	size_t i, count;
+	LCUI_BOOL ok = TRUE;
+	LCUI_Widget root = LCUIWidget_GetRoot();
+	unsigned *hashes, *expected;
+
+	hashes = malloc(sizeof(unsigned) * 256);
+	expected = malloc(sizeof(unsigned) * 256);
+	count = GetHashes(root, hashes);
+	ResetHashes(root);
+	Widget_GenerateHash(root);
+	if (GetHashes(root, expected) != count) {
+		ok = FALSE;
+	}
+	for (i = 0; ok && i < count; ++i) {
+		if (hashes[i] != expected[i]) {
+			ok = FALSE;
+		}
+	}
+	free(hashes);
+	free(expected);
+	return ok;
+}
+
+/** Create a box with the cache_children_style rule and some deep branches */
+static void CreateTree(void)
+{
+	int i, j;
+	LCUI_Widget parent, w;
+	LCUI_WidgetRulesRec rules = { 0 };
+
+	box = LCUIWidget_New(NULL);
+	rules.cache_children_style = TRUE;
+	rules.max_update_children_count = -1;
+	Widget_SetRules(box, &rules);
+	Widget_AddClass(box, "tree");
+	for (i = 0; i < BRANCHES; ++i) {
+		parent = box;
+		for (j = 0; j < DEPTH; ++j) {
+			w = LCUIWidget_New(NULL);
+			Widget_AddClass(w, "tree-node");
+			Widget_Append(parent, w);
+			parent = w;
+		}
+	}
+	Widget_Append(LCUIWidget_GetRoot(), box);
+	Widget_GenerateHash(LCUIWidget_GetRoot());
+}
+
+static void test_widget_hash_update(void)
+{
+	LCUI_Widget w;
+	LCUI_WidgetRulesRec rules = { 0 };
+
+	CreateTree();
+	it_b("the generated hashes are the same as fresh ones", CheckHashes(),
+	     TRUE);
+
+	w = GetNode(1, 1);
+	Widget_AddClass(w, "selected");
+	it_b("the hashes are updated after adding a class", CheckHashes(),
+	     TRUE);
+	Widget_RemoveClass(w, "selected");
+	it_b("the hashes are updated after removing a class", CheckHashes(),
+	     TRUE);
+
+	Widget_SetId(GetNode(2, 0), "branch-2");
+	it_b("the hashes are updated after setting the id", CheckHashes(),
+	     TRUE);
+
+	w = GetNode(0, 2);
+	Widget_AddStatus(w, "hover");
+	it_b("the hashes are updated after adding a status", CheckHashes(),
+	     TRUE);
+	Widget_RemoveStatus(w, "hover");
+	it_b("the hashes are updated after removing a status", CheckHashes(),
+	     TRUE);
+
+	w = GetNode(3, 1);
+	rules.cache_children_style = TRUE;
+	rules.max_update_children_count = -1;
+	Widget_SetRules(w, &rules);
+	it_b("the hashes are updated after enabling cache_children_style",
+	     CheckHashes(), TRUE);
+	Widget_AddClass(box, "tree-large");
+	it_b("the hashes are updated after changing the outer hash root",
+	     CheckHashes(), TRUE);
+	Widget_SetRules(w, NULL);
+	it_b("the hashes are updated after disabling cache_children_style",
+	     CheckHashes(), TRUE);
+
+	w = GetNode(1, 2);
+	Widget_Append(GetNode(2, 0), w);
+	LCUIWidget_Update();
+	it_b("the hashes are updated after reparenting", CheckHashes(), TRUE);
+	Widget_Append(LCUIWidget_GetRoot(), w);
+	LCUIWidget_Update();
+	it_b("the hashes are updated after moving out of the hash root",
+	     CheckHashes(), TRUE);
+
+	Widget_Destroy(w);
+	Widget_Destroy(box);
+	LCUIWidget_Update();
+}
+
+void test_widget_hash(void)
+{
+	LCUI_Init();
+	describe("update widget hash", test_widget_hash_update);
+	LCUI_Destroy();
+}
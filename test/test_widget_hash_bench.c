@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+
+#define BRANCHES 64
+#define DEPTH 32
+#define WIDGETS (BRANCHES * DEPTH + 1)
+#define CHANGES 2000
+
+static volatile unsigned checksum = 0;
+
+/** The previous algorithm: walk every ancestor up to the cache boundary */
+static void FullWalk_GenerateSelfHash(LCUI_Widget widget)
+{
+	int i;
+	unsigned hash = 1080;
+	LCUI_Widget w;
+
+	for (w = widget; w; w = w->parent) {
+		if (w != widget) {
+			hash = strhash(hash, " ");
+		}
+		hash = strhash(hash, w->type ? w->type : "*");
+		if (w->id) {
+			hash = strhash(hash, "#");
+			hash = strhash(hash, w->id);
+		}
+		for (i = 0; w->classes && w->classes[i]; ++i) {
+			hash = strhash(hash, ".");
+			hash = strhash(hash, w->classes[i]);
+		}
+		for (i = 0; w->status && w->status[i]; ++i) {
+			hash = strhash(hash, ":");
+			hash = strhash(hash, w->status[i]);
+		}
+		if (w->rules && w->rules->cache_children_style) {
+			break;
+		}
+	}
+	checksum += hash;
+}
+
+static void FullWalk_GenerateHash(LCUI_Widget w)
+{
+	LinkedListNode *node;
+
+	FullWalk_GenerateSelfHash(w);
+	for (LinkedList_Each(node, &w->children)) {
+		FullWalk_GenerateHash(node->data);
+	}
+}
+
+/** Create a box with many deep branches, like nested lists or trees */
+static LCUI_Widget CreateTree(void)
+{
+	int i, j;
+	char name[32];
+	LCUI_Widget box, parent, w;
+	LCUI_WidgetRulesRec rules = { 0 };
+
+	box = LCUIWidget_New(NULL);
+	rules.cache_children_style = TRUE;
+	rules.max_update_children_count = -1;
+	Widget_SetRules(box, &rules);
+	Widget_AddClass(box, "tree");
+	for (i = 0; i < BRANCHES; ++i) {
+		parent = box;
+		for (j = 0; j < DEPTH; ++j) {
+			w = LCUIWidget_New(NULL);
+			sprintf(name, "level-%d", j);
+			Widget_AddClass(w, "tree-node");
+			Widget_AddClass(w, name);
+			if (j % 2) {
+				Widget_AddClass(w, "tree-node-odd");
+			}
+			Widget_Append(parent, w);
+			parent = w;
+		}
+	}
+	return box;
+}
+
+/** Get the widget at the given depth of the given branch */
+static LCUI_Widget GetNode(LCUI_Widget box, int branch, int depth)
+{
+	LCUI_Widget w = Widget_GetChild(box, branch);
+
+	while (depth-- > 0) {
+		w = Widget_GetChild(w, 0);
+	}
+	return w;
+}
+
+static void ResetHashes(LCUI_Widget w)
+{
+	LinkedListNode *node;
+
+	w->hash = 0;
+	w->local_hash = 0;
+	for (LinkedList_Each(node, &w->children)) {
+		ResetHashes(node->data);
+	}
+}
+
+static size_t GetHashes(LCUI_Widget w, unsigned *hashes)
+{
+	size_t count = 1;
+	LinkedListNode *node;
+
+	hashes[0] = w->hash;
+	for (LinkedList_Each(node, &w->children)) {
+		count += GetHashes(node->data, hashes + count);
+	}
+	return count;
+}
+
+/** Check whether the incrementally updated hashes are the same as new ones */
+static LCUI_BOOL CheckHashes(LCUI_Widget box)
+{
+	size_t i, count;
+	LCUI_BOOL ok = TRUE;
+	unsigned *hashes, *expected;
+
+	hashes = malloc(sizeof(unsigned) * WIDGETS);
+	expected = malloc(sizeof(unsigned) * WIDGETS);
+	count = GetHashes(box, hashes);
+	ResetHashes(box);
+	Widget_GenerateHash(box);
+	GetHashes(box, expected);
+	for (i = 0; i < count; ++i) {
+		if (hashes[i] != expected[i]) {
+			ok = FALSE;
+		}
+	}
+	free(hashes);
+	free(expected);
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	int64_t start;
+	double full_walk, full, walk_change, change, status_change;
+	LCUI_Widget box, w;
+
+	LCUI_Init();
+	box = CreateTree();
+	Widget_Append(LCUIWidget_GetRoot(), box);
+
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < 10; ++i) {
+		FullWalk_GenerateHash(box);
+	}
+	full_walk = (LCUI_GetTimeNs() - start) / 10000.0;
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < 10; ++i) {
+		Widget_GenerateHash(box);
+	}
+	full = (LCUI_GetTimeNs() - start) / 10000.0;
+
+	/* Rehash the subtree after the class of a middle node is changed */
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < CHANGES; ++i) {
+		FullWalk_GenerateHash(GetNode(box, i % BRANCHES, DEPTH / 2));
+	}
+	walk_change = (LCUI_GetTimeNs() - start) / 1000.0 / CHANGES;
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < CHANGES; ++i) {
+		w = GetNode(box, i % BRANCHES, DEPTH / 2);
+		if (i / BRANCHES % 2) {
+			Widget_RemoveClass(w, "selected");
+		} else {
+			Widget_AddClass(w, "selected");
+		}
+	}
+	change = (LCUI_GetTimeNs() - start) / 1000.0 / CHANGES;
+
+	/* Hover a leaf node, its subtree only has itself */
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < CHANGES; ++i) {
+		w = GetNode(box, i % BRANCHES, DEPTH - 1);
+		if (i / BRANCHES % 2) {
+			Widget_RemoveStatus(w, "hover");
+		} else {
+			Widget_AddStatus(w, "hover");
+		}
+	}
+	status_change = (LCUI_GetTimeNs() - start) / 1000.0 / CHANGES;
+
+	Logger_Info("hash a tree of %d branches with %d levels, "
+		    "cache_children_style enabled\n",
+		    BRANCHES, DEPTH);
+	Logger_Info("%-40s%-12s\n", "case", "time(us)");
+	Logger_Info("%-40s%-12.2f\n", "generate all (full walk)", full_walk);
+	Logger_Info("%-40s%-12.2f\n", "generate all (incremental)", full);
+	Logger_Info("%-40s%-12.2f\n", "rehash a middle node (full walk)",
+		    walk_change);
+	Logger_Info("%-40s%-12.2f\n", "toggle class of a middle node", change);
+	Logger_Info("%-40s%-12.2f\n", "toggle status of a leaf node",
+		    status_change);
+	Logger_Info("incrementally updated hashes are %s\n",
+		    CheckHashes(box) ? "correct" : "WRONG");
+	LCUI_Destroy();
+	return 0;
+}
@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/input.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_parser.h>
+
+#define COLS 100
+#define ROWS 50
+#define CELL_SIZE 12
+#define MOVES 2000
+
+/* clang-format off */
+
+static const char *css = CodeToString(
+
+.grid {
+	width: 1200px;
+	margin: 20px;
+}
+
+.cell {
+	display: inline-block;
+	width: 12px;
+	height: 12px;
+	background-color: #eee;
+}
+
+.cell:hover {
+	background-color: #f00;
+}
+
+.grid:hover .cell.marked {
+	background-color: #00f;
+}
+
+);
+
+/* clang-format on */
+
+typedef struct BenchResultRec_ {
+	int64_t time;
+	size_t refresh_count;
+	size_t max_refresh_count;
+} BenchResultRec, *BenchResult;
+
+static LCUI_Widget CreateGrid(LCUI_Widget root)
+{
+	int i;
+	LCUI_Widget grid, cell;
+
+	grid = LCUIWidget_New(NULL);
+	Widget_AddClass(grid, "grid");
+	for (i = 0; i < COLS * ROWS; ++i) {
+		cell = LCUIWidget_New(NULL);
+		Widget_AddClass(cell, "cell");
+		if (i % 100 == 0) {
+			Widget_AddClass(cell, "marked");
+		}
+		Widget_Append(grid, cell);
+	}
+	Widget_Append(root, grid);
+	return grid;
+}
+
+static void MoveMouse(float x, float y, BenchResult result)
+{
+	int64_t start;
+	LCUI_SysEventRec ev;
+	LCUI_WidgetTasksProfileRec profile = { 0 };
+
+	ev.type = LCUI_MOUSEMOVE;
+	ev.motion.x = (int)x;
+	ev.motion.y = (int)y;
+	ev.motion.xrel = 0;
+	ev.motion.yrel = 0;
+	start = LCUI_GetTime();
+	LCUI_TriggerEvent(&ev, NULL);
+	LCUIWidget_UpdateWithProfile(&profile);
+	result->time += LCUI_GetTimeDelta(start);
+	result->refresh_count += profile.refresh_count;
+	result->max_refresh_count =
+	    max(result->max_refresh_count, profile.refresh_count);
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	float x, y;
+	LCUI_Widget root, grid, cell;
+	BenchResultRec result = { 0 }, warmup = { 0 };
+
+	LCUI_Init();
+	LCUI_LoadCSSString(css, __FILE__);
+	root = LCUIWidget_GetRoot();
+	Widget_Resize(root, 1280, 720);
+	grid = CreateGrid(root);
+	LCUIWidget_Update();
+	/* Let the pending tasks of the newly created widgets be finished */
+	MoveMouse(5, 5, &warmup);
+
+	/* Move the mouse into and out of the grid, and across its cells */
+	x = y = 0;
+	for (i = 0; i < MOVES; ++i) {
+		if (i % 100 == 0) {
+			MoveMouse(5, 5, &result);
+			continue;
+		}
+		x = grid->box.content.x + (i * 7 % COLS) * CELL_SIZE + 6;
+		y = grid->box.content.y + (i * 3 % ROWS) * CELL_SIZE + 6;
+		MoveMouse(x, y, &result);
+	}
+	cell = Widget_At(grid, (int)(x - grid->box.content.x),
+			 (int)(y - grid->box.content.y));
+
+	Logger_Info("hover across a grid of %d widgets with %d mouse moves\n",
+		    COLS * ROWS, MOVES);
+	Logger_Info("%-12s%-20s%-20s%-20s\n", "time", "refreshed widgets",
+		    "per move", "max per move");
+	Logger_Info("%-12ld%-20lu%-20.2f%-20lu\n", (long)result.time,
+		    (unsigned long)result.refresh_count,
+		    1.0 * result.refresh_count / MOVES,
+		    (unsigned long)result.max_refresh_count);
+	Logger_Info("the hovered cell %s the :hover style\n",
+		    cell && cell->computed_style.background.color.value ==
+				0xffff0000
+			? "has"
+			: "does not have");
+	cell = Widget_GetChild(grid, 0);
+	Logger_Info("the marked cell %s the .grid:hover style\n",
+		    cell->computed_style.background.color.value == 0xff0000ff
+			? "has"
+			: "does not have");
+	LCUI_Destroy();
+	return 0;
+}
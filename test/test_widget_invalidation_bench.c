@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+
+#define PANELS 8
+#define DEPTH 32
+#define COUNTERS_PER_PANEL 64
+#define COUNTERS (PANELS * COUNTERS_PER_PANEL)
+#define UPDATES_PER_FRAME 100
+#define FRAMES 20
+
+static LCUI_Widget counters[COUNTERS];
+
+/** Create deeply nested panels, each panel has many live counters */
+static void CreatePage(void)
+{
+	int i, j;
+	LCUI_Widget parent, w;
+
+	for (i = 0; i < PANELS; ++i) {
+		parent = LCUIWidget_GetRoot();
+		for (j = 0; j < DEPTH; ++j) {
+			w = LCUIWidget_New(NULL);
+			Widget_SetStyleString(w, "padding", "1px");
+			Widget_Append(parent, w);
+			parent = w;
+		}
+		for (j = 0; j < COUNTERS_PER_PANEL; ++j) {
+			w = LCUIWidget_New(NULL);
+			Widget_Resize(w, 40, 10);
+			Widget_Append(parent, w);
+			counters[i * COUNTERS_PER_PANEL + j] = w;
+		}
+	}
+}
+
+/** Update the digits of all counters many times, then collect dirty rects */
+static void RunFrame(double *update_time, double *collect_time)
+{
+	int i, j;
+	int64_t start, collect;
+	LinkedList rects;
+	LCUI_RectF rect = { 0, 0, 8, 10 };
+
+	LinkedList_Init(&rects);
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < UPDATES_PER_FRAME; ++i) {
+		rect.x = (float)(i % 5 * 8);
+		for (j = 0; j < COUNTERS; ++j) {
+			Widget_InvalidateArea(counters[j], &rect, SV_CONTENT_BOX);
+		}
+	}
+	collect = LCUI_GetTimeNs();
+	Widget_GetInvalidArea(LCUIWidget_GetRoot(), &rects);
+	*update_time += (collect - start) / 1000.0;
+	*collect_time += (LCUI_GetTimeNs() - collect) / 1000.0;
+	RectList_Clear(&rects);
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	double update_time = 0, collect_time = 0;
+	LinkedList rects;
+	LCUI_WidgetInvalidationStatsRec stats;
+
+	LCUI_Init();
+	Widget_Resize(LCUIWidget_GetRoot(), 800, 600);
+	CreatePage();
+	LCUIWidget_Update();
+	LinkedList_Init(&rects);
+	Widget_GetInvalidArea(LCUIWidget_GetRoot(), &rects);
+	RectList_Clear(&rects);
+
+	LCUIWidget_ResetInvalidationStats();
+	for (i = 0; i < FRAMES; ++i) {
+		RunFrame(&update_time, &collect_time);
+	}
+	LCUIWidget_GetInvalidationStats(&stats);
+	Logger_Info("update %d counters in %d panels at depth %d, "
+		    "%d times per frame\n",
+		    COUNTERS, PANELS, DEPTH, UPDATES_PER_FRAME);
+	Logger_Info("%-24s%-12.2f\n", "invalidate time(us)",
+		    update_time / FRAMES);
+	Logger_Info("%-24s%-12.2f\n", "collect time(us)", collect_time / FRAMES);
+	Logger_Info("%-24s%-12lu\n", "calls",
+		    (unsigned long)(stats.calls / FRAMES));
+	Logger_Info("%-24s%-12lu\n", "records",
+		    (unsigned long)(stats.records / FRAMES));
+	Logger_Info("%-24s%-12lu\n", "merged",
+		    (unsigned long)(stats.merged / FRAMES));
+	Logger_Info("%-24s%-12lu\n", "marked ancestors",
+		    (unsigned long)(stats.marked_ancestors / FRAMES));
+	LCUI_Destroy();
+	return 0;
+}
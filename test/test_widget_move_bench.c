@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/painter.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 720
+#define PANEL_WIDTH 480
+#define PANEL_HEIGHT 360
+#define FRAMES 120
+
+typedef struct BenchResultRec_ {
+	int64_t time;
+	size_t rendered_pixels;
+	size_t copied_pixels;
+} BenchResultRec, *BenchResult;
+
+static void CreateBackground(LCUI_Widget root)
+{
+	int i;
+	char color[16];
+	LCUI_Widget tile;
+
+	for (i = 0; i < 32 * 18; ++i) {
+		tile = LCUIWidget_New(NULL);
+		sprintf(color, "#%02x%02x%02x", (i * 7) % 256, (i * 13) % 256,
+			(i * 29) % 256);
+		Widget_SetStyleString(tile, "display", "inline-block");
+		Widget_SetStyleString(tile, "background-color", color);
+		Widget_SetStyleString(tile, "border", "1px solid #ccc");
+		Widget_Resize(tile, 40, 40);
+		Widget_Append(root, tile);
+	}
+}
+
+static LCUI_Widget CreatePanel(LCUI_Widget root)
+{
+	int i;
+	LCUI_Widget panel, item, text;
+
+	panel = LCUIWidget_New(NULL);
+	Widget_SetStyleString(panel, "position", "absolute");
+	Widget_SetStyleString(panel, "z-index", "10");
+	Widget_SetStyleString(panel, "background-color", "#fff");
+	Widget_SetStyleString(panel, "border", "1px solid #999");
+	Widget_SetStyleString(panel, "padding", "8px");
+	Widget_SetStyleString(panel, "box-sizing", "border-box");
+	Widget_Resize(panel, PANEL_WIDTH, PANEL_HEIGHT);
+	for (i = 0; i < 96; ++i) {
+		item = LCUIWidget_New(NULL);
+		text = LCUIWidget_New("textview");
+		Widget_SetStyleString(item, "display", "inline-block");
+		Widget_SetStyleString(item, "background-color", "#eef");
+		Widget_SetStyleString(item, "border", "1px solid #88a");
+		Widget_SetStyleString(item, "border-radius", "4px");
+		Widget_Resize(item, 54, 40);
+		TextView_SetText(text, "item");
+		Widget_Append(item, text);
+		Widget_Append(panel, item);
+	}
+	Widget_Append(root, panel);
+	return panel;
+}
+
+static size_t RenderRects(LCUI_Widget root, LCUI_Graph *canvas,
+			  LinkedList *rects)
+{
+	size_t pixels = 0;
+	LCUI_Rect *rect;
+	LinkedListNode *node;
+	LCUI_PaintContext paint;
+
+	for (LinkedList_Each(node, rects)) {
+		rect = node->data;
+		LCUIRect_ValidateArea(rect, canvas->width, canvas->height);
+		if (rect->width < 1 || rect->height < 1) {
+			continue;
+		}
+		paint = LCUIPainter_Begin(canvas, rect);
+		Graph_FillRect(&paint->canvas, RGB(255, 255, 255), NULL, TRUE);
+		Widget_Render(root, paint);
+		LCUIPainter_End(paint);
+		pixels += rect->width * rect->height;
+	}
+	RectList_Clear(rects);
+	return pixels;
+}
+
+static void RenderAll(LCUI_Widget root, LCUI_Graph *canvas)
+{
+	LinkedList rects;
+	LCUI_Rect rect = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+
+	LinkedList_Init(&rects);
+	Widget_GetInvalidArea(root, &rects);
+	RectList_Clear(&rects);
+	RectList_Add(&rects, &rect);
+	RenderRects(root, canvas, &rects);
+}
+
+static void RunBench(LCUI_Widget root, LCUI_Widget panel, LCUI_Graph *canvas,
+		     LCUI_BOOL reuse_pixels, BenchResult result)
+{
+	int i;
+	int64_t start;
+	LinkedList rects, areas;
+	LCUI_MovedArea area;
+	LinkedListNode *node;
+
+	LinkedList_Init(&rects);
+	LinkedList_Init(&areas);
+	result->time = 0;
+	result->copied_pixels = 0;
+	result->rendered_pixels = 0;
+	Widget_Move(panel, 40, 40);
+	LCUIWidget_Update();
+	RenderAll(root, canvas);
+	for (i = 1; i <= FRAMES; ++i) {
+		Widget_Move(panel, 40.0f + i * 5, 40.0f + i * 2);
+		start = LCUI_GetTime();
+		LCUIWidget_Update();
+		if (reuse_pixels) {
+			Widget_GetInvalidAreaEx(root, &rects, &areas);
+		} else {
+			Widget_GetInvalidArea(root, &rects);
+		}
+		for (LinkedList_Each(node, &areas)) {
+			area = node->data;
+			Graph_CopyRect(canvas, &area->from, area->to.x,
+				       area->to.y);
+			result->copied_pixels += area->to.width * area->to.height;
+		}
+		LinkedList_Clear(&areas, free);
+		result->rendered_pixels += RenderRects(root, canvas, &rects);
+		result->time += LCUI_GetTimeDelta(start);
+	}
+}
+
+#define DIFF(A, B) ((A) > (B) ? (A) - (B) : (B) - (A))
+
+/**
+ * The alpha blending of the renderer has a rounding error of one level, so
+ * the pixels may be slightly different from a full repaint
+ */
+static size_t CompareGraph(LCUI_Graph *a, LCUI_Graph *b, int *max_diff)
+{
+	size_t i, count = 0;
+	LCUI_ARGB *pa, *pb;
+
+	*max_diff = 0;
+	for (i = 0; i < (size_t)(a->width * a->height); ++i) {
+		pa = &a->argb[i];
+		pb = &b->argb[i];
+		if (pa->value == pb->value) {
+			continue;
+		}
+		*max_diff = max(*max_diff, DIFF(pa->r, pb->r));
+		*max_diff = max(*max_diff, DIFF(pa->g, pb->g));
+		*max_diff = max(*max_diff, DIFF(pa->b, pb->b));
+		++count;
+	}
+	return count;
+}
+
+int main(int argc, char **argv)
+{
+	int max_diff;
+	size_t mismatched;
+	LCUI_Widget root, panel;
+	LCUI_Graph canvas, expected;
+	BenchResultRec repaint, reuse;
+
+	LCUI_Init();
+	root = LCUIWidget_GetRoot();
+	Widget_Resize(root, SCREEN_WIDTH, SCREEN_HEIGHT);
+	CreateBackground(root);
+	panel = CreatePanel(root);
+	LCUIWidget_Update();
+
+	Graph_Init(&canvas);
+	Graph_Init(&expected);
+	canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+	expected.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&canvas, SCREEN_WIDTH, SCREEN_HEIGHT);
+	Graph_Create(&expected, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+	RunBench(root, panel, &canvas, FALSE, &repaint);
+	RunBench(root, panel, &canvas, TRUE, &reuse);
+	RenderAll(root, &expected);
+	mismatched = CompareGraph(&canvas, &expected, &max_diff);
+
+	Logger_Info("drag a %dx%d panel over %d frames on a %dx%d screen\n",
+		    PANEL_WIDTH, PANEL_HEIGHT, FRAMES, SCREEN_WIDTH,
+		    SCREEN_HEIGHT);
+	Logger_Info("%-20s%-12s%-20s%-20s\n", "method", "time",
+		    "rendered pixels", "copied pixels");
+	Logger_Info("%-20s%-12ld%-20lu%-20lu\n", "repaint", (long)repaint.time,
+		    (unsigned long)repaint.rendered_pixels,
+		    (unsigned long)repaint.copied_pixels);
+	Logger_Info("%-20s%-12ld%-20lu%-20lu\n", "reuse pixels",
+		    (long)reuse.time, (unsigned long)reuse.rendered_pixels,
+		    (unsigned long)reuse.copied_pixels);
+	Logger_Info("mismatched pixels in the last frame: %lu, "
+		    "max color difference: %d\n",
+		    (unsigned long)mismatched, max_diff);
+
+	Graph_Free(&canvas);
+	Graph_Free(&expected);
+	LCUI_Destroy();
+	return 0;
+}
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include <LCUI/painter.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 720
+#define PAGES 8
+#define FRAMES 30
+
+typedef struct BenchResultRec_ {
+	int64_t time;
+	LCUI_WidgetRepaintStatsRec stats;
+} BenchResultRec, *BenchResult;
+
+/**
+ * Create stacked full-screen pages like the page views of a navigation
+ * stack, only the topmost page is visible when the pages are opaque
+ */
+static LCUI_Widget CreatePages(LCUI_Widget root, const char *bgcolor)
+{
+	int i, j;
+	LCUI_Widget container, page, item, text;
+
+	container = LCUIWidget_New(NULL);
+	Widget_Resize(container, SCREEN_WIDTH, SCREEN_HEIGHT);
+	for (i = 0; i < PAGES; ++i) {
+		page = LCUIWidget_New(NULL);
+		Widget_SetStyleString(page, "position", "absolute");
+		Widget_SetStyleString(page, "background-color", bgcolor);
+		Widget_SetStyleString(page, "padding", "10px");
+		Widget_SetStyleString(page, "box-sizing", "border-box");
+		Widget_Move(page, 0, 0);
+		Widget_Resize(page, SCREEN_WIDTH, SCREEN_HEIGHT);
+		for (j = 0; j < 120; ++j) {
+			item = LCUIWidget_New(NULL);
+			text = LCUIWidget_New("textview");
+			Widget_SetStyleString(item, "display", "inline-block");
+			Widget_SetStyleString(item, "background-color",
+					      "#eef");
+			Widget_SetStyleString(item, "border",
+					      "1px solid #88a");
+			Widget_SetStyleString(item, "border-radius", "4px");
+			Widget_SetStyleString(item, "margin", "4px");
+			Widget_Resize(item, 96, 48);
+			TextView_SetText(text, "list item");
+			Widget_Append(item, text);
+			Widget_Append(page, item);
+		}
+		Widget_Append(container, page);
+	}
+	Widget_Append(root, container);
+	return container;
+}
+
+static void RunBench(const char *bgcolor, BenchResult result)
+{
+	int i;
+	int64_t start;
+	LCUI_Rect rect;
+	LCUI_Graph canvas;
+	LCUI_Widget root, container;
+	LCUI_PaintContext paint;
+
+	root = LCUIWidget_GetRoot();
+	container = CreatePages(root, bgcolor);
+	LCUIWidget_Update();
+	LCUIWidget_Update();
+	Graph_Init(&canvas);
+	canvas.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&canvas, SCREEN_WIDTH, SCREEN_HEIGHT);
+	rect.x = rect.y = 0;
+	rect.width = SCREEN_WIDTH;
+	rect.height = SCREEN_HEIGHT;
+	LCUIWidget_ResetRepaintStats();
+	start = LCUI_GetTime();
+	for (i = 0; i < FRAMES; ++i) {
+		paint = LCUIPainter_Begin(&canvas, &rect);
+		Widget_Render(root, paint);
+		LCUIPainter_End(paint);
+	}
+	result->time = LCUI_GetTimeDelta(start);
+	LCUIWidget_GetRepaintStats(&result->stats);
+	Graph_Free(&canvas);
+	Widget_Destroy(container);
+	LCUIWidget_Update();
+}
+
+static void PrintResult(const char *name, BenchResult r)
+{
+	double screen_pixels = 1.0 * SCREEN_WIDTH * SCREEN_HEIGHT * FRAMES;
+
+	Logger_Info("%-16s%-12.2f%-12.2f%-16.2f%-16lu\n", name,
+		    1.0 * r->time / FRAMES,
+		    r->stats.painted_pixels / screen_pixels,
+		    r->stats.occluded_pixels / screen_pixels,
+		    (unsigned long)(r->stats.occluded_widgets / FRAMES));
+}
+
+int main(int argc, char **argv)
+{
+	BenchResultRec opaque, translucent;
+
+	LCUI_Init();
+	Widget_Resize(LCUIWidget_GetRoot(), SCREEN_WIDTH, SCREEN_HEIGHT);
+	/* The translucent pages can not occlude each other */
+	RunBench("rgba(255,255,255,0.99)", &translucent);
+	RunBench("#fff", &opaque);
+	Logger_Info("render %d stacked full-screen pages on a %dx%d screen, "
+		    "%d frames\n",
+		    PAGES, SCREEN_WIDTH, SCREEN_HEIGHT, FRAMES);
+	Logger_Info("%-16s%-12s%-12s%-16s%-16s\n", "pages", "ms/frame",
+		    "overdraw", "occluded", "occluded widgets");
+	PrintResult("translucent", &translucent);
+	PrintResult("opaque", &opaque);
+	LCUI_Destroy();
+	return 0;
+}
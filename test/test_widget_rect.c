@@ -4,17 +4,121 @@
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/input.h>
+#include <LCUI/painter.h>
+#include <LCUI/thread.h>
+#include <LCUI/atomic.h>
 #include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
 #include "libtest.h"
 
+#define JOURNAL_WIDGETS 64
+#define JOURNAL_ROUNDS 2000
+#define JOURNAL_WRITERS 2
+
+static LCUI_Widget journal_widgets[JOURNAL_WIDGETS];
+static LCUI_AtomicInt journal_writing;
+
+/** Record widgets like the image loader does on the worker thread */
+static void JournalWriterThread(void *arg)
+{
+	int i, j;
+
+	for (i = 0; i < JOURNAL_ROUNDS; ++i) {
+		for (j = 0; j < JOURNAL_WIDGETS; ++j) {
+			Widget_AddToInvalidJournal(journal_widgets[j]);
+		}
+	}
+	LCUIAtomic_Decrement(&journal_writing);
+	LCUIThread_Exit(NULL);
+}
+
+static void test_invalid_journal_threads(LCUI_Widget parent)
+{
+	int i;
+	size_t lost = 0, flushed = 0, unmarked = 0;
+	LCUI_Thread tids[JOURNAL_WRITERS];
+	LCUI_Widget w;
+	LinkedList rects;
+	LCUI_WidgetInvalidationStatsRec stats;
+
+	LinkedList_Init(&rects);
+	for (i = 0; i < JOURNAL_WIDGETS; ++i) {
+		journal_widgets[i] = LCUIWidget_New(NULL);
+		Widget_Resize(journal_widgets[i], 10, 10);
+		Widget_Append(parent, journal_widgets[i]);
+	}
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(LCUIWidget_GetRoot(), &rects);
+	LinkedList_Clear(&rects, free);
+	for (w = parent; w; w = w->parent) {
+		w->has_child_invalid_area = FALSE;
+	}
+	LCUIWidget_ResetInvalidationStats();
+	LCUIAtomic_Store(&journal_writing, JOURNAL_WRITERS);
+	for (i = 0; i < JOURNAL_WRITERS; ++i) {
+		LCUIThread_Create(&tids[i], JournalWriterThread, NULL);
+	}
+	while (LCUIAtomic_Load(&journal_writing) > 0) {
+		flushed += LCUIWidget_FlushInvalidJournal();
+	}
+	for (i = 0; i < JOURNAL_WRITERS; ++i) {
+		LCUIThread_Join(tids[i], NULL);
+	}
+	flushed += LCUIWidget_FlushInvalidJournal();
+	LCUIWidget_GetInvalidationStats(&stats);
+	for (i = 0; i < JOURNAL_WIDGETS; ++i) {
+		if (journal_widgets[i]->invalid_node.data) {
+			++lost;
+		}
+	}
+	for (w = parent; w; w = w->parent) {
+		if (!w->has_child_invalid_area) {
+			++unmarked;
+		}
+	}
+	it_i("flushInvalidJournal() while other threads record widgets, "
+	     "unflushed records",
+	     (int)lost, 0);
+	it_i("flushInvalidJournal() while other threads record widgets, "
+	     "ancestors not marked",
+	     (int)unmarked, 0);
+	it_b("flushInvalidJournal() while other threads record widgets, "
+	     "records + merged == calls",
+	     stats.records + stats.merged ==
+		 JOURNAL_WRITERS * JOURNAL_ROUNDS * JOURNAL_WIDGETS,
+	     TRUE);
+	it_b("flushInvalidJournal() while other threads record widgets, "
+	     "every record is flushed once",
+	     flushed == stats.records, TRUE);
+	it_i("flushInvalidJournal() after all records are flushed",
+	     (int)LCUIWidget_FlushInvalidJournal(), 0);
+	for (i = 0; i < JOURNAL_WIDGETS; ++i) {
+		Widget_Destroy(journal_widgets[i]);
+	}
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(LCUIWidget_GetRoot(), &rects);
+	LinkedList_Clear(&rects, free);
+}
+
 void test_widget_rect(void)
 {
 	LCUI_Widget root;
-	LCUI_Widget parent, child;
+	LCUI_Widget parent, child, page, header;
 	LCUI_SysEventRec ev;
+	LCUI_Color color;
 	LCUI_Rect *rect;
 	LCUI_Rect expected_rect;
 	LinkedList rects;
+	LinkedList areas;
+	LCUI_MovedArea area;
+	LCUI_Graph cached, expected;
+	LCUI_PaintContext paint;
+	LCUI_WidgetRepaintStatsRec stats;
+	LCUI_WidgetInvalidationStatsRec istats;
+	LCUI_RectF invalid_rect;
+	LCUI_Widget leaf, cover;
+	size_t pixels;
+	int i;
 
 	LCUI_Init();
 	root = LCUIWidget_GetRoot();
@@ -81,6 +185,11 @@ void test_widget_rect(void)
 	it_b("app.trigger({ type: 'mousedown', x: 40, y: 40 }), "
 	     "root.getInvalidArea().length == 1",
 	     rects.length == 1, TRUE);
+	/* only the background of the button is changed */
+	expected_rect.x = 1;
+	expected_rect.y = 1;
+	expected_rect.width = 98;
+	expected_rect.height = 98;
 	if (rects.length == 1) {
 		rect = rects.head.next->data;
 		it_rect("root.getInvalidArea()[0]", rect, &expected_rect);
@@ -99,6 +208,10 @@ void test_widget_rect(void)
 		it_rect("root.getInvalidArea()[0]", rect, &expected_rect);
 	}
 	LinkedList_Clear(&rects, free);
+	expected_rect.x = 0;
+	expected_rect.y = 0;
+	expected_rect.width = 100;
+	expected_rect.height = 100;
 
 	ev.type = LCUI_MOUSEMOVE;
 	ev.motion.x = 80;
@@ -157,5 +270,292 @@ void test_widget_rect(void)
 	}
 	LinkedList_Clear(&rects, free);
 
+	parent = LCUIWidget_New(NULL);
+	Widget_SetStyleString(parent, "position", "absolute");
+	Widget_SetStyleString(parent, "background-color", "#f00");
+	Widget_Resize(parent, 50, 50);
+	Widget_Move(parent, 20, 20);
+	Widget_Append(root, parent);
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LinkedList_Clear(&rects, free);
+
+	LinkedList_Init(&areas);
+	Widget_Move(parent, 30, 25);
+	LCUIWidget_Update();
+	Widget_GetInvalidAreaEx(root, &rects, &areas);
+	it_b("parent.move(30, 25), root.getMovedArea().length == 1",
+	     areas.length == 1, TRUE);
+	if (areas.length == 1) {
+		area = areas.head.next->data;
+		expected_rect.x = 20;
+		expected_rect.y = 20;
+		expected_rect.width = 50;
+		expected_rect.height = 50;
+		it_rect("root.getMovedArea()[0].from", &area->from,
+			&expected_rect);
+		expected_rect.x = 30;
+		expected_rect.y = 25;
+		it_rect("root.getMovedArea()[0].to", &area->to, &expected_rect);
+	}
+	it_b("parent.move(30, 25), root.getInvalidArea().length > 0",
+	     rects.length > 0, TRUE);
+	LinkedList_Clear(&rects, free);
+	LinkedList_Clear(&areas, free);
+
+	cover = LCUIWidget_New(NULL);
+	Widget_SetStyleString(cover, "position", "absolute");
+	Widget_SetStyleString(cover, "background-color", "#00f");
+	Widget_Resize(cover, 50, 50);
+	Widget_Move(cover, 30, 25);
+	Widget_Append(root, cover);
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LinkedList_Clear(&rects, free);
+	Widget_Hide(cover);
+	Widget_Move(parent, 35, 25);
+	LCUIWidget_Update();
+	Widget_GetInvalidAreaEx(root, &rects, &areas);
+	it_b("cover.hide(), parent.move(35, 25), "
+	     "root.getMovedArea().length == 0",
+	     areas.length == 0, TRUE);
+	LinkedList_Clear(&rects, free);
+	LinkedList_Clear(&areas, free);
+
+	Widget_Show(cover);
+	Widget_SetStyleString(cover, "background-color", "rgba(0,0,255,0.5)");
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LinkedList_Clear(&rects, free);
+	Widget_Move(cover, 150, 150);
+	Widget_Move(parent, 40, 25);
+	LCUIWidget_Update();
+	Widget_GetInvalidAreaEx(root, &rects, &areas);
+	it_b("cover.move(150, 150), parent.move(40, 25), "
+	     "root.getMovedArea().length == 0",
+	     areas.length == 0, TRUE);
+	LinkedList_Clear(&rects, free);
+	LinkedList_Clear(&areas, free);
+	Widget_Destroy(cover);
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LinkedList_Clear(&rects, free);
+
+	cover = LCUIWidget_New(NULL);
+	Widget_SetStyleString(cover, "position", "absolute");
+	Widget_SetStyleString(cover, "background-color", "#00f");
+	Widget_Resize(cover, 20, 20);
+	Widget_Move(cover, 30, 25);
+	Widget_Prepend(root, cover);
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LinkedList_Clear(&rects, free);
+	Widget_InvalidateArea(cover, NULL, SV_PADDING_BOX);
+	Widget_Move(parent, 45, 25);
+	LCUIWidget_Update();
+	Widget_GetInvalidAreaEx(root, &rects, &areas);
+	it_b("cover.invalidate(), parent.move(45, 25), "
+	     "root.getMovedArea().length == 1",
+	     areas.length == 1, TRUE);
+	LinkedList_Clear(&rects, free);
+	LinkedList_Clear(&areas, free);
+	Widget_Hide(cover);
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LinkedList_Clear(&rects, free);
+
+	Widget_SetOpacity(parent, 0.5f);
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LinkedList_Clear(&rects, free);
+	Widget_Move(parent, 40, 30);
+	LCUIWidget_Update();
+	Widget_GetInvalidAreaEx(root, &rects, &areas);
+	it_b("parent.setOpacity(0.5), parent.move(40, 30), "
+	     "root.getMovedArea().length == 0",
+	     areas.length == 0, TRUE);
+	LinkedList_Clear(&rects, free);
+	LinkedList_Clear(&areas, free);
+
+	child = LCUIWidget_New("textview");
+	TextView_SetText(child, "hello");
+	Widget_Append(parent, child);
+	Widget_SetOpacity(parent, 1.0f);
+	Widget_SetStyleString(parent, "border", "2px solid #000");
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LinkedList_Clear(&rects, free);
+
+	LCUIWidget_GetRepaintStats(&stats);
+	pixels = stats.background_pixels;
+	Widget_SetStyleString(parent, "background-color", "#0f0");
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LCUIWidget_GetRepaintStats(&stats);
+	it_b("parent.style.backgroundColor = '#0f0', "
+	     "root.getInvalidArea().length == 1",
+	     rects.length == 1, TRUE);
+	expected_rect.x = 42;
+	expected_rect.y = 32;
+	expected_rect.width = 46;
+	expected_rect.height = 46;
+	if (rects.length == 1) {
+		rect = rects.head.next->data;
+		it_rect("root.getInvalidArea()[0]", rect, &expected_rect);
+	}
+	it_i("repaintStats.backgroundPixels",
+	     (int)(stats.background_pixels - pixels), 46 * 46);
+	LinkedList_Clear(&rects, free);
+
+	pixels = stats.border_pixels;
+	Widget_SetStyleString(parent, "border-color", "#00f");
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LCUIWidget_GetRepaintStats(&stats);
+	it_b("parent.style.borderColor = '#00f', "
+	     "root.getInvalidArea().length == 4",
+	     rects.length == 4, TRUE);
+	it_i("repaintStats.borderPixels",
+	     (int)(stats.border_pixels - pixels), 50 * 50 - 46 * 46);
+	LinkedList_Clear(&rects, free);
+
+	Graph_Init(&cached);
+	Graph_Init(&expected);
+	cached.color_type = LCUI_COLOR_TYPE_ARGB;
+	expected.color_type = LCUI_COLOR_TYPE_ARGB;
+	Graph_Create(&cached, 200, 200);
+	Graph_Create(&expected, 200, 200);
+	expected_rect.x = 0;
+	expected_rect.y = 0;
+	expected_rect.width = 200;
+	expected_rect.height = 200;
+
+	paint = LCUIPainter_Begin(&cached, &expected_rect);
+	Widget_Render(root, paint);
+	LCUIPainter_End(paint);
+	LCUIWidget_GetRepaintStats(&stats);
+	pixels = stats.content_rendered_pixels;
+	Widget_SetStyleString(parent, "background-color", "#ff0");
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LinkedList_Clear(&rects, free);
+	paint = LCUIPainter_Begin(&cached, &expected_rect);
+	Widget_Render(root, paint);
+	LCUIPainter_End(paint);
+	LCUIWidget_GetRepaintStats(&stats);
+	it_b("parent.style.backgroundColor = '#ff0', "
+	     "repaintStats.contentReusedPixels > 0",
+	     stats.content_reused_pixels > 0, TRUE);
+	it_b("parent.style.backgroundColor = '#ff0', "
+	     "repaintStats.contentRenderedPixels does not change",
+	     stats.content_rendered_pixels == pixels, TRUE);
+	it_i("repaintStats.contentCacheBytes",
+	     (int)stats.content_cache_bytes, (int)parent->content_cache.mem_size);
+
+	parent->enable_content_cache = FALSE;
+	paint = LCUIPainter_Begin(&expected, &expected_rect);
+	Widget_Render(root, paint);
+	LCUIPainter_End(paint);
+	it_b("the pixels rendered with content cache are correct",
+	     memcmp(cached.bytes, expected.bytes, cached.mem_size) == 0, TRUE);
+	parent->enable_content_cache = TRUE;
+	for (i = 0; i < 300; ++i) {
+		Widget_GetInvalidArea(root, &rects);
+	}
+	LinkedList_Clear(&rects, free);
+	LCUIWidget_GetRepaintStats(&stats);
+	it_b("the content cache is freed after 300 idle frames",
+	     !Graph_IsValid(&parent->content_cache) &&
+		 !parent->enable_content_cache,
+	     TRUE);
+	it_i("repaintStats.contentCacheBytes", (int)stats.content_cache_bytes,
+	     0);
+
+	page = LCUIWidget_New(NULL);
+	header = LCUIWidget_New(NULL);
+	Widget_SetStyleString(page, "position", "absolute");
+	Widget_SetStyleString(page, "background-color", "#f00");
+	Widget_SetStyleString(header, "position", "absolute");
+	Widget_SetStyleString(header, "background-color", "#00f");
+	Widget_Move(page, 0, 0);
+	Widget_Resize(page, 200, 200);
+	Widget_Move(header, 0, 0);
+	Widget_Resize(header, 200, 50);
+	Widget_Append(root, page);
+	Widget_Append(root, header);
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LinkedList_Clear(&rects, free);
+	LCUIWidget_ResetRepaintStats();
+	paint = LCUIPainter_Begin(&cached, &expected_rect);
+	Widget_Render(root, paint);
+	LCUIPainter_End(paint);
+	LCUIWidget_GetRepaintStats(&stats);
+	it_i("root.append(page, header), repaintStats.occludedWidgets",
+	     (int)stats.occluded_widgets, 1);
+	it_b("root.append(page, header), repaintStats.occludedPixels >= "
+	     "parent.canvasBox.area + header.borderBox.area",
+	     stats.occluded_pixels >= 50 * 50 + 200 * 50, TRUE);
+	it_i("root.append(page, header), repaintStats.paintedPixels",
+	     (int)stats.painted_pixels, 200 * 150 + 200 * 50);
+	Graph_GetPixel(&cached, 100, 25, color);
+	it_b("the pixels of the header are correct",
+	     color.r == 0 && color.g == 0 && color.b > 250, TRUE);
+	Graph_GetPixel(&cached, 100, 100, color);
+	it_b("the pixels of the page are correct",
+	     color.r > 250 && color.g == 0 && color.b == 0, TRUE);
+	Graph_Free(&cached);
+	Graph_Free(&expected);
+
+	LCUIWidget_ResetInvalidationStats();
+	invalid_rect.y = 0;
+	invalid_rect.width = 10;
+	invalid_rect.height = 10;
+	for (i = 0; i < 100; ++i) {
+		invalid_rect.x = (float)i;
+		Widget_InvalidateArea(header, &invalid_rect, SV_CONTENT_BOX);
+	}
+	LCUIWidget_GetInvalidationStats(&istats);
+	it_i("header.invalidateArea() x100, invalidationStats.records",
+	     (int)istats.records, 1);
+	it_i("header.invalidateArea() x100, invalidationStats.merged",
+	     (int)istats.merged, 99);
+	it_b("header.invalidateArea() x100, root.hasChildInvalidArea",
+	     root->has_child_invalid_area, FALSE);
+	it_i("app.flushInvalidJournal()", (int)LCUIWidget_FlushInvalidJournal(),
+	     1);
+	it_b("app.flushInvalidJournal(), root.hasChildInvalidArea",
+	     root->has_child_invalid_area, TRUE);
+	Widget_GetInvalidArea(root, &rects);
+	it_b("header.invalidateArea() x100, root.getInvalidArea().length == 1",
+	     rects.length == 1, TRUE);
+	if (rects.length == 1) {
+		rect = rects.head.next->data;
+		expected_rect.x = 0;
+		expected_rect.y = 0;
+		expected_rect.width = 109;
+		expected_rect.height = 10;
+		it_rect("root.getInvalidArea()[0]", rect, &expected_rect);
+	}
+	LinkedList_Clear(&rects, free);
+
+	leaf = LCUIWidget_New(NULL);
+	Widget_Resize(leaf, 20, 20);
+	Widget_Append(header, leaf);
+	LCUIWidget_Update();
+	Widget_GetInvalidArea(root, &rects);
+	LinkedList_Clear(&rects, free);
+	Widget_InvalidateArea(leaf, NULL, SV_BORDER_BOX);
+	Widget_Destroy(leaf);
+	LCUIWidget_Update();
+	it_i("leaf.destroy(), app.flushInvalidJournal()",
+	     (int)LCUIWidget_FlushInvalidJournal(), 1);
+	LCUIWidget_GetInvalidationStats(&istats);
+	it_i("leaf.destroy(), invalidationStats.flushes",
+	     (int)istats.flushes, 3);
+	Widget_GetInvalidArea(root, &rects);
+	LinkedList_Clear(&rects, free);
+
+	test_invalid_journal_threads(header);
 	LCUI_Destroy();
 }
@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+#include "test.h"
+#include "libtest.h"
+
+#define BOX_WIDTH 100
+#define BOX_HEIGHT 60
+
+static struct {
+	LCUI_Widget box;
+	LCUI_Widget child;
+	LCUI_Graph result;
+	int rendered;
+} self;
+
+static LCUI_BOOL CheckPixel(LCUI_Graph *graph, int x, int y, LCUI_Color c)
+{
+	LCUI_Color color;
+
+	/* The scaled pixels may have a rounding error */
+	Graph_GetPixel(graph, x, y, color);
+	return abs(color.r - c.r) < 4 && abs(color.g - c.g) < 4 &&
+	       abs(color.b - c.b) < 4 && abs(color.a - c.a) < 4;
+}
+
+static LCUI_BOOL IsSameGraph(LCUI_Graph *a, LCUI_Graph *b)
+{
+	unsigned y;
+
+	if (a->width != b->width || a->height != b->height) {
+		return FALSE;
+	}
+	for (y = 0; y < a->height; ++y) {
+		if (memcmp(a->bytes + a->bytes_per_row * y,
+			   b->bytes + b->bytes_per_row * y,
+			   a->bytes_per_pixel * a->width) != 0) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static void OnRendered(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	self.rendered += 1;
+	Graph_Copy(&self.result, arg);
+}
+
+static void WaitRendered(int timeout)
+{
+	int i;
+
+	for (i = 0; i < timeout / 10 && !self.rendered; ++i) {
+		LCUI_ProcessEvents();
+		LCUI_MSleep(10);
+	}
+}
+
+static void build(void)
+{
+	LCUI_Widget text;
+
+	self.box = LCUIWidget_New(NULL);
+	self.child = LCUIWidget_New(NULL);
+	text = LCUIWidget_New("textview");
+	Widget_SetStyleString(self.box, "position", "absolute");
+	Widget_SetStyleString(self.box, "left", "20px");
+	Widget_SetStyleString(self.box, "top", "10px");
+	Widget_SetStyleString(self.box, "box-sizing", "border-box");
+	Widget_SetStyleString(self.box, "border", "10px solid #00f");
+	Widget_SetStyleString(self.box, "background-color", "#f00");
+	Widget_SetStyleString(self.child, "position", "absolute");
+	Widget_SetStyleString(self.child, "left", "30px");
+	Widget_SetStyleString(self.child, "top", "10px");
+	Widget_SetStyleString(self.child, "width", "20px");
+	Widget_SetStyleString(self.child, "height", "20px");
+	Widget_SetStyleString(self.child, "background-color", "#0f0");
+	TextView_SetText(text, "text");
+	Widget_Resize(self.box, BOX_WIDTH, BOX_HEIGHT);
+	Widget_Append(self.box, text);
+	Widget_Append(self.box, self.child);
+	Widget_Append(LCUIWidget_GetRoot(), self.box);
+	LCUIWidget_Update();
+}
+
+static void test_render_to_graph(void)
+{
+	LCUI_Graph graph;
+	LCUI_RectF rect = { 50, 0, 50, 60 };
+
+	Graph_Init(&graph);
+	it_i("render the whole widget",
+	     Widget_RenderToGraph(self.box, 1.0f, NULL, &graph), 0);
+	it_b("the size of the graph is the size of the border box",
+	     graph.width == BOX_WIDTH && graph.height == BOX_HEIGHT, TRUE);
+	it_b("the border is rendered",
+	     CheckPixel(&graph, 2, 2, ARGB(255, 0, 0, 255)), TRUE);
+	it_b("the background is rendered",
+	     CheckPixel(&graph, 15, BOX_HEIGHT - 15, ARGB(255, 255, 0, 0)),
+	     TRUE);
+	it_b("the child widget is rendered",
+	     CheckPixel(&graph, 50, 30, ARGB(255, 0, 255, 0)), TRUE);
+
+	it_i("render a scaled widget",
+	     Widget_RenderToGraph(self.box, 0.5f, NULL, &graph), 0);
+	it_b("the size of the graph is scaled",
+	     graph.width == BOX_WIDTH / 2 && graph.height == BOX_HEIGHT / 2,
+	     TRUE);
+	it_b("the scaled child widget is rendered",
+	     CheckPixel(&graph, 25, 15, ARGB(255, 0, 255, 0)), TRUE);
+
+	it_i("render a part of the widget",
+	     Widget_RenderToGraph(self.box, 1.0f, &rect, &graph), 0);
+	it_b("the graph only contains the part",
+	     graph.width == 50 && CheckPixel(&graph, 0, 30, ARGB(255, 0, 255, 0)),
+	     TRUE);
+
+	rect.x = -10;
+	rect.width = 20;
+	it_i("render an area beyond the widget",
+	     Widget_RenderToGraph(self.box, 1.0f, &rect, &graph), 0);
+	it_b("the pixels beyond the widget are transparent",
+	     CheckPixel(&graph, 5, 30, ARGB(0, 0, 0, 0)) &&
+		 CheckPixel(&graph, 15, 2, ARGB(255, 0, 0, 255)),
+	     TRUE);
+	it_b("render with an invalid scale",
+	     Widget_RenderToGraph(self.box, 0, NULL, &graph) < 0, TRUE);
+	Graph_Free(&graph);
+}
+
+static void test_render_to_graph_async(void)
+{
+	int id;
+	LCUI_Graph graph;
+
+	Graph_Init(&graph);
+	Graph_Init(&self.result);
+	Widget_RenderToGraph(self.box, 1.0f, NULL, &graph);
+	id = Widget_BindEvent(self.box, "rendered", OnRendered, NULL, NULL);
+	self.rendered = 0;
+	it_i("start rendering on a worker",
+	     Widget_RenderToGraphAsync(self.box, 1.0f, NULL), 0);
+	/* The changes after starting will not affect the result */
+	Widget_SetStyleString(self.box, "background-color", "#ff0");
+	Widget_SetStyleString(self.child, "display", "none");
+	LCUIWidget_Update();
+	WaitRendered(2000);
+	it_i("the rendered event is triggered once", self.rendered, 1);
+	it_b("the result is the same as the synchronous rendering",
+	     IsSameGraph(&self.result, &graph), TRUE);
+
+	self.rendered = 0;
+	Widget_RenderToGraphAsync(self.box, 1.0f, NULL);
+	WaitRendered(2000);
+	it_b("the result of the next rendering has the changes",
+	     CheckPixel(&self.result, 15, BOX_HEIGHT - 15,
+			ARGB(255, 255, 255, 0)) &&
+		 CheckPixel(&self.result, 50, 30, ARGB(255, 255, 255, 0)),
+	     TRUE);
+	Widget_UnbindEventByHandlerId(self.box, id);
+
+	self.rendered = 0;
+	Widget_BindEvent(self.box, "rendered", OnRendered, NULL, NULL);
+	Widget_RenderToGraphAsync(self.box, 1.0f, NULL);
+	Widget_Destroy(self.box);
+	LCUIWidget_Update();
+	WaitRendered(200);
+	it_i("the destroyed widget does not receive the rendered event",
+	     self.rendered, 0);
+	Graph_Free(&self.result);
+	Graph_Free(&graph);
+}
+
+void test_widget_render_to_graph(void)
+{
+	LCUI_Init();
+	build();
+	describe("render widget to graph", test_render_to_graph);
+	describe("render widget to graph on worker",
+		 test_render_to_graph_async);
+	LCUI_Destroy();
+}
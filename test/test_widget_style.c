@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_library.h>
+#include "test.h"
+#include "libtest.h"
+
+static void test_compile_style(void)
+{
+	LCUI_StyleListNode node;
+	LCUI_StyleList list = StyleList();
+
+	it_i("compile a length",
+	     Widget_CompileStyleString(list, "width", "100px"), 0);
+	node = StyleList_GetNode(list, key_width);
+	it_b("the length is parsed",
+	     node && node->style.type == LCUI_STYPE_PX &&
+		 node->style.val_px == 100.0f,
+	     TRUE);
+	it_i("compile a shorthand property",
+	     Widget_CompileStyleString(list, "padding", "1px 2px"), 0);
+	it_b("the shorthand property is expanded",
+	     StyleList_GetNode(list, key_padding_top) &&
+		 StyleList_GetNode(list, key_padding_left),
+	     TRUE);
+	it_i("compile a value again",
+	     Widget_CompileStyleString(list, "width", "200px"), 0);
+	node = StyleList_GetNode(list, key_width);
+	it_b("the old value is replaced", node->style.val_px == 200.0f,
+	     TRUE);
+	it_i("compile an unknown property",
+	     Widget_CompileStyleString(list, "not-a-property", "1px"),
+	     -ENOENT);
+	it_i("compile an invalid value",
+	     Widget_CompileStyleString(list, "z-index", "abc"), -1);
+	StyleList_Delete(list);
+}
+
+static void test_set_styles(void)
+{
+	LCUI_Widget w;
+	LCUI_StyleList list = StyleList();
+
+	w = LCUIWidget_New(NULL);
+	Widget_Append(LCUIWidget_GetRoot(), w);
+	Widget_CompileStyleString(list, "width", "120px");
+	Widget_CompileStyleString(list, "height", "40px");
+	Widget_CompileStyleString(list, "padding", "4px");
+	Widget_CompileStyleString(list, "visibility", "hidden");
+	Widget_SetStyles(w, list);
+	LCUIWidget_Update();
+	it_i("the width is set", (int)w->width, 128);
+	it_i("the height is set", (int)w->height, 48);
+	it_b("the widget is hidden", w->computed_style.visible, FALSE);
+	it_b("the strings are copied to the widget",
+	     Widget_GetStyle(w, key_visibility)->val_string !=
+		 StyleList_GetNode(list, key_visibility)->style.val_string,
+	     TRUE);
+
+	Widget_SetStyles(w, list);
+	LCUIWidget_Update();
+	it_i("the styles can be set again", (int)w->width, 128);
+	StyleList_Delete(list);
+	it_b("the widget keeps its styles after the list is deleted",
+	     strcmp(Widget_GetStyle(w, key_visibility)->val_string,
+		    "hidden") == 0,
+	     TRUE);
+	Widget_Destroy(w);
+}
+
+void test_widget_style(void)
+{
+	LCUI_Init();
+	describe("compile style string", test_compile_style);
+	describe("set styles", test_set_styles);
+	LCUI_Destroy();
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_library.h>
+
+#define FRAMES 100000
+#define VALUES 64
+
+/** Styles of a progress bar which are updated at every tick */
+static const char *names[] = { "width", "background-color", "border",
+			       "margin" };
+
+static void GetValues(int i, char values[4][64])
+{
+	sprintf(values[0], "%dpx", i % 200);
+	sprintf(values[1], "rgba(%d, %d, 255, 0.5)", i % 256, 255 - i % 256);
+	sprintf(values[2], "%dpx solid #%02x0000", i % 4, i % 256);
+	sprintf(values[3], "%dpx %dpx", i % 8, i % 16);
+}
+
+static double SetStyleStrings(LCUI_Widget w)
+{
+	int i, j;
+	int64_t start;
+	char values[VALUES][4][64];
+
+	for (i = 0; i < VALUES; ++i) {
+		GetValues(i, values[i]);
+	}
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < FRAMES; ++i) {
+		for (j = 0; j < 4; ++j) {
+			Widget_SetStyleString(w, names[j],
+					      values[i % VALUES][j]);
+		}
+	}
+	return (LCUI_GetTimeNs() - start) / 1000.0 / FRAMES;
+}
+
+static double SetCompiledStyles(LCUI_Widget w)
+{
+	int i, j;
+	int64_t start;
+	char values[4][64];
+	LCUI_StyleList lists[VALUES];
+
+	for (i = 0; i < VALUES; ++i) {
+		lists[i] = StyleList();
+		GetValues(i, values);
+		for (j = 0; j < 4; ++j) {
+			Widget_CompileStyleString(lists[i], names[j],
+						  values[j]);
+		}
+	}
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < FRAMES; ++i) {
+		Widget_SetStyles(w, lists[i % VALUES]);
+	}
+	start = LCUI_GetTimeNs() - start;
+	for (i = 0; i < VALUES; ++i) {
+		StyleList_Delete(lists[i]);
+	}
+	return start / 1000.0 / FRAMES;
+}
+
+int main(int argc, char **argv)
+{
+	double str, compiled;
+	LCUI_Widget w;
+
+	LCUI_Init();
+	w = LCUIWidget_New(NULL);
+	Widget_Append(LCUIWidget_GetRoot(), w);
+	str = SetStyleStrings(w);
+	compiled = SetCompiledStyles(w);
+	Logger_Info("set %d properties (%d styles after expanding "
+		    "shorthands) %d times\n",
+		    4, (int)w->custom_style->length, FRAMES);
+	Logger_Info("%-32s%-12s\n", "method", "time(us)");
+	Logger_Info("%-32s%-12.3f\n", "Widget_SetStyleString", str);
+	Logger_Info("%-32s%-12.3f\n", "Widget_SetStyles (compiled)",
+		    compiled);
+	LCUI_Destroy();
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/widget/textview.h>
+
+#define CARDS 200
+#define CARD_WIDTH 240
+#define CARD_HEIGHT 160
+#define THUMBNAIL_SCALE 0.5f
+
+static volatile unsigned checksum = 0;
+static int rendered = 0;
+
+/** Create a card with a header, a cover image area and some text */
+static LCUI_Widget CreateCard(int i)
+{
+	char text[64];
+	LCUI_Widget card, header, cover, title, desc;
+
+	card = LCUIWidget_New(NULL);
+	header = LCUIWidget_New(NULL);
+	cover = LCUIWidget_New(NULL);
+	title = LCUIWidget_New("textview");
+	desc = LCUIWidget_New("textview");
+	Widget_SetStyleString(card, "display", "inline-block");
+	Widget_SetStyleString(card, "border", "1px solid #ddd");
+	Widget_SetStyleString(card, "border-radius", "4px");
+	Widget_SetStyleString(card, "background-color", "#fff");
+	Widget_SetStyleString(card, "box-shadow", "0 2px 4px rgba(0,0,0,0.2)");
+	Widget_SetStyleString(header, "height", "24px");
+	Widget_SetStyleString(header, "background-color", "#2196f3");
+	Widget_SetStyleString(cover, "height", "64px");
+	Widget_SetStyleString(cover, "background-color", "#eee");
+	sprintf(text, "Card %d", i);
+	TextView_SetText(title, text);
+	TextView_SetText(desc, "A short description of the card, it may "
+			       "take more than one line.");
+	Widget_Resize(card, CARD_WIDTH, CARD_HEIGHT);
+	Widget_Append(header, title);
+	Widget_Append(card, header);
+	Widget_Append(card, cover);
+	Widget_Append(card, desc);
+	return card;
+}
+
+static void OnRendered(LCUI_Widget w, LCUI_WidgetEvent e, void *arg)
+{
+	LCUI_Graph *graph = arg;
+
+	rendered += 1;
+	checksum += graph->width * graph->height;
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	int64_t start, main_time, total_time;
+	double sync_ms, async_main_ms, async_total_ms;
+	LCUI_Widget cards[CARDS], root;
+	LCUI_Graph graph;
+
+	LCUI_Init();
+	root = LCUIWidget_GetRoot();
+	for (i = 0; i < CARDS; ++i) {
+		cards[i] = CreateCard(i);
+		Widget_BindEvent(cards[i], "rendered", OnRendered, NULL, NULL);
+		Widget_Append(root, cards[i]);
+	}
+	LCUIWidget_Update();
+
+	Graph_Init(&graph);
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < CARDS; ++i) {
+		Widget_RenderToGraph(cards[i], THUMBNAIL_SCALE, NULL, &graph);
+		checksum += graph.width * graph.height;
+	}
+	sync_ms = (LCUI_GetTimeNs() - start) / 1000000.0;
+	Graph_Free(&graph);
+
+	/* Only the snapshots are created in the main loop */
+	start = LCUI_GetTimeNs();
+	for (i = 0; i < CARDS; ++i) {
+		Widget_RenderToGraphAsync(cards[i], THUMBNAIL_SCALE, NULL);
+	}
+	main_time = LCUI_GetTimeNs() - start;
+	while (rendered < CARDS) {
+		LCUI_ProcessEvents();
+		LCUI_MSleep(1);
+	}
+	total_time = LCUI_GetTimeNs() - start;
+	async_main_ms = main_time / 1000000.0;
+	async_total_ms = total_time / 1000000.0;
+
+	Logger_Info("render %d thumbnails of %dx%d cards\n", CARDS,
+		    CARD_WIDTH, CARD_HEIGHT);
+	Logger_Info("%-36s%-12s\n", "method", "time(ms)");
+	Logger_Info("%-36s%-12.2f\n", "synchronous (main loop)", sync_ms);
+	Logger_Info("%-36s%-12.2f\n", "asynchronous (main loop)",
+		    async_main_ms);
+	Logger_Info("%-36s%-12.2f\n", "asynchronous (until completed)",
+		    async_total_ms);
+	LCUI_Destroy();
+	return 0;
+}